@@ -0,0 +1,134 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Logger.h"
+#include "io/DiskFileSystem.h"
+#include "io/DiskIO.h"
+#include "io/File.h"
+#include "io/Md3Loader.h"
+#include "io/MdlLoader.h"
+#include "io/Reader.h"
+#include "mdl/EntityModel.h"
+#include "mdl/Material.h"
+#include "mdl/Palette.h"
+#include "mdl/Texture.h"
+#include "mdl/TextureResource.h"
+
+#include "kdl/result.h"
+
+#include "vm/ray.h"
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace tb::io
+{
+namespace
+{
+
+constexpr auto NumIterations = 200;
+
+using LoadModel = std::function<Result<mdl::EntityModelData>(Reader, Logger&)>;
+
+struct ModelFile
+{
+  std::filesystem::path path;
+  LoadModel load;
+};
+
+mdl::Material makeDummyMaterial(const std::filesystem::path& path)
+{
+  auto textureResource = createTextureResource(mdl::Texture{1, 1});
+  return mdl::Material{path.string(), std::move(textureResource)};
+}
+
+std::vector<ModelFile> makeModelFiles(const mdl::Palette& palette)
+{
+  const auto loadMdl = [&](Reader reader, Logger& logger) {
+    return MdlLoader{"model", reader, palette}.load(logger);
+  };
+  const auto loadMd3 = [](Reader reader, Logger& logger) {
+    return Md3Loader{"model", reader, makeDummyMaterial}.load(logger);
+  };
+
+  return {
+    {"fixture/test/io/Mdl/armor.mdl", loadMdl},
+    {"fixture/test/io/Md3/armor/models/armor_red.md3", loadMd3},
+    {"fixture/test/io/Md3/bfg/models/weapons2/bfg/bfg.md3", loadMd3},
+  };
+}
+
+void hitTestAllFrames(const mdl::EntityModelData& modelData)
+{
+  for (const auto& frame : modelData.frames())
+  {
+    const auto& bounds = frame.bounds();
+    const auto ray = vm::ray3f{bounds.max + vm::vec3f{1, 1, 1}, vm::vec3f{-1, -1, -1}};
+    frame.intersect(ray);
+  }
+}
+
+} // namespace
+
+TEST_CASE("EntityModelLoaderBenchmark.load")
+{
+  auto logger = NullLogger{};
+
+  auto fs = DiskFileSystem{std::filesystem::current_path()};
+  auto paletteFile = fs.openFile("fixture/test/palette.lmp") | kdl::value();
+  const auto palette =
+    mdl::loadPalette(*paletteFile, "fixture/test/palette.lmp") | kdl::value();
+
+  for (const auto& modelFile : makeModelFiles(palette))
+  {
+    const auto file =
+      Disk::openFile(std::filesystem::current_path() / modelFile.path) | kdl::value();
+    const auto reader = file->reader().buffer();
+
+    timeLambda(
+      [&]() {
+        for (auto i = 0; i < NumIterations; ++i)
+        {
+          CHECK(modelFile.load(reader, logger).is_success());
+        }
+      },
+      fmt::format("load {} {} times", modelFile.path.filename().string(), NumIterations));
+
+    timeLambda(
+      [&]() {
+        for (auto i = 0; i < NumIterations; ++i)
+        {
+          const auto modelData = modelFile.load(reader, logger) | kdl::value();
+          hitTestAllFrames(modelData);
+        }
+      },
+      fmt::format(
+        "load and hit test all frames of {} {} times",
+        modelFile.path.filename().string(),
+        NumIterations));
+  }
+}
+
+} // namespace tb::io
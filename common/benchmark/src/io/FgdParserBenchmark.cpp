@@ -0,0 +1,132 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Color.h"
+#include "io/EntityDefinitionClassInfo.h"
+#include "io/FgdParser.h"
+#include "io/TestParserStatus.h"
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace tb::io
+{
+namespace
+{
+
+constexpr auto NumFiles = 32;
+constexpr auto NumClassesPerFile = 250;
+
+std::string makeClasses(const int fileIndex)
+{
+  auto str = std::string{};
+  for (auto i = 0; i < NumClassesPerFile; ++i)
+  {
+    str += fmt::format(
+      R"(
+@PointClass base(Targetname) size(-16 -16 -24, 16 16 32) color(0 255 0)
+  model({{ "path": ":progs/model{0}_{1}.mdl", "skin": skin, "frame": frame }})
+  = entity_{0}_{1} : "Entity {0} {1}"
+[
+  skin(integer) : "Skin" : 1
+  speed(float) : "Speed" : "12.5"
+  style(choices) : "Style" : 0 =
+  [
+    0 : "Normal"
+    1 : "Flicker"
+  ]
+  spawnflags(flags) =
+  [
+    1 : "Start off" : 0
+    2 : "Silent" : 1
+  ]
+]
+)",
+      fileIndex,
+      i);
+  }
+  return str;
+}
+
+void writeFile(const std::filesystem::path& path, const std::string& contents)
+{
+  auto stream = std::ofstream{path, std::ios::out | std::ios::binary};
+  stream << contents;
+}
+
+} // namespace
+
+TEST_CASE("FgdParserBenchmark.parseIncludes")
+{
+  const auto dir = std::filesystem::temp_directory_path() / "tb-fgd-parser-benchmark";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+
+  const auto baseClass =
+    std::string{R"(@baseclass = Targetname [ targetname(target_source) : "Name" ])"};
+
+  auto host = baseClass;
+  auto single = baseClass;
+  for (auto i = 0; i < NumFiles; ++i)
+  {
+    const auto classes = makeClasses(i);
+    const auto filename = fmt::format("include{}.fgd", i);
+    writeFile(dir / filename, classes);
+
+    host += fmt::format("\n@include \"{}\"\n", filename);
+    single += classes;
+  }
+
+  const auto hostPath = dir / "host.fgd";
+  const auto singlePath = dir / "single.fgd";
+  writeFile(hostPath, host);
+  writeFile(singlePath, single);
+
+  auto singleClassInfos = std::vector<EntityDefinitionClassInfo>{};
+  timeLambda(
+    [&]() {
+      auto parser = FgdParser{single, Color{1.0f, 1.0f, 1.0f, 1.0f}, singlePath};
+      auto status = TestParserStatus{};
+      singleClassInfos = parser.parseClassInfos(status);
+    },
+    fmt::format("parse {} classes from a single file", NumFiles * NumClassesPerFile));
+
+  auto includedClassInfos = std::vector<EntityDefinitionClassInfo>{};
+  timeLambda(
+    [&]() {
+      auto parser = FgdParser{host, Color{1.0f, 1.0f, 1.0f, 1.0f}, hostPath};
+      auto status = TestParserStatus{};
+      includedClassInfos = parser.parseClassInfos(status);
+    },
+    fmt::format(
+      "parse {} classes from {} included files",
+      NumFiles * NumClassesPerFile,
+      NumFiles));
+
+  CHECK(includedClassInfos.size() == singleClassInfos.size());
+
+  std::filesystem::remove_all(dir);
+}
+
+} // namespace tb::io
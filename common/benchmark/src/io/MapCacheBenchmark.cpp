@@ -0,0 +1,167 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "io/ParseCache.h"
+#include "io/TestParserStatus.h"
+#include "io/WorldReader.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/WorldNode.h"
+
+#include "vm/bbox.h"
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+
+namespace tb::io
+{
+namespace
+{
+
+constexpr auto GridSize = 50;
+constexpr auto GridHeight = 8;
+constexpr auto BrushSize = 48;
+constexpr auto BrushSpacing = 64;
+constexpr auto NumBrushes = GridSize * GridSize * GridHeight;
+constexpr auto NumEntities = 2000;
+
+const auto WorldBounds = vm::bbox3d{8192.0};
+
+/**
+ * Returns a map containing a grid of cube brushes in worldspawn and a number of point
+ * entities.
+ */
+std::string makeMap()
+{
+  auto str = std::string{"// entity 0\n{\n\"classname\" \"worldspawn\"\n"};
+  for (auto z = 0; z < GridHeight; ++z)
+  {
+    for (auto y = 0; y < GridSize; ++y)
+    {
+      for (auto x = 0; x < GridSize; ++x)
+      {
+        const auto minX = x * BrushSpacing;
+        const auto minY = y * BrushSpacing;
+        const auto minZ = z * BrushSpacing;
+        const auto maxX = minX + BrushSize;
+        const auto maxY = minY + BrushSize;
+        const auto maxZ = minZ + BrushSize;
+        str += fmt::format(
+          R"(// brush {12}
+{{
+( {0} {1} {2} ) ( {0} {4} {2} ) ( {0} {1} {5} ) material 0 0 0 1 1
+( {0} {1} {2} ) ( {0} {1} {5} ) ( {3} {1} {2} ) material 0 0 0 1 1
+( {0} {1} {2} ) ( {3} {1} {2} ) ( {0} {4} {2} ) material 0 0 0 1 1
+( {6} {7} {8} ) ( {6} {10} {8} ) ( {9} {7} {8} ) material 0 0 0 1 1
+( {6} {7} {8} ) ( {9} {7} {8} ) ( {6} {7} {11} ) material 0 0 0 1 1
+( {6} {7} {8} ) ( {6} {7} {11} ) ( {6} {10} {8} ) material 0 0 0 1 1
+}}
+)",
+          minX,
+          minY,
+          minZ,
+          minX + 1,
+          minY + 1,
+          minZ + 1,
+          maxX,
+          maxY,
+          maxZ,
+          maxX + 1,
+          maxY + 1,
+          maxZ + 1,
+          (z * GridSize + y) * GridSize + x);
+      }
+    }
+  }
+  str += "}\n";
+
+  for (auto i = 0; i < NumEntities; ++i)
+  {
+    str += fmt::format(
+      R"(// entity {0}
+{{
+"classname" "light"
+"origin" "{1} {2} 512"
+"light" "300"
+"targetname" "light_{0}"
+}}
+)",
+      i + 1,
+      (i % GridSize) * BrushSpacing,
+      (i / GridSize) * BrushSpacing);
+  }
+
+  return str;
+}
+
+} // namespace
+
+TEST_CASE("MapCacheBenchmark.reopenMap")
+{
+  const auto dir = std::filesystem::temp_directory_path() / "tb-map-cache-benchmark";
+  std::filesystem::remove_all(dir);
+
+  const auto map = makeMap();
+  const auto cache = ParseCache{dir / "cache"};
+  const auto mapFormats = std::vector<mdl::MapFormat>{mdl::MapFormat::Standard};
+
+  auto fingerprint = FileFingerprint{};
+  timeLambda(
+    [&]() { fingerprint = makeFileFingerprint(dir / "benchmark.map", map); },
+    fmt::format("hash {} MB map file", map.size() / 1024 / 1024));
+
+  auto parsedWorldNode = std::unique_ptr<mdl::WorldNode>{};
+  timeLambda(
+    [&]() {
+      auto status = TestParserStatus{};
+      auto reader = WorldReader{map, mdl::MapFormat::Standard, {}};
+      parsedWorldNode = reader.read(WorldBounds, status);
+    },
+    fmt::format(
+      "parse map file with {} brushes and {} entities", NumBrushes, NumEntities));
+
+  auto pendingWrite = std::future<void>{};
+  timeLambda(
+    [&]() { pendingWrite = cache.writeMap(fingerprint, *parsedWorldNode); },
+    "serialize map cache entry");
+  timeLambda([&]() { pendingWrite.wait(); }, "write map cache entry");
+
+  auto cachedWorldNode = std::unique_ptr<mdl::WorldNode>{};
+  timeLambda(
+    [&]() {
+      auto status = TestParserStatus{};
+      cachedWorldNode = cache.readMap(fingerprint, mapFormats, WorldBounds, {}, status);
+    },
+    "read map cache entry");
+
+  REQUIRE(cachedWorldNode != nullptr);
+  CHECK(
+    cachedWorldNode->defaultLayer()->childCount()
+    == parsedWorldNode->defaultLayer()->childCount());
+
+  std::filesystem::remove_all(dir);
+}
+
+} // namespace tb::io
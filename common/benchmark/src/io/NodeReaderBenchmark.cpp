@@ -0,0 +1,147 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "io/NodeReader.h"
+#include "io/TestParserStatus.h"
+#include "mdl/MapFormat.h"
+#include "mdl/Node.h"
+
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+
+#include <fmt/format.h>
+
+#include <string>
+#include <vector>
+
+namespace tb::io
+{
+namespace
+{
+
+constexpr auto GridSize = 50;
+constexpr auto GridHeight = 8;
+constexpr auto BrushSize = 48;
+constexpr auto BrushSpacing = 64;
+constexpr auto NumBrushes = GridSize * GridSize * GridHeight;
+
+/**
+ * Returns a worldspawn entity containing a grid of cube brushes, which is what the
+ * clipboard contains after copying brushes from the editor.
+ */
+std::string makeClipboardContents()
+{
+  auto str = std::string{"{\n\"classname\" \"worldspawn\"\n"};
+  for (auto z = 0; z < GridHeight; ++z)
+  {
+    for (auto y = 0; y < GridSize; ++y)
+    {
+      for (auto x = 0; x < GridSize; ++x)
+      {
+        const auto minX = x * BrushSpacing;
+        const auto minY = y * BrushSpacing;
+        const auto minZ = z * BrushSpacing;
+        const auto maxX = minX + BrushSize;
+        const auto maxY = minY + BrushSize;
+        const auto maxZ = minZ + BrushSize;
+        str += fmt::format(
+          R"({{
+( {0} {1} {2} ) ( {0} {4} {2} ) ( {0} {1} {5} ) material 0 0 0 1 1
+( {0} {1} {2} ) ( {0} {1} {5} ) ( {3} {1} {2} ) material 0 0 0 1 1
+( {0} {1} {2} ) ( {3} {1} {2} ) ( {0} {4} {2} ) material 0 0 0 1 1
+( {6} {7} {8} ) ( {6} {10} {8} ) ( {9} {7} {8} ) material 0 0 0 1 1
+( {6} {7} {8} ) ( {9} {7} {8} ) ( {6} {7} {11} ) material 0 0 0 1 1
+( {6} {7} {8} ) ( {6} {7} {11} ) ( {6} {10} {8} ) material 0 0 0 1 1
+}}
+)",
+          minX,
+          minY,
+          minZ,
+          minX + 1,
+          minY + 1,
+          minZ + 1,
+          maxX,
+          maxY,
+          maxZ,
+          maxX + 1,
+          maxY + 1,
+          maxZ + 1);
+      }
+    }
+  }
+  str += "}\n";
+  return str;
+}
+
+std::vector<mdl::Node*> readNodes(const std::string& str)
+{
+  auto status = TestParserStatus{};
+  return NodeReader::read(str, mdl::MapFormat::Standard, vm::bbox3d{8192.0}, {}, status);
+}
+
+} // namespace
+
+TEST_CASE("NodeReaderBenchmark.pasteBrushes")
+{
+  const auto str = makeClipboardContents();
+
+  auto nodes = std::vector<mdl::Node*>{};
+  timeLambda(
+    [&]() { nodes = readNodes(str); },
+    fmt::format("read {} brushes from the clipboard", NumBrushes));
+
+  // the brushes are returned as children of a layer that stands in for the world node
+  REQUIRE(nodes.size() == 1u);
+  REQUIRE(nodes.front()->childCount() == size_t(NumBrushes));
+
+  auto* container = nodes.front();
+  auto children = container->children();
+  timeLambda(
+    [&]() {
+      for (auto* child : children)
+      {
+        container->removeChild(child);
+      }
+    },
+    fmt::format("detach {} brushes one by one", NumBrushes));
+
+  kdl::vec_clear_and_delete(children);
+  kdl::vec_clear_and_delete(nodes);
+
+  nodes = readNodes(str);
+  container = nodes.front();
+  timeLambda(
+    [&]() {
+      for (auto& child : container->replaceChildren({}))
+      {
+        children.push_back(child.release());
+      }
+    },
+    fmt::format("detach {} brushes at once", NumBrushes));
+
+  CHECK(children.size() == size_t(NumBrushes));
+
+  kdl::vec_clear_and_delete(children);
+  kdl::vec_clear_and_delete(nodes);
+}
+
+} // namespace tb::io
@@ -0,0 +1,209 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Color.h"
+#include "Logger.h"
+#include "io/DiskFileSystem.h"
+#include "io/EntityDefinitionClassInfo.h"
+#include "io/FgdParser.h"
+#include "io/LoadShaders.h"
+#include "io/ParseCache.h"
+#include "io/TestParserStatus.h"
+#include "mdl/GameConfig.h"
+#include "mdl/Quake3Shader.h"
+
+#include "kdl/result.h"
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace tb::io
+{
+namespace
+{
+
+constexpr auto NumClasses = 2000;
+
+// about the size of the shader scripts that ship with Quake 3
+constexpr auto NumShaderFiles = 40;
+constexpr auto NumShadersPerFile = 100;
+
+std::string makeFgd()
+{
+  auto str = std::string{R"(
+@baseclass = Targetname [ targetname(target_source) : "Name" ]
+@baseclass = Target [ target(target_destination) : "Target" ]
+)"};
+
+  for (auto i = 0; i < NumClasses; ++i)
+  {
+    str += fmt::format(
+      R"(
+@PointClass base(Targetname, Target) size(-16 -16 -24, 16 16 32) color(0 255 0)
+  model({{ "path": ":progs/model{0}.mdl", "skin": skin, "frame": frame }})
+  = entity_{0} : "Entity {0}"
+[
+  skin(integer) : "Skin" : 1
+  speed(float) : "Speed" : "12.5"
+  style(choices) : "Style" : 0 =
+  [
+    0 : "Normal"
+    1 : "Flicker"
+  ]
+  spawnflags(flags) =
+  [
+    1 : "Start off" : 0
+    2 : "Silent" : 1
+  ]
+]
+)",
+      i);
+  }
+
+  return str;
+}
+
+std::string makeShaderFile(const int fileIndex)
+{
+  auto str = std::string{};
+  for (auto i = 0; i < NumShadersPerFile; ++i)
+  {
+    str += fmt::format(
+      R"(
+textures/set{0}/shader{1}
+{{
+  qer_editorimage textures/set{0}/shader{1}.tga
+  surfaceparm nomarks
+  surfaceparm nolightmap
+  cull none
+  {{
+    map textures/set{0}/shader{1}.tga
+    rgbGen identity
+  }}
+  {{
+    map $lightmap
+    blendFunc GL_DST_COLOR GL_ZERO
+    rgbGen identity
+  }}
+}}
+)",
+      fileIndex,
+      i);
+  }
+  return str;
+}
+
+} // namespace
+
+TEST_CASE("ParseCacheBenchmark.loadShaders")
+{
+  const auto dir = std::filesystem::temp_directory_path() / "tb-parse-cache-benchmark";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir / "scripts");
+
+  for (auto i = 0; i < NumShaderFiles; ++i)
+  {
+    auto stream = std::ofstream{
+      dir / "scripts" / fmt::format("set{}.shader", i), std::ios::out | std::ios::binary};
+    stream << makeShaderFile(i);
+  }
+
+  const auto materialConfig = mdl::MaterialConfig{
+    {},
+    {".tga"},
+    {},
+    {},
+    "scripts",
+    {},
+  };
+
+  auto fs = DiskFileSystem{dir};
+  auto logger = NullLogger{};
+  const auto cache = ParseCache{dir / "cache"};
+
+  auto parsedShaders = std::vector<mdl::Quake3Shader>{};
+  timeLambda(
+    [&]() {
+      parsedShaders = loadShaders(fs, materialConfig, &cache, logger) | kdl::value();
+    },
+    fmt::format(
+      "load {} shaders from {} files with a cold cache",
+      NumShaderFiles * NumShadersPerFile,
+      NumShaderFiles));
+
+  auto cachedShaders = std::vector<mdl::Quake3Shader>{};
+  timeLambda(
+    [&]() {
+      cachedShaders = loadShaders(fs, materialConfig, &cache, logger) | kdl::value();
+    },
+    fmt::format(
+      "load {} shaders from {} files with a warm cache",
+      NumShaderFiles * NumShadersPerFile,
+      NumShaderFiles));
+
+  CHECK(parsedShaders.size() == size_t(NumShaderFiles * NumShadersPerFile));
+  CHECK(cachedShaders == parsedShaders);
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("ParseCacheBenchmark.loadClassInfos")
+{
+  const auto dir = std::filesystem::temp_directory_path() / "tb-parse-cache-benchmark";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+
+  const auto path = dir / "benchmark.fgd";
+  const auto fgd = makeFgd();
+  {
+    auto stream = std::ofstream{path, std::ios::out | std::ios::binary};
+    stream << fgd;
+  }
+
+  const auto cache = ParseCache{dir / "cache"};
+
+  auto parsedClassInfos = std::vector<EntityDefinitionClassInfo>{};
+  timeLambda(
+    [&]() {
+      auto parser = FgdParser{fgd, Color{1.0f, 1.0f, 1.0f, 1.0f}, path};
+      auto status = TestParserStatus{};
+      parsedClassInfos = parser.parseClassInfos(status);
+      cache.writeClassInfos({path}, parsedClassInfos);
+    },
+    "parse and write cache entry");
+
+  auto cachedClassInfos = std::optional<std::vector<EntityDefinitionClassInfo>>{};
+  timeLambda(
+    [&]() { cachedClassInfos = cache.readClassInfos(path); },
+    "read cache entry");
+
+  REQUIRE(cachedClassInfos != std::nullopt);
+  CHECK(cachedClassInfos->size() == parsedClassInfos.size());
+
+  std::filesystem::remove_all(dir);
+}
+
+} // namespace tb::io
@@ -0,0 +1,136 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
+#include "mdl/MapFormat.h"
+
+#include "kdl/range_utils.h"
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr auto GridSize = 32;
+constexpr auto BrushSize = 64.0;
+constexpr auto NumSides = size_t(16);
+
+const auto WorldBounds = vm::bbox3d{8192.0};
+
+/**
+ * Creates a grid of cuboids and cylinders.
+ */
+std::vector<Brush> makeBrushes()
+{
+  const auto builder = BrushBuilder{MapFormat::Standard, WorldBounds};
+
+  auto result = std::vector<Brush>{};
+  for (auto y = 0; y < GridSize; ++y)
+  {
+    for (auto x = 0; x < GridSize; ++x)
+    {
+      const auto min = vm::vec3d{double(x), double(y), 0.0} * BrushSize;
+      const auto bounds = vm::bbox3d{min, min + vm::vec3d::fill(BrushSize)};
+      result.push_back(
+        ((x + y) % 2 == 0
+           ? builder.createCuboid(bounds, "material")
+           : builder.createCylinder(
+               bounds, NumSides, RadiusMode::ToEdge, vm::axis::z, "material"))
+        | kdl::value());
+    }
+  }
+  return result;
+}
+
+BrushGeometry makeGeometry(const Brush& brush)
+{
+  const auto vertexPositions = brush.vertexPositions();
+  const auto faceVertexIndices = kdl::vec_transform(brush.faces(), [&](const auto& face) {
+    return kdl::vec_transform(face.vertexPositions(), [&](const auto& position) {
+      return *kdl::index_of(vertexPositions, position);
+    });
+  });
+  return BrushGeometry{vertexPositions, faceVertexIndices};
+}
+
+} // namespace
+
+TEST_CASE("BrushGeometryBenchmark.createWithKnownGeometry")
+{
+  const auto brushes = makeBrushes();
+  const auto transformation = vm::translation_matrix(vm::vec3d{16, 32, 8});
+
+  auto transformed = std::vector<Brush>{};
+  timeLambda(
+    [&]() {
+      transformed = kdl::vec_transform(brushes, [&](auto brush) {
+        return brush.transform(WorldBounds, transformation, false)
+               | kdl::transform([&]() { return std::move(brush); }) | kdl::value();
+      });
+    },
+    fmt::format("transform {} brushes along with their geometry", brushes.size()));
+
+  auto rebuilt = std::vector<Brush>{};
+  timeLambda(
+    [&]() {
+      rebuilt = kdl::vec_transform(transformed, [&](const auto& brush) {
+        return Brush::create(WorldBounds, brush.faces()) | kdl::value();
+      });
+    },
+    fmt::format("create {} brushes from their faces", transformed.size()));
+
+  const auto geometries = kdl::vec_transform(transformed, makeGeometry);
+
+  auto adopted = std::vector<Brush>{};
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < transformed.size(); ++i)
+      {
+        adopted.push_back(
+          Brush::create(WorldBounds, transformed[i].faces(), geometries[i])
+          | kdl::value());
+      }
+    },
+    fmt::format("create {} brushes from their faces and geometry", transformed.size()));
+
+  const auto getBounds = [](const auto& brush) { return brush.bounds(); };
+
+  // the face order of rebuilt brushes depends on rounding errors in the face normals
+  CHECK(
+    kdl::vec_transform(rebuilt, getBounds) == kdl::vec_transform(transformed, getBounds));
+  CHECK(adopted == transformed);
+}
+
+} // namespace tb::mdl
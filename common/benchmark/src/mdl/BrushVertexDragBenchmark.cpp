@@ -0,0 +1,194 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Error.h"
+#include "Result.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
+#include "mdl/MapFormat.h"
+
+#include "kdl/parallel.h"
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+#include "vm/polygon.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr auto GridSize = 24;
+constexpr auto NumSelectedBrushes = 1000;
+constexpr auto BrushSize = 64.0;
+constexpr auto NumSides = size_t(16);
+constexpr auto NumSteps = 16;
+
+const auto WorldBounds = vm::bbox3d{8192.0};
+
+/**
+ * Creates a grid of the given number of cuboids and cylinders that do not share any
+ * vertices.
+ */
+std::vector<Brush> makeBrushes(const int count)
+{
+  const auto builder = BrushBuilder{MapFormat::Standard, WorldBounds};
+
+  auto result = std::vector<Brush>{};
+  for (auto i = 0; i < count; ++i)
+  {
+    const auto x = i % GridSize;
+    const auto y = i / GridSize;
+    const auto min = vm::vec3d{double(x), double(y), 0.0} * 2.0 * BrushSize;
+    const auto bounds = vm::bbox3d{min, min + vm::vec3d::fill(BrushSize)};
+    result.push_back(
+      ((x + y) % 2 == 0
+         ? builder.createCuboid(bounds, "material")
+         : builder.createCylinder(
+             bounds, NumSides, RadiusMode::ToEdge, vm::axis::z, "material"))
+      | kdl::value());
+  }
+  return result;
+}
+
+/**
+ * Moves the given vertices of the given brushes in the same way as the vertex tool does
+ * for every mouse move during a drag. Returns the new positions of the moved vertices.
+ */
+std::vector<vm::vec3d> moveVertices(
+  std::vector<Brush>& brushes,
+  const std::vector<vm::vec3d>& vertexPositions,
+  const vm::vec3d& delta)
+{
+  auto newVertexPositions = std::vector<vm::vec3d>{};
+  for (auto& brush : brushes)
+  {
+    const auto verticesToMove = kdl::vec_filter(
+      vertexPositions, [&](const auto& vertex) { return brush.hasVertex(vertex); });
+    if (
+      !verticesToMove.empty() && brush.canMoveVertices(WorldBounds, verticesToMove, delta)
+      && brush.moveVertices(WorldBounds, verticesToMove, delta, false)
+           | kdl::is_success())
+    {
+      newVertexPositions = kdl::vec_concat(
+        std::move(newVertexPositions),
+        brush.findClosestVertexPositions(verticesToMove + delta));
+    }
+  }
+  return kdl::vec_sort_and_remove_duplicates(std::move(newVertexPositions));
+}
+
+/**
+ * Moves those of the given faces which belong to the given brush in the same way as the
+ * face tool does.
+ */
+Result<Brush> moveFaces(
+  Brush brush, const std::vector<vm::polygon3d>& facePositions, const vm::vec3d& delta)
+{
+  const auto facesToMove = kdl::vec_filter(
+    facePositions, [&](const auto& face) { return brush.hasFace(face); });
+  if (!brush.canMoveFaces(WorldBounds, facesToMove, delta))
+  {
+    return Error{"Cannot move faces"};
+  }
+
+  return brush.moveFaces(WorldBounds, facesToMove, delta, false)
+         | kdl::transform([&]() { return std::move(brush); });
+}
+
+} // namespace
+
+TEST_CASE("BrushVertexDragBenchmark.dragVertices")
+{
+  auto brushes = makeBrushes(GridSize * GridSize);
+
+  // the topmost vertex with the greatest x and y coordinates of every brush
+  const auto isLower = [](const auto& lhs, const auto& rhs) {
+    return vm::dot(lhs, vm::vec3d{1, 1, 4}) < vm::dot(rhs, vm::vec3d{1, 1, 4});
+  };
+  auto vertexPositions = kdl::vec_transform(brushes, [&](const auto& brush) {
+    const auto brushVertexPositions = brush.vertexPositions();
+    return *std::max_element(
+      brushVertexPositions.begin(), brushVertexPositions.end(), isLower);
+  });
+
+  const auto delta = vm::vec3d{1, 1, 2};
+  timeLambda(
+    [&]() {
+      for (auto i = 0; i < NumSteps; ++i)
+      {
+        vertexPositions = moveVertices(brushes, vertexPositions, delta);
+      }
+    },
+    fmt::format(
+      "drag {} vertices of {} brushes over {} steps",
+      vertexPositions.size(),
+      brushes.size(),
+      NumSteps));
+
+  CHECK(vertexPositions.size() == brushes.size());
+}
+
+TEST_CASE("BrushVertexDragBenchmark.moveFacesInParallel")
+{
+  const auto brushes = makeBrushes(NumSelectedBrushes);
+
+  // the top face of every brush
+  const auto facePositions = kdl::vec_transform(brushes, [](const auto& brush) {
+    const auto faceIndex = brush.findFace(vm::vec3d{0, 0, 1});
+    REQUIRE(faceIndex);
+    return brush.face(*faceIndex).polygon();
+  });
+
+  const auto delta = vm::vec3d{0, 0, 8};
+
+  auto serialResults = std::vector<Result<Brush>>{};
+  timeLambda(
+    [&]() {
+      serialResults = kdl::vec_transform(brushes, [&](const auto& brush) {
+        return moveFaces(brush, facePositions, delta);
+      });
+    },
+    fmt::format("move the top faces of {} brushes serially", brushes.size()));
+
+  auto parallelResults = std::vector<Result<Brush>>{};
+  timeLambda(
+    [&]() {
+      parallelResults = kdl::vec_parallel_transform(brushes, [&](auto&& brush) {
+        return moveFaces(std::move(brush), facePositions, delta);
+      });
+    },
+    fmt::format("move the top faces of {} brushes in parallel", brushes.size()));
+
+  CHECK(parallelResults == serialResults);
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,150 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/MapFormat.h"
+
+#include "kdl/parallel.h"
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+
+#include <fmt/format.h>
+
+#include <cstdio>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr auto Format = MapFormat::Standard;
+constexpr auto GridSize = 24;
+constexpr auto GridHeight = 4;
+constexpr auto BrushSize = 64.0;
+constexpr auto CarveSize = 40.0;
+constexpr auto CarveSpacing = 96.0;
+
+const auto WorldBounds = vm::bbox3d{8192.0};
+
+std::vector<Brush> makeMinuends()
+{
+  const auto builder = BrushBuilder{Format, WorldBounds};
+
+  auto result = std::vector<Brush>{};
+  for (auto z = 0; z < GridHeight; ++z)
+  {
+    for (auto y = 0; y < GridSize; ++y)
+    {
+      for (auto x = 0; x < GridSize; ++x)
+      {
+        const auto min = vm::vec3d{double(x), double(y), double(z)} * BrushSize;
+        const auto max = min + vm::vec3d::fill(BrushSize);
+        result.push_back(
+          builder.createCuboid(vm::bbox3d{min, max}, "minuend") | kdl::value());
+      }
+    }
+  }
+  return result;
+}
+
+/**
+ * Creates a regular pattern of small carving volumes that cut through the corners of the
+ * minuends.
+ */
+std::vector<Brush> makeSubtrahends()
+{
+  const auto builder = BrushBuilder{Format, WorldBounds};
+  const auto numSubtrahends = int(double(GridSize) * BrushSize / CarveSpacing);
+  const auto height = double(GridHeight) * BrushSize;
+
+  auto result = std::vector<Brush>{};
+  for (auto y = 0; y < numSubtrahends; ++y)
+  {
+    for (auto x = 0; x < numSubtrahends; ++x)
+    {
+      const auto center = vm::vec3d{double(x), double(y), 0.0} * CarveSpacing;
+      const auto min = center - vm::vec3d{CarveSize, CarveSize, 0.0} / 2.0;
+      const auto max = center + vm::vec3d{CarveSize / 2.0, CarveSize / 2.0, height};
+      result.push_back(
+        builder.createCuboid(vm::bbox3d{min, max}, "subtrahend") | kdl::value());
+    }
+  }
+  return result;
+}
+
+size_t countFragments(const std::vector<std::vector<Result<Brush>>>& results)
+{
+  auto count = size_t(0);
+  for (const auto& fragments : results)
+  {
+    count += fragments.size();
+  }
+  return count;
+}
+
+} // namespace
+
+TEST_CASE("CsgSubtractBenchmark.subtract")
+{
+  const auto minuends = makeMinuends();
+  const auto subtrahends = makeSubtrahends();
+  const auto subtrahendPtrs =
+    kdl::vec_transform(subtrahends, [](const auto& subtrahend) { return &subtrahend; });
+
+  const auto subtract = [&](const Brush& minuend) {
+    return minuend.subtract(Format, WorldBounds, "default", subtrahendPtrs);
+  };
+
+  auto serialResults = std::vector<std::vector<Result<Brush>>>{};
+  timeLambda(
+    [&]() { serialResults = kdl::vec_transform(minuends, subtract); },
+    fmt::format(
+      "subtract {} brushes from {} brushes serially",
+      subtrahends.size(),
+      minuends.size()));
+
+  auto minuendPtrs =
+    kdl::vec_transform(minuends, [](const auto& minuend) { return &minuend; });
+
+  auto parallelResults = std::vector<std::vector<Result<Brush>>>{};
+  timeLambda(
+    [&]() {
+      parallelResults = kdl::vec_parallel_transform(
+        minuendPtrs, [&](const auto* minuend) { return subtract(*minuend); });
+    },
+    fmt::format(
+      "subtract {} brushes from {} brushes in parallel",
+      subtrahends.size(),
+      minuends.size()));
+
+  printf(
+    "Subtraction produced %zu fragments from %zu minuends\n",
+    countFragments(parallelResults),
+    minuends.size());
+
+  CHECK(countFragments(parallelResults) == countFragments(serialResults));
+}
+
+} // namespace tb::mdl
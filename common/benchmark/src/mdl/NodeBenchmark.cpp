@@ -0,0 +1,85 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+
+#include "kdl/parallel.h"
+
+#include <fmt/format.h>
+
+#include <memory>
+#include <set>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr size_t NumNodes = 500000;
+
+} // namespace
+
+TEST_CASE("NodeBenchmark.createNodesInParallel")
+{
+  auto nodes = std::vector<std::unique_ptr<EntityNode>>(NumNodes);
+
+  // every node allocates its id when it is created and releases it when it is destroyed
+  timeLambda(
+    [&]() {
+      kdl::parallel_for(NumNodes, [&](const size_t i) {
+        nodes[i] = std::make_unique<EntityNode>(Entity{});
+      });
+    },
+    fmt::format("create {} nodes in parallel", NumNodes));
+
+  auto ids = std::set<IdType>{};
+  for (const auto& node : nodes)
+  {
+    ids.insert(node->nodeId());
+  }
+  CHECK(ids.size() == NumNodes);
+
+  timeLambda(
+    [&]() { kdl::parallel_for(NumNodes, [&](const size_t i) { nodes[i].reset(); }); },
+    fmt::format("destroy {} nodes in parallel", NumNodes));
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumNodes; ++i)
+      {
+        nodes[i] = std::make_unique<EntityNode>(Entity{});
+      }
+    },
+    fmt::format("create {} nodes serially", NumNodes));
+
+  timeLambda(
+    [&]() {
+      for (auto& node : nodes)
+      {
+        node.reset();
+      }
+    },
+    fmt::format("destroy {} nodes serially", NumNodes));
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,178 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushNode.h"
+#include "mdl/EditorContext.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/PickResult.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/result.h"
+
+#include "vm/bbox.h"
+#include "vm/ray.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr auto GridSize = 32;
+constexpr auto BrushSize = 48.0;
+constexpr auto BrushSpacing = 64.0;
+constexpr auto NumSides = 16;
+constexpr auto NumRays = 256;
+
+/**
+ * Adds a GridSize * GridSize * GridSize grid of cylinders to the given world.
+ */
+void makeBrushes(WorldNode& worldNode)
+{
+  const auto builder = BrushBuilder{worldNode.mapFormat(), vm::bbox3d{8192.0}};
+
+  for (auto z = 0; z < GridSize; ++z)
+  {
+    for (auto y = 0; y < GridSize; ++y)
+    {
+      for (auto x = 0; x < GridSize; ++x)
+      {
+        const auto min = vm::vec3d{double(x), double(y), double(z)} * BrushSpacing;
+        const auto max = min + vm::vec3d::fill(BrushSize);
+        worldNode.defaultLayer()->addChild(new BrushNode{
+          builder.createCylinder(
+            vm::bbox3d{min, max}, NumSides, RadiusMode::ToEdge, vm::axis::z, "material")
+          | kdl::value()});
+      }
+    }
+  }
+}
+
+/**
+ * Returns NumRays * NumRays rays which originate in front of the grid and fan out
+ * across it.
+ */
+std::vector<vm::ray3d> makeRays()
+{
+  const auto extent = double(GridSize) * BrushSpacing;
+  const auto origin = vm::vec3d{-extent / 2.0, -extent / 2.0, extent / 3.0};
+
+  auto result = std::vector<vm::ray3d>{};
+  result.reserve(NumRays * NumRays);
+  for (auto i = 0; i < NumRays; ++i)
+  {
+    for (auto j = 0; j < NumRays; ++j)
+    {
+      const auto target = vm::vec3d{
+        double(i) / double(NumRays) * extent,
+        extent,
+        double(j) / double(NumRays) * extent};
+      result.emplace_back(origin, vm::normalize(target - origin));
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("PickBenchmark.pick")
+{
+  auto worldNode = WorldNode{{}, {}, MapFormat::Standard};
+  makeBrushes(worldNode);
+
+  const auto editorContext = EditorContext{};
+  const auto rays = makeRays();
+
+  auto numHits = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& ray : rays)
+      {
+        auto pickResult = PickResult::byDistance();
+        worldNode.pick(editorContext, ray, pickResult);
+        numHits += pickResult.size();
+      }
+    },
+    fmt::format(
+      "pick {} rays in a world with {} brushes",
+      rays.size(),
+      GridSize * GridSize * GridSize));
+
+  CHECK(numHits > 0u);
+}
+
+TEST_CASE("PickBenchmark.pickBrush")
+{
+  const auto builder = BrushBuilder{MapFormat::Standard, vm::bbox3d{8192.0}};
+  auto brushNode = BrushNode{
+    builder.createCylinder(
+      vm::bbox3d{{0, 0, 0}, {2048, 2048, 2048}},
+      NumSides,
+      RadiusMode::ToEdge,
+      vm::axis::z,
+      "material")
+    | kdl::value()};
+
+  const auto editorContext = EditorContext{};
+  const auto rays = makeRays();
+  const auto& brush = brushNode.brush();
+
+  auto numFaceHits = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& ray : rays)
+      {
+        for (const auto& face : brush.faces())
+        {
+          if (face.intersectWithRay(ray))
+          {
+            ++numFaceHits;
+            break;
+          }
+        }
+      }
+    },
+    fmt::format(
+      "intersect {} rays with every face of a {} sided brush", rays.size(), NumSides));
+
+  auto numPickHits = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& ray : rays)
+      {
+        auto pickResult = PickResult{};
+        brushNode.pick(editorContext, ray, pickResult);
+        numPickHits += pickResult.size();
+      }
+    },
+    fmt::format("pick {} rays with a {} sided brush", rays.size(), NumSides));
+
+  CHECK(numPickHits == numFaceHits);
+}
+
+} // namespace tb::mdl
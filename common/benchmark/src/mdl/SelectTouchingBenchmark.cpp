@@ -0,0 +1,101 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/ModelUtils.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/result.h"
+
+#include "vm/bbox.h"
+
+#include <fmt/format.h>
+
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr auto GridSize = 40;
+constexpr auto GridHeight = 10;
+constexpr auto BrushSize = 48.0;
+constexpr auto BrushSpacing = 64.0;
+
+/**
+ * Adds a grid of GridSize * GridSize * GridHeight brushes to the given world and returns
+ * them.
+ */
+std::vector<BrushNode*> makeBrushes(WorldNode& worldNode)
+{
+  const auto builder = BrushBuilder{worldNode.mapFormat(), vm::bbox3d{8192.0}};
+
+  auto result = std::vector<BrushNode*>{};
+  for (auto z = 0; z < GridHeight; ++z)
+  {
+    for (auto y = 0; y < GridSize; ++y)
+    {
+      for (auto x = 0; x < GridSize; ++x)
+      {
+        const auto min = vm::vec3d{double(x), double(y), double(z)} * BrushSpacing;
+        const auto max = min + vm::vec3d::fill(BrushSize);
+        auto* brushNode = new BrushNode{
+          builder.createCuboid(vm::bbox3d{min, max}, "material") | kdl::value()};
+        worldNode.defaultLayer()->addChild(brushNode);
+        result.push_back(brushNode);
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("SelectTouchingBenchmark.collectTouchingNodes")
+{
+  auto worldNode = WorldNode{{}, {}, MapFormat::Standard};
+  const auto brushes = makeBrushes(worldNode);
+
+  for (const auto numSelected : {1u, 10u, 100u, 1000u})
+  {
+    // select brushes that are spread across the entire grid
+    auto selectedBrushes = std::vector<BrushNode*>{};
+    const auto stride = brushes.size() / numSelected;
+    for (size_t i = 0; i < numSelected; ++i)
+    {
+      selectedBrushes.push_back(brushes[i * stride]);
+    }
+
+    auto touchingNodes = std::vector<Node*>{};
+    timeLambda(
+      [&]() { touchingNodes = collectTouchingNodes({&worldNode}, selectedBrushes); },
+      fmt::format(
+        "collect nodes touching {} of {} brushes", numSelected, brushes.size()));
+
+    CHECK(touchingNodes.empty());
+  }
+}
+
+} // namespace tb::mdl
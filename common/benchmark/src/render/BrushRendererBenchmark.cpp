@@ -32,6 +32,7 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -149,4 +150,42 @@ TEST_CASE("BrushRendererBenchmark.benchBrushRenderer")
     "validate remaining brushes");
 }
 
+TEST_CASE("BrushRendererBenchmark.streamTextures")
+{
+  constexpr auto BatchSize = size_t(4);
+
+  auto [brushes, materials] = makeBrushes();
+
+  BrushRenderer r;
+  for (const auto& brush : brushes)
+  {
+    r.addBrush(brush.get());
+  }
+  r.validate();
+
+  // simulate textures arriving in small batches, as they do while they are loaded in the
+  // background, and revalidate the renderer after each batch
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < materials.size(); i += BatchSize)
+      {
+        auto batch = std::vector<const mdl::Material*>{};
+        for (size_t j = i; j < std::min(i + BatchSize, materials.size()); ++j)
+        {
+          batch.push_back(&materials[j]);
+        }
+
+        r.invalidateMaterials(batch);
+        r.validate();
+      }
+    },
+    fmt::format(
+      "invalidate and validate {} brushes for {} batches of {} materials",
+      brushes.size(),
+      materials.size() / BatchSize,
+      BatchSize));
+
+  CHECK(r.valid());
+}
+
 } // namespace tb::render
@@ -0,0 +1,173 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "render/EntityCellGrid.h"
+#include "render/PerspectiveCamera.h"
+#include "render/ViewCuller.h"
+
+#include <fmt/format.h>
+
+#include <memory>
+#include <vector>
+
+namespace tb::render
+{
+namespace
+{
+
+constexpr size_t NumEntitiesPerAxis = 32;
+constexpr auto EntityDistance = 256.0;
+
+struct CellData
+{
+  size_t entityCount = 0;
+};
+
+std::vector<std::unique_ptr<mdl::EntityNode>> makeEntities()
+{
+  auto result = std::vector<std::unique_ptr<mdl::EntityNode>>{};
+  for (size_t x = 0; x < NumEntitiesPerAxis; ++x)
+  {
+    for (size_t y = 0; y < NumEntitiesPerAxis; ++y)
+    {
+      for (size_t z = 0; z < NumEntitiesPerAxis; ++z)
+      {
+        auto entity = mdl::Entity{};
+        entity.setOrigin(vm::vec3d{double(x), double(y), double(z)} * EntityDistance);
+        result.push_back(std::make_unique<mdl::EntityNode>(std::move(entity)));
+      }
+    }
+  }
+  return result;
+}
+
+CellData buildCellData(const std::vector<const mdl::EntityNode*>& entityNodes)
+{
+  return CellData{entityNodes.size()};
+}
+
+} // namespace
+
+TEST_CASE("EntityRendererBenchmark.cullCells")
+{
+  const auto entities = makeEntities();
+
+  auto grid = EntityCellGrid<CellData>{};
+  for (const auto& entity : entities)
+  {
+    grid.addEntity(entity.get());
+  }
+
+  timeLambda(
+    [&]() { grid.validate(buildCellData); },
+    fmt::format(
+      "build {} cells for {} entities", grid.cellCount(), grid.entityCount()));
+
+  // look into the grid from one of its corners
+  const auto camera = PerspectiveCamera{
+    90.0f,
+    1.0f,
+    8192.0f,
+    Camera::Viewport{0, 0, 1920, 1080},
+    vm::vec3f{-512.0f, -512.0f, 1024.0f},
+    vm::normalize(vm::vec3f{1.0f, 1.0f, 0.0f}),
+    vm::vec3f{0.0f, 0.0f, 1.0f}};
+  const auto culler = ViewCuller{camera};
+
+  auto visibleCells = std::vector<CellData*>{};
+  timeLambda(
+    [&]() { visibleCells = grid.findVisibleCells(culler); }, "find visible cells");
+
+  auto visibleEntityCount = size_t(0);
+  for (const auto* cellData : visibleCells)
+  {
+    visibleEntityCount += cellData->entityCount;
+  }
+
+  // the number of submitted draws is the number of visible cells instead of the number of
+  // cells
+  fmt::print(
+    "submitted draws for {} of {} cells containing {} of {} entities\n",
+    visibleCells.size(),
+    grid.cellCount(),
+    visibleEntityCount,
+    grid.entityCount());
+
+  CHECK(!visibleCells.empty());
+  CHECK(visibleCells.size() < grid.cellCount());
+
+  auto visibleEntities = size_t(0);
+  timeLambda(
+    [&]() {
+      visibleEntities = 0;
+      for (const auto& entity : entities)
+      {
+        if (culler.visible(entity->logicalBounds()))
+        {
+          ++visibleEntities;
+        }
+      }
+    },
+    "cull individual entities");
+
+  CHECK(visibleEntities <= visibleEntityCount);
+}
+
+TEST_CASE("EntityRendererBenchmark.invalidateEntity")
+{
+  const auto entities = makeEntities();
+
+  auto grid = EntityCellGrid<CellData>{};
+  for (const auto& entity : entities)
+  {
+    grid.addEntity(entity.get());
+  }
+  grid.validate(buildCellData);
+
+  auto rebuiltCells = size_t(0);
+  const auto countRebuiltCells = [&](const auto& entityNodes) {
+    ++rebuiltCells;
+    return buildCellData(entityNodes);
+  };
+
+  timeLambda(
+    [&]() {
+      grid.invalidate();
+      grid.validate(countRebuiltCells);
+    },
+    "rebuild all cells");
+
+  CHECK(rebuiltCells == grid.cellCount());
+
+  rebuiltCells = 0;
+  timeLambda(
+    [&]() {
+      grid.invalidateEntity(entities.front().get());
+      grid.validate(countRebuiltCells);
+    },
+    "rebuild the cell of one entity");
+
+  CHECK(rebuiltCells == 1);
+}
+
+} // namespace tb::render
@@ -0,0 +1,111 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/BezierPatch.h"
+#include "mdl/EditorContext.h"
+#include "mdl/PatchNode.h"
+#include "render/PatchRenderer.h"
+
+#include <fmt/format.h>
+
+#include <memory>
+#include <vector>
+
+namespace tb::render
+{
+namespace
+{
+
+constexpr size_t NumPatches = 4'000;
+constexpr size_t PatchSize = 7;
+
+std::vector<std::unique_ptr<mdl::PatchNode>> makePatches()
+{
+  auto result = std::vector<std::unique_ptr<mdl::PatchNode>>{};
+  for (size_t i = 0; i < NumPatches; ++i)
+  {
+    const auto offset = vm::vec3d{double(i % 64) * 128.0, double(i / 64) * 128.0, 0.0};
+
+    auto controlPoints = std::vector<mdl::BezierPatch::Point>{};
+    for (size_t row = 0; row < PatchSize; ++row)
+    {
+      for (size_t col = 0; col < PatchSize; ++col)
+      {
+        const auto z = (row + col) % 2 == 0 ? 0.0 : 16.0;
+        controlPoints.emplace_back(
+          offset.x() + double(col) * 16.0, offset.y() + double(row) * 16.0, z, 0.0, 0.0);
+      }
+    }
+
+    result.push_back(std::make_unique<mdl::PatchNode>(mdl::BezierPatch{
+      PatchSize,
+      PatchSize,
+      std::move(controlPoints),
+      "material" + std::to_string(i % 16)}));
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("PatchRendererBenchmark.invalidatePatch")
+{
+  const auto patches = makePatches();
+  const auto editorContext = mdl::EditorContext{};
+
+  auto r = PatchRenderer{editorContext};
+  for (const auto& patch : patches)
+  {
+    r.addPatch(patch.get());
+  }
+
+  timeLambda(
+    [&]() { r.validate(); },
+    fmt::format("validate after adding {} patches to PatchRenderer", patches.size()));
+
+  timeLambda(
+    [&]() {
+      r.invalidatePatch(patches.front().get());
+      r.validate();
+    },
+    "invalidate and validate one patch");
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < patches.size(); i += 100)
+      {
+        r.invalidatePatch(patches[i].get());
+      }
+      r.validate();
+    },
+    fmt::format("invalidate and validate {} patches", patches.size() / 100));
+
+  timeLambda(
+    [&]() {
+      r.invalidate();
+      r.validate();
+    },
+    fmt::format("invalidate and validate all {} patches", patches.size()));
+
+  CHECK(r.valid());
+}
+
+} // namespace tb::render
@@ -0,0 +1,290 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "render/AttrString.h"
+#include "render/EntityCellGrid.h"
+#include "render/FontGlyph.h"
+#include "render/FontTexture.h"
+#include "render/PerspectiveCamera.h"
+#include "render/TextAnchor.h"
+#include "render/TextureFont.h"
+#include "render/ViewCuller.h"
+
+#include <fmt/format.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tb::render
+{
+namespace
+{
+
+constexpr size_t NumEntitiesPerAxis = 28;
+constexpr size_t NumClassnames = 64;
+constexpr auto EntityDistance = 256.0;
+
+constexpr unsigned char FirstChar = 32;
+constexpr unsigned char CharCount = 96;
+constexpr size_t GlyphSize = 16;
+
+std::unique_ptr<TextureFont> makeFont()
+{
+  auto texture = std::make_unique<FontTexture>(CharCount, GlyphSize, 2);
+
+  auto glyphs = std::vector<FontGlyph>{};
+  for (size_t i = 0; i < CharCount; ++i)
+  {
+    const auto x = (i % 16) * GlyphSize;
+    const auto y = (i / 16) * GlyphSize;
+    glyphs.emplace_back(x, y, GlyphSize, GlyphSize, GlyphSize - 4);
+  }
+
+  return std::make_unique<TextureFont>(
+    std::move(texture), glyphs, 12, 4, 16, FirstChar, CharCount);
+}
+
+std::vector<std::unique_ptr<mdl::EntityNode>> makeEntities()
+{
+  auto result = std::vector<std::unique_ptr<mdl::EntityNode>>{};
+  for (size_t x = 0; x < NumEntitiesPerAxis; ++x)
+  {
+    for (size_t y = 0; y < NumEntitiesPerAxis; ++y)
+    {
+      for (size_t z = 0; z < NumEntitiesPerAxis; ++z)
+      {
+        const auto i = result.size();
+        const auto classname = fmt::format("entity_{}", i % NumClassnames);
+        auto entity = mdl::Entity{{{"classname", classname}}};
+        entity.setOrigin(vm::vec3d{double(x), double(y), double(z)} * EntityDistance);
+        result.push_back(std::make_unique<mdl::EntityNode>(std::move(entity)));
+      }
+    }
+  }
+  return result;
+}
+
+AttrString makeLabel(const mdl::EntityNode& entityNode)
+{
+  auto str = AttrString{};
+  str.appendCentered(entityNode.entity().classname());
+  return str;
+}
+
+PerspectiveCamera makeCamera()
+{
+  return PerspectiveCamera{
+    90.0f,
+    1.0f,
+    8192.0f,
+    Camera::Viewport{0, 0, 1920, 1080},
+    vm::vec3f{-512.0f, -512.0f, 1024.0f},
+    vm::normalize(vm::vec3f{1.0f, 1.0f, 0.0f}),
+    vm::vec3f{0.0f, 0.0f, 1.0f}};
+}
+
+SimpleTextAnchor makeAnchor(const mdl::EntityNode& entityNode)
+{
+  return SimpleTextAnchor{
+    vm::vec3f{entityNode.logicalBounds().center()},
+    TextAlignment::Bottom,
+    vm::vec2f{0.0f, 16.0f}};
+}
+
+// mimics the visibility test of TextRenderer, which hides labels that are further away
+// than the maximum view distance
+bool isInViewDistance(const Camera& camera, const TextAnchor& anchor)
+{
+  const auto maxViewDistance = 768.0f;
+  const auto distance = camera.perpendicularDistanceTo(anchor.position(camera));
+  return distance > 0.0f && distance <= maxViewDistance;
+}
+
+} // namespace
+
+TEST_CASE("TextRendererBenchmark.layoutLabels")
+{
+  const auto font = makeFont();
+  const auto entities = makeEntities();
+
+  auto vertexCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& entity : entities)
+      {
+        const auto label = makeLabel(*entity);
+        vertexCount += font->quads(label, true).size();
+        font->measure(label);
+      }
+    },
+    fmt::format("lay out {} labels", entities.size()));
+
+  auto cachedVertexCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& entity : entities)
+      {
+        cachedVertexCount += font->layout(makeLabel(*entity))->quads.size();
+      }
+    },
+    fmt::format("look up {} cached label layouts", entities.size()));
+
+  CHECK(cachedVertexCount == vertexCount);
+}
+
+TEST_CASE("TextRendererBenchmark.cullLabels")
+{
+  const auto font = makeFont();
+  const auto entities = makeEntities();
+
+  auto grid = EntityCellGrid<size_t>{};
+  for (const auto& entity : entities)
+  {
+    grid.addEntity(entity.get());
+  }
+  grid.validate([](const auto& entityNodes) { return entityNodes.size(); });
+
+  const auto camera = makeCamera();
+  const auto& viewport = camera.viewport();
+  auto visibleLabels = size_t(0);
+  const auto addLabel = [&](const mdl::EntityNode* entityNode) {
+    const auto anchor = makeAnchor(*entityNode);
+    if (isInViewDistance(camera, anchor))
+    {
+      const auto layout = font->layout(makeLabel(*entityNode));
+      const auto offset = vm::vec2f{anchor.offset(camera, layout->size)};
+      if (viewport.contains(offset.x(), offset.y(), layout->size.x(), layout->size.y()))
+      {
+        ++visibleLabels;
+      }
+    }
+  };
+
+  timeLambda(
+    [&]() {
+      for (const auto& entity : entities)
+      {
+        addLabel(entity.get());
+      }
+    },
+    fmt::format("test visibility of {} labels", entities.size()));
+
+  const auto allVisibleLabels = visibleLabels;
+  visibleLabels = 0;
+
+  auto testedLabels = size_t(0);
+  timeLambda(
+    [&]() {
+      const auto culler = ViewCuller{camera, 0.0f};
+      grid.forEachVisibleEntity(culler, 128.0, [&](const auto* entityNode) {
+        ++testedLabels;
+        addLabel(entityNode);
+      });
+    },
+    "test visibility of labels in visible cells");
+
+  fmt::print(
+    "tested {} of {} labels in visible cells, {} labels visible\n",
+    testedLabels,
+    entities.size(),
+    visibleLabels);
+
+  CHECK(testedLabels < entities.size());
+  CHECK(visibleLabels == allVisibleLabels);
+}
+
+TEST_CASE("TextRendererBenchmark.layoutDistinctLabels")
+{
+  const auto font = makeFont();
+  const auto entities = makeEntities();
+  const auto camera = makeCamera();
+
+  // every label is distinct, so there are more labels than the font caches layouts for
+  auto labels = std::vector<AttrString>{};
+  for (size_t i = 0; i < entities.size(); ++i)
+  {
+    auto str = AttrString{};
+    str.appendCentered(fmt::format("{} {}", entities[i]->entity().classname(), i));
+    labels.push_back(std::move(str));
+  }
+
+  using Layouts = std::vector<std::shared_ptr<const TextLayout>>;
+  const auto renderFrame = [&](const bool cullBeforeLayout) {
+    auto layouts = Layouts{};
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+      const auto anchor = makeAnchor(*entities[i]);
+      if (!cullBeforeLayout)
+      {
+        auto layout = font->layout(labels[i]);
+        if (isInViewDistance(camera, anchor))
+        {
+          layouts.push_back(std::move(layout));
+        }
+      }
+      else if (isInViewDistance(camera, anchor))
+      {
+        layouts.push_back(font->layout(labels[i]));
+      }
+    }
+    return layouts;
+  };
+
+  const auto renderFrames = [&](const bool cullBeforeLayout) {
+    auto firstFrame = Layouts{};
+    auto lastFrame = Layouts{};
+    timeLambda(
+      [&]() {
+        firstFrame = renderFrame(cullBeforeLayout);
+        for (size_t i = 0; i < 9; ++i)
+        {
+          lastFrame = renderFrame(cullBeforeLayout);
+        }
+      },
+      fmt::format(
+        "render 10 frames of {} distinct labels, {}",
+        labels.size(),
+        cullBeforeLayout ? "culled before layout" : "laid out before culling"));
+    return std::pair{firstFrame, lastFrame};
+  };
+
+  const auto [uncachedFirstFrame, uncachedLastFrame] = renderFrames(false);
+  const auto [cachedFirstFrame, cachedLastFrame] = renderFrames(true);
+
+  fmt::print("{} of {} labels in view distance\n", cachedLastFrame.size(), labels.size());
+
+  CHECK(labels.size() > 4096);
+  CHECK(!cachedLastFrame.empty());
+  CHECK(cachedLastFrame.size() < 4096);
+  CHECK(uncachedLastFrame.size() == cachedLastFrame.size());
+
+  // when every label is laid out, the visible labels are evicted before the next frame
+  CHECK(uncachedLastFrame != uncachedFirstFrame);
+
+  // when the labels are culled first, the visible labels stay cached between frames
+  CHECK(cachedLastFrame == cachedFirstFrame);
+}
+
+} // namespace tb::render
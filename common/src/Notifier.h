@@ -24,9 +24,13 @@
 #include "kdl/set_temp.h"
 #include "kdl/tuple_utils.h"
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <set>
+#include <utility>
 #include <vector>
 
 namespace tb
@@ -63,36 +67,46 @@ private:
   {
     Callback callback;
     size_t id;
+    bool batched;
     bool pendingRemove = false;
 
-    Observer(Callback i_callback, const size_t i_id)
+    Observer(Callback i_callback, const size_t i_id, const bool i_batched = true)
       : callback{std::move(i_callback)}
       , id{i_id}
+      , batched{i_batched}
     {
     }
   };
 
+  enum class Delivery
+  {
+    All,
+    Batched,
+    Unbatched,
+  };
+
   class NotifierState : public NotifierStateBase
   {
   private:
     size_t m_nextId = 0;
     std::vector<Observer> m_observers;
     std::vector<Observer> m_toAdd;
+    Callback m_batchCallback;
     bool m_notifying = false;
 
   public:
     ~NotifierState() override = default;
 
-    size_t connect(Callback callback)
+    size_t connect(Callback callback, const bool batched = true)
     {
       const auto id = m_nextId++;
       if (m_notifying)
       {
-        m_toAdd.emplace_back(std::move(callback), id);
+        m_toAdd.emplace_back(std::move(callback), id, batched);
       }
       else
       {
-        m_observers.emplace_back(std::move(callback), id);
+        m_observers.emplace_back(std::move(callback), id, batched);
       }
       return id;
     }
@@ -112,15 +126,39 @@ private:
       return id;
     }
 
+    void setBatchCallback(Callback batchCallback)
+    {
+      m_batchCallback = std::move(batchCallback);
+    }
+
     template <typename... NA>
     void notify(NA&&... a)
+    {
+      if (m_batchCallback)
+      {
+        // batches are only used with notifiers that pass their arguments by const
+        // reference, so forwarding them twice cannot move from them
+        notifyObservers(Delivery::Unbatched, std::forward<NA>(a)...);
+        m_batchCallback(std::forward<NA>(a)...);
+      }
+      else
+      {
+        notifyObservers(Delivery::All, std::forward<NA>(a)...);
+      }
+    }
+
+    template <typename... NA>
+    void notifyObservers(const Delivery delivery, NA&&... a)
     {
       processPendingObservers();
 
       const auto notifying = kdl::set_temp{m_notifying};
       for (const auto& observer : m_observers)
       {
-        if (!observer.pendingRemove)
+        if (
+          !observer.pendingRemove
+          && (delivery == Delivery::All
+              || observer.batched == (delivery == Delivery::Batched)))
         {
           observer.callback(std::forward<NA>(a)...);
         }
@@ -188,6 +226,9 @@ private:
 public:
   friend class NotifierConnection;
 
+  template <typename T>
+  friend class NotifierBatch;
+
   Notifier() = default;
 
   Notifier(const Notifier&) = delete;
@@ -228,6 +269,28 @@ public:
       });
   }
 
+  /**
+   * Adds the given observer callback to this notifier. Unlike other observers, the
+   * callback is notified immediately while a NotifierBatch for this notifier is open.
+   * Observers that keep derived state in sync with the notifying object should connect
+   * this way.
+   */
+  [[nodiscard]] NotifierConnection connectUnbatched(Callback callback)
+  {
+    const auto id = m_state->connect(std::move(callback), false);
+    return NotifierConnection{m_state, id};
+  }
+
+  template <typename R, typename MemberCallback>
+  [[nodiscard]] NotifierConnection connectUnbatched(
+    R* receiver_, MemberCallback callback_)
+  {
+    return connectUnbatched(
+      [receiver = receiver_, callback = std::move(callback_)](auto&&... args) {
+        std::invoke(callback, receiver, std::forward<decltype(args)>(args)...);
+      });
+  }
+
   /**
    * Adds the given observer callback to this notifier.
    *
@@ -363,4 +426,143 @@ template <typename... AA, typename... NA>
 NotifyBeforeAndAfter(Notifier<AA...>&, Notifier<AA...>&, NA&&...)
   -> NotifyBeforeAndAfter<AA...>;
 
+/**
+ * Counts the notifications that were coalesced by a NotifierBatch.
+ */
+struct NotifierBatchStats
+{
+  /**
+   * The number of notifications that were collected while the batch was open.
+   */
+  size_t collectedNotifications = 0;
+
+  /**
+   * The number of notifications that were delivered to the observers.
+   */
+  size_t deliveredNotifications = 0;
+
+  /**
+   * The number of elements that were delivered to the observers.
+   */
+  size_t deliveredElements = 0;
+};
+
+/**
+ * Coalesces the notifications of a notifier whose observers receive a vector of elements.
+ *
+ * While the batch is open, notifications are not delivered to the observers. Instead, the
+ * batch collects their elements, and when it is flushed, the observers are notified once
+ * with all collected elements. Duplicate elements are removed, and the remaining elements
+ * are passed in the order in which they were first collected. Observers that were
+ * connected with Notifier::connectUnbatched are notified immediately.
+ *
+ * If the notifier is paired with a notifier that announces the upcoming changes, then
+ * that notifier does not announce elements that are already pending. This way, observers
+ * see the same elements in the paired notifications, and they never see two
+ * announcements for an element without a delivered notification in between.
+ *
+ * A batch can be opened multiple times. It is only flushed automatically when it has been
+ * closed as many times as it was opened.
+ *
+ * @tparam T the type of the elements passed to the observers
+ */
+template <typename T>
+class NotifierBatch
+{
+private:
+  Notifier<const std::vector<T>&>& m_notifier;
+  Notifier<const std::vector<T>&>* m_willNotifier = nullptr;
+  size_t m_openCount = 0;
+  std::vector<T> m_pending;
+  std::set<T> m_pendingElements;
+  NotifierBatchStats m_stats;
+
+  using Delivery = typename Notifier<const std::vector<T>&>::Delivery;
+
+public:
+  explicit NotifierBatch(Notifier<const std::vector<T>&>& notifier)
+    : m_notifier{notifier}
+  {
+  }
+
+  NotifierBatch(
+    Notifier<const std::vector<T>&>& notifier,
+    Notifier<const std::vector<T>&>& willNotifier)
+    : m_notifier{notifier}
+    , m_willNotifier{&willNotifier}
+  {
+  }
+
+  bool isOpen() const { return m_openCount > 0; }
+
+  const NotifierBatchStats& stats() const { return m_stats; }
+
+  void open()
+  {
+    if (m_openCount++ == 0)
+    {
+      m_notifier.m_state->setBatchCallback([&](const std::vector<T>& elements) {
+        for (const auto& element : elements)
+        {
+          if (m_pendingElements.insert(element).second)
+          {
+            m_pending.push_back(element);
+          }
+        }
+        ++m_stats.collectedNotifications;
+      });
+
+      if (m_willNotifier)
+      {
+        m_willNotifier->m_state->setBatchCallback([&](const std::vector<T>& elements) {
+          auto newElements = std::vector<T>{};
+          std::copy_if(
+            elements.begin(),
+            elements.end(),
+            std::back_inserter(newElements),
+            [&](const auto& element) { return !m_pendingElements.contains(element); });
+
+          if (!newElements.empty())
+          {
+            m_willNotifier->m_state->notifyObservers(Delivery::Batched, newElements);
+          }
+        });
+      }
+    }
+  }
+
+  void close()
+  {
+    assert(m_openCount > 0);
+    if (--m_openCount == 0)
+    {
+      m_notifier.m_state->setBatchCallback(nullptr);
+      if (m_willNotifier)
+      {
+        m_willNotifier->m_state->setBatchCallback(nullptr);
+      }
+      flush();
+    }
+  }
+
+  /**
+   * Delivers the collected elements to the observers. Notifications sent by the observers
+   * are collected again if the batch is still open.
+   */
+  void flush()
+  {
+    if (m_pending.empty())
+    {
+      return;
+    }
+
+    auto elements = std::exchange(m_pending, {});
+    m_pendingElements.clear();
+
+    ++m_stats.deliveredNotifications;
+    m_stats.deliveredElements += elements.size();
+    m_notifier.m_state->notifyObservers(Delivery::Batched, elements);
+  }
+};
+
 } // namespace tb
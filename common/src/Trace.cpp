@@ -0,0 +1,291 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Trace.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <tuple>
+
+namespace tb
+{
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto ChunkSize = size_t(4096);
+constexpr auto MaxChunkCount = size_t(256);
+
+const auto TraceEpoch = Clock::now();
+
+struct TraceChunk
+{
+  std::array<TraceEvent, ChunkSize> events;
+};
+
+/**
+ * Events are only appended by the thread that owns the buffer. Other threads may read the
+ * events concurrently; they see every event that was appended before the size was
+ * published.
+ */
+class TraceBuffer
+{
+private:
+  std::array<std::atomic<TraceChunk*>, MaxChunkCount> m_chunks{};
+  std::atomic<size_t> m_size = 0;
+  std::atomic<size_t> m_droppedCount = 0;
+
+public:
+  TraceBuffer() = default;
+
+  ~TraceBuffer()
+  {
+    for (auto& chunk : m_chunks)
+    {
+      delete chunk.load();
+    }
+  }
+
+  TraceBuffer(const TraceBuffer&) = delete;
+  TraceBuffer& operator=(const TraceBuffer&) = delete;
+
+  void append(const TraceEvent& event)
+  {
+    const auto size = m_size.load(std::memory_order_relaxed);
+    const auto chunkIndex = size / ChunkSize;
+    if (chunkIndex >= MaxChunkCount)
+    {
+      m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    auto* chunk = m_chunks[chunkIndex].load(std::memory_order_relaxed);
+    if (!chunk)
+    {
+      chunk = new TraceChunk{};
+      m_chunks[chunkIndex].store(chunk, std::memory_order_release);
+    }
+
+    chunk->events[size % ChunkSize] = event;
+    m_size.store(size + 1, std::memory_order_release);
+  }
+
+  void collect(std::vector<TraceEvent>& result) const
+  {
+    const auto size = m_size.load(std::memory_order_acquire);
+    for (size_t i = 0; i < size; ++i)
+    {
+      const auto* chunk = m_chunks[i / ChunkSize].load(std::memory_order_acquire);
+      result.push_back(chunk->events[i % ChunkSize]);
+    }
+  }
+
+  size_t droppedCount() const { return m_droppedCount.load(std::memory_order_relaxed); }
+
+  void clear()
+  {
+    // keep the chunks so that they can be reused
+    m_size.store(0, std::memory_order_release);
+    m_droppedCount.store(0, std::memory_order_relaxed);
+  }
+};
+
+/**
+ * Owns the buffers of all threads. The lock is only taken when a thread records its first
+ * event or ends, and when the recorded events are read or cleared.
+ */
+class TraceRegistry
+{
+private:
+  std::mutex m_mutex;
+  std::vector<std::unique_ptr<TraceBuffer>> m_buffers;
+  std::vector<TraceBuffer*> m_freeBuffers;
+  uint64_t m_nextThreadId = 1;
+
+public:
+  std::tuple<TraceBuffer*, uint64_t> acquireBuffer()
+  {
+    const auto lock = std::lock_guard{m_mutex};
+
+    if (m_freeBuffers.empty())
+    {
+      m_freeBuffers.push_back(
+        m_buffers.emplace_back(std::make_unique<TraceBuffer>()).get());
+    }
+
+    auto* buffer = m_freeBuffers.back();
+    m_freeBuffers.pop_back();
+
+    return {buffer, m_nextThreadId++};
+  }
+
+  void releaseBuffer(TraceBuffer* buffer)
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    m_freeBuffers.push_back(buffer);
+  }
+
+  template <typename F>
+  void visitBuffers(const F& f)
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    for (auto& buffer : m_buffers)
+    {
+      f(*buffer);
+    }
+  }
+};
+
+TraceRegistry& traceRegistry()
+{
+  static auto instance = TraceRegistry{};
+  return instance;
+}
+
+struct ThreadTraceState
+{
+  TraceBuffer* buffer = nullptr;
+  uint64_t threadId = 0;
+  size_t depth = 0;
+
+  ThreadTraceState() { std::tie(buffer, threadId) = traceRegistry().acquireBuffer(); }
+
+  ~ThreadTraceState() { traceRegistry().releaseBuffer(buffer); }
+
+  ThreadTraceState(const ThreadTraceState&) = delete;
+  ThreadTraceState& operator=(const ThreadTraceState&) = delete;
+};
+
+ThreadTraceState& threadTraceState()
+{
+  thread_local auto state = ThreadTraceState{};
+  return state;
+}
+
+int64_t nanosecondsSinceEpoch(const Clock::time_point time)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time - TraceEpoch).count();
+}
+
+void writeEscaped(std::ostream& str, const std::string_view s)
+{
+  for (const auto c : s)
+  {
+    switch (c)
+    {
+    case '"':
+      str << "\\\"";
+      break;
+    case '\\':
+      str << "\\\\";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+      {
+        str << fmt::format("\\u{:04x}", static_cast<unsigned int>(c));
+      }
+      else
+      {
+        str << c;
+      }
+      break;
+    }
+  }
+}
+
+} // namespace
+
+TraceZone::TraceZone(const char* name)
+  : m_name{name}
+{
+  ++threadTraceState().depth;
+  m_start = Clock::now();
+}
+
+TraceZone::~TraceZone()
+{
+  const auto end = Clock::now();
+
+  auto& state = threadTraceState();
+  --state.depth;
+
+  state.buffer->append(TraceEvent{
+    m_name,
+    state.threadId,
+    state.depth,
+    nanosecondsSinceEpoch(m_start),
+    std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_start).count(),
+  });
+}
+
+std::vector<TraceEvent> collectTraceEvents()
+{
+  auto result = std::vector<TraceEvent>{};
+  traceRegistry().visitBuffers([&](const auto& buffer) { buffer.collect(result); });
+
+  std::stable_sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.start < rhs.start;
+  });
+  return result;
+}
+
+size_t droppedTraceEventCount()
+{
+  auto result = size_t(0);
+  traceRegistry().visitBuffers(
+    [&](const auto& buffer) { result += buffer.droppedCount(); });
+  return result;
+}
+
+void clearTraceEvents()
+{
+  traceRegistry().visitBuffers([](auto& buffer) { buffer.clear(); });
+}
+
+void writeChromeTrace(std::ostream& str)
+{
+  str << R"({"displayTimeUnit":"ms","traceEvents":[)";
+
+  auto first = true;
+  for (const auto& event : collectTraceEvents())
+  {
+    str << (first ? "\n" : ",\n");
+    first = false;
+
+    str << R"({"name":")";
+    writeEscaped(str, event.name);
+    str << fmt::format(
+      R"(","cat":"trenchbroom","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+      event.threadId,
+      static_cast<double>(event.start) / 1000.0,
+      static_cast<double>(event.duration) / 1000.0);
+  }
+
+  str << "\n]}\n";
+}
+
+} // namespace tb
@@ -0,0 +1,123 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace tb
+{
+
+/**
+ * A zone that was recorded by a TraceZone.
+ */
+struct TraceEvent
+{
+  /**
+   * The name of the zone. This must point to a string with static storage duration.
+   */
+  const char* name = nullptr;
+
+  /**
+   * A small number identifying the thread that recorded the zone.
+   */
+  uint64_t threadId = 0;
+
+  /**
+   * The number of zones that enclosed this zone on its thread when it was recorded.
+   */
+  size_t depth = 0;
+
+  /**
+   * The start of the zone in nanoseconds since the trace epoch, and its duration in
+   * nanoseconds.
+   */
+  int64_t start = 0;
+  int64_t duration = 0;
+};
+
+/**
+ * Records the time between its construction and its destruction as a trace event.
+ *
+ * Every thread records its events into its own buffer without taking a lock. When a
+ * thread ends, its buffer is handed over to the next thread that records an event, so the
+ * number of buffers is bounded by the number of threads that are alive at the same time.
+ * Each buffer holds a bounded number of events; further events are dropped.
+ *
+ * Use the traceZone macro rather than this class directly, so that instrumentation
+ * compiles out unless TB_ENABLE_TRACING is defined.
+ */
+class TraceZone
+{
+private:
+  const char* m_name;
+  std::chrono::steady_clock::time_point m_start;
+
+public:
+  explicit TraceZone(const char* name);
+  ~TraceZone();
+
+  TraceZone(const TraceZone&) = delete;
+  TraceZone(TraceZone&&) = delete;
+
+  TraceZone& operator=(const TraceZone&) = delete;
+  TraceZone& operator=(TraceZone&&) = delete;
+};
+
+/**
+ * Returns all recorded events ordered by their start time.
+ */
+std::vector<TraceEvent> collectTraceEvents();
+
+/**
+ * Returns the number of events that were dropped because a buffer was full.
+ */
+size_t droppedTraceEventCount();
+
+/**
+ * Discards all recorded events. Must not be called while any thread records events.
+ */
+void clearTraceEvents();
+
+/**
+ * Writes all recorded events in the Chrome trace event format, which can be loaded in
+ * chrome://tracing or Perfetto.
+ */
+void writeChromeTrace(std::ostream& str);
+
+} // namespace tb
+
+#define TB_TRACE_CONCAT_(a, b) a##b
+#define TB_TRACE_CONCAT(a, b) TB_TRACE_CONCAT_(a, b)
+
+// Records a zone named by the given string literal that lasts until the end of the
+// enclosing scope. Compiles to nothing unless TB_ENABLE_TRACING is defined.
+#ifdef TB_ENABLE_TRACING
+#define traceZone(name)                                                                  \
+  const auto TB_TRACE_CONCAT(traceZone_, __LINE__) = tb::TraceZone{name}
+#else
+#define traceZone(name)                                                                  \
+  do                                                                                     \
+  {                                                                                      \
+  } while (0)
+#endif
@@ -186,7 +186,7 @@ DefParser::TokenNameMap DefParser::tokenNames() const
   };
 }
 
-std::vector<EntityDefinitionClassInfo> DefParser::parseClassInfos(ParserStatus& status)
+std::vector<EntityDefinitionClassInfo> DefParser::doParseClassInfos(ParserStatus& status)
 {
   auto result = std::vector<EntityDefinitionClassInfo>{};
 
@@ -80,7 +80,7 @@ public:
 
 private:
   TokenNameMap tokenNames() const override;
-  std::vector<EntityDefinitionClassInfo> parseClassInfos(ParserStatus& status) override;
+  std::vector<EntityDefinitionClassInfo> doParseClassInfos(ParserStatus& status) override;
 
   std::optional<EntityDefinitionClassInfo> parseClassInfo(ParserStatus& status);
   std::unique_ptr<mdl::PropertyDefinition> parseSpawnflags(ParserStatus& status);
@@ -714,7 +714,7 @@ EntParser::EntParser(std::string_view str, const Color& defaultEntityColor)
 {
 }
 
-std::vector<EntityDefinitionClassInfo> EntParser::parseClassInfos(ParserStatus& status)
+std::vector<EntityDefinitionClassInfo> EntParser::doParseClassInfos(ParserStatus& status)
 {
   auto doc = tinyxml2::XMLDocument{};
   doc.Parse(m_str.data(), m_str.length());
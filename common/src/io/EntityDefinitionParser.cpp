@@ -420,26 +420,6 @@ std::unique_ptr<mdl::EntityDefinition> createDefinition(
   };
 }
 
-std::vector<std::unique_ptr<mdl::EntityDefinition>> createDefinitions(
-  ParserStatus& status,
-  const std::vector<EntityDefinitionClassInfo>& classInfos,
-  const Color& defaultEntityColor)
-{
-  const auto resolvedClasses =
-    resolveInheritance(status, filterRedundantClasses(status, classInfos));
-
-  auto result = std::vector<std::unique_ptr<mdl::EntityDefinition>>{};
-  for (auto classInfo : resolvedClasses)
-  {
-    if (auto definition = createDefinition(std::move(classInfo), defaultEntityColor))
-    {
-      result.push_back(std::move(definition));
-    }
-  }
-
-  return result;
-}
-
 } // namespace
 
 /**
@@ -468,6 +448,26 @@ std::vector<EntityDefinitionClassInfo> resolveInheritance(
          | kdl::to_vector;
 }
 
+std::vector<std::unique_ptr<mdl::EntityDefinition>> createDefinitions(
+  ParserStatus& status,
+  const std::vector<EntityDefinitionClassInfo>& classInfos,
+  const Color& defaultEntityColor)
+{
+  const auto resolvedClasses =
+    resolveInheritance(status, filterRedundantClasses(status, classInfos));
+
+  auto result = std::vector<std::unique_ptr<mdl::EntityDefinition>>{};
+  for (auto classInfo : resolvedClasses)
+  {
+    if (auto definition = createDefinition(std::move(classInfo), defaultEntityColor))
+    {
+      result.push_back(std::move(definition));
+    }
+  }
+
+  return result;
+}
+
 EntityDefinitionParser::EntityDefinitionParser(const Color& defaultEntityColor)
   : m_defaultEntityColor{defaultEntityColor}
 {
@@ -475,6 +475,11 @@ EntityDefinitionParser::EntityDefinitionParser(const Color& defaultEntityColor)
 
 EntityDefinitionParser::~EntityDefinitionParser() {}
 
+const Color& EntityDefinitionParser::defaultEntityColor() const
+{
+  return m_defaultEntityColor;
+}
+
 std::vector<std::unique_ptr<mdl::EntityDefinition>> EntityDefinitionParser::
   parseDefinitions(ParserStatus& status)
 {
@@ -482,4 +487,10 @@ std::vector<std::unique_ptr<mdl::EntityDefinition>> EntityDefinitionParser::
   return createDefinitions(status, classInfos, m_defaultEntityColor);
 }
 
+std::vector<EntityDefinitionClassInfo> EntityDefinitionParser::parseClassInfos(
+  ParserStatus& status)
+{
+  return doParseClassInfos(status);
+}
+
 } // namespace tb::io
@@ -39,6 +39,15 @@ class ParserStatus;
 std::vector<EntityDefinitionClassInfo> resolveInheritance(
   ParserStatus& status, const std::vector<EntityDefinitionClassInfo>& classInfos);
 
+/**
+ * Resolves the inheritance of the given class infos and creates an entity definition for
+ * each class that is not a base class.
+ */
+std::vector<std::unique_ptr<mdl::EntityDefinition>> createDefinitions(
+  ParserStatus& status,
+  const std::vector<EntityDefinitionClassInfo>& classInfos,
+  const Color& defaultEntityColor);
+
 class EntityDefinitionParser
 {
 private:
@@ -51,8 +60,16 @@ public:
   std::vector<std::unique_ptr<mdl::EntityDefinition>> parseDefinitions(
     ParserStatus& status);
 
+  /**
+   * Parses the class infos without resolving their inheritance.
+   */
+  std::vector<EntityDefinitionClassInfo> parseClassInfos(ParserStatus& status);
+
+protected:
+  const Color& defaultEntityColor() const;
+
 private:
-  virtual std::vector<EntityDefinitionClassInfo> parseClassInfos(
+  virtual std::vector<EntityDefinitionClassInfo> doParseClassInfos(
     ParserStatus& status) = 0;
 };
 
@@ -19,6 +19,8 @@
 
 #include "FgdParser.h"
 
+#include "FileLocation.h"
+#include "Logger.h"
 #include "el/ELExceptions.h"
 #include "el/Expression.h"
 #include "io/DiskFileSystem.h"
@@ -28,7 +30,8 @@
 #include "io/ParserStatus.h"
 #include "mdl/PropertyDefinition.h"
 
-#include "kdl/invoke.h"
+#include "kdl/overload.h"
+#include "kdl/parallel.h"
 #include "kdl/result.h"
 #include "kdl/string_compare.h"
 #include "kdl/string_format.h"
@@ -38,12 +41,82 @@
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <exception>
 #include <memory>
 #include <string>
+#include <variant>
 #include <vector>
 
 namespace tb::io
 {
+namespace
+{
+
+struct IncludeDirective
+{
+  std::filesystem::path path;
+  FileLocation location;
+};
+
+struct LogMessage
+{
+  LogLevel level;
+  std::string message;
+};
+
+using FgdItem = std::variant<EntityDefinitionClassInfo, IncludeDirective, LogMessage>;
+
+/**
+ * Records the messages logged while parsing a file in between the parsed items so that
+ * they can be replayed in the original order when the items are merged.
+ */
+class BufferingParserStatus : public ParserStatus
+{
+private:
+  std::vector<FgdItem>& m_items;
+  ParserStatus* m_progressStatus;
+
+public:
+  BufferingParserStatus(std::vector<FgdItem>& items, ParserStatus* progressStatus)
+    : ParserStatus{nullLogger(), ""}
+    , m_items{items}
+    , m_progressStatus{progressStatus}
+  {
+  }
+
+private:
+  static Logger& nullLogger()
+  {
+    static auto logger = NullLogger{};
+    return logger;
+  }
+
+  void doProgress(const double progress) override
+  {
+    if (m_progressStatus)
+    {
+      m_progressStatus->progress(progress);
+    }
+  }
+
+  void doLog(const LogLevel level, const std::string& str) override
+  {
+    m_items.push_back(LogMessage{level, str});
+  }
+};
+
+} // namespace
+
+/**
+ * The result of parsing a single file. Included files are not parsed inline, instead the
+ * include directives are recorded so that the included files can be parsed concurrently.
+ */
+struct FgdParser::ParsedFile
+{
+  std::vector<FgdItem> items;
+  std::exception_ptr exception = nullptr;
+  std::optional<std::string> openError = std::nullopt;
+};
 
 FgdTokenizer::FgdTokenizer(const std::string_view str)
   : Tokenizer{str, "", 0}
@@ -159,11 +232,23 @@ FgdParser::FgdParser(
 {
   if (!path.empty() && path.is_absolute())
   {
-    m_fs = std::make_unique<DiskFileSystem>(path.parent_path());
+    m_fs = std::make_shared<DiskFileSystem>(path.parent_path());
     pushIncludePath(path.filename());
   }
 }
 
+FgdParser::FgdParser(
+  const std::string_view str,
+  const Color& defaultEntityColor,
+  std::shared_ptr<FileSystem> fs,
+  std::filesystem::path path)
+  : EntityDefinitionParser{defaultEntityColor}
+  , m_fs{std::move(fs)}
+  , m_tokenizer{FgdTokenizer{str}}
+{
+  pushIncludePath(std::move(path));
+}
+
 FgdParser::FgdParser(std::string_view str, const Color& defaultEntityColor)
   : FgdParser{std::move(str), defaultEntityColor, {}}
 {
@@ -171,6 +256,11 @@ FgdParser::FgdParser(std::string_view str, const Color& defaultEntityColor)
 
 FgdParser::~FgdParser() = default;
 
+const std::vector<std::filesystem::path>& FgdParser::includedPaths() const
+{
+  return m_includedPaths;
+}
+
 FgdParser::TokenNameMap FgdParser::tokenNames() const
 {
   using namespace FgdToken;
@@ -227,25 +317,185 @@ std::filesystem::path FgdParser::currentRoot() const
 
 bool FgdParser::isRecursiveInclude(const std::filesystem::path& path) const
 {
+  const auto normalizedPath = path.lexically_normal();
   return std::any_of(m_paths.begin(), m_paths.end(), [&](const auto& includedPath) {
-    return includedPath == path;
+    return includedPath.lexically_normal() == normalizedPath;
   });
 }
 
-std::vector<EntityDefinitionClassInfo> FgdParser::parseClassInfos(ParserStatus& status)
+std::vector<EntityDefinitionClassInfo> FgdParser::doParseClassInfos(ParserStatus& status)
 {
+  const auto files = parseFiles(status);
+  const auto path = !m_paths.empty() ? m_paths.back() : std::filesystem::path{};
+
   auto classInfos = std::vector<EntityDefinitionClassInfo>{};
-  auto token = m_tokenizer.peekToken();
-  while (!token.hasType(FgdToken::Eof))
+  mergeFile(status, files.at(path.lexically_normal()), files, classInfos);
+  return classInfos;
+}
+
+FgdParser::ParsedFiles FgdParser::parseFiles(ParserStatus& status)
+{
+  const auto path = !m_paths.empty() ? m_paths.back() : std::filesystem::path{};
+
+  auto files = ParsedFiles{};
+  auto [iHostFile, inserted] =
+    files.emplace(path.lexically_normal(), parseFile(&status));
+  assert(inserted);
+
+  // parse the included files one level of the include tree at a time
+  auto paths = findUnparsedIncludes(iHostFile->first, iHostFile->second, files);
+  while (!paths.empty())
   {
-    parseClassInfoOrInclude(status, classInfos);
-    token = m_tokenizer.peekToken();
+    auto parsedFiles = kdl::vec_parallel_transform(
+      paths, [&](const auto& includedPath) { return parseIncludedFile(includedPath); });
+
+    auto nextPaths = std::vector<std::filesystem::path>{};
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+      const auto iFile = files.emplace(paths[i], std::move(parsedFiles[i])).first;
+      for (auto& includedPath :
+           findUnparsedIncludes(iFile->first, iFile->second, files))
+      {
+        if (!kdl::vec_contains(nextPaths, includedPath))
+        {
+          nextPaths.push_back(std::move(includedPath));
+        }
+      }
+    }
+
+    paths = std::move(nextPaths);
   }
-  return classInfos;
+
+  return files;
+}
+
+FgdParser::ParsedFile FgdParser::parseFile(ParserStatus* progressStatus)
+{
+  auto file = ParsedFile{};
+  auto status = BufferingParserStatus{file.items, progressStatus};
+
+  try
+  {
+    auto token = m_tokenizer.peekToken();
+    while (!token.hasType(FgdToken::Eof))
+    {
+      parseClassInfoOrInclude(status, file);
+      token = m_tokenizer.peekToken();
+    }
+  }
+  catch (...)
+  {
+    // rethrown when the file is merged so that the items parsed so far are kept
+    file.exception = std::current_exception();
+  }
+
+  return file;
+}
+
+FgdParser::ParsedFile FgdParser::parseIncludedFile(
+  const std::filesystem::path& path) const
+{
+  return m_fs->openFile(path) | kdl::transform([&](auto file) {
+           auto reader = file->reader().buffer();
+           auto parser = FgdParser{reader.stringView(), defaultEntityColor(), m_fs, path};
+           return parser.parseFile(nullptr);
+         })
+         | kdl::transform_error([](auto e) {
+             auto file = ParsedFile{};
+             file.openError = std::move(e.msg);
+             return file;
+           })
+         | kdl::value();
+}
+
+std::vector<std::filesystem::path> FgdParser::findUnparsedIncludes(
+  const std::filesystem::path& path,
+  const ParsedFile& file,
+  const ParsedFiles& files) const
+{
+  auto result = std::vector<std::filesystem::path>{};
+  for (const auto& item : file.items)
+  {
+    if (const auto* include = std::get_if<IncludeDirective>(&item))
+    {
+      auto includedPath = (path.parent_path() / include->path).lexically_normal();
+      if (!files.contains(includedPath) && !kdl::vec_contains(result, includedPath))
+      {
+        result.push_back(std::move(includedPath));
+      }
+    }
+  }
+  return result;
+}
+
+void FgdParser::mergeFile(
+  ParserStatus& status,
+  const ParsedFile& file,
+  const ParsedFiles& files,
+  std::vector<EntityDefinitionClassInfo>& classInfos)
+{
+  for (const auto& item : file.items)
+  {
+    std::visit(
+      kdl::overload(
+        [&](const EntityDefinitionClassInfo& classInfo) {
+          classInfos.push_back(classInfo);
+        },
+        [&](const IncludeDirective& include) {
+          mergeIncludedFile(status, include.path, include.location, files, classInfos);
+        },
+        [&](const LogMessage& message) {
+          status.forward(message.level, message.message);
+        }),
+      item);
+  }
+
+  if (file.exception)
+  {
+    std::rethrow_exception(file.exception);
+  }
+}
+
+void FgdParser::mergeIncludedFile(
+  ParserStatus& status,
+  const std::filesystem::path& path,
+  const FileLocation& location,
+  const ParsedFiles& files,
+  std::vector<EntityDefinitionClassInfo>& classInfos)
+{
+  status.debug(location, fmt::format("Parsing included file '{}'", path.string()));
+
+  const auto filePath = currentRoot() / path;
+  const auto& file = files.at(filePath.lexically_normal());
+  if (file.openError)
+  {
+    status.error(
+      location, fmt::format("Failed to parse included file: {}", *file.openError));
+    return;
+  }
+
+  status.debug(
+    location, fmt::format("Resolved '{}' to '{}'", path.string(), filePath.string()));
+
+  if (isRecursiveInclude(filePath))
+  {
+    status.error(
+      location,
+      fmt::format(
+        "Skipping recursively included file: {} ({})", path.string(), filePath.string()));
+    return;
+  }
+
+  if (const auto absPath = m_fs->makeAbsolute(filePath); absPath.is_success())
+  {
+    m_includedPaths.push_back(absPath.value());
+  }
+
+  const auto pushIncludePath = PushIncludePath{*this, filePath};
+  mergeFile(status, file, files, classInfos);
 }
 
-void FgdParser::parseClassInfoOrInclude(
-  ParserStatus& status, std::vector<EntityDefinitionClassInfo>& classInfos)
+void FgdParser::parseClassInfoOrInclude(ParserStatus& status, ParsedFile& file)
 {
   const auto token =
     expect(status, FgdToken::Eof | FgdToken::Word, m_tokenizer.peekToken());
@@ -256,14 +506,13 @@ void FgdParser::parseClassInfoOrInclude(
 
   if (kdl::ci::str_is_equal(token.data(), "@include"))
   {
-    auto includedClassInfos = parseInclude(status);
-    classInfos = kdl::vec_concat(classInfos, std::move(includedClassInfos));
+    parseInclude(status, file);
   }
   else
   {
     if (auto classInfo = parseClassInfo(status))
     {
-      classInfos.push_back(std::move(*classInfo));
+      file.items.push_back(std::move(*classInfo));
     }
     status.progress(m_tokenizer.progress());
   }
@@ -1039,63 +1288,21 @@ std::string FgdParser::parseString(ParserStatus& status)
   }
 }
 
-std::vector<EntityDefinitionClassInfo> FgdParser::parseInclude(ParserStatus& status)
+void FgdParser::parseInclude(ParserStatus& status, ParsedFile& file)
 {
   auto token = expect(status, FgdToken::Word, m_tokenizer.nextToken());
   assert(kdl::ci::str_is_equal(token.data(), "@include"));
 
   expect(status, FgdToken::String, token = m_tokenizer.nextToken());
-  return handleInclude(status, token.data());
-}
-
-std::vector<EntityDefinitionClassInfo> FgdParser::handleInclude(
-  ParserStatus& status, const std::filesystem::path& path)
-{
   if (!m_fs)
   {
     status.error(
       m_tokenizer.location(),
       kdl::str_to_string("Cannot include file without host file path"));
-    return {};
+    return;
   }
 
-  const auto restoreSnapshot =
-    kdl::invoke_later{[&, snapshot = m_tokenizer.snapshotStateAndSource()]() {
-      m_tokenizer.restoreStateAndSource(snapshot);
-    }};
-
-  status.debug(
-    m_tokenizer.location(), fmt::format("Parsing included file '{}'", path.string()));
-
-  const auto filePath = currentRoot() / path;
-  return m_fs->openFile(filePath) | kdl::transform([&](auto file) {
-           status.debug(
-             m_tokenizer.location(),
-             fmt::format("Resolved '{}' to '{}'", path.string(), filePath.string()));
-
-           if (isRecursiveInclude(filePath))
-           {
-             status.error(
-               m_tokenizer.location(),
-               fmt::format(
-                 "Skipping recursively included file: {} ({})",
-                 path.string(),
-                 filePath.string()));
-             return std::vector<EntityDefinitionClassInfo>{};
-           }
-
-           const auto pushIncludePath = PushIncludePath{*this, filePath};
-           auto reader = file->reader().buffer();
-           m_tokenizer.replaceState(reader.stringView());
-           return parseClassInfos(status);
-         })
-         | kdl::transform_error([&](auto e) {
-             status.error(
-               m_tokenizer.location(),
-               fmt::format("Failed to parse included file: {}", e.msg));
-             return std::vector<EntityDefinitionClassInfo>{};
-           })
-         | kdl::value();
+  file.items.push_back(IncludeDirective{token.data(), m_tokenizer.location()});
 }
 
 } // namespace tb::io
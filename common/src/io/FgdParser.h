@@ -27,6 +27,7 @@
 #include "vm/bbox.h"
 
 #include <filesystem>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -84,8 +85,12 @@ class FgdParser : public EntityDefinitionParser, public Parser<FgdToken::Type>
 private:
   using Token = FgdTokenizer::Token;
 
+  struct ParsedFile;
+  using ParsedFiles = std::map<std::filesystem::path, ParsedFile>;
+
   std::vector<std::filesystem::path> m_paths;
-  std::unique_ptr<FileSystem> m_fs;
+  std::vector<std::filesystem::path> m_includedPaths;
+  std::shared_ptr<FileSystem> m_fs;
 
   FgdTokenizer m_tokenizer;
 
@@ -98,6 +103,19 @@ public:
 
   ~FgdParser() override;
 
+private:
+  FgdParser(
+    std::string_view str,
+    const Color& defaultEntityColor,
+    std::shared_ptr<FileSystem> fs,
+    std::filesystem::path path);
+
+public:
+  /**
+   * Returns the absolute paths of all files that were included while parsing.
+   */
+  const std::vector<std::filesystem::path>& includedPaths() const;
+
 private:
   class PushIncludePath;
   void pushIncludePath(std::filesystem::path path);
@@ -109,10 +127,29 @@ private:
 private:
   TokenNameMap tokenNames() const override;
 
-  std::vector<EntityDefinitionClassInfo> parseClassInfos(ParserStatus& status) override;
+  std::vector<EntityDefinitionClassInfo> doParseClassInfos(ParserStatus& status) override;
+
+  ParsedFiles parseFiles(ParserStatus& status);
+  ParsedFile parseFile(ParserStatus* progressStatus);
+  ParsedFile parseIncludedFile(const std::filesystem::path& path) const;
+  std::vector<std::filesystem::path> findUnparsedIncludes(
+    const std::filesystem::path& path,
+    const ParsedFile& file,
+    const ParsedFiles& files) const;
+
+  void mergeFile(
+    ParserStatus& status,
+    const ParsedFile& file,
+    const ParsedFiles& files,
+    std::vector<EntityDefinitionClassInfo>& classInfos);
+  void mergeIncludedFile(
+    ParserStatus& status,
+    const std::filesystem::path& path,
+    const FileLocation& location,
+    const ParsedFiles& files,
+    std::vector<EntityDefinitionClassInfo>& classInfos);
 
-  void parseClassInfoOrInclude(
-    ParserStatus& status, std::vector<EntityDefinitionClassInfo>& classInfos);
+  void parseClassInfoOrInclude(ParserStatus& status, ParsedFile& file);
 
   std::optional<EntityDefinitionClassInfo> parseClassInfo(ParserStatus& status);
   EntityDefinitionClassInfo parseSolidClassInfo(ParserStatus& status);
@@ -164,9 +201,7 @@ private:
   Color parseColor(ParserStatus& status);
   std::string parseString(ParserStatus& status);
 
-  std::vector<EntityDefinitionClassInfo> parseInclude(ParserStatus& status);
-  std::vector<EntityDefinitionClassInfo> handleInclude(
-    ParserStatus& status, const std::filesystem::path& path);
+  void parseInclude(ParserStatus& status, ParsedFile& file);
 };
 
 } // namespace tb::io
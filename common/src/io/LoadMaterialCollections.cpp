@@ -23,6 +23,7 @@
 #include "io/FileSystem.h"
 #include "io/LoadShaders.h"
 #include "io/MaterialUtils.h"
+#include "io/ParseCache.h"
 #include "io/PathInfo.h"
 #include "io/PathMatcher.h"
 #include "io/ReadDdsTexture.h"
@@ -38,6 +39,7 @@
 #include "mdl/Quake3Shader.h"
 #include "mdl/Texture.h"
 #include "mdl/TextureResource.h"
+#include "mdl/Thumbnail.h"
 
 #include "kdl/functional.h"
 #include "kdl/grouped_range.h"
@@ -184,31 +186,111 @@ Result<std::filesystem::path> findShaderTexture(
          | kdl::transform_error([&](auto) { return DefaultTexturePath; });
 }
 
+/**
+ * If set, materials are created with a thumbnail, and loading their full texture is
+ * deferred until the texture is requested.
+ */
+struct ThumbnailConfig
+{
+  const ParseCache* parseCache = nullptr;
+};
+
+std::optional<FileFingerprint> fingerprintFile(
+  const FileSystem& fs, const std::filesystem::path& path)
+{
+  return fs.openFile(path) | kdl::transform([&](auto file) {
+           auto reader = file->reader().buffer();
+           return std::optional{makeFileFingerprint(path, reader.stringView())};
+         })
+         | kdl::value_or(std::nullopt);
+}
+
+mdl::ResourceLoader<mdl::Texture> makeThumbnailResourceLoader(
+  const std::filesystem::path& texturePath,
+  const FileSystem& fs,
+  const ParseCache* parseCache,
+  mdl::ResourceLoader<mdl::Texture> textureLoader)
+{
+  return [&, texturePath, parseCache, textureLoader = std::move(textureLoader)]()
+           -> Result<mdl::Texture> {
+    const auto fingerprint =
+      parseCache ? fingerprintFile(fs, texturePath) : std::nullopt;
+
+    if (fingerprint)
+    {
+      if (auto thumbnail = parseCache->readThumbnail(*fingerprint))
+      {
+        return std::move(*thumbnail);
+      }
+    }
+
+    return textureLoader()
+           | kdl::and_then(
+             [](auto texture) { return mdl::createThumbnail(std::move(texture)); })
+           | kdl::transform([&](auto thumbnail) {
+               if (fingerprint)
+               {
+                 parseCache->writeThumbnail(*fingerprint, thumbnail);
+               }
+               return thumbnail;
+             });
+  };
+}
+
+mdl::Material createMaterial(
+  std::string name,
+  const std::filesystem::path& texturePath,
+  mdl::ResourceLoader<mdl::Texture> textureLoader,
+  const FileSystem& fs,
+  const mdl::CreateTextureResource& createResource,
+  const std::optional<ThumbnailConfig>& thumbnailConfig)
+{
+  if (!thumbnailConfig)
+  {
+    return mdl::Material{std::move(name), createResource(std::move(textureLoader))};
+  }
+
+  auto thumbnailLoader = makeThumbnailResourceLoader(
+    texturePath, fs, thumbnailConfig->parseCache, textureLoader);
+
+  auto textureResource = createResource(std::move(textureLoader));
+  textureResource->deferLoading();
+
+  auto material = mdl::Material{std::move(name), std::move(textureResource)};
+  material.setThumbnailResource(createResource(std::move(thumbnailLoader)));
+  return material;
+}
+
 Result<mdl::Material> loadShaderMaterial(
   const mdl::Quake3Shader& shader,
   const FileSystem& fs,
   const mdl::MaterialConfig& materialConfig,
-  const mdl::CreateTextureResource& createResource)
+  const mdl::CreateTextureResource& createResource,
+  const std::optional<ThumbnailConfig>& thumbnailConfig)
 {
-  return findShaderTexture(shader, fs, materialConfig) | kdl::transform([&](auto path_) {
-           return [&, path = std::move(path_)]() {
-             return fs.openFile(path) | kdl::and_then([&](auto file) {
-                      auto reader = file->reader().buffer();
-                      return readFreeImageTexture(reader).transform([](auto texture) {
-                        texture.setMask(mdl::TextureMask::Off);
-                        return texture;
+  return findShaderTexture(shader, fs, materialConfig)
+         | kdl::transform([&](auto texturePath) {
+             auto textureLoader = [&, path = texturePath]() {
+               return fs.openFile(path) | kdl::and_then([&](auto file) {
+                        auto reader = file->reader().buffer();
+                        return readFreeImageTexture(reader).transform([](auto texture) {
+                          texture.setMask(mdl::TextureMask::Off);
+                          return texture;
+                        });
                       });
-                    });
-           };
-         })
-         | kdl::transform([&](auto textureLoader) {
+             };
+
              const auto prefixLength = kdl::path_length(materialConfig.root);
              auto shaderName =
                getMaterialNameFromPathSuffix(shader.shaderPath, prefixLength);
 
-             auto textureResource = createResource(std::move(textureLoader));
-             auto material =
-               mdl::Material{std::move(shaderName), std::move(textureResource)};
+             auto material = createMaterial(
+               std::move(shaderName),
+               texturePath,
+               std::move(textureLoader),
+               fs,
+               createResource,
+               thumbnailConfig);
              material.setSurfaceParms(shader.surfaceParms);
 
              // Note that Quake 3 has a different understanding of front and back, so we
@@ -324,7 +406,8 @@ Result<mdl::Material> loadTextureMaterial(
   const FileSystem& fs,
   const mdl::MaterialConfig& materialConfig,
   const mdl::CreateTextureResource& createResource,
-  const std::optional<Result<mdl::Palette>>& paletteResult)
+  const std::optional<Result<mdl::Palette>>& paletteResult,
+  const std::optional<ThumbnailConfig>& thumbnailConfig)
 {
   const auto prefixLength = kdl::path_length(materialConfig.root);
   const auto pathMatcher = !materialConfig.extensions.empty()
@@ -333,8 +416,13 @@ Result<mdl::Material> loadTextureMaterial(
 
   auto name = getMaterialNameFromPathSuffix(texturePath, prefixLength);
   auto textureLoader = makeTextureResourceLoader(texturePath, name, fs, paletteResult);
-  auto textureResource = createResource(std::move(textureLoader));
-  return mdl::Material{std::move(name), std::move(textureResource)};
+  return createMaterial(
+    std::move(name),
+    texturePath,
+    std::move(textureLoader),
+    fs,
+    createResource,
+    thumbnailConfig);
 }
 
 std::vector<mdl::MaterialCollection> groupMaterialsIntoCollections(
@@ -374,16 +462,14 @@ std::vector<mdl::MaterialCollection> groupMaterialsIntoCollections(
   });
 }
 
-} // namespace
-
-
 Result<mdl::Material> loadMaterial(
   const FileSystem& fs,
   const mdl::MaterialConfig& materialConfig,
   const std::filesystem::path& materialPath,
   const mdl::CreateTextureResource& createResource,
   const std::vector<mdl::Quake3Shader>& shaders,
-  const std::optional<Result<mdl::Palette>>& paletteResult)
+  const std::optional<Result<mdl::Palette>>& paletteResult,
+  const std::optional<ThumbnailConfig>& thumbnailConfig)
 {
   const auto materialPathStem = kdl::path_remove_extension(materialPath);
   const auto iShader =
@@ -392,9 +478,15 @@ Result<mdl::Material> loadMaterial(
     });
 
   return (iShader != shaders.end()
-            ? loadShaderMaterial(*iShader, fs, materialConfig, createResource)
+            ? loadShaderMaterial(
+                *iShader, fs, materialConfig, createResource, thumbnailConfig)
             : loadTextureMaterial(
-                materialPath, fs, materialConfig, createResource, paletteResult))
+                materialPath,
+                fs,
+                materialConfig,
+                createResource,
+                paletteResult,
+                thumbnailConfig))
          | kdl::transform([&](auto material) {
              fs.makeAbsolute(materialPath)
                | kdl::transform([&](auto absPath) { material.setAbsolutePath(absPath); })
@@ -404,19 +496,53 @@ Result<mdl::Material> loadMaterial(
            });
 }
 
+} // namespace
+
+
+Result<mdl::Material> loadMaterial(
+  const FileSystem& fs,
+  const mdl::MaterialConfig& materialConfig,
+  const std::filesystem::path& materialPath,
+  const mdl::CreateTextureResource& createResource,
+  const std::vector<mdl::Quake3Shader>& shaders,
+  const std::optional<Result<mdl::Palette>>& paletteResult)
+{
+  return loadMaterial(
+    fs,
+    materialConfig,
+    materialPath,
+    createResource,
+    shaders,
+    paletteResult,
+    std::nullopt);
+}
+
 Result<std::vector<mdl::MaterialCollection>> loadMaterialCollections(
   const FileSystem& fs,
   const mdl::MaterialConfig& materialConfig,
   const mdl::CreateTextureResource& createResource,
   Logger& logger)
+{
+  return loadMaterialCollections(fs, materialConfig, createResource, nullptr, logger);
+}
+
+Result<std::vector<mdl::MaterialCollection>> loadMaterialCollections(
+  const FileSystem& fs,
+  const mdl::MaterialConfig& materialConfig,
+  const mdl::CreateTextureResource& createResource,
+  const ParseCache* parseCache,
+  Logger& logger)
 {
   const auto paletteResult = loadPalette(fs, materialConfig);
 
-  return loadShaders(fs, materialConfig, logger) | kdl::transform([&](auto shaders) {
-           return kdl::vec_filter(std::move(shaders), [&](const auto& shader) {
-             return kdl::path_has_prefix(shader.shaderPath, materialConfig.root);
-           });
-         })
+  const auto thumbnailConfig = ThumbnailConfig{parseCache};
+
+  return loadShaders(fs, materialConfig, parseCache, logger)
+         | kdl::transform([&](auto shaders) {
+             return kdl::vec_filter(std::move(shaders), [&](const auto& shader) {
+               return kdl::path_has_prefix(shader.shaderPath, materialConfig.root);
+             });
+           })
          | kdl::and_then([&](auto shaders) {
              return findAllMaterialPaths(fs, materialConfig, shaders)
                     | kdl::and_then([&](const auto& materialPaths) {
@@ -429,7 +555,8 @@ Result<std::vector<mdl::MaterialCollection>> loadMaterialCollections(
                                      materialPath,
                                      createResource,
                                      shaders,
-                                     paletteResult);
+                                     paletteResult,
+                                     thumbnailConfig);
                                  })
                                | kdl::fold;
                       });
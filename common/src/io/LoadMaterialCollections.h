@@ -43,6 +43,7 @@ struct MaterialConfig;
 namespace tb::io
 {
 class FileSystem;
+class ParseCache;
 
 Result<mdl::Material> loadMaterial(
   const FileSystem& fs,
@@ -58,4 +59,11 @@ Result<std::vector<mdl::MaterialCollection>> loadMaterialCollections(
   const mdl::CreateTextureResource& createResource,
   Logger& logger);
 
+Result<std::vector<mdl::MaterialCollection>> loadMaterialCollections(
+  const FileSystem& fs,
+  const mdl::MaterialConfig& materialConfig,
+  const mdl::CreateTextureResource& createResource,
+  const ParseCache* parseCache,
+  Logger& logger);
+
 } // namespace tb::io
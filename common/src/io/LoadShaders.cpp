@@ -22,6 +22,7 @@
 #include "Error.h" // IWYU pragma: keep
 #include "Logger.h"
 #include "io/FileSystem.h"
+#include "io/ParseCache.h"
 #include "io/PathInfo.h"
 #include "io/Quake3ShaderParser.h"
 #include "io/SimpleParserStatus.h"
@@ -36,6 +37,7 @@
 
 #include <fmt/format.h>
 
+#include <optional>
 #include <vector>
 
 namespace tb::io
@@ -45,15 +47,36 @@ namespace
 {
 
 Result<std::vector<mdl::Quake3Shader>> loadShader(
-  const FileSystem& fs, const std::filesystem::path& path, Logger& logger)
+  const FileSystem& fs,
+  const std::filesystem::path& path,
+  const ParseCache* parseCache,
+  Logger& logger)
 {
   return fs.openFile(path) | kdl::transform([&](auto file) {
            auto bufferedReader = file->reader().buffer();
+           const auto contents = bufferedReader.stringView();
+
+           const auto fingerprint =
+             parseCache ? std::optional{makeFileFingerprint(path, contents)}
+                        : std::nullopt;
+           if (fingerprint)
+           {
+             if (auto shaders = parseCache->readShaders(*fingerprint))
+             {
+               return std::move(*shaders);
+             }
+           }
+
            try
            {
-             auto parser = Quake3ShaderParser{bufferedReader.stringView()};
+             auto parser = Quake3ShaderParser{contents};
              auto status = SimpleParserStatus{logger, path.string()};
-             return parser.parse(status);
+             auto shaders = parser.parse(status);
+             if (fingerprint)
+             {
+               parseCache->writeShaders(*fingerprint, shaders);
+             }
+             return shaders;
            }
            catch (const ParserException& e)
            {
@@ -68,6 +91,15 @@ Result<std::vector<mdl::Quake3Shader>> loadShader(
 
 Result<std::vector<mdl::Quake3Shader>> loadShaders(
   const FileSystem& fs, const mdl::MaterialConfig& materialConfig, Logger& logger)
+{
+  return loadShaders(fs, materialConfig, nullptr, logger);
+}
+
+Result<std::vector<mdl::Quake3Shader>> loadShaders(
+  const FileSystem& fs,
+  const mdl::MaterialConfig& materialConfig,
+  const ParseCache* parseCache,
+  Logger& logger)
 {
   if (fs.pathInfo(materialConfig.shaderSearchPath) != PathInfo::Directory)
   {
@@ -81,7 +113,9 @@ Result<std::vector<mdl::Quake3Shader>> loadShaders(
          | kdl::and_then([&](auto paths) {
              return kdl::vec_parallel_transform(
                       paths,
-                      [&](const auto& path) { return loadShader(fs, path, logger); })
+                      [&](const auto& path) {
+                        return loadShader(fs, path, parseCache, logger);
+                      })
                     | kdl::fold;
            })
          | kdl::transform(
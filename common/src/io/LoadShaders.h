@@ -37,8 +37,19 @@ class Quake3Shader;
 namespace tb::io
 {
 class FileSystem;
+class ParseCache;
 
 Result<std::vector<mdl::Quake3Shader>> loadShaders(
   const FileSystem& fs, const mdl::MaterialConfig& materialConfig, Logger& logger);
 
+/**
+ * Loads the shaders, using the given cache (if any) to skip parsing shader files that
+ * have not changed since they were last parsed.
+ */
+Result<std::vector<mdl::Quake3Shader>> loadShaders(
+  const FileSystem& fs,
+  const mdl::MaterialConfig& materialConfig,
+  const ParseCache* parseCache,
+  Logger& logger);
+
 } // namespace tb::io
@@ -0,0 +1,487 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapCacheSerializer.h"
+
+#include "Color.h"
+#include "io/Reader.h"
+#include "io/ReaderException.h"
+#include "mdl/BezierPatch.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Node.h"
+#include "mdl/PatchNode.h"
+
+#include <fmt/format.h>
+
+#include <cassert>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+namespace tb::io
+{
+namespace
+{
+
+enum class RecordType : uint8_t
+{
+  End,
+  Entity,
+  EntityEnd,
+  Brush,
+  BrushFace,
+  Patch,
+};
+
+template <typename T>
+void write(std::ostream& stream, const T value)
+{
+  static_assert(std::is_arithmetic_v<T>);
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeRecordType(std::ostream& stream, const RecordType recordType)
+{
+  write(stream, static_cast<uint8_t>(recordType));
+}
+
+void writeString(std::ostream& stream, const std::string_view str)
+{
+  write(stream, uint64_t(str.size()));
+  stream.write(str.data(), std::streamsize(str.size()));
+}
+
+template <typename T, size_t S>
+void writeVec(std::ostream& stream, const vm::vec<T, S>& vec)
+{
+  for (size_t i = 0; i < S; ++i)
+  {
+    write(stream, vec[i]);
+  }
+}
+
+template <typename T, typename W>
+void writeOptional(
+  std::ostream& stream, const std::optional<T>& value, const W& writeValue)
+{
+  write(stream, uint8_t(value ? 1 : 0));
+  if (value)
+  {
+    writeValue(*value);
+  }
+}
+
+void writeFileLocation(std::ostream& stream, const FileLocation& location)
+{
+  write(stream, uint64_t(location.line));
+  writeOptional(
+    stream, location.column, [&](const auto column) { write(stream, uint64_t(column)); });
+}
+
+FileLocation startLocation(const mdl::Node& node)
+{
+  return FileLocation{node.lineNumber()};
+}
+
+FileLocation endLocation(const mdl::Node& node)
+{
+  return FileLocation{node.lineNumber() + node.lineCount()};
+}
+
+void writeAttributes(std::ostream& stream, const mdl::BrushFaceAttributes& attributes)
+{
+  writeString(stream, attributes.materialName());
+  writeVec(stream, attributes.offset());
+  writeVec(stream, attributes.scale());
+  write(stream, attributes.rotation());
+  writeOptional(
+    stream, attributes.surfaceContents(), [&](const auto c) { write(stream, c); });
+  writeOptional(
+    stream, attributes.surfaceFlags(), [&](const auto f) { write(stream, f); });
+  writeOptional(
+    stream, attributes.surfaceValue(), [&](const auto v) { write(stream, v); });
+  writeOptional(
+    stream, attributes.color(), [&](const auto& c) { writeVec<float, 4>(stream, c); });
+}
+
+void writeBrushFace(
+  std::ostream& stream, const mdl::BrushFace& face, const mdl::MapFormat mapFormat)
+{
+  // the parser passes the column of a face as its line count
+  writeFileLocation(stream, FileLocation{face.lineNumber(), face.lineCount()});
+  for (const auto& point : face.points())
+  {
+    writeVec(stream, point);
+  }
+  writeAttributes(stream, face.attributes());
+
+  const auto uvAxes = mdl::isParallelUVCoordSystem(mapFormat)
+                        ? std::optional{std::tuple{face.uAxis(), face.vAxis()}}
+                        : std::nullopt;
+  writeOptional(stream, uvAxes, [&](const auto& axes) {
+    writeVec(stream, std::get<0>(axes));
+    writeVec(stream, std::get<1>(axes));
+  });
+}
+
+void writeBrushGeometry(std::ostream& stream, const mdl::Brush& brush)
+{
+  auto vertexIndices = std::unordered_map<const mdl::BrushVertex*, uint64_t>{};
+  vertexIndices.reserve(brush.vertexCount());
+
+  write(stream, uint64_t(brush.vertexCount()));
+  for (const auto* vertex : brush.vertices())
+  {
+    vertexIndices.emplace(vertex, vertexIndices.size());
+    writeVec(stream, vertex->position());
+  }
+
+  for (const auto& face : brush.faces())
+  {
+    write(stream, uint64_t(face.vertexCount()));
+    for (const auto* vertex : face.vertices())
+    {
+      write(stream, vertexIndices.at(vertex));
+    }
+  }
+}
+
+std::string readString(Reader& reader)
+{
+  const auto size = reader.readSize<uint64_t>();
+  if (!reader.canRead(size))
+  {
+    throw ReaderException{fmt::format("Invalid string size: {}", size)};
+  }
+
+  auto str = std::string(size, '\0');
+  reader.read(str.data(), size);
+  return str;
+}
+
+template <typename T, size_t S>
+vm::vec<T, S> readVec(Reader& reader)
+{
+  return reader.readVec<T, S>();
+}
+
+template <typename R>
+auto readOptional(Reader& reader, const R& readValue)
+{
+  using T = decltype(readValue());
+  return reader.readBool<uint8_t>() ? std::optional<T>{readValue()} : std::nullopt;
+}
+
+size_t readCount(Reader& reader, const size_t elementSize)
+{
+  const auto count = reader.readSize<uint64_t>();
+  // a corrupt count could overflow when multiplied with the element size
+  if (count > (reader.size() - reader.position()) / elementSize)
+  {
+    throw ReaderException{fmt::format("Invalid element count: {}", count)};
+  }
+  return count;
+}
+
+FileLocation readFileLocation(Reader& reader)
+{
+  const auto line = reader.readSize<uint64_t>();
+  const auto column = readOptional(reader, [&]() { return reader.readSize<uint64_t>(); });
+  return FileLocation{line, column};
+}
+
+mdl::BrushFaceAttributes readAttributes(Reader& reader)
+{
+  auto attributes = mdl::BrushFaceAttributes{readString(reader)};
+  attributes.setOffset(readVec<float, 2>(reader));
+  attributes.setScale(readVec<float, 2>(reader));
+  attributes.setRotation(reader.readFloat<float>());
+  attributes.setSurfaceContents(
+    readOptional(reader, [&]() { return reader.readInt<int32_t>(); }));
+  attributes.setSurfaceFlags(
+    readOptional(reader, [&]() { return reader.readInt<int32_t>(); }));
+  attributes.setSurfaceValue(
+    readOptional(reader, [&]() { return reader.readFloat<float>(); }));
+  attributes.setColor(
+    readOptional(reader, [&]() { return Color{readVec<float, 4>(reader)}; }));
+  return attributes;
+}
+
+MapCacheBrushFace readBrushFace(Reader& reader)
+{
+  auto location = readFileLocation(reader);
+  const auto point1 = readVec<double, 3>(reader);
+  const auto point2 = readVec<double, 3>(reader);
+  const auto point3 = readVec<double, 3>(reader);
+  auto attributes = readAttributes(reader);
+  auto uvAxes = readOptional(reader, [&]() {
+    const auto uAxis = readVec<double, 3>(reader);
+    const auto vAxis = readVec<double, 3>(reader);
+    return std::tuple{uAxis, vAxis};
+  });
+
+  return MapCacheBrushFace{
+    std::move(location),
+    {point1, point2, point3},
+    std::move(attributes),
+    std::move(uvAxes),
+  };
+}
+
+MapCacheEntity readEntity(Reader& reader)
+{
+  auto location = readFileLocation(reader);
+
+  const auto count = readCount(reader, 2 * sizeof(uint64_t));
+  auto properties = std::vector<mdl::EntityProperty>{};
+  properties.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    auto key = readString(reader);
+    auto value = readString(reader);
+    properties.emplace_back(std::move(key), std::move(value));
+  }
+
+  return MapCacheEntity{std::move(location), std::move(properties)};
+}
+
+MapCacheBrush readBrush(Reader& reader)
+{
+  auto startLocation = readFileLocation(reader);
+  auto endLocation = readFileLocation(reader);
+
+  const auto faceCount = readCount(reader, 9 * sizeof(double));
+  auto faces = std::vector<MapCacheBrushFace>{};
+  faces.reserve(faceCount);
+  for (size_t i = 0; i < faceCount; ++i)
+  {
+    faces.push_back(readBrushFace(reader));
+  }
+
+  const auto vertexCount = readCount(reader, 3 * sizeof(double));
+  auto vertexPositions = std::vector<vm::vec3d>{};
+  vertexPositions.reserve(vertexCount);
+  for (size_t i = 0; i < vertexCount; ++i)
+  {
+    vertexPositions.push_back(readVec<double, 3>(reader));
+  }
+
+  // the indices are checked when the brush geometry is created from them
+  auto faceVertexIndices = std::vector<std::vector<size_t>>{};
+  faceVertexIndices.reserve(faceCount);
+  for (size_t i = 0; i < faceCount; ++i)
+  {
+    const auto indexCount = readCount(reader, sizeof(uint64_t));
+    auto& indices = faceVertexIndices.emplace_back();
+    indices.reserve(indexCount);
+    for (size_t j = 0; j < indexCount; ++j)
+    {
+      indices.push_back(reader.readSize<uint64_t>());
+    }
+  }
+
+  return MapCacheBrush{
+    std::move(startLocation),
+    std::move(endLocation),
+    std::move(faces),
+    std::move(vertexPositions),
+    std::move(faceVertexIndices),
+  };
+}
+
+MapCachePatch readPatch(Reader& reader)
+{
+  auto startLocation = readFileLocation(reader);
+  auto endLocation = readFileLocation(reader);
+  const auto rowCount = reader.readSize<uint64_t>();
+  const auto columnCount = reader.readSize<uint64_t>();
+
+  // like the map parser, only accept odd dimensions of at least 3
+  if (rowCount < 3 || rowCount % 2 != 1 || columnCount < 3 || columnCount % 2 != 1)
+  {
+    throw ReaderException{
+      fmt::format("Invalid patch dimensions: {}x{}", rowCount, columnCount)};
+  }
+
+  const auto count = readCount(reader, 5 * sizeof(double));
+  if (rowCount > count / columnCount || count != rowCount * columnCount)
+  {
+    throw ReaderException{fmt::format(
+      "Invalid control point count: {} for {}x{} patch", count, rowCount, columnCount)};
+  }
+
+  auto controlPoints = std::vector<vm::vec<double, 5>>{};
+  controlPoints.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    controlPoints.push_back(readVec<double, 5>(reader));
+  }
+
+  auto materialName = readString(reader);
+
+  return MapCachePatch{
+    std::move(startLocation),
+    std::move(endLocation),
+    rowCount,
+    columnCount,
+    std::move(controlPoints),
+    std::move(materialName),
+  };
+}
+
+} // namespace
+
+mdl::MapFormat readMapCacheFormat(Reader& reader)
+{
+  const auto mapFormat = reader.read<uint8_t, uint8_t>();
+  if (
+    mapFormat == static_cast<uint8_t>(mdl::MapFormat::Unknown)
+    || mapFormat > static_cast<uint8_t>(mdl::MapFormat::Quake3))
+  {
+    throw ReaderException{fmt::format("Invalid map format: {}", mapFormat)};
+  }
+  return static_cast<mdl::MapFormat>(mapFormat);
+}
+
+std::optional<MapCacheRecord> readMapCacheRecord(Reader& reader)
+{
+  const auto recordType = reader.read<uint8_t, uint8_t>();
+  switch (static_cast<RecordType>(recordType))
+  {
+  case RecordType::End:
+    return std::nullopt;
+  case RecordType::Entity:
+    return readEntity(reader);
+  case RecordType::EntityEnd:
+    return MapCacheEntityEnd{readFileLocation(reader)};
+  case RecordType::Brush:
+    return readBrush(reader);
+  case RecordType::BrushFace:
+    return readBrushFace(reader);
+  case RecordType::Patch:
+    return readPatch(reader);
+  }
+
+  throw ReaderException{fmt::format("Invalid record type: {}", recordType)};
+}
+
+MapCacheSerializer::MapCacheSerializer(
+  std::ostream& stream, const mdl::MapFormat mapFormat)
+  : m_stream{stream}
+  , m_mapFormat{mapFormat}
+{
+  assert(m_mapFormat != mdl::MapFormat::Unknown);
+}
+
+void MapCacheSerializer::doBeginFile(const std::vector<const mdl::Node*>& /* rootNodes */)
+{
+  write(m_stream, static_cast<uint8_t>(m_mapFormat));
+}
+
+void MapCacheSerializer::doEndFile()
+{
+  writeRecordType(m_stream, RecordType::End);
+}
+
+void MapCacheSerializer::doBeginEntity(const mdl::Node* node)
+{
+  assert(m_pendingEntity == std::nullopt);
+
+  // the properties are passed in separately, so the entity is written once the first
+  // brush, patch or the end of the entity is reached
+  m_pendingEntity = MapCacheEntity{startLocation(*node), {}};
+}
+
+void MapCacheSerializer::doEndEntity(const mdl::Node* node)
+{
+  writePendingEntity();
+
+  writeRecordType(m_stream, RecordType::EntityEnd);
+  writeFileLocation(m_stream, endLocation(*node));
+}
+
+void MapCacheSerializer::doEntityProperty(const mdl::EntityProperty& property)
+{
+  assert(m_pendingEntity != std::nullopt);
+  m_pendingEntity->properties.push_back(property);
+}
+
+void MapCacheSerializer::doBrush(const mdl::BrushNode* brushNode)
+{
+  writePendingEntity();
+
+  const auto& brush = brushNode->brush();
+
+  writeRecordType(m_stream, RecordType::Brush);
+  writeFileLocation(m_stream, startLocation(*brushNode));
+  writeFileLocation(m_stream, endLocation(*brushNode));
+  write(m_stream, uint64_t(brush.faceCount()));
+  for (const auto& face : brush.faces())
+  {
+    writeBrushFace(m_stream, face, m_mapFormat);
+  }
+  writeBrushGeometry(m_stream, brush);
+}
+
+void MapCacheSerializer::doBrushFace(const mdl::BrushFace& face)
+{
+  writeRecordType(m_stream, RecordType::BrushFace);
+  writeBrushFace(m_stream, face, m_mapFormat);
+}
+
+void MapCacheSerializer::doPatch(const mdl::PatchNode* patchNode)
+{
+  writePendingEntity();
+
+  const auto& patch = patchNode->patch();
+
+  writeRecordType(m_stream, RecordType::Patch);
+  writeFileLocation(m_stream, startLocation(*patchNode));
+  writeFileLocation(m_stream, endLocation(*patchNode));
+  write(m_stream, uint64_t(patch.pointRowCount()));
+  write(m_stream, uint64_t(patch.pointColumnCount()));
+  write(m_stream, uint64_t(patch.controlPoints().size()));
+  for (const auto& controlPoint : patch.controlPoints())
+  {
+    writeVec(m_stream, controlPoint);
+  }
+  writeString(m_stream, patch.materialName());
+}
+
+void MapCacheSerializer::writePendingEntity()
+{
+  if (m_pendingEntity)
+  {
+    writeRecordType(m_stream, RecordType::Entity);
+    writeFileLocation(m_stream, m_pendingEntity->startLocation);
+    write(m_stream, uint64_t(m_pendingEntity->properties.size()));
+    for (const auto& property : m_pendingEntity->properties)
+    {
+      writeString(m_stream, property.key());
+      writeString(m_stream, property.value());
+    }
+    m_pendingEntity = std::nullopt;
+  }
+}
+
+} // namespace tb::io
@@ -0,0 +1,153 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FileLocation.h"
+#include "io/NodeSerializer.h"
+#include "mdl/BrushFaceAttributes.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/MapFormat.h"
+
+#include "vm/vec.h"
+
+#include <array>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+namespace tb::mdl
+{
+class BrushNode;
+class BrushFace;
+class Node;
+class PatchNode;
+} // namespace tb::mdl
+
+namespace tb::io
+{
+class Reader;
+
+/**
+ * The records of a map cache. Together, they contain everything that the MapParser
+ * callbacks receive when a map file is parsed, so replaying them to a MapReader yields
+ * the same nodes as parsing the file the cache was created from.
+ */
+struct MapCacheEntity
+{
+  FileLocation startLocation;
+  std::vector<mdl::EntityProperty> properties;
+};
+
+struct MapCacheEntityEnd
+{
+  FileLocation endLocation;
+};
+
+struct MapCacheBrushFace
+{
+  FileLocation location;
+  std::array<vm::vec3d, 3> points;
+  mdl::BrushFaceAttributes attributes;
+  /** Only present for map formats that use a parallel UV coordinate system. */
+  std::optional<std::tuple<vm::vec3d, vm::vec3d>> uvAxes;
+};
+
+struct MapCacheBrush
+{
+  FileLocation startLocation;
+  FileLocation endLocation;
+  std::vector<MapCacheBrushFace> faces;
+  /** The vertices of the brush geometry, so that it need not be computed again. */
+  std::vector<vm::vec3d> vertexPositions;
+  /** For each face, the indices of its vertices in the order of its boundary. */
+  std::vector<std::vector<size_t>> faceVertexIndices;
+};
+
+struct MapCachePatch
+{
+  FileLocation startLocation;
+  FileLocation endLocation;
+  size_t rowCount;
+  size_t columnCount;
+  std::vector<vm::vec<double, 5>> controlPoints;
+  std::string materialName;
+};
+
+using MapCacheRecord = std::variant<
+  MapCacheEntity,
+  MapCacheEntityEnd,
+  MapCacheBrush,
+  MapCacheBrushFace,
+  MapCachePatch>;
+
+/**
+ * Reads the map format that a map cache was written for.
+ *
+ * @throws ReaderException if the cache is malformed
+ */
+mdl::MapFormat readMapCacheFormat(Reader& reader);
+
+/**
+ * Reads the next record of a map cache. Returns an empty optional if the end of the cache
+ * was reached.
+ *
+ * @throws ReaderException if the cache is malformed
+ */
+std::optional<MapCacheRecord> readMapCacheRecord(Reader& reader);
+
+/**
+ * Writes nodes in a compact binary form that can be read back much faster than a map
+ * file. Unlike MapFileSerializer, it stores the file positions that the nodes and brush
+ * faces already have, so that a map that was read from its cache reports the same line
+ * numbers as a map that was read from the original file.
+ *
+ * Floating point values are stored exactly, and entity properties are stored without
+ * escaping them.
+ */
+class MapCacheSerializer : public NodeSerializer
+{
+private:
+  std::ostream& m_stream;
+  mdl::MapFormat m_mapFormat;
+  std::optional<MapCacheEntity> m_pendingEntity;
+
+public:
+  MapCacheSerializer(std::ostream& stream, mdl::MapFormat mapFormat);
+
+private:
+  void doBeginFile(const std::vector<const mdl::Node*>& rootNodes) override;
+  void doEndFile() override;
+
+  void doBeginEntity(const mdl::Node* node) override;
+  void doEndEntity(const mdl::Node* node) override;
+  void doEntityProperty(const mdl::EntityProperty& property) override;
+  void doBrush(const mdl::BrushNode* brushNode) override;
+  void doBrushFace(const mdl::BrushFace& face) override;
+
+  void doPatch(const mdl::PatchNode* patchNode) override;
+
+private:
+  void writePendingEntity();
+};
+
+} // namespace tb::io
@@ -22,6 +22,7 @@
 #include "Error.h" // IWYU pragma: keep
 #include "FileLocation.h"
 #include "Uuid.h"
+#include "io/MapCacheSerializer.h"
 #include "io/ParserStatus.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
@@ -36,6 +37,7 @@
 #include "mdl/VisibilityState.h"
 #include "mdl/WorldNode.h"
 
+#include "kdl/overload.h"
 #include "kdl/parallel.h"
 #include "kdl/result.h"
 #include "kdl/string_format.h"
@@ -101,6 +103,74 @@ void MapReader::readBrushFaces(const vm::bbox3d& worldBounds, ParserStatus& stat
   parseBrushFaces(status);
 }
 
+void MapReader::readCachedEntities(
+  Reader& reader, const vm::bbox3d& worldBounds, ParserStatus& status)
+{
+  m_worldBounds = worldBounds;
+
+  const auto replayBrushFace = [&](const MapCacheBrushFace& face) {
+    const auto& [p1, p2, p3] = face.points;
+    if (face.uvAxes)
+    {
+      const auto& [uAxis, vAxis] = *face.uvAxes;
+      onValveBrushFace(
+        face.location,
+        m_targetMapFormat,
+        p1,
+        p2,
+        p3,
+        face.attributes,
+        uAxis,
+        vAxis,
+        status);
+    }
+    else
+    {
+      onStandardBrushFace(
+        face.location, m_targetMapFormat, p1, p2, p3, face.attributes, status);
+    }
+  };
+
+  while (auto record = readMapCacheRecord(reader))
+  {
+    std::visit(
+      kdl::overload(
+        [&](MapCacheEntity& entity) {
+          onBeginEntity(entity.startLocation, std::move(entity.properties), status);
+        },
+        [&](const MapCacheEntityEnd& entityEnd) {
+          onEndEntity(entityEnd.endLocation, status);
+        },
+        [&](MapCacheBrush& brush) {
+          onBeginBrush(brush.startLocation, status);
+          for (const auto& face : brush.faces)
+          {
+            replayBrushFace(face);
+          }
+          onEndBrush(brush.endLocation, status);
+
+          auto& brushInfo = std::get<BrushInfo>(m_objectInfos.back());
+          brushInfo.vertexPositions = std::move(brush.vertexPositions);
+          brushInfo.faceVertexIndices = std::move(brush.faceVertexIndices);
+        },
+        [&](const MapCacheBrushFace& face) { replayBrushFace(face); },
+        [&](MapCachePatch& patch) {
+          onPatch(
+            patch.startLocation,
+            patch.endLocation,
+            m_targetMapFormat,
+            patch.rowCount,
+            patch.columnCount,
+            std::move(patch.controlPoints),
+            std::move(patch.materialName),
+            status);
+        }),
+      *record);
+  }
+
+  createNodes(status);
+}
+
 // implement MapParser interface
 
 void MapReader::onBeginEntity(
@@ -125,7 +195,8 @@ void MapReader::onEndEntity(const FileLocation& endLocation, ParserStatus& /* st
 
 void MapReader::onBeginBrush(const FileLocation& location, ParserStatus& /* status */)
 {
-  m_objectInfos.emplace_back(BrushInfo{{}, location, std::nullopt, m_currentEntityInfo});
+  m_objectInfos.emplace_back(
+    BrushInfo{{}, location, std::nullopt, m_currentEntityInfo, {}, {}});
 }
 
 void MapReader::onEndBrush(const FileLocation& endLocation, ParserStatus& /* status */)
@@ -585,7 +656,16 @@ CreateNodeResult createNodeFromEntityInfo(
 CreateNodeResult createBrushNode(
   MapReader::BrushInfo brushInfo, const vm::bbox3d& worldBounds)
 {
-  return mdl::Brush::create(worldBounds, std::move(brushInfo.faces))
+  auto brushResult = brushInfo.vertexPositions.empty()
+                       ? mdl::Brush::create(worldBounds, std::move(brushInfo.faces))
+                       : mdl::Brush::create(
+                           worldBounds,
+                           std::move(brushInfo.faces),
+                           mdl::BrushGeometry{
+                             std::move(brushInfo.vertexPositions),
+                             brushInfo.faceVertexIndices});
+
+  return std::move(brushResult)
          | kdl::transform([&](auto brush) {
              auto brushNode = std::make_unique<mdl::BrushNode>(std::move(brush));
              const auto [startLine, lineCount] = getFilePosition(brushInfo);
@@ -50,6 +50,7 @@ namespace tb::io
 {
 
 class ParserStatus;
+class Reader;
 
 /**
  * Abstract superclass containing common code for:
@@ -84,6 +85,9 @@ public: // only public so that helper methods can see these declarations
     FileLocation startLocation;
     std::optional<FileLocation> endLocation;
     std::optional<size_t> parentIndex;
+    /** The vertices and face vertex indices of the brush geometry, if it is known. */
+    std::vector<vm::vec3d> vertexPositions;
+    std::vector<std::vector<size_t>> faceVertexIndices;
   };
 
   struct PatchInfo
@@ -142,6 +146,14 @@ protected:
    * @throws ParserException if parsing fails
    */
   void readBrushFaces(const vm::bbox3d& worldBounds, ParserStatus& status);
+  /**
+   * Reads the records of a map cache written by MapCacheSerializer and creates nodes from
+   * them in the same way as if the map file the cache was created from had been parsed.
+   *
+   * @throws ReaderException if the cache is malformed
+   */
+  void readCachedEntities(
+    Reader& reader, const vm::bbox3d& worldBounds, ParserStatus& status);
 
 protected: // implement MapParser interface
   void onBeginEntity(
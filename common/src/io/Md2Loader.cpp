@@ -34,7 +34,9 @@
 
 #include <fmt/format.h>
 
+#include <memory>
 #include <string>
+#include <tuple>
 
 namespace tb::io
 {
@@ -362,11 +364,20 @@ auto getVertices(const Md2Frame& frame, const std::vector<Md2MeshVertex>& meshVe
   return vertices;
 }
 
-void buildFrame(
-  mdl::EntityModelData& model,
-  mdl::EntityModelSurface& surface,
-  const Md2Frame& frame,
-  const std::vector<Md2Mesh>& meshes)
+auto getBounds(const Md2Frame& frame, const std::vector<Md2Mesh>& meshes)
+{
+  auto bounds = vm::bbox3f::builder{};
+  for (const auto& md2Mesh : meshes)
+  {
+    for (const auto& md2MeshVertex : md2Mesh.vertices)
+    {
+      bounds.add(frame.vertex(md2MeshVertex.vertexIndex));
+    }
+  }
+  return bounds.bounds();
+}
+
+auto buildMesh(const Md2Frame& frame, const std::vector<Md2Mesh>& meshes)
 {
   size_t vertexCount = 0;
   auto size = render::IndexRangeMap::Size{};
@@ -376,20 +387,14 @@ void buildFrame(
     size.inc(md2Mesh.type);
   }
 
-  auto bounds = vm::bbox3f::builder{};
-
   auto builder =
     render::IndexRangeMapBuilder<mdl::EntityModelVertex::Type>{vertexCount, size};
   for (const auto& md2Mesh : meshes)
   {
     if (!md2Mesh.vertices.empty())
     {
-      vertexCount += md2Mesh.vertices.size();
       const auto vertices = getVertices(frame, md2Mesh.vertices);
 
-      bounds.add(
-        std::begin(vertices), std::end(vertices), render::GetVertexComponent<0>());
-
       if (md2Mesh.type == render::PrimType::TriangleFan)
       {
         builder.addTriangleFan(vertices);
@@ -401,9 +406,24 @@ void buildFrame(
     }
   }
 
-  auto& modelFrame = model.addFrame(frame.name, bounds.bounds());
+  return std::tuple{std::move(builder.vertices()), std::move(builder.indices())};
+}
+
+/**
+ * Adds the given frame to the model. Only the frame bounds are computed here, the frame
+ * mesh is built when it is first needed. All frames share the given meshes.
+ */
+void buildFrame(
+  mdl::EntityModelData& model,
+  mdl::EntityModelSurface& surface,
+  Md2Frame frame,
+  std::shared_ptr<const std::vector<Md2Mesh>> meshes)
+{
+  auto& modelFrame = model.addFrame(frame.name, getBounds(frame, *meshes));
   surface.addMesh(
-    modelFrame, std::move(builder.vertices()), std::move(builder.indices()));
+    modelFrame, [frame = std::move(frame), meshes = std::move(meshes)]() {
+      return buildMesh(frame, *meshes);
+    });
 }
 
 } // namespace
@@ -478,17 +498,17 @@ Result<mdl::EntityModelData> Md2Loader::load(Logger& logger)
 
     const auto frameSize =
       6 * sizeof(float) + Md2Layout::FrameNameLength + vertexCount * 4;
-    const auto meshes = parseMeshes(
-      reader.subReaderFromBegin(commandOffset, commandCount * 4), commandCount);
+    const auto meshes = std::make_shared<const std::vector<Md2Mesh>>(parseMeshes(
+      reader.subReaderFromBegin(commandOffset, commandCount * 4), commandCount));
 
     for (size_t i = 0; i < frameCount; ++i)
     {
-      const auto frame = parseFrame(
+      auto frame = parseFrame(
         reader.subReaderFromBegin(frameOffset + i * frameSize, frameSize),
         i,
         vertexCount);
 
-      buildFrame(data, surface, frame, meshes);
+      buildFrame(data, surface, std::move(frame), meshes);
     }
 
     return data;
@@ -29,14 +29,14 @@
 
 #include "kdl/range_to_vector.h"
 #include "kdl/result.h"
-#include "kdl/result_fold.h" // IWYU pragma: keep
 #include "kdl/string_format.h"
-#include "kdl/vector_utils.h"
 
 #include <fmt/core.h>
 
+#include <memory>
 #include <ranges>
 #include <string>
+#include <tuple>
 
 namespace tb::io
 {
@@ -211,20 +211,27 @@ auto parseTriangles(Reader reader, const size_t triangleCount)
   return triangles;
 }
 
-void buildFrameSurface(
-  mdl::EntityModelFrame& frame,
-  mdl::EntityModelSurface& surface,
-  const std::vector<Md3Triangle>& triangles,
-  const std::vector<mdl::EntityModelVertex>& vertices)
+/**
+ * The UV coordinates and triangles of a surface, shared by all frames.
+ */
+struct Md3SurfaceMesh
+{
+  std::vector<vm::vec2f> uvCoords;
+  std::vector<Md3Triangle> triangles;
+};
+
+auto buildFrameMesh(const Md3SurfaceMesh& mesh, const std::vector<vm::vec3f>& positions)
 {
   using Vertex = mdl::EntityModelVertex;
 
+  const auto vertices = buildVertices(positions, mesh.uvCoords);
+
   auto rangeMap =
-    render::IndexRangeMap{render::PrimType::Triangles, 0, 3 * triangles.size()};
+    render::IndexRangeMap{render::PrimType::Triangles, 0, 3 * mesh.triangles.size()};
   auto frameVertices = std::vector<Vertex>{};
-  frameVertices.reserve(3 * triangles.size());
+  frameVertices.reserve(3 * mesh.triangles.size());
 
-  for (const auto& triangle : triangles)
+  for (const auto& triangle : mesh.triangles)
   {
     if (
       triangle.i1 >= vertices.size() || triangle.i2 >= vertices.size()
@@ -242,11 +249,15 @@ void buildFrameSurface(
     frameVertices.push_back(v3);
   }
 
-  surface.addMesh(frame, std::move(frameVertices), std::move(rangeMap));
+  return std::tuple{std::move(frameVertices), std::move(rangeMap)};
 }
 
-Result<void> parseFrameSurfaces(
-  Reader reader, mdl::EntityModelFrame& frame, mdl::EntityModelData& model)
+/**
+ * Adds the per frame meshes of every surface to the model. The UV coordinates and
+ * triangles of a surface are decoded once and shared by all frames, and only the vertex
+ * positions are decoded per frame. The frame meshes are built when they are first needed.
+ */
+Result<void> parseSurfaceMeshes(Reader reader, mdl::EntityModelData& model)
 {
   for (size_t i = 0; i < model.surfaceCount(); ++i)
   {
@@ -272,23 +283,28 @@ Result<void> parseFrameSurfaces(
 
     if (frameCount > 0)
     {
-      const auto frameVertexLength = vertexCount * Md3Layout::VertexLength;
-      const auto frameVertexOffset = vertexOffset + frame.index() * frameVertexLength;
-
-      const auto vertexPositions = parseVertexPositions(
-        reader.subReaderFromBegin(frameVertexOffset, frameVertexLength), vertexCount);
-      const auto uvCoords = parseUV(
-        reader.subReaderFromBegin(uvCoordOffset, vertexCount * Md3Layout::UVLength),
-        vertexCount);
-      const auto vertices = buildVertices(vertexPositions, uvCoords);
-
-      const auto triangles = parseTriangles(
-        reader.subReaderFromBegin(
-          triangleOffset, triangleCount * Md3Layout::TriangleLength),
-        triangleCount);
+      const auto mesh = std::make_shared<const Md3SurfaceMesh>(Md3SurfaceMesh{
+        parseUV(
+          reader.subReaderFromBegin(uvCoordOffset, vertexCount * Md3Layout::UVLength),
+          vertexCount),
+        parseTriangles(
+          reader.subReaderFromBegin(
+            triangleOffset, triangleCount * Md3Layout::TriangleLength),
+          triangleCount),
+      });
 
       auto& surface = model.surface(i);
-      buildFrameSurface(frame, surface, triangles, vertices);
+      for (auto& frame : model.frames())
+      {
+        const auto frameVertexLength = vertexCount * Md3Layout::VertexLength;
+        const auto frameVertexOffset = vertexOffset + frame.index() * frameVertexLength;
+
+        auto positions = parseVertexPositions(
+          reader.subReaderFromBegin(frameVertexOffset, frameVertexLength), vertexCount);
+        surface.addMesh(frame, [mesh, positions = std::move(positions)]() {
+          return buildFrameMesh(*mesh, positions);
+        });
+      }
     }
 
     reader = reader.subReaderFromBegin(endOffset);
@@ -360,18 +376,16 @@ Result<mdl::EntityModelData> Md3Loader::load(Logger&)
              data,
              m_loadMaterial)
            | kdl::and_then([&]() {
-               return kdl::vec_transform(
-                        std::views::iota(0u, frameCount),
-                        [&](const auto i) {
-                          auto& frame = parseFrame(
-                            reader.subReaderFromBegin(
-                              frameOffset + i * Md3Layout::FrameLength,
-                              Md3Layout::FrameLength),
-                            data);
-                          return parseFrameSurfaces(
-                            reader.subReaderFromBegin(surfaceOffset), frame, data);
-                        })
-                      | kdl::fold | kdl::transform([&]() { return std::move(data); });
+               for (size_t i = 0; i < frameCount; ++i)
+               {
+                 parseFrame(
+                   reader.subReaderFromBegin(
+                     frameOffset + i * Md3Layout::FrameLength, Md3Layout::FrameLength),
+                   data);
+               }
+
+               return parseSurfaceMeshes(reader.subReaderFromBegin(surfaceOffset), data)
+                      | kdl::transform([&]() { return std::move(data); });
              });
   }
   catch (const ReaderException& e)
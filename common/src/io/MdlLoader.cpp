@@ -34,7 +34,9 @@
 
 #include <fmt/format.h>
 
+#include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace tb::io
@@ -235,6 +237,17 @@ struct MdlSkinTriangle
   size_t vertices[3];
 };
 
+/**
+ * The skin vertices and triangles of a model, shared by all of its frames.
+ */
+struct MdlMesh
+{
+  std::vector<MdlSkinVertex> vertices;
+  std::vector<MdlSkinTriangle> triangles;
+  size_t skinWidth;
+  size_t skinHeight;
+};
+
 auto unpackFrameVertex(
   const vm::vec<unsigned char, 4>& vertex,
   const vm::vec3f& origin,
@@ -268,26 +281,21 @@ auto parseFrameVertices(
   });
 }
 
-auto makeFrameTriangles(
-  const std::vector<MdlSkinTriangle>& triangles,
-  const std::vector<MdlSkinVertex>& vertices,
-  const std::vector<vm::vec3f>& positions,
-  const size_t skinWidth,
-  const size_t skinHeight)
+auto makeFrameTriangles(const MdlMesh& mesh, const std::vector<vm::vec3f>& positions)
 {
   auto frameTriangles = std::vector<mdl::EntityModelVertex>{};
-  frameTriangles.reserve(triangles.size());
+  frameTriangles.reserve(mesh.triangles.size() * 3);
 
-  for (size_t i = 0; i < triangles.size(); ++i)
+  for (const auto& triangle : mesh.triangles)
   {
-    const auto& triangle = triangles[i];
     for (size_t j = 0; j < 3; ++j)
     {
       const auto vertexIndex = triangle.vertices[j];
-      const auto& skinVertex = vertices[vertexIndex];
+      const auto& skinVertex = mesh.vertices[vertexIndex];
 
       auto uv = vm::vec2f{
-        float(skinVertex.u) / float(skinWidth), float(skinVertex.v) / float(skinHeight)};
+        float(skinVertex.u) / float(mesh.skinWidth),
+        float(skinVertex.v) / float(mesh.skinHeight)};
       if (skinVertex.onseam && !triangle.front)
       {
         uv[0] += 0.5f;
@@ -300,66 +308,63 @@ auto makeFrameTriangles(
   return frameTriangles;
 }
 
+auto buildFrameMesh(const MdlMesh& mesh, const std::vector<vm::vec3f>& positions)
+{
+  const auto frameTriangles = makeFrameTriangles(mesh, positions);
+
+  auto size = render::IndexRangeMap::Size{};
+  size.inc(render::PrimType::Triangles, frameTriangles.size());
+
+  auto builder = render::IndexRangeMapBuilder<mdl::EntityModelVertex::Type>{
+    frameTriangles.size() * 3, size};
+  builder.addTriangles(frameTriangles);
+
+  return std::tuple{std::move(builder.vertices()), std::move(builder.indices())};
+}
+
+/**
+ * Adds a frame to the model. Only the frame's vertex positions are decoded here, the
+ * frame mesh is built from them when it is first needed.
+ */
 void doParseFrame(
   Reader reader,
   mdl::EntityModelData& model,
   mdl::EntityModelSurface& surface,
-  const std::vector<MdlSkinTriangle>& triangles,
-  const std::vector<MdlSkinVertex>& vertices,
-  const size_t skinWidth,
-  const size_t skinHeight,
+  std::shared_ptr<const MdlMesh> mesh,
   const vm::vec3f& origin,
   const vm::vec3f& scale)
 {
   reader.seekForward(MdlLayout::SimpleFrameName);
   auto name = reader.readString(MdlLayout::SimpleFrameLength);
 
-  const auto positions = parseFrameVertices(reader, vertices, origin, scale);
+  auto positions = parseFrameVertices(reader, mesh->vertices, origin, scale);
 
   auto bounds = vm::bbox3f::builder{};
   bounds.add(positions.begin(), positions.end());
 
-  const auto frameTriangles =
-    makeFrameTriangles(triangles, vertices, positions, skinWidth, skinHeight);
-
-  auto size = render::IndexRangeMap::Size{};
-  size.inc(render::PrimType::Triangles, frameTriangles.size());
-
-  auto builder = render::IndexRangeMapBuilder<mdl::EntityModelVertex::Type>{
-    frameTriangles.size() * 3, size};
-  builder.addTriangles(frameTriangles);
-
   auto& frame = model.addFrame(std::move(name), bounds.bounds());
-  surface.addMesh(frame, std::move(builder.vertices()), std::move(builder.indices()));
+  surface.addMesh(
+    frame, [mesh = std::move(mesh), positions = std::move(positions)]() {
+      return buildFrameMesh(*mesh, positions);
+    });
 }
 
 void parseFrame(
   Reader& reader,
   mdl::EntityModelData& model,
   mdl::EntityModelSurface& surface,
-  const std::vector<MdlSkinTriangle>& triangles,
-  const std::vector<MdlSkinVertex>& vertices,
-  size_t skinWidth,
-  size_t skinHeight,
+  const std::shared_ptr<const MdlMesh>& mesh,
   const vm::vec3f& origin,
   const vm::vec3f& scale)
 {
   const auto frameLength =
-    MdlLayout::SimpleFrameName + MdlLayout::SimpleFrameLength + vertices.size() * 4;
+    MdlLayout::SimpleFrameName + MdlLayout::SimpleFrameLength + mesh->vertices.size() * 4;
 
   const auto type = reader.readInt<int32_t>();
   if (type == 0)
   { // single frame
     doParseFrame(
-      reader.subReaderFromCurrent(frameLength),
-      model,
-      surface,
-      triangles,
-      vertices,
-      skinWidth,
-      skinHeight,
-      origin,
-      scale);
+      reader.subReaderFromCurrent(frameLength), model, surface, mesh, origin, scale);
     reader.seekForward(frameLength);
   }
   else
@@ -373,10 +378,7 @@ void parseFrame(
       reader.subReaderFromCurrent(frameTimeLength, frameLength),
       model,
       surface,
-      triangles,
-      vertices,
-      skinWidth,
-      skinHeight,
+      mesh,
       origin,
       scale);
 
@@ -555,13 +557,14 @@ Result<mdl::EntityModelData> MdlLoader::load(Logger& /* logger */)
     parseSkins(
       reader, surface, skinCount, skinWidth, skinHeight, flags, m_name, m_palette);
 
-    const auto vertices = parseVertices(reader, vertexCount);
-    const auto triangles = parseTriangles(reader, triangleCount);
+    auto vertices = parseVertices(reader, vertexCount);
+    auto triangles = parseTriangles(reader, triangleCount);
+    const auto mesh = std::make_shared<const MdlMesh>(
+      MdlMesh{std::move(vertices), std::move(triangles), skinWidth, skinHeight});
 
     for (size_t i = 0; i < frameCount; ++i)
     {
-      parseFrame(
-        reader, data, surface, triangles, vertices, skinWidth, skinHeight, origin, scale);
+      parseFrame(reader, data, surface, mesh, origin, scale);
     }
 
     return data;
@@ -0,0 +1,1243 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ParseCache.h"
+
+#include "Error.h" // IWYU pragma: keep
+#include "el/Expression.h"
+#include "el/Value.h"
+#include "io/DiskIO.h"
+#include "io/EntityDefinitionClassInfo.h"
+#include "io/File.h"
+#include "io/MapCacheSerializer.h"
+#include "io/NodeWriter.h"
+#include "io/PathInfo.h"
+#include "io/ReaderException.h"
+#include "io/WorldReader.h"
+#include "mdl/PropertyDefinition.h"
+#include "mdl/Quake3Shader.h"
+#include "mdl/Texture.h"
+#include "mdl/TextureBuffer.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/overload.h"
+#include "kdl/reflection_impl.h"
+#include "kdl/result.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace tb::io
+{
+
+kdl_reflect_impl(FileFingerprint);
+
+namespace
+{
+
+constexpr auto Magic = std::string_view{"TBPC"};
+constexpr auto FormatVersion = uint32_t{2};
+
+enum class EntryType : uint32_t
+{
+  Shaders,
+  ClassInfos,
+  Thumbnail,
+  Map,
+};
+
+class BinaryWriter
+{
+private:
+  std::ostream& m_stream;
+
+public:
+  explicit BinaryWriter(std::ostream& stream)
+    : m_stream{stream}
+  {
+  }
+
+  template <typename T>
+  void write(const T value)
+  {
+    static_assert(std::is_arithmetic_v<T>);
+    m_stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void writeBool(const bool value) { write(uint8_t(value ? 1 : 0)); }
+
+  void writeString(const std::string_view str)
+  {
+    write(uint64_t(str.size()));
+    m_stream.write(str.data(), std::streamsize(str.size()));
+  }
+
+  void writePath(const std::filesystem::path& path) { writeString(path.string()); }
+
+  std::ostream& stream() { return m_stream; }
+
+  void writeBytes(const unsigned char* data, const size_t size)
+  {
+    write(uint64_t(size));
+    m_stream.write(reinterpret_cast<const char*>(data), std::streamsize(size));
+  }
+};
+
+std::string readString(Reader& reader)
+{
+  const auto size = reader.readSize<uint64_t>();
+  return reader.readString(size);
+}
+
+std::filesystem::path readPath(Reader& reader)
+{
+  return std::filesystem::path{readString(reader)};
+}
+
+template <typename E>
+E readEnum(Reader& reader, const E maxValue)
+{
+  const auto value = reader.read<uint8_t, uint8_t>();
+  if (value > static_cast<uint8_t>(maxValue))
+  {
+    throw ReaderException{fmt::format("Invalid enum value: {}", value)};
+  }
+  return static_cast<E>(value);
+}
+
+/**
+ * Reads the number of elements of a sequence whose elements take up at least the given
+ * number of bytes each. Throws if the remaining bytes cannot hold that many elements so
+ * that a corrupt count does not lead to a huge allocation.
+ */
+size_t readCount(Reader& reader, const size_t minElementSize)
+{
+  const auto count = reader.readSize<uint64_t>();
+  if (count > (reader.size() - reader.position()) / minElementSize)
+  {
+    throw ReaderException{fmt::format("Invalid element count: {}", count)};
+  }
+  return count;
+}
+
+template <typename E>
+void writeEnum(BinaryWriter& writer, const E value)
+{
+  writer.write(static_cast<uint8_t>(value));
+}
+
+template <typename T, typename W>
+void writeOptional(
+  BinaryWriter& writer, const std::optional<T>& value, const W& writeValue)
+{
+  writer.writeBool(value.has_value());
+  if (value)
+  {
+    writeValue(*value);
+  }
+}
+
+template <typename R>
+auto readOptional(Reader& reader, const R& readValue)
+{
+  using T = decltype(readValue());
+  return reader.readBool<uint8_t>() ? std::optional<T>{readValue()} : std::nullopt;
+}
+
+bool isUncompressedFormat(const GLenum format)
+{
+  return format == GL_RGB || format == GL_BGR || format == GL_RGBA || format == GL_BGRA;
+}
+
+/**
+ * Returns whether an image of the given dimensions takes up the given number of bytes.
+ * Dimensions whose product overflows never match.
+ */
+bool isImageSize(
+  const size_t width, const size_t height, const size_t bytesPerPixel, const size_t size)
+{
+  const auto max = std::numeric_limits<size_t>::max();
+  if (height != 0 && width > max / height)
+  {
+    return false;
+  }
+
+  const auto pixelCount = width * height;
+  if (bytesPerPixel != 0 && pixelCount > max / bytesPerPixel)
+  {
+    return false;
+  }
+
+  return pixelCount * bytesPerPixel == size;
+}
+
+std::filesystem::path entryPath(
+  const std::filesystem::path& directory,
+  const std::string_view subDirectory,
+  const std::filesystem::path& path)
+{
+  return directory / subDirectory
+         / fmt::format("{:016x}.bin", hashFileContents(path.string()));
+}
+
+std::optional<int64_t> diskModificationTime(const std::filesystem::path& path)
+{
+  auto error = std::error_code{};
+  const auto time = std::filesystem::last_write_time(path, error);
+  return !error ? std::optional{int64_t(time.time_since_epoch().count())} : std::nullopt;
+}
+
+std::optional<FileFingerprint> makeDiskFileFingerprint(const std::filesystem::path& path)
+{
+  const auto modificationTime = diskModificationTime(path);
+  if (!modificationTime)
+  {
+    return std::nullopt;
+  }
+
+  return Disk::openFile(path) | kdl::transform([&](auto file) {
+           auto reader = file->reader().buffer();
+           return std::optional{
+             makeFileFingerprint(path, reader.stringView(), *modificationTime)};
+         })
+         | kdl::value_or(std::nullopt);
+}
+
+bool matchesDiskFile(const FileFingerprint& fingerprint)
+{
+  // check the cheap attributes before hashing the file contents
+  auto error = std::error_code{};
+  const auto size = std::filesystem::file_size(fingerprint.path, error);
+  if (error || size != fingerprint.size)
+  {
+    return false;
+  }
+
+  if (diskModificationTime(fingerprint.path) != fingerprint.modificationTime)
+  {
+    return false;
+  }
+
+  return Disk::openFile(fingerprint.path) | kdl::transform([&](auto file) {
+           auto reader = file->reader().buffer();
+           return hashFileContents(reader.stringView()) == fingerprint.contentHash;
+         })
+         | kdl::value_or(false);
+}
+
+void writeFingerprints(
+  BinaryWriter& writer, const std::vector<FileFingerprint>& fingerprints)
+{
+  writer.write(uint64_t(fingerprints.size()));
+  for (const auto& fingerprint : fingerprints)
+  {
+    writer.writePath(fingerprint.path);
+    writer.write(fingerprint.size);
+    writer.write(fingerprint.modificationTime);
+    writer.write(fingerprint.contentHash);
+  }
+}
+
+std::vector<FileFingerprint> readFingerprints(Reader& reader)
+{
+  const auto count = reader.readSize<uint64_t>();
+
+  auto result = std::vector<FileFingerprint>{};
+  for (size_t i = 0; i < count; ++i)
+  {
+    auto path = readPath(reader);
+    const auto size = reader.read<uint64_t, uint64_t>();
+    const auto modificationTime = reader.read<int64_t, int64_t>();
+    const auto contentHash = reader.read<uint64_t, uint64_t>();
+    result.push_back(
+      FileFingerprint{std::move(path), size, modificationTime, contentHash});
+  }
+  return result;
+}
+
+/**
+ * Writes the given entry to a temporary file first and then moves it into place so that
+ * a concurrent reader never observes a partially written entry.
+ */
+template <typename F>
+void writeEntry(
+  const std::filesystem::path& path,
+  const EntryType entryType,
+  const std::vector<FileFingerprint>& fingerprints,
+  const F& writePayload)
+{
+  auto error = std::error_code{};
+  std::filesystem::create_directories(path.parent_path(), error);
+  if (error)
+  {
+    return;
+  }
+
+  // the temporary file name must be unique so that concurrent writers of the same entry
+  // don't interfere
+  auto tempPath = path;
+  tempPath += fmt::format(
+    ".{:x}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+  {
+    auto stream = std::ofstream{tempPath, std::ios::out | std::ios::binary};
+    if (!stream)
+    {
+      return;
+    }
+
+    auto writer = BinaryWriter{stream};
+    stream.write(Magic.data(), std::streamsize(Magic.size()));
+    writer.write(FormatVersion);
+    writer.write(static_cast<uint32_t>(entryType));
+    writeFingerprints(writer, fingerprints);
+    writePayload(writer);
+
+    if (!stream)
+    {
+      stream.close();
+      std::filesystem::remove(tempPath, error);
+      return;
+    }
+  }
+
+  std::filesystem::rename(tempPath, path, error);
+  if (error)
+  {
+    std::filesystem::remove(tempPath, error);
+  }
+}
+
+/**
+ * Reads the entry at the given path. The given function is called with the stored
+ * fingerprints and must return whether they are still valid. If so, the payload is read
+ * and returned.
+ */
+template <typename V, typename F>
+auto readEntry(
+  const std::filesystem::path& path,
+  const EntryType entryType,
+  const V& validateFingerprints,
+  const F& readPayload) -> std::optional<decltype(readPayload(std::declval<Reader&>()))>
+{
+  if (Disk::pathInfo(path) != PathInfo::File)
+  {
+    return std::nullopt;
+  }
+
+  return Disk::openFile(path) | kdl::transform([&](std::shared_ptr<CFile> file) {
+           using ResultType =
+             std::optional<decltype(readPayload(std::declval<Reader&>()))>;
+
+           try
+           {
+             auto reader = file->reader().buffer();
+             if (
+               reader.readString(Magic.size()) != Magic
+               || reader.read<uint32_t, uint32_t>() != FormatVersion
+               || reader.read<uint32_t, uint32_t>() != static_cast<uint32_t>(entryType))
+             {
+               return ResultType{};
+             }
+
+             if (!validateFingerprints(readFingerprints(reader)))
+             {
+               return ResultType{};
+             }
+
+             auto result = readPayload(reader);
+             return reader.eof() ? ResultType{std::move(result)} : ResultType{};
+           }
+           catch (const ReaderException&)
+           {
+             return ResultType{};
+           }
+         })
+         | kdl::value_or(std::nullopt);
+}
+
+void writeShader(BinaryWriter& writer, const mdl::Quake3Shader& shader)
+{
+  writer.writePath(shader.shaderPath);
+  writer.writePath(shader.editorImage);
+  writer.writePath(shader.lightImage);
+  writeEnum(writer, shader.culling);
+
+  writer.write(uint64_t(shader.surfaceParms.size()));
+  for (const auto& surfaceParm : shader.surfaceParms)
+  {
+    writer.writeString(surfaceParm);
+  }
+
+  writer.write(uint64_t(shader.stages.size()));
+  for (const auto& stage : shader.stages)
+  {
+    writer.writePath(stage.map);
+    writer.writeString(stage.blendFunc.srcFactor);
+    writer.writeString(stage.blendFunc.destFactor);
+  }
+}
+
+mdl::Quake3Shader readShader(Reader& reader)
+{
+  auto shader = mdl::Quake3Shader{};
+  shader.shaderPath = readPath(reader);
+  shader.editorImage = readPath(reader);
+  shader.lightImage = readPath(reader);
+  shader.culling = readEnum(reader, mdl::Quake3Shader::Culling::None);
+
+  const auto surfaceParmCount = reader.readSize<uint64_t>();
+  for (size_t i = 0; i < surfaceParmCount; ++i)
+  {
+    shader.surfaceParms.insert(readString(reader));
+  }
+
+  const auto stageCount = reader.readSize<uint64_t>();
+  for (size_t i = 0; i < stageCount; ++i)
+  {
+    auto& stage = shader.addStage();
+    stage.map = readPath(reader);
+    stage.blendFunc.srcFactor = readString(reader);
+    stage.blendFunc.destFactor = readString(reader);
+  }
+
+  return shader;
+}
+
+void writeFileLocation(BinaryWriter& writer, const FileLocation& location)
+{
+  writer.write(uint64_t(location.line));
+  writeOptional(
+    writer, location.column, [&](const auto column) { writer.write(uint64_t(column)); });
+}
+
+FileLocation readFileLocation(Reader& reader)
+{
+  const auto line = reader.readSize<uint64_t>();
+  const auto column = readOptional(reader, [&]() { return reader.readSize<uint64_t>(); });
+  return FileLocation{line, column};
+}
+
+enum class ValueTag : uint8_t
+{
+  Boolean,
+  String,
+  Number,
+  Array,
+  Map,
+  LeftBoundedRange,
+  RightBoundedRange,
+  BoundedRange,
+  Null,
+  Undefined,
+};
+
+void writeValue(BinaryWriter& writer, const el::Value& value)
+{
+  switch (value.type())
+  {
+  case el::ValueType::Boolean:
+    writeEnum(writer, ValueTag::Boolean);
+    writer.writeBool(value.booleanValue());
+    break;
+  case el::ValueType::String:
+    writeEnum(writer, ValueTag::String);
+    writer.writeString(value.stringValue());
+    break;
+  case el::ValueType::Number:
+    writeEnum(writer, ValueTag::Number);
+    writer.write(value.numberValue());
+    break;
+  case el::ValueType::Array:
+    writeEnum(writer, ValueTag::Array);
+    writer.write(uint64_t(value.arrayValue().size()));
+    for (const auto& element : value.arrayValue())
+    {
+      writeValue(writer, element);
+    }
+    break;
+  case el::ValueType::Map:
+    writeEnum(writer, ValueTag::Map);
+    writer.write(uint64_t(value.mapValue().size()));
+    for (const auto& [key, element] : value.mapValue())
+    {
+      writer.writeString(key);
+      writeValue(writer, element);
+    }
+    break;
+  case el::ValueType::Range:
+    std::visit(
+      kdl::overload(
+        [&](const el::LeftBoundedRange& range) {
+          writeEnum(writer, ValueTag::LeftBoundedRange);
+          writer.write(int64_t(range.first));
+        },
+        [&](const el::RightBoundedRange& range) {
+          writeEnum(writer, ValueTag::RightBoundedRange);
+          writer.write(int64_t(range.last));
+        },
+        [&](const el::BoundedRange& range) {
+          writeEnum(writer, ValueTag::BoundedRange);
+          writer.write(int64_t(range.first));
+          writer.write(int64_t(range.last));
+        }),
+      value.rangeValue());
+    break;
+  case el::ValueType::Null:
+    writeEnum(writer, ValueTag::Null);
+    break;
+  case el::ValueType::Undefined:
+    writeEnum(writer, ValueTag::Undefined);
+    break;
+  }
+}
+
+el::Value readValue(Reader& reader)
+{
+  switch (readEnum(reader, ValueTag::Undefined))
+  {
+  case ValueTag::Boolean:
+    return el::Value{reader.readBool<uint8_t>()};
+  case ValueTag::String:
+    return el::Value{readString(reader)};
+  case ValueTag::Number:
+    return el::Value{reader.readDouble<double>()};
+  case ValueTag::Array: {
+    const auto count = reader.readSize<uint64_t>();
+    auto array = el::ArrayType{};
+    for (size_t i = 0; i < count; ++i)
+    {
+      array.push_back(readValue(reader));
+    }
+    return el::Value{std::move(array)};
+  }
+  case ValueTag::Map: {
+    const auto count = reader.readSize<uint64_t>();
+    auto map = el::MapType{};
+    for (size_t i = 0; i < count; ++i)
+    {
+      auto key = readString(reader);
+      map.emplace(std::move(key), readValue(reader));
+    }
+    return el::Value{std::move(map)};
+  }
+  case ValueTag::LeftBoundedRange:
+    return el::Value{el::RangeType{el::LeftBoundedRange{reader.read<int64_t, long>()}}};
+  case ValueTag::RightBoundedRange:
+    return el::Value{el::RangeType{el::RightBoundedRange{reader.read<int64_t, long>()}}};
+  case ValueTag::BoundedRange: {
+    const auto first = reader.read<int64_t, long>();
+    const auto last = reader.read<int64_t, long>();
+    return el::Value{el::RangeType{el::BoundedRange{first, last}}};
+  }
+  case ValueTag::Null:
+    return el::Value::Null;
+  case ValueTag::Undefined:
+    return el::Value::Undefined;
+  }
+
+  throw ReaderException{"Invalid value tag"};
+}
+
+enum class ExpressionTag : uint8_t
+{
+  Literal,
+  Variable,
+  Array,
+  Map,
+  Unary,
+  Binary,
+  Subscript,
+  Switch,
+};
+
+void writeExpression(BinaryWriter& writer, const el::ExpressionNode& expression)
+{
+  writeOptional(writer, expression.location(), [&](const auto& location) {
+    writeFileLocation(writer, location);
+  });
+
+  expression.accept(kdl::overload(
+    [&](const el::LiteralExpression& literalExpression) {
+      writeEnum(writer, ExpressionTag::Literal);
+      writeValue(writer, literalExpression.value);
+    },
+    [&](const el::VariableExpression& variableExpression) {
+      writeEnum(writer, ExpressionTag::Variable);
+      writer.writeString(variableExpression.variableName);
+    },
+    [&](const el::ArrayExpression& arrayExpression) {
+      writeEnum(writer, ExpressionTag::Array);
+      writer.write(uint64_t(arrayExpression.elements.size()));
+      for (const auto& element : arrayExpression.elements)
+      {
+        writeExpression(writer, element);
+      }
+    },
+    [&](const el::MapExpression& mapExpression) {
+      writeEnum(writer, ExpressionTag::Map);
+      writer.write(uint64_t(mapExpression.elements.size()));
+      for (const auto& [key, element] : mapExpression.elements)
+      {
+        writer.writeString(key);
+        writeExpression(writer, element);
+      }
+    },
+    [&](const el::UnaryExpression& unaryExpression) {
+      writeEnum(writer, ExpressionTag::Unary);
+      writeEnum(writer, unaryExpression.operation);
+      writeExpression(writer, unaryExpression.operand);
+    },
+    [&](const el::BinaryExpression& binaryExpression) {
+      writeEnum(writer, ExpressionTag::Binary);
+      writeEnum(writer, binaryExpression.operation);
+      writeExpression(writer, binaryExpression.leftOperand);
+      writeExpression(writer, binaryExpression.rightOperand);
+    },
+    [&](const el::SubscriptExpression& subscriptExpression) {
+      writeEnum(writer, ExpressionTag::Subscript);
+      writeExpression(writer, subscriptExpression.leftOperand);
+      writeExpression(writer, subscriptExpression.rightOperand);
+    },
+    [&](const el::SwitchExpression& switchExpression) {
+      writeEnum(writer, ExpressionTag::Switch);
+      writer.write(uint64_t(switchExpression.cases.size()));
+      for (const auto& case_ : switchExpression.cases)
+      {
+        writeExpression(writer, case_);
+      }
+    }));
+}
+
+el::ExpressionNode readExpression(Reader& reader);
+
+std::vector<el::ExpressionNode> readExpressions(Reader& reader)
+{
+  const auto count = reader.readSize<uint64_t>();
+  auto result = std::vector<el::ExpressionNode>{};
+  for (size_t i = 0; i < count; ++i)
+  {
+    result.push_back(readExpression(reader));
+  }
+  return result;
+}
+
+el::ExpressionNode readExpression(Reader& reader)
+{
+  auto location = readOptional(reader, [&]() { return readFileLocation(reader); });
+
+  // the stored expression tree is already balanced, so the rebalancing done by the
+  // ExpressionNode constructor does not change it
+  switch (readEnum(reader, ExpressionTag::Switch))
+  {
+  case ExpressionTag::Literal:
+    return el::ExpressionNode{el::LiteralExpression{readValue(reader)}, location};
+  case ExpressionTag::Variable:
+    return el::ExpressionNode{el::VariableExpression{readString(reader)}, location};
+  case ExpressionTag::Array:
+    return el::ExpressionNode{el::ArrayExpression{readExpressions(reader)}, location};
+  case ExpressionTag::Map: {
+    const auto count = reader.readSize<uint64_t>();
+    auto elements = std::map<std::string, el::ExpressionNode>{};
+    for (size_t i = 0; i < count; ++i)
+    {
+      auto key = readString(reader);
+      elements.emplace(std::move(key), readExpression(reader));
+    }
+    return el::ExpressionNode{el::MapExpression{std::move(elements)}, location};
+  }
+  case ExpressionTag::Unary: {
+    const auto operation = readEnum(reader, el::UnaryOperation::RightBoundedRange);
+    return el::ExpressionNode{
+      el::UnaryExpression{operation, readExpression(reader)}, location};
+  }
+  case ExpressionTag::Binary: {
+    const auto operation = readEnum(reader, el::BinaryOperation::Case);
+    // braced initialization guarantees left to right evaluation order
+    return el::ExpressionNode{
+      el::BinaryExpression{operation, readExpression(reader), readExpression(reader)},
+      location};
+  }
+  case ExpressionTag::Subscript:
+    return el::ExpressionNode{
+      el::SubscriptExpression{readExpression(reader), readExpression(reader)}, location};
+  case ExpressionTag::Switch:
+    return el::ExpressionNode{el::SwitchExpression{readExpressions(reader)}, location};
+  }
+
+  throw ReaderException{"Invalid expression tag"};
+}
+
+enum class PropertyDefinitionTag : uint8_t
+{
+  TargetSource,
+  TargetDestination,
+  String,
+  Unknown,
+  Boolean,
+  Integer,
+  Float,
+  Choice,
+  Flags,
+};
+
+template <typename T, typename W>
+void writeDefaultValue(
+  BinaryWriter& writer,
+  const mdl::PropertyDefinitionWithDefaultValue<T>& definition,
+  const W& writeValue)
+{
+  writer.writeBool(definition.hasDefaultValue());
+  if (definition.hasDefaultValue())
+  {
+    writeValue(definition.defaultValue());
+  }
+}
+
+void writePropertyDefinition(
+  BinaryWriter& writer, const mdl::PropertyDefinition& definition)
+{
+  const auto writeBaseAttributes = [&](const auto tag) {
+    writeEnum(writer, tag);
+    writer.writeString(definition.key());
+    writer.writeString(definition.shortDescription());
+    writer.writeString(definition.longDescription());
+    writer.writeBool(definition.readOnly());
+  };
+  const auto writeString = [&](const auto& str) { writer.writeString(str); };
+
+  switch (definition.type())
+  {
+  case mdl::PropertyDefinitionType::TargetSourceProperty:
+    writeBaseAttributes(PropertyDefinitionTag::TargetSource);
+    break;
+  case mdl::PropertyDefinitionType::TargetDestinationProperty:
+    writeBaseAttributes(PropertyDefinitionTag::TargetDestination);
+    break;
+  case mdl::PropertyDefinitionType::StringProperty: {
+    const auto isUnknown =
+      dynamic_cast<const mdl::UnknownPropertyDefinition*>(&definition) != nullptr;
+    writeBaseAttributes(
+      isUnknown ? PropertyDefinitionTag::Unknown : PropertyDefinitionTag::String);
+    writeDefaultValue(
+      writer,
+      static_cast<const mdl::StringPropertyDefinition&>(definition),
+      writeString);
+    break;
+  }
+  case mdl::PropertyDefinitionType::BooleanProperty:
+    writeBaseAttributes(PropertyDefinitionTag::Boolean);
+    writeDefaultValue(
+      writer,
+      static_cast<const mdl::BooleanPropertyDefinition&>(definition),
+      [&](const auto b) { writer.writeBool(b); });
+    break;
+  case mdl::PropertyDefinitionType::IntegerProperty:
+    writeBaseAttributes(PropertyDefinitionTag::Integer);
+    writeDefaultValue(
+      writer,
+      static_cast<const mdl::IntegerPropertyDefinition&>(definition),
+      [&](const auto i) { writer.write(int64_t(i)); });
+    break;
+  case mdl::PropertyDefinitionType::FloatProperty:
+    writeBaseAttributes(PropertyDefinitionTag::Float);
+    writeDefaultValue(
+      writer,
+      static_cast<const mdl::FloatPropertyDefinition&>(definition),
+      [&](const auto f) { writer.write(f); });
+    break;
+  case mdl::PropertyDefinitionType::ChoiceProperty: {
+    const auto& choiceDefinition =
+      static_cast<const mdl::ChoicePropertyDefinition&>(definition);
+    writeBaseAttributes(PropertyDefinitionTag::Choice);
+    writeDefaultValue(writer, choiceDefinition, writeString);
+    writer.write(uint64_t(choiceDefinition.options().size()));
+    for (const auto& option : choiceDefinition.options())
+    {
+      writer.writeString(option.value());
+      writer.writeString(option.description());
+    }
+    break;
+  }
+  case mdl::PropertyDefinitionType::FlagsProperty: {
+    const auto& flagsDefinition =
+      static_cast<const mdl::FlagsPropertyDefinition&>(definition);
+    writeBaseAttributes(PropertyDefinitionTag::Flags);
+    writer.write(uint64_t(flagsDefinition.options().size()));
+    for (const auto& option : flagsDefinition.options())
+    {
+      writer.write(int64_t(option.value()));
+      writer.writeString(option.shortDescription());
+      writer.writeString(option.longDescription());
+      writer.writeBool(option.isDefault());
+    }
+    break;
+  }
+  }
+}
+
+std::shared_ptr<mdl::PropertyDefinition> readPropertyDefinition(Reader& reader)
+{
+  const auto tag = readEnum(reader, PropertyDefinitionTag::Flags);
+  auto key = readString(reader);
+  auto shortDescription = readString(reader);
+  auto longDescription = readString(reader);
+  const auto readOnly = reader.readBool<uint8_t>();
+
+  const auto readStringValue = [&]() { return readString(reader); };
+
+  switch (tag)
+  {
+  case PropertyDefinitionTag::TargetSource:
+    return std::make_shared<mdl::PropertyDefinition>(
+      std::move(key),
+      mdl::PropertyDefinitionType::TargetSourceProperty,
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly);
+  case PropertyDefinitionTag::TargetDestination:
+    return std::make_shared<mdl::PropertyDefinition>(
+      std::move(key),
+      mdl::PropertyDefinitionType::TargetDestinationProperty,
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly);
+  case PropertyDefinitionTag::String:
+    return std::make_shared<mdl::StringPropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly,
+      readOptional(reader, readStringValue));
+  case PropertyDefinitionTag::Unknown:
+    return std::make_shared<mdl::UnknownPropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly,
+      readOptional(reader, readStringValue));
+  case PropertyDefinitionTag::Boolean:
+    return std::make_shared<mdl::BooleanPropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly,
+      readOptional(reader, [&]() { return reader.readBool<uint8_t>(); }));
+  case PropertyDefinitionTag::Integer:
+    return std::make_shared<mdl::IntegerPropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly,
+      readOptional(reader, [&]() { return reader.read<int64_t, int>(); }));
+  case PropertyDefinitionTag::Float:
+    return std::make_shared<mdl::FloatPropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly,
+      readOptional(reader, [&]() { return reader.readFloat<float>(); }));
+  case PropertyDefinitionTag::Choice: {
+    auto defaultValue = readOptional(reader, readStringValue);
+    const auto optionCount = reader.readSize<uint64_t>();
+    auto options = mdl::ChoicePropertyOption::List{};
+    for (size_t i = 0; i < optionCount; ++i)
+    {
+      auto value = readString(reader);
+      auto description = readString(reader);
+      options.emplace_back(std::move(value), std::move(description));
+    }
+    return std::make_shared<mdl::ChoicePropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      std::move(options),
+      readOnly,
+      std::move(defaultValue));
+  }
+  case PropertyDefinitionTag::Flags: {
+    auto definition = std::make_shared<mdl::FlagsPropertyDefinition>(std::move(key));
+    const auto optionCount = reader.readSize<uint64_t>();
+    for (size_t i = 0; i < optionCount; ++i)
+    {
+      const auto value = reader.read<int64_t, int>();
+      auto optionShortDescription = readString(reader);
+      auto optionLongDescription = readString(reader);
+      const auto isDefault = reader.readBool<uint8_t>();
+      definition->addOption(
+        value,
+        std::move(optionShortDescription),
+        std::move(optionLongDescription),
+        isDefault);
+    }
+    return definition;
+  }
+  }
+
+  throw ReaderException{"Invalid property definition tag"};
+}
+
+void writeClassInfo(BinaryWriter& writer, const EntityDefinitionClassInfo& classInfo)
+{
+  writeEnum(writer, classInfo.type);
+  writeFileLocation(writer, classInfo.location);
+  writer.writeString(classInfo.name);
+  writeOptional(writer, classInfo.description, [&](const auto& description) {
+    writer.writeString(description);
+  });
+  writeOptional(writer, classInfo.color, [&](const auto& color) {
+    for (size_t i = 0; i < 4; ++i)
+    {
+      writer.write(color[i]);
+    }
+  });
+  writeOptional(writer, classInfo.size, [&](const auto& size) {
+    for (size_t i = 0; i < 3; ++i)
+    {
+      writer.write(size.min[i]);
+      writer.write(size.max[i]);
+    }
+  });
+  writeOptional(writer, classInfo.modelDefinition, [&](const auto& modelDefinition) {
+    writeExpression(writer, modelDefinition.expression());
+  });
+  writeOptional(writer, classInfo.decalDefinition, [&](const auto& decalDefinition) {
+    writeExpression(writer, decalDefinition.expression());
+  });
+
+  writer.write(uint64_t(classInfo.propertyDefinitions.size()));
+  for (const auto& propertyDefinition : classInfo.propertyDefinitions)
+  {
+    writePropertyDefinition(writer, *propertyDefinition);
+  }
+
+  writer.write(uint64_t(classInfo.superClasses.size()));
+  for (const auto& superClass : classInfo.superClasses)
+  {
+    writer.writeString(superClass);
+  }
+}
+
+EntityDefinitionClassInfo readClassInfo(Reader& reader)
+{
+  auto classInfo = EntityDefinitionClassInfo{};
+  classInfo.type = readEnum(reader, EntityDefinitionClassType::BaseClass);
+  classInfo.location = readFileLocation(reader);
+  classInfo.name = readString(reader);
+  classInfo.description = readOptional(reader, [&]() { return readString(reader); });
+  classInfo.color = readOptional(reader, [&]() {
+    auto color = Color{};
+    for (size_t i = 0; i < 4; ++i)
+    {
+      color[i] = reader.readFloat<float>();
+    }
+    return color;
+  });
+  classInfo.size = readOptional(reader, [&]() {
+    auto size = vm::bbox3d{};
+    for (size_t i = 0; i < 3; ++i)
+    {
+      size.min[i] = reader.readDouble<double>();
+      size.max[i] = reader.readDouble<double>();
+    }
+    return size;
+  });
+  classInfo.modelDefinition = readOptional(
+    reader, [&]() { return mdl::ModelDefinition{readExpression(reader)}; });
+  classInfo.decalDefinition = readOptional(
+    reader, [&]() { return mdl::DecalDefinition{readExpression(reader)}; });
+
+  const auto propertyDefinitionCount = reader.readSize<uint64_t>();
+  for (size_t i = 0; i < propertyDefinitionCount; ++i)
+  {
+    classInfo.propertyDefinitions.push_back(readPropertyDefinition(reader));
+  }
+
+  const auto superClassCount = reader.readSize<uint64_t>();
+  for (size_t i = 0; i < superClassCount; ++i)
+  {
+    classInfo.superClasses.push_back(readString(reader));
+  }
+
+  return classInfo;
+}
+
+} // namespace
+
+uint64_t hashFileContents(const std::string_view contents)
+{
+  constexpr auto OffsetBasis = uint64_t{14695981039346656037ull};
+  constexpr auto Prime = uint64_t{1099511628211ull};
+
+  auto hash = OffsetBasis;
+  for (const auto c : contents)
+  {
+    hash ^= uint64_t(static_cast<unsigned char>(c));
+    hash *= Prime;
+  }
+  return hash;
+}
+
+FileFingerprint makeFileFingerprint(
+  std::filesystem::path path,
+  const std::string_view contents,
+  const int64_t modificationTime)
+{
+  return FileFingerprint{
+    std::move(path),
+    uint64_t(contents.size()),
+    modificationTime,
+    hashFileContents(contents)};
+}
+
+ParseCache::ParseCache(std::filesystem::path directory)
+  : m_directory{std::move(directory)}
+{
+}
+
+const std::filesystem::path& ParseCache::directory() const
+{
+  return m_directory;
+}
+
+std::optional<std::vector<mdl::Quake3Shader>> ParseCache::readShaders(
+  const FileFingerprint& fingerprint) const
+{
+  return readEntry(
+    entryPath(m_directory, "shaders", fingerprint.path),
+    EntryType::Shaders,
+    [&](const auto& fingerprints) {
+      return fingerprints.size() == 1 && fingerprints.front() == fingerprint;
+    },
+    [](auto& reader) {
+      // every shader starts with three paths
+      const auto count = readCount(reader, 3 * sizeof(uint64_t));
+      auto shaders = std::vector<mdl::Quake3Shader>{};
+      shaders.reserve(count);
+      for (size_t i = 0; i < count; ++i)
+      {
+        shaders.push_back(readShader(reader));
+      }
+      return shaders;
+    });
+}
+
+void ParseCache::writeShaders(
+  const FileFingerprint& fingerprint, const std::vector<mdl::Quake3Shader>& shaders) const
+{
+  writeEntry(
+    entryPath(m_directory, "shaders", fingerprint.path),
+    EntryType::Shaders,
+    {fingerprint},
+    [&](auto& writer) {
+      writer.write(uint64_t(shaders.size()));
+      for (const auto& shader : shaders)
+      {
+        writeShader(writer, shader);
+      }
+    });
+}
+
+std::optional<mdl::Texture> ParseCache::readThumbnail(
+  const FileFingerprint& fingerprint) const
+{
+  return readEntry(
+    entryPath(m_directory, "thumbnails", fingerprint.path),
+    EntryType::Thumbnail,
+    [&](const auto& fingerprints) {
+      return fingerprints.size() == 1 && fingerprints.front() == fingerprint;
+    },
+    [](auto& reader) {
+      const auto width = reader.template readSize<uint64_t>();
+      const auto height = reader.template readSize<uint64_t>();
+      const auto format = reader.template read<uint32_t, GLenum>();
+      const auto mask = readEnum(reader, mdl::TextureMask::Off);
+
+      auto averageColor = Color{};
+      for (size_t i = 0; i < 4; ++i)
+      {
+        averageColor[i] = reader.template readFloat<float>();
+      }
+
+      const auto size = readCount(reader, 1);
+      if (
+        !isUncompressedFormat(format)
+        || !isImageSize(width, height, mdl::bytesPerPixelForFormat(format), size))
+      {
+        throw ReaderException{"Invalid thumbnail size"};
+      }
+
+      auto buffer = mdl::TextureBuffer{size};
+      reader.read(buffer.data(), size);
+
+      return mdl::Texture{
+        width,
+        height,
+        averageColor,
+        format,
+        mask,
+        mdl::NoEmbeddedDefaults{},
+        std::move(buffer)};
+    });
+}
+
+void ParseCache::writeThumbnail(
+  const FileFingerprint& fingerprint, const mdl::Texture& thumbnail) const
+{
+  const auto& buffers = thumbnail.buffersIfLoaded();
+  if (buffers.empty() || !isUncompressedFormat(thumbnail.format()))
+  {
+    return;
+  }
+
+  writeEntry(
+    entryPath(m_directory, "thumbnails", fingerprint.path),
+    EntryType::Thumbnail,
+    {fingerprint},
+    [&](auto& writer) {
+      writer.write(uint64_t(thumbnail.width()));
+      writer.write(uint64_t(thumbnail.height()));
+      writer.write(uint32_t(thumbnail.format()));
+      writeEnum(writer, thumbnail.mask());
+
+      const auto& averageColor = thumbnail.averageColor();
+      for (size_t i = 0; i < 4; ++i)
+      {
+        writer.write(averageColor[i]);
+      }
+
+      const auto& buffer = buffers.front();
+      writer.writeBytes(buffer.data(), buffer.size());
+    });
+}
+
+std::optional<std::vector<EntityDefinitionClassInfo>> ParseCache::readClassInfos(
+  const std::filesystem::path& path) const
+{
+  return readEntry(
+    entryPath(m_directory, "entities", path),
+    EntryType::ClassInfos,
+    [&](const auto& fingerprints) {
+      return !fingerprints.empty() && fingerprints.front().path == path
+             && std::all_of(fingerprints.begin(), fingerprints.end(), matchesDiskFile);
+    },
+    [](auto& reader) {
+      // every class info contains at least a line number and a name
+      const auto count = readCount(reader, 2 * sizeof(uint64_t));
+      auto classInfos = std::vector<EntityDefinitionClassInfo>{};
+      classInfos.reserve(count);
+      for (size_t i = 0; i < count; ++i)
+      {
+        classInfos.push_back(readClassInfo(reader));
+      }
+      return classInfos;
+    });
+}
+
+void ParseCache::writeClassInfos(
+  const std::vector<std::filesystem::path>& paths,
+  const std::vector<EntityDefinitionClassInfo>& classInfos) const
+{
+  if (paths.empty())
+  {
+    return;
+  }
+
+  auto fingerprints = std::vector<FileFingerprint>{};
+  for (const auto& path : paths)
+  {
+    if (auto fingerprint = makeDiskFileFingerprint(path))
+    {
+      fingerprints.push_back(std::move(*fingerprint));
+    }
+    else
+    {
+      // if we cannot fingerprint every file, we cannot validate the entry later
+      return;
+    }
+  }
+
+  writeEntry(
+    entryPath(m_directory, "entities", paths.front()),
+    EntryType::ClassInfos,
+    fingerprints,
+    [&](auto& writer) {
+      writer.write(uint64_t(classInfos.size()));
+      for (const auto& classInfo : classInfos)
+      {
+        writeClassInfo(writer, classInfo);
+      }
+    });
+}
+
+std::unique_ptr<mdl::WorldNode> ParseCache::readMap(
+  const FileFingerprint& fingerprint,
+  const std::vector<mdl::MapFormat>& mapFormats,
+  const vm::bbox3d& worldBounds,
+  const mdl::EntityPropertyConfig& entityPropertyConfig,
+  ParserStatus& status) const
+{
+  auto worldNode = readEntry(
+    entryPath(m_directory, "maps", fingerprint.path),
+    EntryType::Map,
+    [&](const auto& fingerprints) {
+      return fingerprints.size() == 1 && fingerprints.front() == fingerprint;
+    },
+    [&](auto& reader) {
+      return WorldReader::readCache(
+        reader, mapFormats, worldBounds, entityPropertyConfig, status);
+    });
+
+  return worldNode ? std::move(*worldNode) : nullptr;
+}
+
+std::future<void> ParseCache::writeMap(
+  const FileFingerprint& fingerprint, const mdl::WorldNode& worldNode) const
+{
+  auto stream = std::ostringstream{std::ios::out | std::ios::binary};
+  auto nodeWriter = NodeWriter{
+    worldNode, std::make_unique<MapCacheSerializer>(stream, worldNode.mapFormat())};
+  nodeWriter.writeMap();
+
+  return std::async(
+    std::launch::async,
+    [path = entryPath(m_directory, "maps", fingerprint.path),
+     fingerprint,
+     payload = std::move(stream).str()]() {
+      writeEntry(path, EntryType::Map, {fingerprint}, [&](auto& writer) {
+        writer.stream().write(payload.data(), std::streamsize(payload.size()));
+      });
+    });
+}
+
+void ParseCache::clear() const
+{
+  auto error = std::error_code{};
+  std::filesystem::remove_all(m_directory, error);
+}
+
+} // namespace tb::io
@@ -0,0 +1,165 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "kdl/reflection_decl.h"
+
+#include "vm/bbox.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace tb::mdl
+{
+struct EntityPropertyConfig;
+enum class MapFormat;
+class Quake3Shader;
+class Texture;
+class WorldNode;
+} // namespace tb::mdl
+
+namespace tb::io
+{
+struct EntityDefinitionClassInfo;
+class ParserStatus;
+
+/**
+ * Identifies the contents of a file that was parsed. A cached parse result is only used
+ * if all fingerprints it was created from still match.
+ *
+ * The modification time is only known for files that reside on the disk; it is 0 for
+ * files from a virtual file system.
+ */
+struct FileFingerprint
+{
+  std::filesystem::path path;
+  uint64_t size = 0;
+  int64_t modificationTime = 0;
+  uint64_t contentHash = 0;
+
+  kdl_reflect_decl(FileFingerprint, path, size, modificationTime, contentHash);
+};
+
+/**
+ * Computes a 64 bit FNV-1a hash of the given contents.
+ */
+uint64_t hashFileContents(std::string_view contents);
+
+FileFingerprint makeFileFingerprint(
+  std::filesystem::path path, std::string_view contents, int64_t modificationTime = 0);
+
+/**
+ * Stores parse results in a compact binary form in the given directory so that files
+ * which have not changed since they were last parsed need not be parsed again.
+ *
+ * The cache is best effort: failure to read a cache entry is treated as a cache miss, and
+ * failure to write one is ignored. Diagnostics that were emitted when the file was
+ * originally parsed are not replayed when a cached result is used.
+ *
+ * The cache can be used from multiple threads concurrently. If two threads write the
+ * entry for the same file at the same time, the entry written last wins.
+ */
+class ParseCache
+{
+private:
+  std::filesystem::path m_directory;
+
+public:
+  explicit ParseCache(std::filesystem::path directory);
+
+  const std::filesystem::path& directory() const;
+
+  /**
+   * Returns the cached shaders for the given file if the cache contains an entry that
+   * matches the given fingerprint.
+   */
+  std::optional<std::vector<mdl::Quake3Shader>> readShaders(
+    const FileFingerprint& fingerprint) const;
+
+  void writeShaders(
+    const FileFingerprint& fingerprint,
+    const std::vector<mdl::Quake3Shader>& shaders) const;
+
+  /**
+   * Returns the cached thumbnail for the given texture file if the cache contains an
+   * entry that matches the given fingerprint.
+   */
+  std::optional<mdl::Texture> readThumbnail(const FileFingerprint& fingerprint) const;
+
+  /**
+   * Stores the given thumbnail, which must be loaded and must use an uncompressed format.
+   */
+  void writeThumbnail(
+    const FileFingerprint& fingerprint, const mdl::Texture& thumbnail) const;
+
+  /**
+   * Returns the cached class infos for the entity definition file at the given path if
+   * neither that file nor any of the files it included have changed on the disk.
+   */
+  std::optional<std::vector<EntityDefinitionClassInfo>> readClassInfos(
+    const std::filesystem::path& path) const;
+
+  /**
+   * Stores the given class infos. The first of the given paths is the path of the entity
+   * definition file, the remaining paths are the files it included. All paths must be
+   * absolute.
+   */
+  void writeClassInfos(
+    const std::vector<std::filesystem::path>& paths,
+    const std::vector<EntityDefinitionClassInfo>& classInfos) const;
+
+  /**
+   * Returns the world stored for the map file with the given fingerprint if the cache
+   * contains an entry that matches it and that was created for one of the given map
+   * formats. Returns null otherwise.
+   *
+   * The returned world is identical to the world that was originally read from the file.
+   */
+  std::unique_ptr<mdl::WorldNode> readMap(
+    const FileFingerprint& fingerprint,
+    const std::vector<mdl::MapFormat>& mapFormats,
+    const vm::bbox3d& worldBounds,
+    const mdl::EntityPropertyConfig& entityPropertyConfig,
+    ParserStatus& status) const;
+
+  /**
+   * Stores the given world, which must have just been read from the map file with the
+   * given fingerprint and must not have been modified since.
+   *
+   * The world is serialized on the calling thread, which takes a fraction of the time it
+   * took to parse the map file. The entry is then written to the disk on a worker thread,
+   * and the returned future becomes ready once it has been written. The world can be
+   * modified or destroyed as soon as this function returns.
+   */
+  std::future<void> writeMap(
+    const FileFingerprint& fingerprint, const mdl::WorldNode& worldNode) const;
+
+  /**
+   * Deletes all cache entries.
+   */
+  void clear() const;
+};
+
+} // namespace tb::io
@@ -95,6 +95,11 @@ void ParserStatus::errorAndThrow(const std::string& str)
   throw ParserException(buildMessage(str));
 }
 
+void ParserStatus::forward(const LogLevel level, const std::string& message)
+{
+  doLog(level, m_prefix.empty() ? message : m_prefix + ": " + message);
+}
+
 void ParserStatus::log(
   const LogLevel level, const FileLocation& location, const std::string& str)
 {
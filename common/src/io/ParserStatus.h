@@ -57,6 +57,12 @@ public:
   void error(const std::string& str);
   [[noreturn]] void errorAndThrow(const std::string& str);
 
+  /**
+   * Logs a message that was already built by another parser status without a prefix,
+   * e.g. one that buffered the messages of a parser running on another thread.
+   */
+  void forward(LogLevel level, const std::string& message);
+
 private:
   void log(LogLevel level, const FileLocation& location, const std::string& str);
   std::string buildMessage(const FileLocation& location, const std::string& str) const;
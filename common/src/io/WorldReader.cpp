@@ -19,6 +19,8 @@
 
 #include "WorldReader.h"
 
+#include "Trace.h"
+#include "io/MapCacheSerializer.h"
 #include "io/ParserStatus.h"
 #include "mdl/BrushNode.h"
 #include "mdl/Entity.h"
@@ -29,6 +31,7 @@
 #include "mdl/WorldNode.h"
 
 #include "kdl/vector_set.h"
+#include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 
@@ -175,7 +178,34 @@ void setLinkIds(mdl::WorldNode& worldNode, ParserStatus& status)
 std::unique_ptr<mdl::WorldNode> WorldReader::read(
   const vm::bbox3d& worldBounds, ParserStatus& status)
 {
+  traceZone("WorldReader::read");
+
   readEntities(worldBounds, status);
+  return finishRead(status);
+}
+
+std::unique_ptr<mdl::WorldNode> WorldReader::readCache(
+  Reader& reader,
+  const std::vector<mdl::MapFormat>& mapFormats,
+  const vm::bbox3d& worldBounds,
+  const mdl::EntityPropertyConfig& entityPropertyConfig,
+  ParserStatus& status)
+{
+  traceZone("WorldReader::readCache");
+
+  const auto mapFormat = readMapCacheFormat(reader);
+  if (!kdl::vec_contains(mapFormats, mapFormat))
+  {
+    return nullptr;
+  }
+
+  auto worldReader = WorldReader{"", mapFormat, entityPropertyConfig};
+  worldReader.readCachedEntities(reader, worldBounds, status);
+  return worldReader.finishRead(status);
+}
+
+std::unique_ptr<mdl::WorldNode> WorldReader::finishRead(ParserStatus& status)
+{
   sanitizeLayerSortIndicies(*m_worldNode, status);
   setLinkIds(*m_worldNode, status);
   m_worldNode->rebuildNodeTree();
@@ -36,6 +36,7 @@ class WorldNode;
 namespace tb::io
 {
 class ParserStatus;
+class Reader;
 
 class WorldReaderException : public Exception
 {
@@ -79,6 +80,29 @@ public:
     const mdl::EntityPropertyConfig& entityPropertyConfig,
     ParserStatus& status);
 
+  /**
+   * Reads the world from a map cache written by MapCacheSerializer. The resulting world
+   * is identical to the world that was read from the map file the cache was created from.
+   *
+   * @param reader the reader to read the cache from
+   * @param mapFormats the map formats that the map file may be in
+   * @param worldBounds world bounds
+   * @param entityPropertyConfig the entity property config to use
+   * @param status status
+   * @return the world node, or null if the cache was created for a map format other than
+   * the given ones
+   * @throws ReaderException if the cache is malformed
+   */
+  static std::unique_ptr<mdl::WorldNode> readCache(
+    Reader& reader,
+    const std::vector<mdl::MapFormat>& mapFormats,
+    const vm::bbox3d& worldBounds,
+    const mdl::EntityPropertyConfig& entityPropertyConfig,
+    ParserStatus& status);
+
+private:
+  std::unique_ptr<mdl::WorldNode> finishRead(ParserStatus& status);
+
 private: // implement MapReader interface
   mdl::Node* onWorldNode(
     std::unique_ptr<mdl::WorldNode> worldNode, ParserStatus& status) override;
@@ -106,6 +106,20 @@ Result<Brush> Brush::create(const vm::bbox3d& worldBounds, std::vector<BrushFace
          | kdl::transform([&]() { return std::move(brush); });
 }
 
+Result<Brush> Brush::create(
+  const vm::bbox3d& worldBounds, std::vector<BrushFace> faces, BrushGeometry geometry)
+{
+  auto brush = Brush{std::move(faces)};
+  if (brush.adoptGeometry(
+        worldBounds, std::make_unique<BrushGeometry>(std::move(geometry))))
+  {
+    return brush;
+  }
+
+  return brush.updateGeometryFromFaces(worldBounds)
+         | kdl::transform([&]() { return std::move(brush); });
+}
+
 Result<void> Brush::updateGeometryFromFaces(const vm::bbox3d& worldBounds)
 {
   // First, add all faces to the brush geometry
@@ -161,6 +175,75 @@ Result<void> Brush::updateGeometryFromFaces(const vm::bbox3d& worldBounds)
   return kdl::void_success;
 }
 
+bool Brush::adoptGeometry(
+  const vm::bbox3d& worldBounds, std::unique_ptr<BrushGeometry> geometry)
+{
+  // Correct vertex positions and heal short edges as if the geometry was computed from
+  // the faces
+  geometry->correctVertexPositions();
+  if (
+    !geometry->polyhedron() || !geometry->closed() || !geometry->healEdges()
+    || geometry->faceCount() != m_faces.size()
+    || !worldBounds.contains(geometry->bounds()))
+  {
+    return false;
+  }
+
+  // Every vertex must be on or below the boundary of every face, and on the boundary of
+  // the faces it belongs to
+  auto faceIndex = size_t(0);
+  for (const BrushFaceGeometry* faceGeometry : geometry->faces())
+  {
+    const auto& boundary = m_faces[faceIndex++].boundary();
+
+    for (const auto* vertex : geometry->vertices())
+    {
+      if (
+        boundary.point_status(vertex->position(), AdoptGeometryEpsilon)
+        == vm::plane_status::above)
+      {
+        return false;
+      }
+    }
+
+    for (const auto* halfEdge : faceGeometry->boundary())
+    {
+      if (
+        boundary.point_status(halfEdge->origin()->position(), AdoptGeometryEpsilon)
+        != vm::plane_status::inside)
+      {
+        return false;
+      }
+    }
+  }
+
+  faceIndex = 0;
+  for (BrushFaceGeometry* faceGeometry : geometry->faces())
+  {
+    auto& face = m_faces[faceIndex++];
+    faceGeometry->setPlane(face.boundary());
+    face.setGeometry(faceGeometry);
+  }
+
+  // Order the faces and their geometries as if the geometry was computed from the faces
+  BrushFace::sortFaces(m_faces);
+
+  auto sortedFaceGeometries = BrushGeometry::FaceList{};
+  for (size_t i = 0u; i < m_faces.size(); ++i)
+  {
+    auto* faceGeometry = m_faces[i].geometry();
+    faceGeometry->setPayload(i);
+    sortedFaceGeometries.append(geometry->faces().remove(faceGeometry));
+  }
+  geometry->faces() = std::move(sortedFaceGeometries);
+
+  m_geometry = std::move(geometry);
+
+  assert(checkFaceLinks());
+
+  return true;
+}
+
 const vm::bbox3d& Brush::bounds() const
 {
   ensure(m_geometry != nullptr, "geometry is null");
@@ -639,7 +722,7 @@ static BrushGeometry snappedGeometry(const BrushGeometry& geometry, const double
     points.push_back(snapToF * vm::round(vertex->position() / snapToF));
   }
 
-  return BrushGeometry(std::move(points));
+  return BrushGeometry{geometry, std::move(points)};
 }
 
 bool Brush::canSnapVertices(
@@ -857,7 +940,7 @@ Brush::CanMoveVerticesResult Brush::doCanMoveVertices(
 
   BrushGeometry remaining(remainingPoints);
   BrushGeometry moving(movingPoints);
-  BrushGeometry result(resultPoints);
+  BrushGeometry result(*m_geometry, std::move(resultPoints));
 
   // Will the result go out of world bounds?
   if (!worldBounds.contains(result.bounds()))
@@ -958,7 +1041,7 @@ Result<void> Brush::doMoveVertices(
     }
   }
 
-  BrushGeometry newGeometry(newVertices);
+  const BrushGeometry newGeometry(*m_geometry, std::move(newVertices));
 
   using VecMap = std::map<vm::vec3d, vm::vec3d>;
   VecMap vertexMapping;
@@ -1118,6 +1201,13 @@ Result<void> Brush::updateFacesFromGeometry(
   }
 
   m_faces = std::move(newFaces);
+
+  // The faces were derived from the new geometry, so it can usually be adopted instead of
+  // being recomputed from the faces
+  if (adoptGeometry(worldBounds, std::make_unique<BrushGeometry>(newGeometry)))
+  {
+    return kdl::void_success;
+  }
   return updateGeometryFromFaces(worldBounds);
 }
 
@@ -1131,12 +1221,25 @@ std::vector<Result<Brush>> Brush::subtract(
 
   for (const auto* subtrahend : subtrahends)
   {
+    // disjoint subtrahends leave the fragments unchanged, so skip them early
+    if (!bounds().intersects(subtrahend->bounds()))
+    {
+      continue;
+    }
+
     auto nextResults = std::vector<BrushGeometry>{};
 
-    for (const BrushGeometry& fragment : result)
+    for (BrushGeometry& fragment : result)
     {
-      auto subFragments = fragment.subtract(*subtrahend->m_geometry);
-      nextResults = kdl::vec_concat(std::move(nextResults), std::move(subFragments));
+      if (fragment.bounds().intersects(subtrahend->bounds()))
+      {
+        auto subFragments = fragment.subtract(*subtrahend->m_geometry);
+        nextResults = kdl::vec_concat(std::move(nextResults), std::move(subFragments));
+      }
+      else
+      {
+        nextResults.push_back(std::move(fragment));
+      }
     }
 
     result = std::move(nextResults);
@@ -1177,6 +1280,18 @@ Result<void> Brush::transform(
     }
   }
 
+  // Transforming the geometry along with the faces is much cheaper than recomputing it,
+  // but a mirroring transformation would invert the orientation of its faces
+  if (m_geometry && vm::compute_determinant(transformation) > 0.0)
+  {
+    auto geometry = std::make_unique<BrushGeometry>(*m_geometry);
+    geometry->transform(transformation);
+    if (adoptGeometry(worldBounds, std::move(geometry)))
+    {
+      return kdl::void_success;
+    }
+  }
+
   return updateGeometryFromFaces(worldBounds);
 }
 
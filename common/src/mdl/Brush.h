@@ -25,6 +25,7 @@
 #include "kdl/reflection_decl.h"
 
 #include "vm/bbox.h"
+#include "vm/constants.h"
 #include "vm/mat.h"
 #include "vm/plane.h"
 #include "vm/polygon.h"
@@ -53,6 +54,17 @@ private:
    */
   constexpr static double CloseVertexEpsilon = static_cast<double>(0.01);
 
+  /**
+   * Epsilon value to use when checking whether a geometry matches the faces of a brush.
+   * A geometry computed from the faces has its vertices within the point status epsilon
+   * of the face boundaries before their positions are corrected, and the correction moves
+   * a vertex by less than twice the correction epsilon. An adopted geometry must not
+   * deviate from the faces any further.
+   */
+  constexpr static double AdoptGeometryEpsilon =
+    vm::constants<double>::point_status_epsilon()
+    + 2.0 * vm::constants<double>::correct_epsilon();
+
 public:
   using VertexList = BrushVertexList;
   using EdgeList = BrushEdgeList;
@@ -77,11 +89,35 @@ public:
   static Result<Brush> create(
     const vm::bbox3d& worldBounds, std::vector<BrushFace> faces);
 
+  /**
+   * Creates a brush from the given faces and a geometry that is already known for them,
+   * e.g. one that was restored from a cache. The i-th face of the geometry must belong to
+   * the i-th of the given faces.
+   *
+   * The geometry is adopted if a cheap check confirms that it is a closed convex
+   * polyhedron whose faces lie on the boundaries of the given faces. Otherwise, the
+   * geometry is computed from the faces as if the brush was created without it.
+   *
+   * @param worldBounds the world bounds
+   * @param faces the brush faces
+   * @param geometry the geometry of the brush
+   * @return the brush or an error if the geometry cannot be computed from the faces
+   */
+  static Result<Brush> create(
+    const vm::bbox3d& worldBounds, std::vector<BrushFace> faces, BrushGeometry geometry);
+
 private:
   explicit Brush(std::vector<BrushFace> faces);
 
   Result<void> updateGeometryFromFaces(const vm::bbox3d& worldBounds);
 
+  /**
+   * Adopts the given geometry if it matches the faces of this brush. Returns false and
+   * leaves this brush unchanged if it doesn't.
+   */
+  bool adoptGeometry(
+    const vm::bbox3d& worldBounds, std::unique_ptr<BrushGeometry> geometry);
+
 public:
   const vm::bbox3d& bounds() const;
 
@@ -291,7 +327,7 @@ public:
    * modifying `this`.
    *
    * @param subtrahends brushes to subtract from `this`. The passed-in brushes are not
-   * modified.
+   * modified. Subtrahends whose bounds do not intersect the bounds of `this` are skipped.
    * @return the subtraction result framents as Brushes, or Errors for any fragments
    * which were invalid. Note, the subtraction result should still be usable even if some
    * Errors are returned. It's a hint to the user to double check the result, and
@@ -322,6 +358,9 @@ public:
   /**
    * Applies the given transformation to this brush.
    *
+   * Unless the transformation mirrors the brush, its geometry is transformed along with
+   * its faces instead of being computed from the transformed faces.
+   *
    * If the brush becomes invalid, an error is returned.
    *
    * @param worldBounds the world bounds
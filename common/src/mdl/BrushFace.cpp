@@ -794,6 +794,11 @@ size_t BrushFace::lineNumber() const
   return m_lineNumber;
 }
 
+size_t BrushFace::lineCount() const
+{
+  return m_lineCount;
+}
+
 void BrushFace::setFilePosition(const size_t lineNumber, const size_t lineCount) const
 {
   m_lineNumber = lineNumber;
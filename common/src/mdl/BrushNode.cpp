@@ -36,22 +36,36 @@
 #include "render/BrushRendererBrushCache.h"
 
 #include "kdl/overload.h"
+#include "kdl/vector_utils.h"
 
 #include "vm/intersection.h"
 #include "vm/util.h"
 #include "vm/vec.h"
 
 #include <algorithm>
+#include <cassert>
 #include <string>
 #include <vector>
 
 namespace tb::mdl
 {
+namespace
+{
+
+BrushPlanes makeBrushPlanes(const Brush& brush)
+{
+  return BrushPlanes{kdl::vec_transform(
+    brush.faces(), [](const auto& face) { return face.boundary(); })};
+}
+
+} // namespace
+
 const HitType::Type BrushNode::BrushHitType = HitType::freeType();
 
 BrushNode::BrushNode(Brush brush)
   : m_brushRendererBrushCache(std::make_unique<render::BrushRendererBrushCache>())
   , m_brush(std::move(brush))
+  , m_planes{makeBrushPlanes(m_brush)}
 {
   clearSelectedFaces();
 }
@@ -96,10 +110,12 @@ Brush BrushNode::setBrush(Brush brush)
 
   using std::swap;
   swap(m_brush, brush);
+  m_planes = makeBrushPlanes(m_brush);
 
   updateSelectedFaceCount();
   invalidateIssues();
   invalidateVertexCache();
+  invalidateStateRevision();
 
   return brush;
 }
@@ -124,6 +140,7 @@ void BrushNode::deselectFace(const size_t faceIndex)
 void BrushNode::updateFaceTags(const size_t faceIndex, TagManager& tagManager)
 {
   m_brush.face(faceIndex).updateTags(tagManager);
+  invalidateStateRevision();
 }
 
 void BrushNode::setFaceMaterial(const size_t faceIndex, Material* material)
@@ -134,6 +151,23 @@ void BrushNode::setFaceMaterial(const size_t faceIndex, Material* material)
   invalidateVertexCache();
 }
 
+void BrushNode::setFaceMaterials(const std::vector<Material*>& materials)
+{
+  assert(materials.size() == m_brush.faceCount());
+
+  auto changed = false;
+  for (size_t i = 0; i < materials.size(); ++i)
+  {
+    changed |= m_brush.face(i).setMaterial(materials[i]);
+  }
+
+  if (changed)
+  {
+    invalidateIssues();
+    invalidateVertexCache();
+  }
+}
+
 static bool containsPatch(const Brush& brush, const PatchGrid& grid)
 {
   if (!brush.bounds().contains(grid.bounds))
@@ -366,13 +400,33 @@ std::optional<std::tuple<double, size_t>> BrushNode::findFaceHit(
 {
   if (vm::intersect_ray_bbox(ray, logicalBounds()))
   {
-    for (size_t i = 0u; i < m_brush.faceCount(); ++i)
+    if (const auto entryDistance = m_planes.findEntryDistance(ray))
     {
-      const auto& face = m_brush.face(i);
-      if (const auto distance = face.intersectWithRay(ray))
+      const auto findFaceHitIf =
+        [&](const auto& isCandidate) -> std::optional<std::tuple<double, size_t>> {
+        for (size_t i = 0u; i < m_brush.faceCount(); ++i)
+        {
+          if (isCandidate(i))
+          {
+            if (const auto distance = m_brush.face(i).intersectWithRay(ray))
+            {
+              return std::tuple{*distance, i};
+            }
+          }
+        }
+        return std::nullopt;
+      };
+
+      // Only the faces through which the ray enters the brush can be hit. If the ray
+      // grazes an edge or a vertex, the tolerant entry test may select the wrong faces,
+      // so we fall back to testing all faces.
+      if (const auto hit = findFaceHitIf([&](const size_t i) {
+            return m_planes.isEntryPlane(i, ray, *entryDistance);
+          }))
       {
-        return std::tuple{*distance, i};
+        return hit;
       }
+      return findFaceHitIf([](const size_t) { return true; });
     }
   }
   return std::nullopt;
@@ -410,6 +464,7 @@ void BrushNode::initializeTags(TagManager& tagManager)
   {
     face.initializeTags(tagManager);
   }
+  invalidateStateRevision();
 }
 
 void BrushNode::clearTags()
@@ -419,6 +474,7 @@ void BrushNode::clearTags()
     face.clearTags();
   }
   Taggable::clearTags();
+  invalidateStateRevision();
 }
 
 void BrushNode::updateTags(TagManager& tagManager)
@@ -428,6 +484,7 @@ void BrushNode::updateTags(TagManager& tagManager)
     face.updateTags(tagManager);
   }
   Taggable::updateTags(tagManager);
+  invalidateStateRevision();
 }
 
 bool BrushNode::allFacesHaveAnyTagInMask(TagType::Type tagMask) const
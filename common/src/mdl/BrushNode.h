@@ -22,6 +22,7 @@
 #include "Macros.h"
 #include "mdl/Brush.h"
 #include "mdl/BrushGeometry.h"
+#include "mdl/BrushPlanes.h"
 #include "mdl/HitType.h"
 #include "mdl/Node.h"
 #include "mdl/Object.h"
@@ -60,6 +61,7 @@ private:
   mutable std::unique_ptr<render::BrushRendererBrushCache>
     m_brushRendererBrushCache; // unique_ptr for breaking header dependencies
   Brush m_brush;               // must be destroyed before the brush renderer cache
+  BrushPlanes m_planes;
   size_t m_selectedFaceCount = 0u;
 
 public:
@@ -81,6 +83,13 @@ public:
 
   void setFaceMaterial(size_t faceIndex, Material* material);
 
+  /**
+   * Sets the material of every face to the material at the same index in the given
+   * vector, which must contain one material per face. The node's caches are invalidated
+   * at most once, and only if the material of any face changed.
+   */
+  void setFaceMaterials(const std::vector<Material*>& materials);
+
   bool contains(const Node* node) const;
   bool intersects(const Node* node) const;
 
@@ -0,0 +1,119 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BrushPlanes.h"
+
+#include "vm/constants.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace tb::mdl
+{
+
+namespace
+{
+constexpr auto Epsilon = vm::constants<double>::almost_zero();
+} // namespace
+
+BrushPlanes::BrushPlanes() = default;
+
+BrushPlanes::BrushPlanes(const std::vector<vm::plane3d>& planes)
+{
+  m_normalX.reserve(planes.size());
+  m_normalY.reserve(planes.size());
+  m_normalZ.reserve(planes.size());
+  m_distance.reserve(planes.size());
+
+  for (const auto& plane : planes)
+  {
+    m_normalX.push_back(plane.normal.x());
+    m_normalY.push_back(plane.normal.y());
+    m_normalZ.push_back(plane.normal.z());
+    m_distance.push_back(plane.distance);
+  }
+}
+
+size_t BrushPlanes::size() const
+{
+  return m_distance.size();
+}
+
+std::optional<double> BrushPlanes::findEntryDistance(const vm::ray3d& ray) const
+{
+  const auto ox = ray.origin.x();
+  const auto oy = ray.origin.y();
+  const auto oz = ray.origin.z();
+  const auto dx = ray.direction.x();
+  const auto dy = ray.direction.y();
+  const auto dz = ray.direction.z();
+
+  const auto* normalX = m_normalX.data();
+  const auto* normalY = m_normalY.data();
+  const auto* normalZ = m_normalZ.data();
+  const auto* distance = m_distance.data();
+
+  auto entryDistance = -std::numeric_limits<double>::infinity();
+  auto exitDistance = std::numeric_limits<double>::infinity();
+  auto parallelAndOutside = false;
+
+  // This loop is branch free so that the compiler can vectorize it. The distance is
+  // meaningless for planes parallel to the ray, but it is masked out for those.
+  const auto count = size();
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto cos = normalX[i] * dx + normalY[i] * dy + normalZ[i] * dz;
+    const auto offset =
+      distance[i] - (normalX[i] * ox + normalY[i] * oy + normalZ[i] * oz);
+    const auto t = offset / cos;
+
+    entryDistance = cos < 0.0 ? std::max(entryDistance, t) : entryDistance;
+    exitDistance = cos > 0.0 ? std::min(exitDistance, t) : exitDistance;
+    parallelAndOutside |= cos == 0.0 && offset < -Epsilon;
+  }
+
+  if (
+    parallelAndOutside || entryDistance > exitDistance + Epsilon
+    || entryDistance < -Epsilon)
+  {
+    return std::nullopt;
+  }
+
+  return entryDistance;
+}
+
+bool BrushPlanes::isEntryPlane(
+  const size_t index, const vm::ray3d& ray, const double entryDistance) const
+{
+  const auto cos = m_normalX[index] * ray.direction.x()
+                   + m_normalY[index] * ray.direction.y()
+                   + m_normalZ[index] * ray.direction.z();
+  if (cos >= 0.0)
+  {
+    return false;
+  }
+
+  const auto offset =
+    m_distance[index]
+    - (m_normalX[index] * ray.origin.x() + m_normalY[index] * ray.origin.y()
+       + m_normalZ[index] * ray.origin.z());
+  return offset / cos >= entryDistance - Epsilon;
+}
+
+} // namespace tb::mdl
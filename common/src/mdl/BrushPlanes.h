@@ -0,0 +1,69 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "vm/plane.h"
+#include "vm/ray.h"
+
+#include <optional>
+#include <vector>
+
+namespace tb::mdl
+{
+
+/**
+ * Stores the boundary planes of a convex brush in a compact structure of arrays so that
+ * rays can be intersected with the brush without visiting its geometry.
+ *
+ * The planes are stored in the same order as the faces of the brush they were created
+ * from, so a plane index is also a face index.
+ */
+class BrushPlanes
+{
+private:
+  std::vector<double> m_normalX;
+  std::vector<double> m_normalY;
+  std::vector<double> m_normalZ;
+  std::vector<double> m_distance;
+
+public:
+  BrushPlanes();
+  explicit BrushPlanes(const std::vector<vm::plane3d>& planes);
+
+  size_t size() const;
+
+  /**
+   * Intersects the given ray with the convex hull bounded by the planes and returns the
+   * distance at which the ray enters the hull.
+   *
+   * The test is tolerant, so it may report a hit for rays which miss the hull by a small
+   * margin, but it never misses a ray which enters the hull through the interior of a
+   * face. Returns nothing if the ray misses the hull or if its origin is inside the hull.
+   */
+  std::optional<double> findEntryDistance(const vm::ray3d& ray) const;
+
+  /**
+   * Indicates whether the given ray enters the hull through the plane at the given index,
+   * given the entry distance returned by findEntryDistance.
+   */
+  bool isEntryPlane(size_t index, const vm::ray3d& ray, double entryDistance) const;
+};
+
+} // namespace tb::mdl
@@ -76,6 +76,11 @@ DecalDefinition::DecalDefinition(el::ExpressionNode expression)
 {
 }
 
+const el::ExpressionNode& DecalDefinition::expression() const
+{
+  return m_expression;
+}
+
 void DecalDefinition::append(const DecalDefinition& other)
 {
   const auto location = m_expression.location();
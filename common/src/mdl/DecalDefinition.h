@@ -55,6 +55,8 @@ public:
   explicit DecalDefinition(const FileLocation& location);
   explicit DecalDefinition(el::ExpressionNode expression);
 
+  const el::ExpressionNode& expression() const;
+
   void append(const DecalDefinition& other);
 
   /**
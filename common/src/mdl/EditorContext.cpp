@@ -47,6 +47,8 @@ void EditorContext::reset()
   m_hiddenEntityDefinitions.reset();
   m_blockSelection = false;
   m_currentGroup = nullptr;
+  invalidateCachedNodeStates();
+  m_cachedNodeStates.shrink_to_fit();
 }
 
 TagType::Type EditorContext::hiddenTags() const
@@ -59,6 +61,7 @@ void EditorContext::setHiddenTags(const TagType::Type hiddenTags)
   if (hiddenTags != m_hiddenTags)
   {
     m_hiddenTags = hiddenTags;
+    invalidateCachedNodeStates();
     editorContextDidChangeNotifier();
   }
 }
@@ -158,7 +161,7 @@ bool EditorContext::visible(const mdl::GroupNode* groupNode) const
   {
     return false;
   }
-  return groupNode->visible();
+  return cachedNodeState(groupNode).visible;
 }
 
 bool EditorContext::visible(const mdl::EntityNode* entityNode) const
@@ -173,12 +176,7 @@ bool EditorContext::visible(const mdl::EntityNode* entityNode) const
     return anyChildVisible(entityNode);
   }
 
-  if (!entityNode->visible())
-  {
-    return false;
-  }
-
-  if (entityNode->entity().pointEntity() && !pref(Preferences::ShowPointEntities))
+  if (!pref(Preferences::ShowPointEntities))
   {
     return false;
   }
@@ -188,7 +186,7 @@ bool EditorContext::visible(const mdl::EntityNode* entityNode) const
     return false;
   }
 
-  return true;
+  return cachedNodeState(entityNode).visible;
 }
 
 bool EditorContext::visible(const mdl::BrushNode* brushNode) const
@@ -208,17 +206,13 @@ bool EditorContext::visible(const mdl::BrushNode* brushNode) const
     return false;
   }
 
-  if (brushNode->allFacesHaveAnyTagInMask(m_hiddenTags))
-  {
-    return false;
-  }
-
   if (entityDefinitionHidden(brushNode->entity()))
   {
     return false;
   }
 
-  return brushNode->visible();
+  const auto& cachedState = cachedNodeState(brushNode);
+  return !cachedState.allFacesHidden && cachedState.visible;
 }
 
 bool EditorContext::visible(
@@ -239,7 +233,7 @@ bool EditorContext::visible(const mdl::PatchNode* patchNode) const
     return false;
   }
 
-  return patchNode->visible();
+  return cachedNodeState(patchNode).visible;
 }
 
 bool EditorContext::anyChildVisible(const mdl::Node* node) const
@@ -249,6 +243,43 @@ bool EditorContext::anyChildVisible(const mdl::Node* node) const
     children, [this](const Node* child) { return visible(child); });
 }
 
+template <typename N>
+const EditorContext::CachedNodeState& EditorContext::cachedNodeState(const N* node) const
+{
+  const auto nodeId = node->nodeId();
+  if (nodeId >= m_cachedNodeStates.size())
+  {
+    m_cachedNodeStates.resize(nodeId + 1);
+  }
+
+  auto& cachedState = m_cachedNodeStates[nodeId];
+  if (cachedState.revision != node->stateRevision())
+  {
+    cachedState = CachedNodeState{
+      node->stateRevision(),
+      node->visible(),
+      node->editable() && inOpenGroup(node),
+      allFacesHidden(node),
+    };
+  }
+  return cachedState;
+}
+
+bool EditorContext::allFacesHidden(const mdl::Node*) const
+{
+  return false;
+}
+
+bool EditorContext::allFacesHidden(const mdl::BrushNode* brushNode) const
+{
+  return brushNode->allFacesHaveAnyTagInMask(m_hiddenTags);
+}
+
+void EditorContext::invalidateCachedNodeStates()
+{
+  m_cachedNodeStates.clear();
+}
+
 bool EditorContext::editable(const mdl::Node* node) const
 {
   return node->editable();
@@ -282,19 +313,19 @@ bool EditorContext::selectable(const mdl::LayerNode*) const
 
 bool EditorContext::selectable(const mdl::GroupNode* groupNode) const
 {
-  return visible(groupNode) && editable(groupNode) && !groupNode->opened()
-         && inOpenGroup(groupNode);
+  return visible(groupNode) && cachedNodeState(groupNode).editableInOpenGroup
+         && !groupNode->opened();
 }
 
 bool EditorContext::selectable(const mdl::EntityNode* entityNode) const
 {
-  return visible(entityNode) && editable(entityNode) && !entityNode->hasChildren()
-         && inOpenGroup(entityNode);
+  return visible(entityNode) && cachedNodeState(entityNode).editableInOpenGroup
+         && !entityNode->hasChildren();
 }
 
 bool EditorContext::selectable(const mdl::BrushNode* brushNode) const
 {
-  return visible(brushNode) && editable(brushNode) && inOpenGroup(brushNode);
+  return visible(brushNode) && cachedNodeState(brushNode).editableInOpenGroup;
 }
 
 bool EditorContext::selectable(
@@ -305,7 +336,7 @@ bool EditorContext::selectable(
 
 bool EditorContext::selectable(const mdl::PatchNode* patchNode) const
 {
-  return visible(patchNode) && editable(patchNode) && inOpenGroup(patchNode);
+  return visible(patchNode) && cachedNodeState(patchNode).editableInOpenGroup;
 }
 
 bool EditorContext::canChangeSelection() const
@@ -24,6 +24,9 @@
 
 #include "kdl/bitset.h"
 
+#include <cstdint>
+#include <vector>
+
 namespace tb::mdl
 {
 class EntityDefinition;
@@ -41,6 +44,19 @@ class WorldNode;
 class EditorContext
 {
 private:
+  /**
+   * The parts of a node's visibility and selectability that require visiting its
+   * ancestors or, for brushes, its faces. It is valid only as long as the node's state
+   * revision matches the revision it was computed at.
+   */
+  struct CachedNodeState
+  {
+    uint64_t revision = 0;
+    bool visible = false;
+    bool editableInOpenGroup = false;
+    bool allFacesHidden = false;
+  };
+
   TagType::Type m_hiddenTags;
   kdl::bitset m_hiddenEntityDefinitions;
 
@@ -48,6 +64,10 @@ private:
 
   mdl::GroupNode* m_currentGroup;
 
+  // indexed by node id, not synchronized; node ids are reused, so this grows only with
+  // the highest number of nodes that existed at the same time
+  mutable std::vector<CachedNodeState> m_cachedNodeStates;
+
 public:
   Notifier<> editorContextDidChangeNotifier;
 
@@ -84,6 +104,12 @@ public:
 private:
   bool anyChildVisible(const mdl::Node* node) const;
 
+  template <typename N>
+  const CachedNodeState& cachedNodeState(const N* node) const;
+  bool allFacesHidden(const mdl::Node* node) const;
+  bool allFacesHidden(const mdl::BrushNode* brushNode) const;
+  void invalidateCachedNodeStates();
+
 public:
   bool editable(const mdl::Node* node) const;
   bool editable(const mdl::BrushNode* brushNode, const mdl::BrushFace& face) const;
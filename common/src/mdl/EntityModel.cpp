@@ -21,6 +21,7 @@
 
 #include "mdl/MaterialCollection.h"
 #include "mdl/Texture.h"
+#include "octree.h"
 #include "render/IndexRangeMap.h"
 #include "render/MaterialIndexRangeMap.h"
 #include "render/MaterialIndexRangeRenderer.h"
@@ -35,6 +36,8 @@
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <functional>
+#include <mutex>
 #include <string>
 
 namespace tb::mdl
@@ -78,155 +81,7 @@ std::ostream& operator<<(std::ostream& lhs, const Orientation rhs)
 }
 
 
-// EntityModelFrame
-
-kdl_reflect_impl(EntityModelFrame);
-
-EntityModelFrame::EntityModelFrame(
-  const size_t index, std::string name, const vm::bbox3f& bounds)
-  : m_index{index}
-  , m_name{std::move(name)}
-  , m_bounds{bounds}
-  , m_spacialTree{16.0f}
-{
-}
-
-size_t EntityModelFrame::index() const
-{
-  return m_index;
-}
-
-size_t EntityModelFrame::skinOffset() const
-{
-  return m_skinOffset;
-}
-
-void EntityModelFrame::setSkinOffset(const size_t skinOffset)
-{
-  m_skinOffset = skinOffset;
-}
-
-const std::string& EntityModelFrame::name() const
-{
-  return m_name;
-}
-
-const vm::bbox3f& EntityModelFrame::bounds() const
-{
-  return m_bounds;
-}
-
-std::optional<float> EntityModelFrame::intersect(const vm::ray3f& ray) const
-{
-  auto closestDistance = std::optional<float>{};
-
-  const auto candidates = m_spacialTree.find_intersectors(ray);
-  for (const auto triNum : candidates)
-  {
-    const auto& p1 = m_tris[triNum * 3 + 0];
-    const auto& p2 = m_tris[triNum * 3 + 1];
-    const auto& p3 = m_tris[triNum * 3 + 2];
-    closestDistance =
-      vm::safe_min(closestDistance, vm::intersect_ray_triangle(ray, p1, p2, p3));
-  }
-
-  return closestDistance;
-}
-
-void EntityModelFrame::addToSpacialTree(
-  const std::vector<EntityModelVertex>& vertices,
-  const render::PrimType primType,
-  const size_t index,
-  const size_t count)
-{
-  switch (primType)
-  {
-  case render::PrimType::Points:
-  case render::PrimType::Lines:
-  case render::PrimType::LineStrip:
-  case render::PrimType::LineLoop:
-    break;
-  case render::PrimType::Triangles: {
-    assert(count % 3 == 0);
-    m_tris.reserve(m_tris.size() + count);
-    for (size_t i = 0; i < count; i += 3)
-    {
-      auto bounds = vm::bbox3f::builder{};
-      const auto& p1 = render::getVertexComponent<0>(vertices[index + i + 0]);
-      const auto& p2 = render::getVertexComponent<0>(vertices[index + i + 1]);
-      const auto& p3 = render::getVertexComponent<0>(vertices[index + i + 2]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const auto triIndex = m_tris.size() / 3u;
-      m_tris.push_back(p1);
-      m_tris.push_back(p2);
-      m_tris.push_back(p3);
-      m_spacialTree.insert(bounds.bounds(), triIndex);
-    }
-    break;
-  }
-  case render::PrimType::Polygon:
-  case render::PrimType::TriangleFan: {
-    assert(count > 2);
-    m_tris.reserve(m_tris.size() + (count - 2) * 3);
-
-    const auto& p1 = render::getVertexComponent<0>(vertices[index]);
-    for (size_t i = 1; i < count - 1; ++i)
-    {
-      auto bounds = vm::bbox3f::builder{};
-      const auto& p2 = render::getVertexComponent<0>(vertices[index + i]);
-      const auto& p3 = render::getVertexComponent<0>(vertices[index + i + 1]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const auto triIndex = m_tris.size() / 3u;
-      m_tris.push_back(p1);
-      m_tris.push_back(p2);
-      m_tris.push_back(p3);
-      m_spacialTree.insert(bounds.bounds(), triIndex);
-    }
-    break;
-  }
-  case render::PrimType::Quads:
-  case render::PrimType::QuadStrip:
-  case render::PrimType::TriangleStrip: {
-    assert(count > 2);
-    m_tris.reserve(m_tris.size() + (count - 2) * 3);
-    for (size_t i = 0; i < count - 2; ++i)
-    {
-      auto bounds = vm::bbox3f::builder{};
-      const auto& p1 = render::getVertexComponent<0>(vertices[index + i + 0]);
-      const auto& p2 = render::getVertexComponent<0>(vertices[index + i + 1]);
-      const auto& p3 = render::getVertexComponent<0>(vertices[index + i + 2]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const auto triIndex = m_tris.size() / 3u;
-      if (i % 2 == 0)
-      {
-        m_tris.push_back(p1);
-        m_tris.push_back(p2);
-        m_tris.push_back(p3);
-      }
-      else
-      {
-        m_tris.push_back(p1);
-        m_tris.push_back(p3);
-        m_tris.push_back(p2);
-      }
-      m_spacialTree.insert(bounds.bounds(), triIndex);
-    }
-    break;
-  }
-    switchDefault();
-  }
-}
-
-// EntityModelData::Mesh
+// EntityModelMesh
 
 /**
  * The mesh associated with a frame and a surface.
@@ -234,50 +89,33 @@ void EntityModelFrame::addToSpacialTree(
 class EntityModelMesh
 {
 protected:
-  std::vector<EntityModelVertex> m_vertices;
-
   kdl_reflect_inline_empty(EntityModelMesh);
 
-  /**
-   * Creates a new frame mesh that uses the given vertices.
-   *
-   * @param vertices the vertices
-   */
-  explicit EntityModelMesh(std::vector<EntityModelVertex> vertices)
-    : m_vertices{std::move(vertices)}
-  {
-  }
-
 public:
+  using PrimitiveFunc = std::function<void(
+    const std::vector<EntityModelVertex>& vertices,
+    render::PrimType primType,
+    size_t index,
+    size_t count)>;
+
   virtual ~EntityModelMesh() = default;
 
-public:
   /**
    * Returns a renderer that renders this mesh with the given material.
    *
    * @param skin the material to use when rendering the mesh
    * @return the renderer
    */
-  std::unique_ptr<render::MaterialIndexRangeRenderer> buildRenderer(
-    const Material* skin) const
-  {
-    const auto vertexArray = render::VertexArray::ref(m_vertices);
-    return doBuildRenderer(skin, vertexArray);
-  }
+  virtual std::unique_ptr<render::MaterialIndexRangeRenderer> buildRenderer(
+    const Material* skin) const = 0;
 
-private:
   /**
-   * Creates and returns the actual mesh renderer
-   *
-   * @param skin the skin to use when rendering the mesh
-   * @param vertices the vertices associated with this mesh
-   * @return the renderer
+   * Calls the given function for every primitive of this mesh.
    */
-  virtual std::unique_ptr<render::MaterialIndexRangeRenderer> doBuildRenderer(
-    const Material* skin, const render::VertexArray& vertices) const = 0;
+  virtual void forEachPrimitive(const PrimitiveFunc& func) const = 0;
 };
 
-// EntityModelData::IndexedMesh
+// EntityModelIndexedMesh
 
 namespace
 {
@@ -288,6 +126,7 @@ namespace
 class EntityModelIndexedMesh : public EntityModelMesh
 {
 private:
+  std::vector<EntityModelVertex> m_vertices;
   render::IndexRangeMap m_indices;
 
   kdl_reflect_inline_empty(EntityModelIndexedMesh);
@@ -296,29 +135,30 @@ public:
   /**
    * Creates a new frame mesh with the given vertices and indices.
    *
-   * @param frame the frame to which this mesh belongs
    * @param vertices the vertices
    * @param indices the indices
    */
   EntityModelIndexedMesh(
-    EntityModelFrame& frame,
-    std::vector<EntityModelVertex> vertices,
-    render::IndexRangeMap indices)
-    : EntityModelMesh{std::move(vertices)}
+    std::vector<EntityModelVertex> vertices, render::IndexRangeMap indices)
+    : m_vertices{std::move(vertices)}
     , m_indices{std::move(indices)}
   {
-    m_indices.forEachPrimitive(
-      [&](const render::PrimType primType, const size_t index, const size_t count) {
-        frame.addToSpacialTree(m_vertices, primType, index, count);
-      });
   }
 
-private:
-  std::unique_ptr<render::MaterialIndexRangeRenderer> doBuildRenderer(
-    const Material* skin, const render::VertexArray& vertices) const override
+  std::unique_ptr<render::MaterialIndexRangeRenderer> buildRenderer(
+    const Material* skin) const override
   {
+    const auto vertexArray = render::VertexArray::ref(m_vertices);
     const render::MaterialIndexRangeMap indices(skin, m_indices);
-    return std::make_unique<render::MaterialIndexRangeRenderer>(vertices, indices);
+    return std::make_unique<render::MaterialIndexRangeRenderer>(vertexArray, indices);
+  }
+
+  void forEachPrimitive(const PrimitiveFunc& func) const override
+  {
+    m_indices.forEachPrimitive(
+      [&](const render::PrimType primType, const size_t index, const size_t count) {
+        func(m_vertices, primType, index, count);
+      });
   }
 };
 
@@ -331,6 +171,7 @@ private:
 class EntityModelMaterialMesh : public EntityModelMesh
 {
 private:
+  std::vector<EntityModelVertex> m_vertices;
   render::MaterialIndexRangeMap m_indices;
 
   kdl_reflect_inline_empty(EntityModelMaterialMesh);
@@ -339,36 +180,260 @@ public:
   /**
    * Creates a new frame mesh with the given vertices and per material indices.
    *
-   * @param frame the frame to which this mesh belongs
    * @param vertices the vertices
    * @param indices the per material indices
    */
   EntityModelMaterialMesh(
-    EntityModelFrame& frame,
-    std::vector<EntityModelVertex> vertices,
-    render::MaterialIndexRangeMap indices)
-    : EntityModelMesh{std::move(vertices)}
+    std::vector<EntityModelVertex> vertices, render::MaterialIndexRangeMap indices)
+    : m_vertices{std::move(vertices)}
     , m_indices{std::move(indices)}
+  {
+  }
+
+  std::unique_ptr<render::MaterialIndexRangeRenderer> buildRenderer(
+    const Material* /* skin */) const override
+  {
+    const auto vertexArray = render::VertexArray::ref(m_vertices);
+    return std::make_unique<render::MaterialIndexRangeRenderer>(vertexArray, m_indices);
+  }
+
+  void forEachPrimitive(const PrimitiveFunc& func) const override
   {
     m_indices.forEachPrimitive([&](
                                  const Material* /* material */,
                                  const render::PrimType primType,
                                  const size_t index,
                                  const size_t count) {
-      frame.addToSpacialTree(m_vertices, primType, index, count);
+      func(m_vertices, primType, index, count);
     });
   }
+};
 
+// EntityModelLazyMesh
+
+/**
+ * A model frame mesh that is decoded by a loader when it is first used. The loader is
+ * released once it has been called.
+ */
+class EntityModelLazyMesh : public EntityModelMesh
+{
 private:
-  std::unique_ptr<render::MaterialIndexRangeRenderer> doBuildRenderer(
-    const Material* /* skin */, const render::VertexArray& vertices) const override
+  mutable EntityModelMeshLoader m_loader;
+  mutable std::once_flag m_loaded;
+  mutable std::unique_ptr<EntityModelIndexedMesh> m_mesh;
+
+  kdl_reflect_inline_empty(EntityModelLazyMesh);
+
+public:
+  /**
+   * Creates a new frame mesh that is decoded by the given loader.
+   *
+   * @param loader produces the vertices and indices of this mesh
+   */
+  explicit EntityModelLazyMesh(EntityModelMeshLoader loader)
+    : m_loader{std::move(loader)}
   {
-    return std::make_unique<render::MaterialIndexRangeRenderer>(vertices, m_indices);
+  }
+
+  std::unique_ptr<render::MaterialIndexRangeRenderer> buildRenderer(
+    const Material* skin) const override
+  {
+    return mesh().buildRenderer(skin);
+  }
+
+  void forEachPrimitive(const PrimitiveFunc& func) const override
+  {
+    mesh().forEachPrimitive(func);
+  }
+
+private:
+  const EntityModelIndexedMesh& mesh() const
+  {
+    std::call_once(m_loaded, [&]() {
+      auto [vertices, indices] = m_loader();
+      m_mesh =
+        std::make_unique<EntityModelIndexedMesh>(std::move(vertices), std::move(indices));
+      m_loader = nullptr;
+    });
+    return *m_mesh;
   }
 };
 
 } // namespace
 
+// EntityModelFrame
+
+namespace
+{
+
+using TriNum = size_t;
+
+} // namespace
+
+struct EntityModelFrame::SpacialTree
+{
+  std::once_flag built;
+  std::vector<vm::vec3f> tris;
+  octree<float, TriNum> tree{16.0f};
+
+  void addTriangle(const vm::vec3f& p1, const vm::vec3f& p2, const vm::vec3f& p3)
+  {
+    auto bounds = vm::bbox3f::builder{};
+    bounds.add(p1);
+    bounds.add(p2);
+    bounds.add(p3);
+
+    const auto triIndex = TriNum(tris.size() / 3u);
+    tris.push_back(p1);
+    tris.push_back(p2);
+    tris.push_back(p3);
+    tree.insert(bounds.bounds(), triIndex);
+  }
+
+  void add(
+    const std::vector<EntityModelVertex>& vertices,
+    const render::PrimType primType,
+    const size_t index,
+    const size_t count)
+  {
+    switch (primType)
+    {
+    case render::PrimType::Points:
+    case render::PrimType::Lines:
+    case render::PrimType::LineStrip:
+    case render::PrimType::LineLoop:
+      break;
+    case render::PrimType::Triangles: {
+      assert(count % 3 == 0);
+      tris.reserve(tris.size() + count);
+      for (size_t i = 0; i < count; i += 3)
+      {
+        addTriangle(
+          render::getVertexComponent<0>(vertices[index + i + 0]),
+          render::getVertexComponent<0>(vertices[index + i + 1]),
+          render::getVertexComponent<0>(vertices[index + i + 2]));
+      }
+      break;
+    }
+    case render::PrimType::Polygon:
+    case render::PrimType::TriangleFan: {
+      assert(count > 2);
+      tris.reserve(tris.size() + (count - 2) * 3);
+
+      const auto& p1 = render::getVertexComponent<0>(vertices[index]);
+      for (size_t i = 1; i < count - 1; ++i)
+      {
+        addTriangle(
+          p1,
+          render::getVertexComponent<0>(vertices[index + i]),
+          render::getVertexComponent<0>(vertices[index + i + 1]));
+      }
+      break;
+    }
+    case render::PrimType::Quads:
+    case render::PrimType::QuadStrip:
+    case render::PrimType::TriangleStrip: {
+      assert(count > 2);
+      tris.reserve(tris.size() + (count - 2) * 3);
+      for (size_t i = 0; i < count - 2; ++i)
+      {
+        const auto& p1 = render::getVertexComponent<0>(vertices[index + i + 0]);
+        const auto& p2 = render::getVertexComponent<0>(vertices[index + i + 1]);
+        const auto& p3 = render::getVertexComponent<0>(vertices[index + i + 2]);
+        if (i % 2 == 0)
+        {
+          addTriangle(p1, p2, p3);
+        }
+        else
+        {
+          addTriangle(p1, p3, p2);
+        }
+      }
+      break;
+    }
+      switchDefault();
+    }
+  }
+};
+
+kdl_reflect_impl(EntityModelFrame);
+
+EntityModelFrame::EntityModelFrame(
+  const size_t index, std::string name, const vm::bbox3f& bounds)
+  : m_index{index}
+  , m_name{std::move(name)}
+  , m_bounds{bounds}
+  , m_spacialTree{std::make_unique<SpacialTree>()}
+{
+}
+
+EntityModelFrame::EntityModelFrame(EntityModelFrame&& other) noexcept = default;
+EntityModelFrame& EntityModelFrame::operator=(EntityModelFrame&& other) noexcept =
+  default;
+
+EntityModelFrame::~EntityModelFrame() = default;
+
+size_t EntityModelFrame::index() const
+{
+  return m_index;
+}
+
+size_t EntityModelFrame::skinOffset() const
+{
+  return m_skinOffset;
+}
+
+void EntityModelFrame::setSkinOffset(const size_t skinOffset)
+{
+  m_skinOffset = skinOffset;
+}
+
+const std::string& EntityModelFrame::name() const
+{
+  return m_name;
+}
+
+const vm::bbox3f& EntityModelFrame::bounds() const
+{
+  return m_bounds;
+}
+
+std::optional<float> EntityModelFrame::intersect(const vm::ray3f& ray) const
+{
+  auto& spacialTree = *m_spacialTree;
+  std::call_once(spacialTree.built, [&]() {
+    for (const auto* mesh : m_meshes)
+    {
+      mesh->forEachPrimitive([&](
+                               const std::vector<EntityModelVertex>& vertices,
+                               const render::PrimType primType,
+                               const size_t index,
+                               const size_t count) {
+        spacialTree.add(vertices, primType, index, count);
+      });
+    }
+  });
+
+  auto closestDistance = std::optional<float>{};
+
+  const auto candidates = spacialTree.tree.find_intersectors(ray);
+  for (const auto triNum : candidates)
+  {
+    const auto& p1 = spacialTree.tris[triNum * 3 + 0];
+    const auto& p2 = spacialTree.tris[triNum * 3 + 1];
+    const auto& p3 = spacialTree.tris[triNum * 3 + 2];
+    closestDistance =
+      vm::safe_min(closestDistance, vm::intersect_ray_triangle(ray, p1, p2, p3));
+  }
+
+  return closestDistance;
+}
+
+void EntityModelFrame::addMesh(const EntityModelMesh& mesh)
+{
+  m_meshes.push_back(&mesh);
+}
+
 // EntityModelSurface
 
 kdl_reflect_impl(EntityModelSurface);
@@ -415,8 +480,10 @@ void EntityModelSurface::addMesh(
   render::IndexRangeMap indices)
 {
   assert(frame.index() < frameCount());
-  m_meshes[frame.index()] = std::make_unique<EntityModelIndexedMesh>(
-    frame, std::move(vertices), std::move(indices));
+  assert(!m_meshes[frame.index()]);
+  m_meshes[frame.index()] =
+    std::make_unique<EntityModelIndexedMesh>(std::move(vertices), std::move(indices));
+  frame.addMesh(*m_meshes[frame.index()]);
 }
 
 void EntityModelSurface::addMesh(
@@ -425,8 +492,18 @@ void EntityModelSurface::addMesh(
   render::MaterialIndexRangeMap indices)
 {
   assert(frame.index() < frameCount());
-  m_meshes[frame.index()] = std::make_unique<EntityModelMaterialMesh>(
-    frame, std::move(vertices), std::move(indices));
+  assert(!m_meshes[frame.index()]);
+  m_meshes[frame.index()] =
+    std::make_unique<EntityModelMaterialMesh>(std::move(vertices), std::move(indices));
+  frame.addMesh(*m_meshes[frame.index()]);
+}
+
+void EntityModelSurface::addMesh(EntityModelFrame& frame, EntityModelMeshLoader loader)
+{
+  assert(frame.index() < frameCount());
+  assert(!m_meshes[frame.index()]);
+  m_meshes[frame.index()] = std::make_unique<EntityModelLazyMesh>(std::move(loader));
+  frame.addMesh(*m_meshes[frame.index()]);
 }
 
 void EntityModelSurface::setSkins(std::vector<Material> skins)
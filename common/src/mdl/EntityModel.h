@@ -21,23 +21,19 @@ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
 
 #include "mdl/EntityModelDataResource.h"
 #include "mdl/EntityModel_Forward.h"
-#include "octree.h"
 
 #include "kdl/reflection_decl.h"
 
 #include "vm/bbox.h"
+#include "vm/ray.h"
 
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <vector>
 
-namespace tb
-{
-template <typename T, typename U>
-class octree;
-}
-
 namespace tb::render
 {
 enum class PrimType;
@@ -82,9 +78,18 @@ enum class Orientation
 
 std::ostream& operator<<(std::ostream& lhs, Orientation rhs);
 
+class EntityModelMesh;
+
 /**
- * One frame of the model. Since frames are loaded on demand, each frame has two possible
- * states: loaded and unloaded. These states are modeled as subclasses of this class.
+ * Produces the vertices and indices of a frame mesh. Loaders use this to defer decoding a
+ * frame until it is first rendered or hit tested.
+ */
+using EntityModelMeshLoader =
+  std::function<std::tuple<std::vector<EntityModelVertex>, render::IndexRangeMap>()>;
+
+/**
+ * One frame of the model. The spacial tree used for hit testing is built from the
+ * frame's meshes when the frame is hit tested for the first time.
  */
 class EntityModelFrame
 {
@@ -95,10 +100,9 @@ private:
   size_t m_skinOffset = 0;
 
   // For hit testing
-  std::vector<vm::vec3f> m_tris;
-  using TriNum = size_t;
-  using SpacialTree = octree<float, TriNum>;
-  SpacialTree m_spacialTree;
+  std::vector<const EntityModelMesh*> m_meshes;
+  struct SpacialTree;
+  std::unique_ptr<SpacialTree> m_spacialTree;
 
   kdl_reflect_decl(EntityModelFrame, m_index, m_name, m_bounds, m_skinOffset);
 
@@ -110,6 +114,11 @@ public:
    */
   explicit EntityModelFrame(size_t index, std::string name, const vm::bbox3f& bounds);
 
+  EntityModelFrame(EntityModelFrame&& other) noexcept;
+  EntityModelFrame& operator=(EntityModelFrame&& other) noexcept;
+
+  ~EntityModelFrame();
+
   /**
    * Returns the index of this frame.
    *
@@ -151,23 +160,14 @@ public:
   std::optional<float> intersect(const vm::ray3f& ray) const;
 
   /**
-   * Adds the given primitives to the spacial tree for this frame.
+   * Registers the given mesh with this frame. The mesh's primitives are added to the
+   * spacial tree of this frame when it is built. The mesh must outlive this frame.
    *
-   * @param vertices the vertices
-   * @param primType the primitive type
-   * @param index the index of the first primitive's first vertex in the given vertex
-   * array
-   * @param count the number of vertices that make up the primitive(s)
-   */
-  void addToSpacialTree(
-    const std::vector<EntityModelVertex>& vertices,
-    render::PrimType primType,
-    size_t index,
-    size_t count);
+   * @param mesh the mesh to add
+   */
+  void addMesh(const EntityModelMesh& mesh);
 };
 
-class EntityModelMesh;
-
 /**
  * A model surface represents an individual part of a model. MDL and MD2 models use only
  * one surface, while more complex model formats such as MD3 contain multiple surfaces
@@ -239,6 +239,16 @@ public:
     std::vector<EntityModelVertex> vertices,
     render::MaterialIndexRangeMap indices);
 
+  /**
+   * Adds a new mesh to this surface that is decoded by the given loader when it is first
+   * rendered or hit tested. The loader may be called on any thread, but it is called at
+   * most once.
+   *
+   * @param frame the frame which the mesh belongs to
+   * @param loader produces the mesh vertices and indices
+   */
+  void addMesh(EntityModelFrame& frame, EntityModelMeshLoader loader);
+
   /**
    * Sets the given materials as skins to this surface.
    *
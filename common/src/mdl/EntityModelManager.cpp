@@ -67,7 +67,11 @@ void EntityModelManager::reloadShaders()
   if (m_game)
   {
     m_shaders =
-      io::loadShaders(m_game->gameFileSystem(), m_game->config().materialConfig, m_logger)
+      io::loadShaders(
+        m_game->gameFileSystem(),
+        m_game->config().materialConfig,
+        m_game->parseCache(),
+        m_logger)
       | kdl::if_error(
         [&](const auto& e) { m_logger.error() << "Failed to reload shaders: " << e.msg; })
       | kdl::value_or(std::vector<Quake3Shader>{});
@@ -60,6 +60,11 @@ const vm::bbox3d& EntityNode::modelBounds() const
 
 void EntityNode::setModel(const EntityModel* model)
 {
+  if (m_entity.model() == model)
+  {
+    return;
+  }
+
   m_entity.setModel(model);
   nodePhysicalBoundsDidChange();
 }
@@ -43,7 +43,8 @@ class Logger;
 namespace tb::io
 {
 class FileSystem;
-}
+class ParseCache;
+} // namespace tb::io
 
 namespace tb::mdl
 {
@@ -65,6 +66,12 @@ public: // game configuration
   virtual const GameConfig& config() const = 0;
   virtual const io::FileSystem& gameFileSystem() const = 0;
 
+  /**
+   * Returns the cache for parsed shaders and entity definitions, or nullptr if parse
+   * results should not be cached.
+   */
+  virtual const io::ParseCache* parseCache() const = 0;
+
   bool isGamePathPreference(const std::filesystem::path& prefPath) const;
 
   virtual std::filesystem::path gamePath() const = 0;
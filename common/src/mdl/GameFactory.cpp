@@ -125,7 +125,13 @@ size_t GameFactory::gameCount() const
 
 std::shared_ptr<Game> GameFactory::createGame(const std::string& gameName, Logger& logger)
 {
-  return std::make_shared<GameImpl>(gameConfig(gameName), gamePath(gameName), logger);
+  if (m_userGameDir.empty())
+  {
+    return std::make_shared<GameImpl>(gameConfig(gameName), gamePath(gameName), logger);
+  }
+
+  return std::make_shared<GameImpl>(
+    gameConfig(gameName), gamePath(gameName), m_userGameDir / gameName / "cache", logger);
 }
 
 std::vector<std::string> GameFactory::fileFormats(const std::string& gameName) const
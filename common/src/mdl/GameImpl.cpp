@@ -26,6 +26,7 @@
 #include "io/DiskFileSystem.h"
 #include "io/DiskIO.h"
 #include "io/EntParser.h"
+#include "io/EntityDefinitionClassInfo.h"
 #include "io/ExportOptions.h"
 #include "io/FgdParser.h"
 #include "io/GameConfigParser.h"
@@ -33,6 +34,7 @@
 #include "io/NodeReader.h"
 #include "io/NodeWriter.h"
 #include "io/ObjSerializer.h"
+#include "io/ParseCache.h"
 #include "io/PathInfo.h"
 #include "io/SimpleParserStatus.h"
 #include "io/SystemPaths.h"
@@ -56,23 +58,27 @@
 #include "kdl/string_utils.h"
 #include "kdl/vector_utils.h"
 
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace tb::mdl
 {
-GameImpl::GameImpl(GameConfig& config, std::filesystem::path gamePath, Logger& logger)
-  : m_config{config}
-  , m_gamePath{std::move(gamePath)}
+namespace
 {
-  initializeFileSystem(logger);
-}
 
-Result<std::vector<std::unique_ptr<EntityDefinition>>> GameImpl::loadEntityDefinitions(
-  io::ParserStatus& status, const std::filesystem::path& path) const
+struct ParsedClassInfos
+{
+  std::vector<io::EntityDefinitionClassInfo> classInfos;
+  // the entity definition file followed by all files it included
+  std::vector<std::filesystem::path> paths;
+};
+
+Result<ParsedClassInfos> parseClassInfos(
+  io::ParserStatus& status, const std::filesystem::path& path, const Color& defaultColor)
 {
   const auto extension = path.extension().string();
-  const auto& defaultColor = m_config.entityConfig.defaultColor;
 
   try
   {
@@ -81,7 +87,10 @@ Result<std::vector<std::unique_ptr<EntityDefinition>>> GameImpl::loadEntityDefin
       return io::Disk::openFile(path) | kdl::transform([&](auto file) {
                auto reader = file->reader().buffer();
                auto parser = io::FgdParser{reader.stringView(), defaultColor, path};
-               return parser.parseDefinitions(status);
+               auto classInfos = parser.parseClassInfos(status);
+               return ParsedClassInfos{
+                 std::move(classInfos),
+                 kdl::vec_concat(std::vector{path}, parser.includedPaths())};
              });
     }
     if (kdl::ci::str_is_equal(".def", extension))
@@ -89,7 +98,7 @@ Result<std::vector<std::unique_ptr<EntityDefinition>>> GameImpl::loadEntityDefin
       return io::Disk::openFile(path) | kdl::transform([&](auto file) {
                auto reader = file->reader().buffer();
                auto parser = io::DefParser{reader.stringView(), defaultColor};
-               return parser.parseDefinitions(status);
+               return ParsedClassInfos{parser.parseClassInfos(status), {path}};
              });
     }
     if (kdl::ci::str_is_equal(".ent", extension))
@@ -97,7 +106,7 @@ Result<std::vector<std::unique_ptr<EntityDefinition>>> GameImpl::loadEntityDefin
       return io::Disk::openFile(path) | kdl::transform([&](auto file) {
                auto reader = file->reader().buffer();
                auto parser = io::EntParser{reader.stringView(), defaultColor};
-               return parser.parseDefinitions(status);
+               return ParsedClassInfos{parser.parseClassInfos(status), {path}};
              });
     }
 
@@ -109,6 +118,52 @@ Result<std::vector<std::unique_ptr<EntityDefinition>>> GameImpl::loadEntityDefin
   }
 }
 
+} // namespace
+
+GameImpl::GameImpl(GameConfig& config, std::filesystem::path gamePath, Logger& logger)
+  : m_config{config}
+  , m_gamePath{std::move(gamePath)}
+{
+  initializeFileSystem(logger);
+}
+
+GameImpl::GameImpl(
+  GameConfig& config,
+  std::filesystem::path gamePath,
+  std::filesystem::path parseCacheDirectory,
+  Logger& logger)
+  : GameImpl{config, std::move(gamePath), logger}
+{
+  m_parseCache = std::make_unique<io::ParseCache>(std::move(parseCacheDirectory));
+}
+
+GameImpl::~GameImpl() = default;
+
+Result<std::vector<std::unique_ptr<EntityDefinition>>> GameImpl::loadEntityDefinitions(
+  io::ParserStatus& status, const std::filesystem::path& path) const
+{
+  const auto& defaultColor = m_config.entityConfig.defaultColor;
+
+  if (m_parseCache)
+  {
+    if (const auto classInfos = m_parseCache->readClassInfos(path))
+    {
+      return io::createDefinitions(status, *classInfos, defaultColor);
+    }
+  }
+
+  return parseClassInfos(status, path, defaultColor)
+         | kdl::transform([&](const auto& parsedClassInfos) {
+             if (m_parseCache)
+             {
+               m_parseCache->writeClassInfos(
+                 parsedClassInfos.paths, parsedClassInfos.classInfos);
+             }
+             return io::createDefinitions(
+               status, parsedClassInfos.classInfos, defaultColor);
+           });
+}
+
 const GameConfig& GameImpl::config() const
 {
   return m_config;
@@ -119,6 +174,11 @@ const io::FileSystem& GameImpl::gameFileSystem() const
   return m_fs;
 }
 
+const io::ParseCache* GameImpl::parseCache() const
+{
+  return m_parseCache.get();
+}
+
 std::filesystem::path GameImpl::gamePath() const
 {
   return m_gamePath;
@@ -211,6 +271,29 @@ Result<std::unique_ptr<WorldNode>> GameImpl::newMap(
   return worldNode;
 }
 
+namespace
+{
+
+std::unique_ptr<WorldNode> readWorld(
+  const std::string_view str,
+  const MapFormat format,
+  const std::vector<MapFormat>& possibleFormats,
+  const vm::bbox3d& worldBounds,
+  const EntityPropertyConfig& entityPropertyConfig,
+  io::ParserStatus& parserStatus)
+{
+  if (format == MapFormat::Unknown)
+  {
+    return io::WorldReader::tryRead(
+      str, possibleFormats, worldBounds, entityPropertyConfig, parserStatus);
+  }
+
+  auto worldReader = io::WorldReader{str, format, entityPropertyConfig};
+  return worldReader.read(worldBounds, parserStatus);
+}
+
+} // namespace
+
 Result<std::unique_ptr<WorldNode>> GameImpl::loadMap(
   const MapFormat format,
   const vm::bbox3d& worldBounds,
@@ -220,24 +303,47 @@ Result<std::unique_ptr<WorldNode>> GameImpl::loadMap(
   auto parserStatus = io::SimpleParserStatus{logger};
   return io::Disk::openFile(path) | kdl::transform([&](auto file) {
            auto fileReader = file->reader().buffer();
-           if (format == MapFormat::Unknown)
+
+           // Try all formats listed in the game config if the format is unknown
+           const auto possibleFormats =
+             format == MapFormat::Unknown
+               ? kdl::vec_transform(
+                   m_config.fileFormats,
+                   [](const auto& config) { return mdl::formatFromName(config.format); })
+               : std::vector<MapFormat>{format};
+
+           const auto fingerprint =
+             m_parseCache ? std::optional{io::makeFileFingerprint(
+                              path, fileReader.stringView())}
+                          : std::nullopt;
+           if (fingerprint)
            {
-             // Try all formats listed in the game config
-             const auto possibleFormats = kdl::vec_transform(
-               m_config.fileFormats,
-               [](const auto& config) { return mdl::formatFromName(config.format); });
-
-             return io::WorldReader::tryRead(
-               fileReader.stringView(),
-               possibleFormats,
-               worldBounds,
-               entityPropertyConfig(),
-               parserStatus);
+             if (
+               auto worldNode = m_parseCache->readMap(
+                 *fingerprint,
+                 possibleFormats,
+                 worldBounds,
+                 entityPropertyConfig(),
+                 parserStatus))
+             {
+               return worldNode;
+             }
            }
 
-           auto worldReader =
-             io::WorldReader{fileReader.stringView(), format, entityPropertyConfig()};
-           return worldReader.read(worldBounds, parserStatus);
+           auto worldNode = readWorld(
+             fileReader.stringView(),
+             format,
+             possibleFormats,
+             worldBounds,
+             entityPropertyConfig(),
+             parserStatus);
+           if (fingerprint)
+           {
+             // only the serialization of the world delays loading, the cache entry is
+             // written to the disk in the background
+             m_pendingMapCacheWrite = m_parseCache->writeMap(*fingerprint, *worldNode);
+           }
+           return worldNode;
          });
 }
 
@@ -322,7 +428,8 @@ void GameImpl::writeBrushFacesToStream(
 void GameImpl::loadMaterialCollections(
   MaterialManager& materialManager, const CreateTextureResource& createResource) const
 {
-  materialManager.reload(m_fs, m_config.materialConfig, createResource);
+  materialManager.reload(
+    m_fs, m_config.materialConfig, createResource, m_parseCache.get());
 }
 
 void GameImpl::reloadWads(
@@ -24,6 +24,7 @@
 #include "mdl/GameFileSystem.h"
 
 #include <filesystem>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -33,6 +34,11 @@ namespace tb
 class Logger;
 } // namespace tb
 
+namespace tb::io
+{
+class ParseCache;
+} // namespace tb::io
+
 namespace tb::mdl
 {
 struct EntityPropertyConfig;
@@ -44,10 +50,23 @@ private:
   GameFileSystem m_fs;
   std::filesystem::path m_gamePath;
   std::vector<std::filesystem::path> m_additionalSearchPaths;
+  std::unique_ptr<io::ParseCache> m_parseCache;
+  mutable std::future<void> m_pendingMapCacheWrite;
 
 public:
   GameImpl(GameConfig& config, std::filesystem::path gamePath, Logger& logger);
 
+  /**
+   * Creates a game that caches parsed shaders, entity definitions and maps in the given
+   * directory.
+   */
+  GameImpl(
+    GameConfig& config,
+    std::filesystem::path gamePath,
+    std::filesystem::path parseCacheDirectory,
+    Logger& logger);
+  ~GameImpl() override;
+
 public: // implement EntityDefinitionLoader interface:
   Result<std::vector<std::unique_ptr<EntityDefinition>>> loadEntityDefinitions(
     io::ParserStatus& status, const std::filesystem::path& path) const override;
@@ -55,6 +74,7 @@ public: // implement EntityDefinitionLoader interface:
 public: // implement Game interface
   const GameConfig& config() const override;
   const io::FileSystem& gameFileSystem() const override;
+  const io::ParseCache* parseCache() const override;
 
   std::filesystem::path gamePath() const override;
 
@@ -112,7 +112,11 @@ void GroupNode::setHasPendingChanges(const bool hasPendingChanges)
 
 void GroupNode::setEditState(const EditState editState)
 {
-  m_editState = editState;
+  if (editState != m_editState)
+  {
+    m_editState = editState;
+    invalidateStateRevision();
+  }
 }
 
 void GroupNode::setAncestorEditState(const EditState editState)
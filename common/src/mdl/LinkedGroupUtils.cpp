@@ -32,7 +32,10 @@
 #include "kdl/result_fold.h"
 #include "kdl/zip_iterator.h"
 
+#include <algorithm>
+#include <optional>
 #include <string_view>
+#include <typeinfo>
 #include <unordered_map>
 
 namespace tb::mdl
@@ -261,6 +264,43 @@ Result<std::unique_ptr<Node>> cloneAndTransformRecursive(
            });
 }
 
+/**
+ * Returns a copy of the contents of the given node with the given transformation applied.
+ */
+Result<NodeContents> transformNodeContents(
+  const Node& node, const vm::bbox3d& worldBounds, const vm::mat4x4d& transformation)
+{
+  return node.accept(kdl::overload(
+    [](const WorldNode*) -> Result<NodeContents> {
+      ensure(false, "Linked group structure is valid");
+    },
+    [](const LayerNode*) -> Result<NodeContents> {
+      ensure(false, "Linked group structure is valid");
+    },
+    [&](const GroupNode* groupNode) -> Result<NodeContents> {
+      auto group = groupNode->group();
+      group.transform(transformation);
+      return NodeContents{std::move(group)};
+    },
+    [&](const EntityNode* entityNode) -> Result<NodeContents> {
+      const auto updateAngleProperty =
+        entityNode->entityPropertyConfig().updateAnglePropertyAfterTransform;
+      auto entity = entityNode->entity();
+      entity.transform(transformation, updateAngleProperty);
+      return NodeContents{std::move(entity)};
+    },
+    [&](const BrushNode* brushNode) -> Result<NodeContents> {
+      auto brush = brushNode->brush();
+      return brush.transform(worldBounds, transformation, true)
+             | kdl::transform([&]() { return NodeContents{std::move(brush)}; });
+    },
+    [&](const PatchNode* patchNode) -> Result<NodeContents> {
+      auto patch = patchNode->patch();
+      patch.transform(transformation);
+      return NodeContents{std::move(patch)};
+    }));
+}
+
 /**
  * Given a node, clones its children recursively and applies the given transform.
  *
@@ -271,44 +311,14 @@ Result<std::vector<std::unique_ptr<Node>>> cloneAndTransformChildren(
 {
   auto nodesToClone = collectDescendants(std::vector{&node});
 
-  using TransformResult = Result<std::pair<const Node*, NodeContents>>;
-
   // In parallel, produce pairs { node pointer, transformed contents } from the nodes in
   // `nodesToClone`
   auto transformResults =
     kdl::vec_parallel_transform(nodesToClone, [&](const Node* nodeToTransform) {
-      return nodeToTransform->accept(kdl::overload(
-        [](const WorldNode*) -> TransformResult {
-          ensure(false, "Linked group structure is valid");
-        },
-        [](const LayerNode*) -> TransformResult {
-          ensure(false, "Linked group structure is valid");
-        },
-        [&](const GroupNode* groupNode) -> TransformResult {
-          auto group = groupNode->group();
-          group.transform(transformation);
-          return std::make_pair(nodeToTransform, NodeContents{std::move(group)});
-        },
-        [&](const EntityNode* entityNode) -> TransformResult {
-          const auto updateAngleProperty =
-            entityNode->entityPropertyConfig().updateAnglePropertyAfterTransform;
-          auto entity = entityNode->entity();
-          entity.transform(transformation, updateAngleProperty);
-          return std::make_pair(nodeToTransform, NodeContents{std::move(entity)});
-        },
-        [&](const BrushNode* brushNode) -> TransformResult {
-          auto brush = brushNode->brush();
-          return brush.transform(worldBounds, transformation, true)
-                 | kdl::and_then([&]() -> TransformResult {
-                     return std::make_pair(
-                       nodeToTransform, NodeContents{std::move(brush)});
-                   });
-        },
-        [&](const PatchNode* patchNode) -> TransformResult {
-          auto patch = patchNode->patch();
-          patch.transform(transformation);
-          return std::make_pair(nodeToTransform, NodeContents{std::move(patch)});
-        }));
+      return transformNodeContents(*nodeToTransform, worldBounds, transformation)
+             | kdl::transform([&](auto contents) {
+                 return std::make_pair(nodeToTransform, std::move(contents));
+               });
     });
 
   return std::move(transformResults) | kdl::fold
@@ -402,19 +412,8 @@ void preserveGroupNames(
       [](const PatchNode*) {}));
 }
 
-void preserveEntityProperties(
-  EntityNode& clonedEntityNode, const EntityNode& correspondingEntityNode)
+void preserveEntityProperties(Entity& clonedEntity, const Entity& correspondingEntity)
 {
-  if (
-    clonedEntityNode.entity().protectedProperties().empty()
-    && correspondingEntityNode.entity().protectedProperties().empty())
-  {
-    return;
-  }
-
-  auto clonedEntity = clonedEntityNode.entity();
-  const auto& correspondingEntity = correspondingEntityNode.entity();
-
   const auto allProtectedProperties = kdl::vec_sort_and_remove_duplicates(kdl::vec_concat(
     clonedEntity.protectedProperties(), correspondingEntity.protectedProperties()));
 
@@ -429,7 +428,20 @@ void preserveEntityProperties(
       clonedEntity.addOrUpdateProperty(propertyKey, *propertyValue);
     }
   }
+}
+
+void preserveEntityProperties(
+  EntityNode& clonedEntityNode, const EntityNode& correspondingEntityNode)
+{
+  if (
+    clonedEntityNode.entity().protectedProperties().empty()
+    && correspondingEntityNode.entity().protectedProperties().empty())
+  {
+    return;
+  }
 
+  auto clonedEntity = clonedEntityNode.entity();
+  preserveEntityProperties(clonedEntity, correspondingEntityNode.entity());
   clonedEntityNode.setEntity(std::move(clonedEntity));
 }
 
@@ -461,6 +473,177 @@ void preserveEntityProperties(
       [](const BrushNode*) {},
       [](const PatchNode*) {}));
 }
+
+Result<std::pair<Node*, std::vector<std::unique_ptr<Node>>>> replaceLinkedGroupChildren(
+  const GroupNode& sourceGroupNode,
+  GroupNode& targetGroupNode,
+  const vm::mat4x4d& invertedSourceTransformation,
+  const vm::bbox3d& worldBounds)
+{
+  const auto transformation =
+    targetGroupNode.group().transformation() * invertedSourceTransformation;
+  return cloneAndTransformChildren(sourceGroupNode, worldBounds, transformation)
+         | kdl::transform([&](auto newChildren) {
+             const auto linkIdToNodeMap = makeLinkIdToNodeMap(targetGroupNode.children());
+             preserveGroupNames(newChildren, linkIdToNodeMap);
+             preserveEntityProperties(newChildren, linkIdToNodeMap);
+             return std::pair{
+               static_cast<Node*>(&targetGroupNode), std::move(newChildren)};
+           });
+}
+
+bool collectCorrespondingNodes(
+  const Node& sourceNode,
+  Node& targetNode,
+  std::vector<std::pair<const Node*, Node*>>& result)
+{
+  const auto& sourceChildren = sourceNode.children();
+  const auto& targetChildren = targetNode.children();
+  if (sourceChildren.size() != targetChildren.size())
+  {
+    return false;
+  }
+
+  for (size_t i = 0; i < sourceChildren.size(); ++i)
+  {
+    const auto* sourceChild = dynamic_cast<const Object*>(sourceChildren[i]);
+    const auto* targetChild = dynamic_cast<const Object*>(targetChildren[i]);
+    if (
+      !sourceChild || !targetChild
+      || typeid(*sourceChildren[i]) != typeid(*targetChildren[i])
+      || sourceChild->linkId() != targetChild->linkId())
+    {
+      return false;
+    }
+
+    result.emplace_back(sourceChildren[i], targetChildren[i]);
+    if (!collectCorrespondingNodes(*sourceChildren[i], *targetChildren[i], result))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Returns pairs of corresponding source and target nodes if the given target group node
+ * has the same structure as the given source group node, that is, if all of their
+ * descendants have the same types and link IDs at the same positions.
+ */
+std::optional<std::vector<std::pair<const Node*, Node*>>> collectCorrespondingNodes(
+  const GroupNode& sourceGroupNode, GroupNode& targetGroupNode)
+{
+  auto result = std::vector<std::pair<const Node*, Node*>>{};
+  return collectCorrespondingNodes(sourceGroupNode, targetGroupNode, result)
+           ? std::optional{std::move(result)}
+           : std::nullopt;
+}
+
+bool facesEqual(const BrushFace& lhs, const BrushFace& rhs)
+{
+  return lhs.points() == rhs.points() && lhs.attributes() == rhs.attributes()
+         && lhs.uAxis() == rhs.uAxis() && lhs.vAxis() == rhs.vAxis();
+}
+
+bool brushesEqual(const Brush& lhs, const Brush& rhs)
+{
+  return lhs.faceCount() == rhs.faceCount()
+         && std::ranges::equal(lhs.faces(), rhs.faces(), facesEqual);
+}
+
+/**
+ * Applies the properties of the given target node that must not be overwritten to the
+ * given contents, and returns whether the resulting contents differ from the contents of
+ * the target node.
+ *
+ * Materials, entity definitions and models are not compared since they are not part of
+ * transformed contents.
+ */
+bool preserveAndCompareContents(NodeContents& contents, const Node& targetNode)
+{
+  return targetNode.accept(kdl::overload(
+    [](const WorldNode*) -> bool { ensure(false, "Linked group structure is valid"); },
+    [](const LayerNode*) -> bool { ensure(false, "Linked group structure is valid"); },
+    [&](const GroupNode* groupNode) {
+      auto& group = std::get<Group>(contents.get());
+      group.setName(groupNode->group().name());
+      return !(group == groupNode->group());
+    },
+    [&](const EntityNode* entityNode) {
+      auto& entity = std::get<Entity>(contents.get());
+      preserveEntityProperties(entity, entityNode->entity());
+      return !(entity == entityNode->entity());
+    },
+    [&](const BrushNode* brushNode) {
+      return !brushesEqual(std::get<Brush>(contents.get()), brushNode->brush());
+    },
+    [&](const PatchNode* patchNode) {
+      return !(std::get<BezierPatch>(contents.get()) == patchNode->patch());
+    }));
+}
+
+bool isWithinWorldBounds(
+  const NodeContents& contents, const Node& targetNode, const vm::bbox3d& worldBounds)
+{
+  return std::visit(
+    kdl::overload(
+      [](const Layer&) { return true; },
+      [](const Group&) { return true; },
+      [&](const Entity& entity) {
+        return targetNode.hasChildren()
+               || worldBounds.contains(
+                 EntityNode::DefaultBounds.translate(entity.origin()));
+      },
+      [&](const Brush& brush) { return worldBounds.contains(brush.bounds()); },
+      [&](const BezierPatch& patch) { return worldBounds.contains(patch.bounds()); }),
+    contents.get());
+}
+
+/**
+ * Transforms the contents of the given source nodes and returns the transformed contents
+ * for those corresponding target nodes whose contents differ.
+ */
+Result<std::vector<std::pair<Node*, NodeContents>>> computeChangedContents(
+  const std::vector<std::pair<const Node*, Node*>>& correspondingNodes,
+  const vm::bbox3d& worldBounds,
+  const vm::mat4x4d& transformation)
+{
+  using ChangedContents = std::optional<std::pair<Node*, NodeContents>>;
+
+  return kdl::vec_parallel_transform(
+           correspondingNodes,
+           [&](const auto& sourceAndTargetNode) -> Result<ChangedContents> {
+             const auto& [sourceNode, targetNode] = sourceAndTargetNode;
+             return transformNodeContents(*sourceNode, worldBounds, transformation)
+                    | kdl::or_else([](const auto&) -> Result<NodeContents> {
+                        return Error{"Failed to transform a linked node"};
+                      })
+                    | kdl::and_then([&](auto contents) -> Result<ChangedContents> {
+                        if (!preserveAndCompareContents(contents, *targetNode))
+                        {
+                          return std::nullopt;
+                        }
+                        if (!isWithinWorldBounds(contents, *targetNode, worldBounds))
+                        {
+                          return Error{
+                            "Updating a linked node would exceed world bounds"};
+                        }
+                        return std::pair{targetNode, std::move(contents)};
+                      });
+           })
+         | kdl::fold | kdl::transform([](auto allContents) {
+             auto result = std::vector<std::pair<Node*, NodeContents>>{};
+             for (auto& contents : allContents)
+             {
+               if (contents)
+               {
+                 result.push_back(std::move(*contents));
+               }
+             }
+             return result;
+           });
+}
 } // namespace
 
 Result<UpdateLinkedGroupsResult> updateLinkedGroups(
@@ -480,22 +663,61 @@ Result<UpdateLinkedGroupsResult> updateLinkedGroups(
   return kdl::vec_transform(
            targetGroupNodesToUpdate,
            [&](auto* targetGroupNode) {
-             const auto transformation =
-               targetGroupNode->group().transformation() * *invertedSourceTransformation;
-             return cloneAndTransformChildren(
-                      sourceGroupNode, worldBounds, transformation)
-                    | kdl::transform([&](auto newChildren) {
-                        const auto linkIdToNodeMap =
-                          makeLinkIdToNodeMap(targetGroupNode->children());
-                        preserveGroupNames(newChildren, linkIdToNodeMap);
-                        preserveEntityProperties(newChildren, linkIdToNodeMap);
-                        return std::pair{
-                          static_cast<Node*>(targetGroupNode), std::move(newChildren)};
-                      });
+             return replaceLinkedGroupChildren(
+               sourceGroupNode,
+               *targetGroupNode,
+               *invertedSourceTransformation,
+               worldBounds);
            })
          | kdl::fold;
 }
 
+Result<LinkedGroupUpdates> computeLinkedGroupUpdates(
+  const GroupNode& sourceGroupNode,
+  const std::vector<GroupNode*>& targetGroupNodes,
+  const vm::bbox3d& worldBounds)
+{
+  const auto& sourceGroup = sourceGroupNode.group();
+  const auto invertedSourceTransformation = vm::invert(sourceGroup.transformation());
+  if (!invertedSourceTransformation)
+  {
+    return Error{"Group transformation is not invertible"};
+  }
+
+  auto result = LinkedGroupUpdates{};
+
+  const auto targetGroupNodesToUpdate =
+    kdl::vec_erase(targetGroupNodes, &sourceGroupNode);
+  return kdl::vec_transform(
+           targetGroupNodesToUpdate,
+           [&](auto* targetGroupNode) -> Result<void> {
+             if (
+               auto correspondingNodes =
+                 collectCorrespondingNodes(sourceGroupNode, *targetGroupNode))
+             {
+               const auto transformation =
+                 targetGroupNode->group().transformation()
+                 * *invertedSourceTransformation;
+               return computeChangedContents(
+                        *correspondingNodes, worldBounds, transformation)
+                      | kdl::transform([&](auto changedContents) {
+                          result.contentsToSwap = kdl::vec_concat(
+                            std::move(result.contentsToSwap), std::move(changedContents));
+                        });
+             }
+
+             return replaceLinkedGroupChildren(
+                      sourceGroupNode,
+                      *targetGroupNode,
+                      *invertedSourceTransformation,
+                      worldBounds)
+                    | kdl::transform([&](auto childrenToReplace) {
+                        result.childrenToReplace.push_back(std::move(childrenToReplace));
+                      });
+           })
+         | kdl::fold | kdl::transform([&]() { return std::move(result); });
+}
+
 namespace
 {
 
@@ -25,6 +25,7 @@
 #include "mdl/EntityNode.h" // IWYU pragma: keep
 #include "mdl/GroupNode.h"
 #include "mdl/LayerNode.h"
+#include "mdl/NodeContents.h"
 #include "mdl/NodeVisitor.h"
 #include "mdl/PatchNode.h" // IWYU pragma: keep
 #include "mdl/WorldNode.h"
@@ -135,6 +136,41 @@ Result<UpdateLinkedGroupsResult> updateLinkedGroups(
   const std::vector<mdl::GroupNode*>& targetGroupNodes,
   const vm::bbox3d& worldBounds);
 
+struct LinkedGroupUpdates
+{
+  /**
+   * Target nodes whose children must be replaced because their structure no longer
+   * matches the structure of the source group.
+   */
+  UpdateLinkedGroupsResult childrenToReplace;
+
+  /**
+   * Nodes in target groups whose contents must be swapped because they differ from the
+   * transformed contents of their corresponding source nodes.
+   */
+  std::vector<std::pair<Node*, NodeContents>> contentsToSwap;
+};
+
+/**
+ * Computes the changes necessary to update the given target group nodes from the given
+ * source group node.
+ *
+ * Unlike updateLinkedGroups(), this function only returns changes for those nodes in the
+ * target groups that actually differ from their transformed source nodes. If a target
+ * group has the same structure as the source group, i.e. if all of their descendants
+ * have the same types and link IDs at the same positions, then the source nodes are
+ * transformed and compared against their corresponding target nodes, and only the
+ * contents of the nodes that differ are returned. Otherwise, the children of the target
+ * group are replaced entirely as in updateLinkedGroups().
+ *
+ * Protected entity properties and group names are preserved as in updateLinkedGroups().
+ * This operation fails under the same conditions as updateLinkedGroups().
+ */
+Result<LinkedGroupUpdates> computeLinkedGroupUpdates(
+  const GroupNode& sourceGroupNode,
+  const std::vector<mdl::GroupNode*>& targetGroupNodes,
+  const vm::bbox3d& worldBounds);
+
 std::vector<Error> initializeLinkIds(const std::vector<Node*>& nodes);
 
 /**
@@ -104,7 +104,9 @@ Material::Material(Material&& other)
   , m_absolutePath{std::move(other.m_absolutePath)}
   , m_relativePath{std::move(other.m_relativePath)}
   , m_textureResource{std::move(other.m_textureResource)}
+  , m_thumbnailResource{std::move(other.m_thumbnailResource)}
   , m_usageCount{static_cast<size_t>(other.m_usageCount)}
+  , m_usageStarted{std::move(other.m_usageStarted)}
   , m_surfaceParms{std::move(other.m_surfaceParms)}
   , m_culling{std::move(other.m_culling)}
   , m_blendFunc{std::move(other.m_blendFunc)}
@@ -117,7 +119,9 @@ Material& Material::operator=(Material&& other)
   m_absolutePath = std::move(other.m_absolutePath);
   m_relativePath = std::move(other.m_relativePath);
   m_textureResource = std::move(other.m_textureResource);
+  m_thumbnailResource = std::move(other.m_thumbnailResource);
   m_usageCount = static_cast<size_t>(other.m_usageCount);
+  m_usageStarted = std::move(other.m_usageStarted);
   m_surfaceParms = std::move(other.m_surfaceParms);
   m_culling = std::move(other.m_culling);
   m_blendFunc = std::move(other.m_blendFunc);
@@ -164,6 +168,21 @@ const TextureResource& Material::textureResource() const
   return *m_textureResource;
 }
 
+void Material::requestTexture() const
+{
+  m_textureResource->requestLoading();
+}
+
+const Texture* Material::thumbnail() const
+{
+  return m_thumbnailResource ? m_thumbnailResource->get() : nullptr;
+}
+
+void Material::setThumbnailResource(std::shared_ptr<TextureResource> thumbnailResource)
+{
+  m_thumbnailResource = std::move(thumbnailResource);
+}
+
 const std::set<std::string>& Material::surfaceParms() const
 {
   return m_surfaceParms;
@@ -203,7 +222,10 @@ size_t Material::usageCount() const
 
 void Material::incUsageCount()
 {
-  ++m_usageCount;
+  if (m_usageCount++ == 0 && m_usageStarted)
+  {
+    m_usageStarted(*this);
+  }
 }
 
 void Material::decUsageCount()
@@ -213,6 +235,11 @@ void Material::decUsageCount()
   unused(previous);
 }
 
+void Material::setUsageStarted(std::function<void(const Material&)> usageStarted)
+{
+  m_usageStarted = std::move(usageStarted);
+}
+
 void Material::activate(const int minFilter, const int magFilter) const
 {
   if (const auto* texture = m_textureResource->get();
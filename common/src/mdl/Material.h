@@ -26,6 +26,7 @@
 
 #include <atomic>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
@@ -90,8 +91,10 @@ private:
   std::filesystem::path m_relativePath;
 
   std::shared_ptr<TextureResource> m_textureResource;
+  std::shared_ptr<TextureResource> m_thumbnailResource;
 
   std::atomic<size_t> m_usageCount = 0;
+  std::function<void(const Material&)> m_usageStarted;
 
   // Quake 3 surface parameters; move these to materials when we add proper support for
   // those.
@@ -110,6 +113,7 @@ private:
     m_absolutePath,
     m_relativePath,
     m_textureResource,
+    m_thumbnailResource,
     m_usageCount,
     m_surfaceParms,
     m_culling,
@@ -145,6 +149,19 @@ public:
 
   const TextureResource& textureResource() const;
 
+  /**
+   * Requests that the texture be loaded if its loading was deferred. Must only be called
+   * from the main thread.
+   */
+  void requestTexture() const;
+
+  /**
+   * Returns a downscaled version of the texture for previews, or null if this material
+   * has no thumbnail or if it isn't loaded yet.
+   */
+  const Texture* thumbnail() const;
+  void setThumbnailResource(std::shared_ptr<TextureResource> thumbnailResource);
+
   const std::set<std::string>& surfaceParms() const;
   void setSurfaceParms(std::set<std::string> surfaceParms);
 
@@ -158,6 +175,13 @@ public:
   void incUsageCount();
   void decUsageCount();
 
+  /**
+   * Sets a function to call whenever the usage count of this material goes from 0 to 1.
+   * Since materials are bound to brush faces in parallel, the function can be called from
+   * any thread.
+   */
+  void setUsageStarted(std::function<void(const Material&)> usageStarted);
+
   void activate(int minFilter, int magFilter) const;
   void deactivate() const;
 };
@@ -31,8 +31,8 @@
 #include "kdl/vector_utils.h"
 
 #include <algorithm>
+#include <mutex>
 #include <string>
-#include <unordered_set>
 #include <vector>
 
 namespace tb::mdl
@@ -48,10 +48,11 @@ MaterialManager::~MaterialManager() = default;
 void MaterialManager::reload(
   const io::FileSystem& fs,
   const mdl::MaterialConfig& materialConfig,
-  const CreateTextureResource& createResource)
+  const CreateTextureResource& createResource,
+  const io::ParseCache* parseCache)
 {
   clear();
-  io::loadMaterialCollections(fs, materialConfig, createResource, m_logger)
+  io::loadMaterialCollections(fs, materialConfig, createResource, parseCache, m_logger)
     | kdl::transform([&](auto materialCollections) {
         for (auto& collection : materialCollections)
         {
@@ -83,8 +84,14 @@ void MaterialManager::addMaterialCollection(MaterialCollection collection)
 
 void MaterialManager::clear()
 {
+  {
+    const auto lock = std::lock_guard{m_newlyUsedMaterialsMutex};
+    m_newlyUsedMaterials.clear();
+  }
+
   m_collections.clear();
   m_materialsByName.clear();
+  m_materialsByTextureResourceId.clear();
   m_materials.clear();
 
   // Remove logging because it might fail when the document is already destroyed.
@@ -101,14 +108,33 @@ Material* MaterialManager::material(const std::string& name)
   return const_cast<Material*>(const_cast<const MaterialManager*>(this)->material(name));
 }
 
+void MaterialManager::requestUsedTextures()
+{
+  auto newlyUsedMaterials = std::vector<const Material*>{};
+  {
+    const auto lock = std::lock_guard{m_newlyUsedMaterialsMutex};
+    std::swap(newlyUsedMaterials, m_newlyUsedMaterials);
+  }
+
+  for (const auto* material : newlyUsedMaterials)
+  {
+    material->requestTexture();
+  }
+}
+
 const std::vector<const Material*> MaterialManager::findMaterialsByTextureResourceId(
   const std::vector<ResourceId>& textureResourceIds) const
 {
-  const auto resourceIdSet =
-    std::unordered_set<ResourceId>{textureResourceIds.begin(), textureResourceIds.end()};
-  return kdl::vec_filter(m_materials, [&](const auto* material) {
-    return resourceIdSet.count(material->textureResource().id()) > 0;
-  });
+  auto result = std::vector<const Material*>{};
+  for (const auto& resourceId : textureResourceIds)
+  {
+    const auto [first, last] = m_materialsByTextureResourceId.equal_range(resourceId);
+    for (auto it = first; it != last; ++it)
+    {
+      result.push_back(it->second);
+    }
+  }
+  return result;
 }
 
 const std::vector<const Material*>& MaterialManager::materials() const
@@ -147,5 +173,28 @@ void MaterialManager::updateMaterials()
   m_materials = kdl::vec_transform(kdl::map_values(m_materialsByName), [](auto* t) {
     return const_cast<const Material*>(t);
   });
+
+  m_materialsByTextureResourceId.clear();
+  for (const auto* material : m_materials)
+  {
+    m_materialsByTextureResourceId.emplace(material->textureResource().id(), material);
+  }
+
+  const auto addNewlyUsedMaterial = [this](const Material& material) {
+    const auto lock = std::lock_guard{m_newlyUsedMaterialsMutex};
+    m_newlyUsedMaterials.push_back(&material);
+  };
+
+  for (auto& collection : m_collections)
+  {
+    for (auto& material : collection.materials())
+    {
+      material.setUsageStarted(addNewlyUsedMaterial);
+      if (material.usageCount() > 0)
+      {
+        addNewlyUsedMaterial(material);
+      }
+    }
+  }
 }
 } // namespace tb::mdl
@@ -20,9 +20,11 @@
 #pragma once
 
 #include "mdl/MaterialCollection.h"
+#include "mdl/Resource.h"
 #include "mdl/TextureResource.h"
 
 #include <filesystem>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -34,6 +36,7 @@ class Logger;
 namespace io
 {
 class FileSystem;
+class ParseCache;
 } // namespace io
 
 namespace mdl
@@ -55,8 +58,13 @@ private:
   std::vector<MaterialCollection> m_collections;
 
   std::unordered_map<std::string, Material*> m_materialsByName;
+  std::unordered_multimap<ResourceId, const Material*> m_materialsByTextureResourceId;
   std::vector<const Material*> m_materials;
 
+  // materials whose usage count went from 0 to 1 since their textures were last requested
+  std::mutex m_newlyUsedMaterialsMutex;
+  std::vector<const Material*> m_newlyUsedMaterials;
+
 public:
   explicit MaterialManager(Logger& logger);
   ~MaterialManager();
@@ -64,7 +72,8 @@ public:
   void reload(
     const io::FileSystem& fs,
     const mdl::MaterialConfig& materialConfig,
-    const CreateTextureResource& createResource);
+    const CreateTextureResource& createResource,
+    const io::ParseCache* parseCache = nullptr);
 
   // for testing
   void setMaterialCollections(std::vector<MaterialCollection> collections);
@@ -78,6 +87,12 @@ public:
   const Material* material(const std::string& name) const;
   Material* material(const std::string& name);
 
+  /**
+   * Requests loading the deferred textures of the materials that came into use since this
+   * was last called. Must only be called from the main thread.
+   */
+  void requestUsedTextures();
+
   const std::vector<const Material*> findMaterialsByTextureResourceId(
     const std::vector<ResourceId>& textureResourceIds) const;
 
@@ -51,6 +51,11 @@ ModelDefinition::ModelDefinition(el::ExpressionNode expression)
 {
 }
 
+const el::ExpressionNode& ModelDefinition::expression() const
+{
+  return m_expression;
+}
+
 void ModelDefinition::append(ModelDefinition other)
 {
   const auto location = m_expression.location();
@@ -55,6 +55,8 @@ public:
 
   explicit ModelDefinition(el::ExpressionNode expression);
 
+  const el::ExpressionNode& expression() const;
+
   void append(ModelDefinition other);
 
   /**
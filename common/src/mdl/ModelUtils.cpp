@@ -24,9 +24,12 @@
 #include "mdl/BrushFaceHandle.h"
 #include "mdl/EditorContext.h"
 #include "mdl/NodeQueries.h"
+#include "mdl/WorldNode.h"
 
 #include "kdl/vector_utils.h"
 
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace tb::mdl
@@ -161,6 +164,53 @@ std::map<Node*, std::vector<Node*>> parentChildrenMap(const std::vector<Node*>&
   return result;
 }
 
+static const WorldNode* findContainingWorld(const Node* node)
+{
+  while (node->parent())
+  {
+    node = node->parent();
+  }
+  return dynamic_cast<const WorldNode*>(node);
+}
+
+/**
+ * Returns the world that contains all of the given nodes, or null if there is no such
+ * world.
+ */
+static const WorldNode* findCommonContainingWorld(const std::vector<Node*>& nodes)
+{
+  const WorldNode* world = nullptr;
+  for (const auto* node : nodes)
+  {
+    const auto* containingWorld = findContainingWorld(node);
+    if (!containingWorld || (world && world != containingWorld))
+    {
+      return nullptr;
+    }
+    world = containingWorld;
+  }
+  return world;
+}
+
+/**
+ * Maps the nodes in the spacial index of the given world to the given brushes whose
+ * bounds they might intersect. Nodes that cannot intersect any of the given brushes are
+ * not contained in the returned map.
+ */
+static std::unordered_map<const Node*, std::vector<const BrushNode*>> findCandidates(
+  const WorldNode& world, const std::vector<BrushNode*>& brushes)
+{
+  auto result = std::unordered_map<const Node*, std::vector<const BrushNode*>>{};
+  for (const auto* brush : brushes)
+  {
+    for (const auto* node : world.nodeTree().find_intersectors(brush->physicalBounds()))
+    {
+      result[node].push_back(brush);
+    }
+  }
+  return result;
+}
+
 /**
  * Recursively collect brushes and entities from the given vector of node trees such that
  * the returned nodes match the given predicate. A matching brush is only returned if it
@@ -169,6 +219,11 @@ std::map<Node*, std::vector<Node*>> parentChildrenMap(const std::vector<Node*>&
  * pair of node and brush.
  *
  * The given predicate must be a function that maps a node and a brush to true or false.
+ * It must only return true if the bounds of the node and the brush intersect.
+ *
+ * If the given nodes belong to a world, its spacial index is used to find the brushes
+ * that a node can possibly match, so that the predicate is not evaluated for every pair
+ * of node and brush.
  */
 template <typename P>
 static std::vector<Node*> collectMatchingNodes(
@@ -178,8 +233,16 @@ static std::vector<Node*> collectMatchingNodes(
 {
   auto result = std::vector<Node*>{};
 
-  const auto collectIfMatching = [&](auto* node) {
-    for (const auto* brush : brushes)
+  const auto brushSet =
+    std::unordered_set<const BrushNode*>{brushes.begin(), brushes.end()};
+
+  const auto* world = findCommonContainingWorld(nodes);
+  const auto candidates =
+    world ? findCandidates(*world, brushes)
+          : std::unordered_map<const Node*, std::vector<const BrushNode*>>{};
+
+  const auto collectIfMatchingAny = [&](auto* node, const auto& candidateBrushes) {
+    for (const auto* brush : candidateBrushes)
     {
       if (predicate(node, brush))
       {
@@ -189,10 +252,36 @@ static std::vector<Node*> collectMatchingNodes(
     }
   };
 
+  const auto collectIfMatchingBounds = [&](auto* node) {
+    const auto& bounds = node->logicalBounds();
+    for (const auto* brush : brushes)
+    {
+      if (brush->logicalBounds().intersects(bounds) && predicate(node, brush))
+      {
+        result.push_back(node);
+        return;
+      }
+    }
+  };
+
+  const auto collectIfMatching = [&](auto* node) {
+    if (world)
+    {
+      if (const auto iCandidates = candidates.find(node); iCandidates != candidates.end())
+      {
+        collectIfMatchingAny(node, iCandidates->second);
+      }
+    }
+    else
+    {
+      collectIfMatchingBounds(node);
+    }
+  };
+
   for (auto* node : nodes)
   {
     node->accept(kdl::overload(
-      [](auto&& thisLambda, WorldNode* world) { world->visitChildren(thisLambda); },
+      [](auto&& thisLambda, WorldNode* world_) { world_->visitChildren(thisLambda); },
       [](auto&& thisLambda, LayerNode* layer) { layer->visitChildren(thisLambda); },
       [&](auto&& thisLambda, GroupNode* group) {
         if (group->opened() || group->hasOpenedDescendant())
@@ -201,7 +290,8 @@ static std::vector<Node*> collectMatchingNodes(
         }
         else
         {
-          collectIfMatching(group);
+          // groups are not in the spacial index
+          collectIfMatchingBounds(group);
         }
       },
       [&](auto&& thisLambda, EntityNode* entity) {
@@ -216,15 +306,12 @@ static std::vector<Node*> collectMatchingNodes(
       },
       [&](BrushNode* brush) {
         // if `brush` is one of the search query nodes, don't count it as touching
-        if (!kdl::vec_contains(brushes, brush))
+        if (!brushSet.contains(brush))
         {
           collectIfMatching(brush);
         }
       },
-      [&](PatchNode* patch) {
-        // if `patch` is one of the search query nodes, don't count it as touching
-        collectIfMatching(patch);
-      }));
+      [&](PatchNode* patch) { collectIfMatching(patch); }));
   }
 
   return result;
@@ -29,8 +29,14 @@
 #include "kdl/reflection_impl.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cassert>
+#include <functional>
 #include <iterator>
+#include <mutex>
+#include <queue>
 #include <string>
 #include <vector>
 
@@ -39,11 +45,130 @@ namespace tb::mdl
 
 kdl_reflect_impl(NodePath);
 
-Node::Node() = default;
+namespace
+{
+
+/**
+ * Hands out node ids in batches. The ids of destroyed nodes are reused, lowest first, so
+ * that the highest id in use is bounded by the number of nodes that exist at the same
+ * time plus the ids that are cached by the threads that create and destroy nodes.
+ */
+class NodeIdAllocator
+{
+public:
+  static constexpr size_t BatchSize = 256;
+
+private:
+  // nodes are created from multiple threads when a map is loaded
+  std::mutex m_mutex;
+  IdType m_nextId = 0;
+  std::priority_queue<IdType, std::vector<IdType>, std::greater<>> m_freeIds;
+
+public:
+  /**
+   * Appends a batch of ids to the given vector so that the lowest id is at the back.
+   */
+  void allocate(std::vector<IdType>& ids)
+  {
+    const auto first = ids.size();
+    {
+      const auto lock = std::lock_guard{m_mutex};
+      while (ids.size() - first < BatchSize && !m_freeIds.empty())
+      {
+        ids.push_back(m_freeIds.top());
+        m_freeIds.pop();
+      }
+      while (ids.size() - first < BatchSize)
+      {
+        ids.push_back(m_nextId++);
+      }
+    }
+    std::reverse(std::next(ids.begin(), std::ptrdiff_t(first)), ids.end());
+  }
+
+  template <typename I>
+  void release(I begin, const I end)
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    for (; begin != end; ++begin)
+    {
+      m_freeIds.push(*begin);
+    }
+  }
+};
+
+NodeIdAllocator& nodeIdAllocator()
+{
+  static auto allocator = NodeIdAllocator{};
+  return allocator;
+}
+
+/**
+ * Caches node ids for one thread so that creating and destroying nodes only locks the
+ * allocator once per batch of ids.
+ */
+class NodeIdCache
+{
+private:
+  // used as a stack so that recently released ids are reused first
+  std::vector<IdType> m_ids;
+
+public:
+  NodeIdCache() { m_ids.reserve(2 * NodeIdAllocator::BatchSize); }
+
+  ~NodeIdCache() { nodeIdAllocator().release(m_ids.begin(), m_ids.end()); }
+
+  deleteCopyAndMove(NodeIdCache);
+
+  IdType allocate()
+  {
+    if (m_ids.empty())
+    {
+      nodeIdAllocator().allocate(m_ids);
+    }
+
+    const auto id = m_ids.back();
+    m_ids.pop_back();
+    return id;
+  }
+
+  void release(const IdType id)
+  {
+    m_ids.push_back(id);
+    if (m_ids.size() == 2 * NodeIdAllocator::BatchSize)
+    {
+      const auto batch =
+        std::next(m_ids.begin(), std::ptrdiff_t(NodeIdAllocator::BatchSize));
+      nodeIdAllocator().release(batch, m_ids.end());
+      m_ids.erase(batch, m_ids.end());
+    }
+  }
+};
+
+NodeIdCache& nodeIdCache()
+{
+  thread_local auto cache = NodeIdCache{};
+  return cache;
+}
+
+uint64_t nextStateRevision()
+{
+  static auto revision = std::atomic<uint64_t>{0};
+  return revision.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+} // namespace
+
+Node::Node()
+  : m_nodeId{nodeIdCache().allocate()}
+  , m_stateRevision{nextStateRevision()}
+{
+}
 
 Node::~Node()
 {
   clearChildren();
+  nodeIdCache().release(m_nodeId);
 }
 
 const std::string& Node::name() const
@@ -51,6 +176,25 @@ const std::string& Node::name() const
   return doGetName();
 }
 
+IdType Node::nodeId() const
+{
+  return m_nodeId;
+}
+
+uint64_t Node::stateRevision() const
+{
+  return m_stateRevision;
+}
+
+void Node::invalidateStateRevision()
+{
+  m_stateRevision = nextStateRevision();
+  for (auto* child : m_children)
+  {
+    child->invalidateStateRevision();
+  }
+}
+
 NodePath Node::pathFrom(const Node& ancestor) const
 {
   auto result = NodePath{};
@@ -429,6 +573,7 @@ void Node::setParent(Node* parent)
     parentWillChange();
     m_parent = parent;
     parentDidChange();
+    invalidateStateRevision();
   }
 }
 
@@ -719,6 +864,7 @@ bool Node::setVisibilityState(const VisibilityState visibility)
   if (visibility != m_visibilityState)
   {
     m_visibilityState = visibility;
+    invalidateStateRevision();
     return true;
   }
   return false;
@@ -762,6 +908,7 @@ bool Node::setLockState(const LockState lockState)
   if (lockState != m_lockState)
   {
     m_lockState = lockState;
+    invalidateStateRevision();
     return true;
   }
   return false;
@@ -774,7 +921,11 @@ bool Node::lockedByOtherSelection() const
 
 void Node::setLockedByOtherSelection(const bool lockedByOtherSelection)
 {
-  m_lockedByOtherSelection = lockedByOtherSelection;
+  if (lockedByOtherSelection != m_lockedByOtherSelection)
+  {
+    m_lockedByOtherSelection = lockedByOtherSelection;
+    invalidateStateRevision();
+  }
 }
 
 void Node::pick(
@@ -793,6 +944,11 @@ size_t Node::lineNumber() const
   return m_lineNumber;
 }
 
+size_t Node::lineCount() const
+{
+  return m_lineCount;
+}
+
 void Node::setFilePosition(const size_t lineNumber, const size_t lineCount) const
 {
   m_lineNumber = lineNumber;
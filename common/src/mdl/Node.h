@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "mdl/IdType.h"
 #include "mdl/IssueType.h"
 #include "mdl/LockState.h"
 #include "mdl/NodeVisitor.h"
@@ -32,6 +33,7 @@
 #include "vm/util.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -59,6 +61,8 @@ struct NodePath
 class Node : public Taggable
 {
 private:
+  IdType m_nodeId;
+  uint64_t m_stateRevision;
   Node* m_parent = nullptr;
   std::vector<Node*> m_children;
   size_t m_descendantCount = 0;
@@ -91,6 +95,24 @@ public:
 public: // getters
   const std::string& name() const;
 
+  /**
+   * Returns an id that identifies this node among all nodes that currently exist. Ids
+   * are handed out starting at 0 and the ids of destroyed nodes are reused, so they can
+   * be used to index dense structures such as NodeIdSet. Unlike persistent ids, node ids
+   * are not saved.
+   */
+  IdType nodeId() const;
+
+  /**
+   * Returns the revision of the state that determines whether this node is visible,
+   * editable and inside an open group, which comprises the visibility and lock states of
+   * this node and its ancestors, whether it is locked by another selection and whether
+   * its containing groups are open. Subclasses can add to that state, e.g. brushes add
+   * the tags of their faces. The revision changes whenever that state changes, and no
+   * two nodes ever share a revision.
+   */
+  uint64_t stateRevision() const;
+
   /**
    * Returns a path from the given ancestor to this node.
    *
@@ -272,6 +294,12 @@ protected: // notification for parents
   };
   void nodePhysicalBoundsDidChange();
 
+  /**
+   * Assigns new state revisions to this node and its descendants. Must be called whenever
+   * the state reflected by stateRevision() changes.
+   */
+  void invalidateStateRevision();
+
 private:
   void childWillChange(Node* node);
   void childDidChange(Node* node);
@@ -345,6 +373,7 @@ public: // picking
 
 public: // file position
   size_t lineNumber() const;
+  size_t lineCount() const;
   void setFilePosition(size_t lineNumber, size_t lineCount) const;
   bool containsLine(size_t lineNumber) const;
 
@@ -131,6 +131,11 @@ bool NodeCollection::hasOnlyPatches() const
   return !empty() && nodeCount() == patchCount();
 }
 
+bool NodeCollection::contains(const Node* node) const
+{
+  return m_ids.contains(node->nodeId());
+}
+
 std::vector<Node*>::iterator NodeCollection::begin()
 {
   return std::begin(m_nodes);
@@ -189,113 +194,89 @@ void NodeCollection::addNodes(const std::vector<Node*>& nodes)
   }
 }
 
+void NodeCollection::addNodes(const NodeCollection& nodes)
+{
+  addNodes(nodes.nodes());
+}
+
 void NodeCollection::addNode(Node* node)
 {
   ensure(node != nullptr, "node is null");
+
+  const auto doAddNode = [&](auto* typedNode, auto& typedNodes) {
+    if (m_ids.insert(typedNode->nodeId()))
+    {
+      m_nodes.push_back(typedNode);
+      typedNodes.push_back(typedNode);
+    }
+  };
+
   node->accept(kdl::overload(
     [](WorldNode*) {},
-    [&](LayerNode* layer) {
-      m_nodes.push_back(layer);
-      m_layers.push_back(layer);
-    },
-    [&](GroupNode* group) {
-      m_nodes.push_back(group);
-      m_groups.push_back(group);
-    },
-    [&](EntityNode* entity) {
-      m_nodes.push_back(entity);
-      m_entities.push_back(entity);
-    },
-    [&](BrushNode* brush) {
-      m_nodes.push_back(brush);
-      m_brushes.push_back(brush);
-    },
-    [&](PatchNode* patch) {
-      m_nodes.push_back(patch);
-      m_patches.push_back(patch);
-    }));
-}
-
-static const auto doRemoveNodes = [](
-                                    auto& nodes,
-                                    auto& layers,
-                                    auto& groups,
-                                    auto& entities,
-                                    auto& brushes,
-                                    auto& patches,
-                                    auto cur,
-                                    auto end) {
-  auto nodeEnd = std::end(nodes);
-  auto layerEnd = std::end(layers);
-  auto groupEnd = std::end(groups);
-  auto entityEnd = std::end(entities);
-  auto brushEnd = std::end(brushes);
-  auto patchEnd = std::end(patches);
-
-  while (cur != end)
+    [&](LayerNode* layer) { doAddNode(layer, m_layers); },
+    [&](GroupNode* group) { doAddNode(group, m_groups); },
+    [&](EntityNode* entity) { doAddNode(entity, m_entities); },
+    [&](BrushNode* brush) { doAddNode(brush, m_brushes); },
+    [&](PatchNode* patch) { doAddNode(patch, m_patches); }));
+}
+
+void NodeCollection::removeNodes(const std::vector<Node*>& nodes)
+{
+  auto idsToRemove = NodeIdSet{};
+  for (const auto* node : nodes)
   {
-    (*cur)->accept(kdl::overload(
-      [](WorldNode*) {},
-      [&](LayerNode* layer) {
-        nodeEnd = std::remove(std::begin(nodes), nodeEnd, layer);
-        layerEnd = std::remove(std::begin(layers), layerEnd, layer);
-      },
-      [&](GroupNode* group) {
-        nodeEnd = std::remove(std::begin(nodes), nodeEnd, group);
-        groupEnd = std::remove(std::begin(groups), groupEnd, group);
-      },
-      [&](EntityNode* entity) {
-        nodeEnd = std::remove(std::begin(nodes), nodeEnd, entity);
-        entityEnd = std::remove(std::begin(entities), entityEnd, entity);
-      },
-      [&](BrushNode* brush) {
-        nodeEnd = std::remove(std::begin(nodes), nodeEnd, brush);
-        brushEnd = std::remove(std::begin(brushes), brushEnd, brush);
-      },
-      [&](PatchNode* patch) {
-        nodeEnd = std::remove(std::begin(nodes), nodeEnd, patch);
-        patchEnd = std::remove(std::begin(patches), patchEnd, patch);
-      }));
-    ++cur;
+    ensure(node != nullptr, "node is null");
+    if (contains(node))
+    {
+      idsToRemove.insert(node->nodeId());
+    }
   }
 
-  nodes.erase(nodeEnd, std::end(nodes));
-  layers.erase(layerEnd, std::end(layers));
-  groups.erase(groupEnd, std::end(groups));
-  entities.erase(entityEnd, std::end(entities));
-  brushes.erase(brushEnd, std::end(brushes));
-  patches.erase(patchEnd, std::end(patches));
-};
+  if (idsToRemove.count() == m_ids.count())
+  {
+    clear();
+  }
+  else if (!idsToRemove.empty())
+  {
+    m_ids -= idsToRemove;
+
+    const auto isRemoved = [&](const auto* node) {
+      return !m_ids.contains(node->nodeId());
+    };
+
+    std::erase_if(m_nodes, isRemoved);
+    std::erase_if(m_layers, isRemoved);
+    std::erase_if(m_groups, isRemoved);
+    std::erase_if(m_entities, isRemoved);
+    std::erase_if(m_brushes, isRemoved);
+    std::erase_if(m_patches, isRemoved);
+  }
+}
 
-void NodeCollection::removeNodes(const std::vector<Node*>& nodes)
+void NodeCollection::removeNodes(const NodeCollection& nodes)
 {
-  doRemoveNodes(
-    m_nodes,
-    m_layers,
-    m_groups,
-    m_entities,
-    m_brushes,
-    m_patches,
-    std::begin(nodes),
-    std::end(nodes));
+  removeNodes(nodes.nodes());
 }
 
 void NodeCollection::removeNode(Node* node)
 {
   ensure(node != nullptr, "node is null");
-  doRemoveNodes(
-    m_nodes,
-    m_layers,
-    m_groups,
-    m_entities,
-    m_brushes,
-    m_patches,
-    &node,
-    std::next(&node));
+  if (m_ids.erase(node->nodeId()))
+  {
+    std::erase(m_nodes, node);
+    node->accept(kdl::overload(
+      [](WorldNode*) {},
+      [&](LayerNode* layer) { std::erase(m_layers, layer); },
+      [&](GroupNode* group) { std::erase(m_groups, group); },
+      [&](EntityNode* entity) { std::erase(m_entities, entity); },
+      [&](BrushNode* brush) { std::erase(m_brushes, brush); },
+      [&](PatchNode* patch) { std::erase(m_patches, patch); }));
+  }
 }
 
 void NodeCollection::clear()
 {
+  m_ids.clear();
   m_nodes.clear();
   m_layers.clear();
   m_groups.clear();
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include "mdl/NodeIdSet.h"
+
 #include "kdl/reflection_decl.h"
 
 #include <cstddef>
@@ -33,9 +35,17 @@ class LayerNode;
 class Node;
 class PatchNode;
 
+/**
+ * A set of nodes that keeps its nodes in insertion order and maintains a view of the
+ * nodes of each type. Membership is tracked in a NodeIdSet, so membership tests take
+ * constant time and removing nodes takes time linear in the size of the collection.
+ *
+ * The world node is never added to a collection.
+ */
 class NodeCollection
 {
 private:
+  NodeIdSet m_ids;
   std::vector<Node*> m_nodes;
   std::vector<LayerNode*> m_layers;
   std::vector<GroupNode*> m_groups;
@@ -69,6 +79,8 @@ public:
   bool hasPatches() const;
   bool hasOnlyPatches() const;
 
+  bool contains(const Node* node) const;
+
   std::vector<Node*>::iterator begin();
   std::vector<Node*>::iterator end();
   std::vector<Node*>::const_iterator begin() const;
@@ -81,10 +93,20 @@ public:
   const std::vector<BrushNode*>& brushes() const;
   const std::vector<PatchNode*>& patches() const;
 
+  /**
+   * Adds the given nodes. Nodes that are already contained in this collection are
+   * ignored.
+   */
   void addNodes(const std::vector<Node*>& nodes);
+  void addNodes(const NodeCollection& nodes);
   void addNode(Node* node);
 
+  /**
+   * Removes the given nodes. Nodes that are not contained in this collection are
+   * ignored.
+   */
   void removeNodes(const std::vector<Node*>& nodes);
+  void removeNodes(const NodeCollection& nodes);
   void removeNode(Node* node);
 
   void clear();
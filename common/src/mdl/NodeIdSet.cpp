@@ -0,0 +1,126 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NodeIdSet.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace tb::mdl
+{
+
+bool NodeIdSet::empty() const
+{
+  return m_count == 0;
+}
+
+size_t NodeIdSet::count() const
+{
+  return m_count;
+}
+
+bool NodeIdSet::contains(const IdType id) const
+{
+  const auto wordIndex = id / BitsPerWord;
+  return wordIndex < m_words.size()
+         && (m_words[wordIndex] & (Word{1} << (id % BitsPerWord))) != 0;
+}
+
+bool NodeIdSet::insert(const IdType id)
+{
+  const auto wordIndex = id / BitsPerWord;
+  if (wordIndex >= m_words.size())
+  {
+    m_words.resize(wordIndex + 1, 0);
+  }
+
+  const auto mask = Word{1} << (id % BitsPerWord);
+  if ((m_words[wordIndex] & mask) != 0)
+  {
+    return false;
+  }
+
+  m_words[wordIndex] |= mask;
+  ++m_count;
+  return true;
+}
+
+bool NodeIdSet::erase(const IdType id)
+{
+  const auto wordIndex = id / BitsPerWord;
+  const auto mask = Word{1} << (id % BitsPerWord);
+  if (wordIndex >= m_words.size() || (m_words[wordIndex] & mask) == 0)
+  {
+    return false;
+  }
+
+  m_words[wordIndex] &= ~mask;
+  --m_count;
+  trim();
+  return true;
+}
+
+void NodeIdSet::clear()
+{
+  m_words.clear();
+  m_count = 0;
+}
+
+NodeIdSet& NodeIdSet::operator-=(const NodeIdSet& other)
+{
+  const auto wordCount = std::min(m_words.size(), other.m_words.size());
+  for (size_t i = 0; i < wordCount; ++i)
+  {
+    m_words[i] &= ~other.m_words[i];
+  }
+
+  updateCount();
+  trim();
+  return *this;
+}
+
+bool operator==(const NodeIdSet& lhs, const NodeIdSet& rhs)
+{
+  // both sets are trimmed, so equal sets have the same number of words
+  return lhs.m_count == rhs.m_count && lhs.m_words == rhs.m_words;
+}
+
+bool operator!=(const NodeIdSet& lhs, const NodeIdSet& rhs)
+{
+  return !(lhs == rhs);
+}
+
+void NodeIdSet::updateCount()
+{
+  m_count = 0;
+  for (const auto word : m_words)
+  {
+    m_count += size_t(std::popcount(word));
+  }
+}
+
+void NodeIdSet::trim()
+{
+  while (!m_words.empty() && m_words.back() == 0)
+  {
+    m_words.pop_back();
+  }
+}
+
+} // namespace tb::mdl
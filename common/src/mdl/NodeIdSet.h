@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mdl/IdType.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tb::mdl
+{
+
+/**
+ * A set of node ids backed by a bitset. Membership tests, insertion and removal take
+ * constant time, and removing all ids of another set takes time linear in the highest id
+ * contained in either set.
+ *
+ * Node ids are handed out densely and reused (see Node::nodeId()), so the memory used by
+ * a set is bounded by the number of nodes that exist at the same time, not by the number
+ * of nodes in the set.
+ */
+class NodeIdSet
+{
+private:
+  using Word = uint64_t;
+  static constexpr auto BitsPerWord = sizeof(Word) * 8;
+
+  std::vector<Word> m_words;
+  size_t m_count = 0;
+
+public:
+  bool empty() const;
+  size_t count() const;
+
+  bool contains(IdType id) const;
+
+  /**
+   * Adds the given id. Returns true if it was not contained in this set before.
+   */
+  bool insert(IdType id);
+
+  /**
+   * Removes the given id. Returns true if it was contained in this set before.
+   */
+  bool erase(IdType id);
+
+  void clear();
+
+  /**
+   * Removes all ids contained in the given set.
+   */
+  NodeIdSet& operator-=(const NodeIdSet& other);
+  friend bool operator==(const NodeIdSet& lhs, const NodeIdSet& rhs);
+  friend bool operator!=(const NodeIdSet& lhs, const NodeIdSet& rhs);
+
+private:
+  void updateCount();
+  void trim();
+};
+
+} // namespace tb::mdl
@@ -20,8 +20,10 @@
 #pragma once
 
 #include "kdl/intrusive_circular_list.h"
+#include "kdl/vector_set.h"
 
 #include "vm/bbox.h"
+#include "vm/mat.h"
 #include "vm/plane.h"
 #include "vm/ray.h"
 #include "vm/segment.h"
@@ -32,7 +34,6 @@
 #include <limits>
 #include <optional>
 #include <string>
-#include <unordered_set>
 #include <variant>
 #include <vector>
 
@@ -1240,6 +1241,36 @@ public: // Constructors
    */
   explicit Polyhedron(std::vector<vm::vec<T, 3>> positions);
 
+  /**
+   * Constructs a polyhedron with the given vertices and faces without computing a convex
+   * hull. Each face is given by the indices of its vertices in the order in which they
+   * appear on its boundary, that is, in counter clockwise order when viewed from outside.
+   *
+   * The faces are not checked for convexity. If they do not form a closed surface where
+   * every edge is shared by exactly two faces, the polyhedron is left empty.
+   *
+   * @param positions the vertex positions
+   * @param faces the faces, given as indices into the vertex positions
+   */
+  Polyhedron(
+    std::vector<vm::vec<T, 3>> positions,
+    const std::vector<std::vector<std::size_t>>& faces);
+
+  /**
+   * Constructs a polyhedron that corresponds to the convex hull of the given points,
+   * using the given polyhedron as a starting point. The given points correspond to the
+   * vertices of the given polyhedron in order.
+   *
+   * If the given polyhedron remains strictly convex when its vertices are moved to the
+   * given points, its topology is retained and only the vertex positions and the face
+   * planes are updated. This is usually the case if the points differ only slightly from
+   * the vertex positions. Otherwise, the convex hull is computed from scratch.
+   *
+   * @param previous the polyhedron to start from
+   * @param positions the points from which the convex hull is computed
+   */
+  Polyhedron(const Polyhedron<T, FP, VP>& previous, std::vector<vm::vec<T, 3>> positions);
+
   /**
    * Copy constructor.
    */
@@ -1581,6 +1612,18 @@ private:
    */
   void updateBounds();
 
+public: // Transformation
+  /**
+   * Transforms the vertices and face planes of this polyhedron by the given
+   * transformation. The transformation must not mirror this polyhedron, since that would
+   * invert the orientation of the face boundaries.
+   *
+   * Updates the bounds of this polyhedron afterwards.
+   *
+   * @param transformation the transformation to apply
+   */
+  void transform(const vm::mat<T, 4, 4>& transformation);
+
 public: // Vertex correction and edge healing
   /**
    * Rounds each component of position of every vertex to the nearest integer if the
@@ -1738,6 +1781,21 @@ private: // Convex hull; adding and removing points
    */
   Vertex* addPoint(const vm::vec<T, 3>& position, T planeEpsilon);
 
+  /**
+   * Moves the vertices of this polyhedron to the given positions, which correspond to the
+   * vertices in order, and updates the face planes accordingly. The vertices are only
+   * moved if this polyhedron remains the convex hull of its vertices without changing its
+   * topology, that is, if every face remains planar, if every vertex remains strictly
+   * below the planes of the faces it does not belong to, and if no vertex comes too close
+   * to another vertex.
+   *
+   * Otherwise, this polyhedron is left unchanged.
+   *
+   * @param positions the new vertex positions
+   * @return true if the vertices were moved and false otherwise
+   */
+  bool moveVerticesRetainingTopology(const std::vector<vm::vec<T, 3>>& positions);
+
 private:
   /**
    * Helper function that adds the given point to an empty polyhedron. Afterwards, this
@@ -1911,7 +1969,7 @@ private:
   void visitFace(
     const vm::vec<T, 3>& position,
     HalfEdge* initialBoundaryEdge,
-    std::unordered_set<Face*>& visitedFaces,
+    kdl::vector_set<Face*>& visitedFaces,
     Seam& seam,
     T planeEpsilon);
 
@@ -22,6 +22,7 @@
 #include "Macros.h"
 #include "Polyhedron.h"
 
+#include "kdl/vector_set.h"
 #include "kdl/vector_utils.h"
 
 #include "vm/bbox.h"
@@ -30,6 +31,7 @@
 #include "vm/segment.h"
 #include "vm/util.h"
 
+#include <algorithm>
 #include <list>
 #include <unordered_set>
 #include <vector>
@@ -110,6 +112,125 @@ typename Polyhedron<T, FP, VP>::Vertex* Polyhedron<T, FP, VP>::addPoint(
   return result;
 }
 
+template <typename T, typename FP, typename VP>
+bool Polyhedron<T, FP, VP>::moveVerticesRetainingTopology(
+  const std::vector<vm::vec<T, 3>>& positions)
+{
+  if (!polyhedron() || positions.size() != vertexCount())
+  {
+    return false;
+  }
+
+  auto oldPositions = std::vector<vm::vec<T, 3>>{};
+  oldPositions.reserve(vertexCount());
+
+  auto movedVertices = std::vector<const Vertex*>{};
+  auto positionIt = positions.begin();
+  for (auto* vertex : m_vertices)
+  {
+    oldPositions.push_back(vertex->position());
+    if (vertex->position() != *positionIt)
+    {
+      vertex->setPosition(*positionIt);
+      movedVertices.push_back(vertex);
+    }
+    ++positionIt;
+  }
+
+  const auto restorePositions = [&]() {
+    auto oldPositionIt = oldPositions.begin();
+    for (auto* vertex : m_vertices)
+    {
+      vertex->setPosition(*oldPositionIt++);
+    }
+    return false;
+  };
+
+  // addPoint discards points that are too close to an existing vertex
+  for (const auto* movedVertex : movedVertices)
+  {
+    for (const auto* vertex : m_vertices)
+    {
+      if (
+        vertex != movedVertex
+        && vm::distance(vertex->position(), movedVertex->position()) < MinEdgeLength)
+      {
+        return restorePositions();
+      }
+    }
+  }
+
+  const auto planeEpsilon = detail::computePlaneEpsilon(positions);
+
+  auto planes = std::vector<vm::plane<T, 3>>{};
+  planes.reserve(faceCount());
+
+  auto faceVertices = std::vector<const Vertex*>{};
+  for (const auto* face : m_faces)
+  {
+    faceVertices.clear();
+    for (const auto* halfEdge : face->boundary())
+    {
+      faceVertices.push_back(halfEdge->origin());
+    }
+
+    const auto isMoved = std::any_of(
+      faceVertices.begin(), faceVertices.end(), [&](const auto* vertex) {
+        return std::find(movedVertices.begin(), movedVertices.end(), vertex)
+               != movedVertices.end();
+      });
+
+    if (!isMoved)
+    {
+      planes.push_back(face->plane());
+    }
+    else
+    {
+      // Newell's method yields a robust normal even if some of the vertices are colinear
+      const auto center = face->center();
+      auto normal = vm::vec<T, 3>{0, 0, 0};
+      for (const auto* halfEdge : face->boundary())
+      {
+        normal = normal
+                 + vm::cross(
+                   halfEdge->origin()->position() - center,
+                   halfEdge->destination()->position() - center);
+      }
+
+      if (vm::is_zero(normal, vm::constants<T>::almost_zero()))
+      {
+        return restorePositions();
+      }
+      planes.emplace_back(center, vm::normalize(normal));
+    }
+
+    // Every face must remain planar, and every other vertex must be strictly below the
+    // face. Otherwise, faces would have to be split or merged.
+    for (const auto* vertex : m_vertices)
+    {
+      const auto isOnFace =
+        std::find(faceVertices.begin(), faceVertices.end(), vertex) != faceVertices.end();
+      const auto expectedStatus =
+        isOnFace ? vm::plane_status::inside : vm::plane_status::below;
+      if (planes.back().point_status(vertex->position(), planeEpsilon) != expectedStatus)
+      {
+        return restorePositions();
+      }
+    }
+  }
+
+  auto planeIt = planes.begin();
+  for (auto* face : m_faces)
+  {
+    face->setPlane(*planeIt++);
+  }
+
+  updateBounds();
+
+  assert(checkInvariant());
+  return true;
+}
+
 template <typename T, typename FP, typename VP>
 typename Polyhedron<T, FP, VP>::Vertex* Polyhedron<T, FP, VP>::addFirstPoint(
   const vm::vec<T, 3>& position)
@@ -638,7 +759,8 @@ std::optional<typename Polyhedron<T, FP, VP>::Seam> Polyhedron<T, FP, VP>::
 
   auto seam = Seam{};
 
-  auto visitedFaces = std::unordered_set<Face*>{initialVisibleFace};
+  auto visitedFaces = kdl::vector_set<Face*>{faceCount()};
+  visitedFaces.insert(initialVisibleFace);
   visitFace(
     position, initialVisibleFace->boundary().front(), visitedFaces, seam, planeEpsilon);
 
@@ -649,7 +771,7 @@ template <typename T, typename FP, typename VP>
 void Polyhedron<T, FP, VP>::visitFace(
   const vm::vec<T, 3>& position,
   HalfEdge* initialBoundaryEdge,
-  std::unordered_set<Face*>& visitedFaces,
+  kdl::vector_set<Face*>& visitedFaces,
   Seam& seam,
   const T planeEpsilon)
 {
@@ -705,7 +827,7 @@ void Polyhedron<T, FP, VP>::split(const Seam& seam)
   // The first half edge we remembered above is our entry point into that portion of the
   // polyhedron. We must remember which faces we have already visited to stop the
   // recursion.
-  auto visitedFaces = std::unordered_set<Face*>{};
+  auto visitedFaces = kdl::vector_set<Face*>{faceCount()};
 
   // Will automatically delete the vertices when it falls out of scope
   auto verticesToDelete = VertexList{};
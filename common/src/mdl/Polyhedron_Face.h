@@ -327,20 +327,22 @@ bool Polyhedron_Face<T, FP, VP>::coplanar(const Face* other, const T epsilon) co
   assert(other != nullptr);
 
   // Test if the normals are colinear by checking their enclosed angle.
-  if (T(1) - vm::dot(normal(), other->normal()) >= vm::constants<T>::colinear_epsilon())
+  const auto myNormal = normal();
+  const auto otherNormal = other->normal();
+  if (T(1) - vm::dot(myNormal, otherNormal) >= vm::constants<T>::colinear_epsilon())
   {
     return false;
   }
 
   const auto myPlane =
-    vm::plane<T, 3>{m_boundary.front()->origin()->position(), normal()};
+    vm::plane<T, 3>{m_boundary.front()->origin()->position(), myNormal};
   if (!other->verticesOnPlane(myPlane, epsilon))
   {
     return false;
   }
 
   const auto otherPlane =
-    vm::plane<T, 3>{other->boundary().front()->origin()->position(), other->normal()};
+    vm::plane<T, 3>{other->boundary().front()->origin()->position(), otherNormal};
   return verticesOnPlane(otherPlane, epsilon);
 }
 
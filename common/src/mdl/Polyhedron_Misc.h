@@ -24,6 +24,8 @@
 #include "kdl/range_utils.h"
 
 #include "vm/bbox.h"
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
 #include "vm/plane.h"
 #include "vm/ray.h"
 #include "vm/scalar.h"
@@ -31,7 +33,10 @@
 #include "vm/vec.h"
 #include "vm/vec_io.h" // IWYU pragma: keep
 
+#include <algorithm>
+#include <map>
 #include <sstream>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -173,6 +178,104 @@ Polyhedron<T, FP, VP>::Polyhedron(std::vector<vm::vec<T, 3>> positions)
   addPoints(std::move(positions));
 }
 
+template <typename T, typename FP, typename VP>
+Polyhedron<T, FP, VP>::Polyhedron(
+  std::vector<vm::vec<T, 3>> positions,
+  const std::vector<std::vector<std::size_t>>& faces)
+{
+  const auto isValidFace = [&](const auto& face) {
+    for (std::size_t i = 0; i < face.size(); ++i)
+    {
+      const auto origin = face[i];
+      const auto destination = face[(i + 1) % face.size()];
+      if (origin >= positions.size() || origin == destination)
+      {
+        return false;
+      }
+    }
+    return face.size() >= 3;
+  };
+
+  if (!std::all_of(faces.begin(), faces.end(), isValidFace))
+  {
+    updateBounds();
+    return;
+  }
+
+  auto vertices = std::vector<Vertex*>{};
+  vertices.reserve(positions.size());
+  for (const auto& position : positions)
+  {
+    auto* vertex = new Vertex{position};
+    vertices.push_back(vertex);
+    m_vertices.push_back(vertex);
+  }
+
+  auto valid = true;
+
+  // maps the indices of the origin and the destination of each half edge to the half edge
+  auto halfEdges = std::map<std::tuple<std::size_t, std::size_t>, HalfEdge*>{};
+  for (const auto& face : faces)
+  {
+    auto boundary = HalfEdgeList{};
+    for (std::size_t i = 0; i < face.size(); ++i)
+    {
+      const auto origin = face[i];
+      const auto destination = face[(i + 1) % face.size()];
+
+      auto* halfEdge = new HalfEdge{vertices[origin]};
+      boundary.push_back(halfEdge);
+      const auto inserted =
+        halfEdges.emplace(std::tuple{origin, destination}, halfEdge).second;
+      valid = inserted && valid;
+    }
+
+    const auto plane =
+      vm::from_points(positions[face[1]], positions[face[0]], positions[face[2]]);
+    valid = plane.has_value() && valid;
+    m_faces.push_back(new Face{std::move(boundary), plane.value_or(vm::plane<T, 3>{})});
+  }
+
+  for (const auto& [indices, halfEdge] : halfEdges)
+  {
+    const auto& [origin, destination] = indices;
+    const auto twin = halfEdges.find(std::tuple{destination, origin});
+    if (twin == halfEdges.end())
+    {
+      m_edges.push_back(new Edge{halfEdge});
+      valid = false;
+    }
+    else if (origin < destination)
+    {
+      m_edges.push_back(new Edge{halfEdge, twin->second});
+    }
+  }
+
+  valid = valid && std::all_of(vertices.begin(), vertices.end(), [](const auto* vertex) {
+            return vertex->leaving() != nullptr;
+          });
+
+  if (!valid)
+  {
+    clear();
+    return;
+  }
+
+  updateBounds();
+}
+
+template <typename T, typename FP, typename VP>
+Polyhedron<T, FP, VP>::Polyhedron(
+  const Polyhedron<T, FP, VP>& previous, std::vector<vm::vec<T, 3>> positions)
+  : Polyhedron{previous}
+{
+  if (!moveVerticesRetainingTopology(positions))
+  {
+    clear();
+    addPoints(std::move(positions));
+  }
+}
+
 template <typename T, typename FP, typename VP>
 Polyhedron<T, FP, VP>::Polyhedron(const Polyhedron<T, FP, VP>& other)
 {
@@ -755,6 +858,30 @@ void Polyhedron<T, FP, VP>::updateBounds()
   }
 }
 
+template <typename T, typename FP, typename VP>
+void Polyhedron<T, FP, VP>::transform(const vm::mat<T, 4, 4>& transformation)
+{
+  assert(vm::compute_determinant(transformation) > T(0));
+
+  for (auto* vertex : m_vertices)
+  {
+    vertex->setPosition(transformation * vertex->position());
+  }
+
+  // normals must be transformed by the inverse transpose, otherwise shearing or
+  // non-uniform scaling would tilt them away from their faces
+  const auto normalTransformation =
+    vm::transpose(*vm::invert(vm::strip_translation(transformation)));
+  for (auto* face : m_faces)
+  {
+    const auto& plane = face->plane();
+    face->setPlane(vm::plane<T, 3>{
+      transformation * plane.anchor(),
+      vm::normalize(normalTransformation * plane.normal)});
+  }
+  updateBounds();
+}
+
 template <typename T, typename FP, typename VP>
 void Polyhedron<T, FP, VP>::correctVertexPositions(const size_t decimals, const T epsilon)
 {
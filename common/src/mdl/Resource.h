@@ -87,6 +87,14 @@ struct ResourceUnloaded
   kdl_reflect_inline_empty(ResourceUnloaded);
 };
 
+template <typename T>
+struct ResourceDeferred
+{
+  ResourceLoader<T> loader;
+
+  kdl_reflect_inline_empty(ResourceDeferred);
+};
+
 template <typename T>
 struct ResourceLoading
 {
@@ -134,6 +142,7 @@ struct ResourceFailed
 template <typename T>
 using ResourceState = std::variant<
   ResourceUnloaded<T>,
+  ResourceDeferred<T>,
   ResourceLoading<T>,
   ResourceLoaded<T>,
   ResourceReady<T>,
@@ -222,6 +231,8 @@ ResourceState<T> drop(ResourceDropping<T> state, const bool glContextAvailable)
  * | State          | Transition       | New state       |
  * |----------------|------------------|-----------------|
  * | Unloaded       | process          | Loading         |
+ * | Unloaded       | deferLoading     | Deferred        |
+ * | Deferred       | requestLoading   | Unloaded        |
  * | Loading        | process          | Loaded or Failed|
  * | Loaded         | process          | Ready           |
  * | Ready          | drop             | Dropping        |
@@ -280,9 +291,40 @@ public:
   bool needsProcessing() const
   {
     return !std::holds_alternative<ResourceReady<T>>(m_state)
+           && !std::holds_alternative<ResourceDeferred<T>>(m_state)
            && !std::holds_alternative<ResourceFailed>(m_state);
   }
 
+  bool isDeferred() const { return std::holds_alternative<ResourceDeferred<T>>(m_state); }
+
+  /**
+   * Prevents an unloaded resource from being loaded until requestLoading is called.
+   */
+  void deferLoading()
+  {
+    m_state = std::visit(
+      kdl::overload(
+        [](ResourceUnloaded<T> state) -> ResourceState<T> {
+          return ResourceDeferred<T>{std::move(state.loader)};
+        },
+        [](auto state) -> ResourceState<T> { return state; }),
+      std::move(m_state));
+  }
+
+  /**
+   * Allows a deferred resource to be loaded the next time it is processed.
+   */
+  void requestLoading()
+  {
+    m_state = std::visit(
+      kdl::overload(
+        [](ResourceDeferred<T> state) -> ResourceState<T> {
+          return ResourceUnloaded<T>{std::move(state.loader)};
+        },
+        [](auto state) -> ResourceState<T> { return state; }),
+      std::move(m_state));
+  }
+
   bool process(TaskRunner taskRunner, const ProcessContext& context)
   {
     const auto previousStateIndex = m_state.index();
@@ -330,17 +372,20 @@ public:
 
   void loadSync()
   {
+    const auto load = [](const ResourceLoader<T>& loader) -> ResourceState<T> {
+      return loader() | kdl::transform([](auto value) -> ResourceState<T> {
+               return ResourceLoaded<T>{std::move(value)};
+             })
+             | kdl::transform_error([](auto error) -> ResourceState<T> {
+                 return ResourceFailed{std::move(error.msg)};
+               })
+             | kdl::value();
+    };
+
     m_state = std::visit(
       kdl::overload(
-        [&](ResourceUnloaded<T> state) -> ResourceState<T> {
-          return state.loader() | kdl::transform([](auto value) -> ResourceState<T> {
-                   return ResourceLoaded<T>{std::move(value)};
-                 })
-                 | kdl::transform_error([](auto error) -> ResourceState<T> {
-                     return ResourceFailed{std::move(error.msg)};
-                   })
-                 | kdl::value();
-        },
+        [&](ResourceUnloaded<T> state) -> ResourceState<T> { return load(state.loader); },
+        [&](ResourceDeferred<T> state) -> ResourceState<T> { return load(state.loader); },
         [](auto state) -> ResourceState<T> { return state; }),
       std::move(m_state));
   }
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "Trace.h"
 #include "mdl/Resource.h"
 
 #include "kdl/collection_utils.h"
@@ -113,6 +114,8 @@ public:
     const ProcessContext& processContext,
     std::optional<std::chrono::milliseconds> timeout = std::nullopt)
   {
+    traceZone("ResourceManager::process");
+
     const auto checkTimeout =
       timeout ? std::function{[timeout_ = *timeout,
                                startTime = std::chrono::steady_clock::now()]() {
@@ -0,0 +1,143 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Thumbnail.h"
+
+#include "Error.h" // IWYU pragma: keep
+#include "mdl/Texture.h"
+#include "mdl/TextureBuffer.h"
+
+#include <algorithm>
+#include <array>
+
+namespace tb::mdl
+{
+namespace
+{
+
+size_t thumbnailExtent(const size_t extent, const size_t maxExtent, const size_t maxSize)
+{
+  return std::max(size_t(1), (extent * maxSize + maxExtent / 2) / maxExtent);
+}
+
+/**
+ * Averages the pixels of the given source rectangle. For formats with an alpha channel,
+ * the color channels are weighted by alpha so that transparent pixels do not bleed their
+ * color into the result.
+ */
+void averagePixels(
+  const unsigned char* source,
+  const size_t sourceWidth,
+  const size_t bytesPerPixel,
+  const size_t x0,
+  const size_t y0,
+  const size_t x1,
+  const size_t y1,
+  unsigned char* target)
+{
+  const auto hasAlpha = bytesPerPixel == 4;
+  const auto colorChannels = hasAlpha ? size_t(3) : bytesPerPixel;
+
+  auto sums = std::array<double, 4>{};
+  auto alphaSum = 0.0;
+  for (auto y = y0; y < y1; ++y)
+  {
+    const auto* row = source + (y * sourceWidth + x0) * bytesPerPixel;
+    for (auto x = x0; x < x1; ++x, row += bytesPerPixel)
+    {
+      const auto weight = hasAlpha ? double(row[3]) : 1.0;
+      for (size_t c = 0; c < colorChannels; ++c)
+      {
+        sums[c] += weight * double(row[c]);
+      }
+      alphaSum += weight;
+    }
+  }
+
+  const auto count = double((x1 - x0) * (y1 - y0));
+  for (size_t c = 0; c < colorChannels; ++c)
+  {
+    target[c] = alphaSum > 0.0 ? (unsigned char)(sums[c] / alphaSum + 0.5) : 0;
+  }
+  if (hasAlpha)
+  {
+    target[3] = (unsigned char)(alphaSum / count + 0.5);
+  }
+}
+
+} // namespace
+
+Result<Texture> createThumbnail(Texture texture, const size_t maxSize)
+{
+  const auto& buffers = texture.buffersIfLoaded();
+  if (buffers.empty())
+  {
+    return Error{"Texture is not loaded"};
+  }
+
+  const auto width = texture.width();
+  const auto height = texture.height();
+  const auto maxExtent = std::max(width, height);
+  if (maxExtent <= maxSize || isCompressedFormat(texture.format()))
+  {
+    return texture;
+  }
+
+  const auto bytesPerPixel = bytesPerPixelForFormat(texture.format());
+  const auto& source = buffers.front();
+  if (source.size() < width * height * bytesPerPixel)
+  {
+    return Error{"Texture has no pixel data"};
+  }
+
+  const auto thumbnailWidth = thumbnailExtent(width, maxExtent, maxSize);
+  const auto thumbnailHeight = thumbnailExtent(height, maxExtent, maxSize);
+
+  auto buffer = TextureBuffer{thumbnailWidth * thumbnailHeight * bytesPerPixel};
+  for (size_t y = 0; y < thumbnailHeight; ++y)
+  {
+    const auto y0 = y * height / thumbnailHeight;
+    const auto y1 = std::max(y0 + 1, (y + 1) * height / thumbnailHeight);
+    for (size_t x = 0; x < thumbnailWidth; ++x)
+    {
+      const auto x0 = x * width / thumbnailWidth;
+      const auto x1 = std::max(x0 + 1, (x + 1) * width / thumbnailWidth);
+      averagePixels(
+        source.data(),
+        width,
+        bytesPerPixel,
+        x0,
+        y0,
+        x1,
+        y1,
+        buffer.data() + (y * thumbnailWidth + x) * bytesPerPixel);
+    }
+  }
+
+  return Texture{
+    thumbnailWidth,
+    thumbnailHeight,
+    texture.averageColor(),
+    texture.format(),
+    texture.mask(),
+    NoEmbeddedDefaults{},
+    std::move(buffer)};
+}
+
+} // namespace tb::mdl
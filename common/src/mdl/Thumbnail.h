@@ -0,0 +1,48 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+#include "mdl/Texture.h"
+
+#include <cstddef>
+
+namespace tb::mdl
+{
+
+/**
+ * The maximum width and height of a material thumbnail. The material browser never shows
+ * a material larger than this, so a thumbnail can stand in for the full texture there.
+ */
+constexpr auto ThumbnailSize = size_t(128);
+
+/**
+ * Downscales the given texture so that it fits into a square of the given size while
+ * preserving its aspect ratio. Only the first mip level is used, and the thumbnail has no
+ * mip levels of its own.
+ *
+ * Textures that already fit and textures with a compressed format are returned as they
+ * are.
+ *
+ * Returns an error if the given texture is not loaded.
+ */
+Result<Texture> createThumbnail(Texture texture, size_t maxSize = ThumbnailSize);
+
+} // namespace tb::mdl
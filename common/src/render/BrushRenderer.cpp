@@ -20,6 +20,7 @@
 #include "BrushRenderer.h"
 
 #include "PreferenceManager.h"
+#include "Trace.h"
 #include "mdl/Brush.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
@@ -31,6 +32,7 @@
 #include "render/BrushRendererBrushCache.h"
 #include "render/RenderContext.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <vector>
@@ -182,6 +184,7 @@ void BrushRenderer::invalidate()
     removeBrushFromVbo(*brushNode);
   }
   m_invalidBrushes = m_allBrushes;
+  m_materialIndexValid = false;
 
   assert(m_brushInfo.empty());
   assert(m_transparentFaces->empty());
@@ -191,13 +194,14 @@ void BrushRenderer::invalidate()
 void BrushRenderer::invalidateMaterials(
   const std::vector<const mdl::Material*>& materials)
 {
-  const auto materialSet =
-    std::unordered_set<const mdl::Material*>{materials.begin(), materials.end()};
-  for (auto* brush : m_allBrushes)
+  updateMaterialIndex();
+
+  for (const auto* material : materials)
   {
-    for (const auto& face : brush->brush().faces())
+    if (const auto it = m_brushesByMaterial.find(material);
+        it != m_brushesByMaterial.end())
     {
-      if (materialSet.count(face.material()) > 0)
+      for (const auto* brush : it->second)
       {
         brush->brushRendererBrushCache().invalidateVertexCache();
         invalidateBrush(brush);
@@ -215,6 +219,9 @@ void BrushRenderer::invalidateBrush(const mdl::BrushNode* brushNode)
     assert(m_invalidBrushes.find(brushNode) == std::end(m_invalidBrushes));
     return;
   }
+  // the brush's faces may use different materials now
+  m_unindexedBrushes.insert(brushNode);
+
   // if it's not in the invalid set, put it in
   if (m_invalidBrushes.insert(brushNode).second)
   {
@@ -233,6 +240,11 @@ void BrushRenderer::clear()
   m_allBrushes.clear();
   m_invalidBrushes.clear();
 
+  m_brushesByMaterial.clear();
+  m_materialsByBrush.clear();
+  m_unindexedBrushes.clear();
+  m_materialIndexValid = true;
+
   m_vertexArray = std::make_shared<BrushVertexArray>();
   m_edgeIndices = std::make_shared<BrushIndexArray>();
   m_transparentFaces = std::make_shared<MaterialToBrushIndicesMap>();
@@ -381,6 +393,7 @@ void BrushRenderer::renderEdges(RenderBatch& renderBatch)
 void BrushRenderer::validate()
 {
   assert(!valid());
+  traceZone("BrushRenderer::validate");
 
   for (auto* brushNode : m_invalidBrushes)
   {
@@ -680,6 +693,7 @@ void BrushRenderer::addBrush(const mdl::BrushNode* brushNode)
   {
     assert(m_brushInfo.find(brushNode) == std::end(m_brushInfo));
     assertResult(m_invalidBrushes.insert(brushNode).second);
+    m_unindexedBrushes.insert(brushNode);
   }
 }
 
@@ -688,6 +702,9 @@ void BrushRenderer::removeBrush(const mdl::BrushNode* brushNode)
   // update m_brushValid
   m_allBrushes.erase(brushNode);
 
+  unindexBrush(brushNode);
+  m_unindexedBrushes.erase(brushNode);
+
   if (m_invalidBrushes.erase(brushNode) > 0u)
   {
     // invalid brushes are not in the VBO, so we can return  now.
@@ -698,6 +715,58 @@ void BrushRenderer::removeBrush(const mdl::BrushNode* brushNode)
   removeBrushFromVbo(*brushNode);
 }
 
+void BrushRenderer::updateMaterialIndex()
+{
+  if (!m_materialIndexValid)
+  {
+    m_brushesByMaterial.clear();
+    m_materialsByBrush.clear();
+    m_unindexedBrushes = m_allBrushes;
+    m_materialIndexValid = true;
+  }
+
+  for (const auto* brushNode : m_unindexedBrushes)
+  {
+    unindexBrush(brushNode);
+    indexBrush(brushNode);
+  }
+  m_unindexedBrushes.clear();
+}
+
+void BrushRenderer::indexBrush(const mdl::BrushNode* brushNode)
+{
+  auto& materials = m_materialsByBrush[brushNode];
+  for (const auto& face : brushNode->brush().faces())
+  {
+    const auto* material = face.material();
+    if (std::find(materials.begin(), materials.end(), material) == materials.end())
+    {
+      materials.push_back(material);
+      m_brushesByMaterial[material].insert(brushNode);
+    }
+  }
+}
+
+void BrushRenderer::unindexBrush(const mdl::BrushNode* brushNode)
+{
+  if (const auto it = m_materialsByBrush.find(brushNode); it != m_materialsByBrush.end())
+  {
+    for (const auto* material : it->second)
+    {
+      if (const auto bIt = m_brushesByMaterial.find(material);
+          bIt != m_brushesByMaterial.end())
+      {
+        bIt->second.erase(brushNode);
+        if (bIt->second.empty())
+        {
+          m_brushesByMaterial.erase(bIt);
+        }
+      }
+    }
+    m_materialsByBrush.erase(it);
+  }
+}
+
 void BrushRenderer::removeBrushFromVbo(const mdl::BrushNode& brushNode)
 {
   auto it = m_brushInfo.find(&brushNode);
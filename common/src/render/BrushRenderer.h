@@ -143,6 +143,21 @@ private:
   std::unordered_set<const mdl::BrushNode*> m_allBrushes;
   std::unordered_set<const mdl::BrushNode*> m_invalidBrushes;
 
+  /**
+   * Maps each material to the brushes that have a face using it, so that
+   * invalidateMaterials need not visit every face of every brush.
+   *
+   * The index is updated lazily in invalidateMaterials. Brushes that were added or
+   * invalidated since the last update are kept in m_unindexedBrushes, and if the entire
+   * renderer was invalidated, the index is rebuilt from scratch.
+   */
+  std::unordered_map<const mdl::Material*, std::unordered_set<const mdl::BrushNode*>>
+    m_brushesByMaterial;
+  std::unordered_map<const mdl::BrushNode*, std::vector<const mdl::Material*>>
+    m_materialsByBrush;
+  std::unordered_set<const mdl::BrushNode*> m_unindexedBrushes;
+  bool m_materialIndexValid = true;
+
   std::shared_ptr<BrushVertexArray> m_vertexArray;
   std::shared_ptr<BrushIndexArray> m_edgeIndices;
 
@@ -303,6 +318,10 @@ public:
   void removeBrush(const mdl::BrushNode* brushNode);
 
 private:
+  void updateMaterialIndex();
+  void indexBrush(const mdl::BrushNode* brushNode);
+  void unindexBrush(const mdl::BrushNode* brushNode);
+
   /**
    * If the given brush is not currently in the VBO, it's silently ignored.
    * Otherwise, it's removed from the VBO (having its indices zeroed out, causing it to no
@@ -192,13 +192,16 @@ public:
       return;
     }
 
-    // resize?
+    // resize? if the contents are preserved, only the dirty range must be uploaded
     if (m_dirtyRange.capacity() != (m_vbo->capacity() / sizeof(T)))
     {
-      freeBlock();
-      allocateBlock(vboManager);
-      assert(prepared());
-      return;
+      if (!m_vboManager->resizeVbo(*m_vbo, m_snapshot.size() * sizeof(T)))
+      {
+        m_vbo->writeElements(0, m_snapshot);
+        m_dirtyRange = DirtyRangeTracker(m_snapshot.size());
+        assert(prepared());
+        return;
+      }
     }
 
     // otherwise, it's an incremental update of the dirty ranges.
@@ -0,0 +1,248 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mdl/EntityNode.h"
+#include "render/ViewCuller.h"
+
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include <cmath>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace tb::render
+{
+
+/**
+ * Groups entities by the cell of a regular grid that contains the center of their
+ * bounds.
+ *
+ * Each cell stores the union of the physical bounds of its entities, which include their
+ * models, so that it can be culled against the view frustum as a whole, and it stores
+ * data of type T that is derived from its entities, e.g. vertex arrays. The data of a
+ * cell is rebuilt on demand when the cell was invalidated, so that changing a single
+ * entity does not require rebuilding the data for all entities.
+ */
+template <typename T>
+class EntityCellGrid
+{
+public:
+  static constexpr auto CellSize = 1024.0;
+
+  struct Cell
+  {
+    std::vector<const mdl::EntityNode*> entities;
+    vm::bbox3d bounds;
+    T data;
+    bool valid = false;
+  };
+
+private:
+  std::map<vm::vec3i, Cell> m_cells;
+  std::unordered_map<const mdl::EntityNode*, vm::vec3i> m_entityCells;
+
+public:
+  bool empty() const { return m_entityCells.empty(); }
+
+  size_t entityCount() const { return m_entityCells.size(); }
+
+  size_t cellCount() const { return m_cells.size(); }
+
+  /**
+   * Adds the given entity. Returns false if the entity was already added.
+   */
+  bool addEntity(const mdl::EntityNode* entityNode)
+  {
+    const auto key = cellKey(*entityNode);
+    if (!m_entityCells.emplace(entityNode, key).second)
+    {
+      return false;
+    }
+
+    auto& cell = m_cells[key];
+    cell.entities.push_back(entityNode);
+    cell.valid = false;
+    return true;
+  }
+
+  /**
+   * Removes the given entity. Returns false if the entity was not added.
+   */
+  bool removeEntity(const mdl::EntityNode* entityNode)
+  {
+    const auto it = m_entityCells.find(entityNode);
+    if (it == m_entityCells.end())
+    {
+      return false;
+    }
+
+    removeFromCell(it->second, entityNode);
+    m_entityCells.erase(it);
+    return true;
+  }
+
+  /**
+   * Invalidates the cell that contains the given entity, moving the entity to another
+   * cell if its bounds have changed.
+   */
+  void invalidateEntity(const mdl::EntityNode* entityNode)
+  {
+    const auto it = m_entityCells.find(entityNode);
+    if (it == m_entityCells.end())
+    {
+      return;
+    }
+
+    const auto key = cellKey(*entityNode);
+    if (key != it->second)
+    {
+      removeFromCell(it->second, entityNode);
+      it->second = key;
+      m_cells[key].entities.push_back(entityNode);
+    }
+    m_cells[key].valid = false;
+  }
+
+  void invalidate()
+  {
+    for (auto& [key, cell] : m_cells)
+    {
+      cell.valid = false;
+    }
+  }
+
+  void clear()
+  {
+    m_cells.clear();
+    m_entityCells.clear();
+  }
+
+  template <typename F>
+  void forEachEntity(const F& f) const
+  {
+    for (const auto& [key, cell] : m_cells)
+    {
+      for (const auto* entityNode : cell.entities)
+      {
+        f(entityNode);
+      }
+    }
+  }
+
+  /**
+   * Rebuilds the bounds and the data of every invalid cell by calling the given function
+   * with the cell's entities.
+   */
+  template <typename F>
+  void validate(const F& buildData)
+  {
+    for (auto& [key, cell] : m_cells)
+    {
+      if (!cell.valid)
+      {
+        cell.bounds = computeBounds(cell.entities);
+        cell.data = buildData(cell.entities);
+        cell.valid = true;
+      }
+    }
+  }
+
+  /**
+   * Returns the data of the cells that are visible according to the given culler. All
+   * cells must be valid.
+   */
+  std::vector<T*> findVisibleCells(const ViewCuller& culler)
+  {
+    auto result = std::vector<T*>{};
+    for (auto& [key, cell] : m_cells)
+    {
+      if (culler.visible(cell.bounds))
+      {
+        result.push_back(&cell.data);
+      }
+    }
+    return result;
+  }
+
+  /**
+   * Calls the given function for each entity in a cell that is visible according to the
+   * given culler after expanding the cell's bounds by the given margin. All cells must be
+   * valid.
+   */
+  template <typename F>
+  void forEachVisibleEntity(
+    const ViewCuller& culler, const double margin, const F& f) const
+  {
+    for (const auto& [key, cell] : m_cells)
+    {
+      if (culler.visible(cell.bounds.expand(margin)))
+      {
+        for (const auto* entityNode : cell.entities)
+        {
+          f(entityNode);
+        }
+      }
+    }
+  }
+
+private:
+  static vm::vec3i cellKey(const mdl::EntityNode& entityNode)
+  {
+    const auto center = entityNode.logicalBounds().center();
+    return vm::vec3i{
+      int(std::floor(center.x() / CellSize)),
+      int(std::floor(center.y() / CellSize)),
+      int(std::floor(center.z() / CellSize))};
+  }
+
+  static vm::bbox3d computeBounds(const std::vector<const mdl::EntityNode*>& entities)
+  {
+    auto builder = vm::bbox3d::builder{};
+    for (const auto* entityNode : entities)
+    {
+      builder.add(entityNode->physicalBounds());
+    }
+    return builder.initialized() ? builder.bounds() : vm::bbox3d{};
+  }
+
+  void removeFromCell(const vm::vec3i& key, const mdl::EntityNode* entityNode)
+  {
+    const auto it = m_cells.find(key);
+    if (it != m_cells.end())
+    {
+      it->second.entities = kdl::vec_erase(std::move(it->second.entities), entityNode);
+      if (it->second.entities.empty())
+      {
+        m_cells.erase(it);
+      }
+      else
+      {
+        it->second.valid = false;
+      }
+    }
+  }
+};
+
+} // namespace tb::render
@@ -35,14 +35,25 @@
 #include "render/RenderContext.h"
 #include "render/RenderUtils.h"
 #include "render/Shaders.h"
-#include "render/Transformation.h"
+#include "render/ViewCuller.h"
 
 #include "vm/mat.h"
 
+#include <unordered_map>
 #include <vector>
 
 namespace tb::render
 {
+namespace
+{
+
+struct Instance
+{
+  vm::mat4x4f transformation;
+  int orientation;
+};
+
+} // namespace
 
 EntityModelRenderer::EntityModelRenderer(
   Logger& logger,
@@ -190,6 +201,10 @@ void EntityModelRenderer::doRender(RenderContext& renderContext)
     const auto& propertyConfig = m_entities.begin()->first->entityPropertyConfig();
     const auto& defaultModelScaleExpression = propertyConfig.defaultModelScaleExpression;
 
+    // group the visible entities by their renderer so that the materials of every model
+    // frame are bound only once for all of its instances
+    const auto culler = ViewCuller{renderContext.camera()};
+    auto batches = std::unordered_map<MaterialRenderer*, std::vector<Instance>>{};
     for (const auto& [entityNode, renderer] : m_entities)
     {
       if (!m_showHiddenEntities && !m_editorContext.visible(entityNode))
@@ -199,23 +214,28 @@ void EntityModelRenderer::doRender(RenderContext& renderContext)
 
       const auto* model = entityNode->entity().model();
       const auto* modelData = model ? model->data() : nullptr;
-      if (!modelData)
+      // the physical bounds include the model, which can extend past the logical bounds
+      if (!modelData || !culler.visible(entityNode->physicalBounds()))
       {
         continue;
       }
 
-      shader.set("Orientation", static_cast<int>(modelData->orientation()));
-
       const auto transformation = vm::mat4x4f{
         entityNode->entity().modelTransformation(defaultModelScaleExpression)};
-      const auto multMatrix =
-        MultiplyModelMatrix{renderContext.transformation(), transformation};
-
-      shader.set("ModelMatrix", transformation);
+      batches[renderer].push_back(
+        Instance{transformation, static_cast<int>(modelData->orientation())});
+    }
 
-      auto renderFunc = DefaultMaterialRenderFunc{
-        renderContext.minFilterMode(), renderContext.magFilterMode()};
-      renderer->render(renderFunc);
+    auto renderFunc = DefaultMaterialRenderFunc{
+      renderContext.minFilterMode(), renderContext.magFilterMode()};
+    for (const auto& [renderer, instances] : batches)
+    {
+      // the entity model shader computes the vertex positions from the model matrix
+      // uniform, so only that uniform needs to change between instances
+      renderer->renderInstances(renderFunc, instances.size(), [&](const size_t i) {
+        shader.set("Orientation", instances[i].orientation);
+        shader.set("ModelMatrix", instances[i].transformation);
+      });
     }
   }
 }
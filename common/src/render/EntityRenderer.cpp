@@ -32,6 +32,7 @@
 #include "render/RenderContext.h"
 #include "render/RenderService.h"
 #include "render/TextAnchor.h"
+#include "render/ViewCuller.h"
 
 #include "vm/mat.h"
 #include "vm/mat_ext.h"
@@ -44,6 +45,8 @@ namespace tb::render
 namespace
 {
 
+constexpr auto LabelMargin = 128.0;
+
 class EntityClassnameAnchor : public TextAnchor3D
 {
 private:
@@ -86,9 +89,7 @@ void EntityRenderer::invalidate()
 void EntityRenderer::clear()
 {
   m_entities.clear();
-  m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer();
-  m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer();
-  m_solidBoundsRenderer = TriangleRenderer();
+  m_boundsCells.clear();
   m_modelRenderer.clear();
 }
 
@@ -102,7 +103,7 @@ void EntityRenderer::addEntity(const mdl::EntityNode* entity)
   if (m_entities.insert(entity).second)
   {
     m_modelRenderer.addEntity(entity);
-    invalidateBounds();
+    m_boundsCells.addEntity(entity);
   }
 }
 
@@ -112,14 +113,14 @@ void EntityRenderer::removeEntity(const mdl::EntityNode* entity)
   {
     m_entities.erase(it);
     m_modelRenderer.removeEntity(entity);
-    invalidateBounds();
+    m_boundsCells.removeEntity(entity);
   }
 }
 
 void EntityRenderer::invalidateEntity(const mdl::EntityNode* entity)
 {
   m_modelRenderer.updateEntity(entity);
-  invalidateBounds();
+  m_boundsCells.invalidateEntity(entity);
 }
 
 void EntityRenderer::invalidateEntityModels(
@@ -214,56 +215,60 @@ void EntityRenderer::render(RenderContext& renderContext, RenderBatch& renderBat
 
 void EntityRenderer::renderBounds(RenderContext& renderContext, RenderBatch& renderBatch)
 {
-  if (!m_boundsValid)
-  {
-    validateBounds();
-  }
+  m_boundsCells.validate(
+    [&](const auto& entityNodes) { return buildBoundsRenderers(entityNodes); });
 
-  if (renderContext.showPointEntityBounds())
+  const auto culler = ViewCuller{renderContext.camera()};
+  for (auto* boundsRenderers : m_boundsCells.findVisibleCells(culler))
   {
-    renderPointEntityWireframeBounds(renderBatch);
-  }
+    if (renderContext.showPointEntityBounds())
+    {
+      renderPointEntityWireframeBounds(*boundsRenderers, renderBatch);
+    }
 
-  if (renderContext.showBrushEntityBounds())
-  {
-    renderBrushEntityWireframeBounds(renderBatch);
-  }
+    if (renderContext.showBrushEntityBounds())
+    {
+      renderBrushEntityWireframeBounds(*boundsRenderers, renderBatch);
+    }
 
-  if (m_showHiddenEntities || renderContext.showPointEntities())
-  {
-    renderSolidBounds(renderBatch);
+    if (m_showHiddenEntities || renderContext.showPointEntities())
+    {
+      renderSolidBounds(*boundsRenderers, renderBatch);
+    }
   }
 }
 
-void EntityRenderer::renderPointEntityWireframeBounds(RenderBatch& renderBatch)
+void EntityRenderer::renderPointEntityWireframeBounds(
+  BoundsRenderers& boundsRenderers, RenderBatch& renderBatch)
 {
+  auto& renderer = boundsRenderers.pointEntityWireframeBoundsRenderer;
   if (m_showOccludedBounds)
   {
-    m_pointEntityWireframeBoundsRenderer.renderOnTop(
-      renderBatch, m_overrideBoundsColor, m_occludedBoundsColor);
+    renderer.renderOnTop(renderBatch, m_overrideBoundsColor, m_occludedBoundsColor);
   }
 
-  m_pointEntityWireframeBoundsRenderer.render(
-    renderBatch, m_overrideBoundsColor, m_boundsColor);
+  renderer.render(renderBatch, m_overrideBoundsColor, m_boundsColor);
 }
 
-void EntityRenderer::renderBrushEntityWireframeBounds(RenderBatch& renderBatch)
+void EntityRenderer::renderBrushEntityWireframeBounds(
+  BoundsRenderers& boundsRenderers, RenderBatch& renderBatch)
 {
+  auto& renderer = boundsRenderers.brushEntityWireframeBoundsRenderer;
   if (m_showOccludedBounds)
   {
-    m_brushEntityWireframeBoundsRenderer.renderOnTop(
-      renderBatch, m_overrideBoundsColor, m_occludedBoundsColor);
+    renderer.renderOnTop(renderBatch, m_overrideBoundsColor, m_occludedBoundsColor);
   }
 
-  m_brushEntityWireframeBoundsRenderer.render(
-    renderBatch, m_overrideBoundsColor, m_boundsColor);
+  renderer.render(renderBatch, m_overrideBoundsColor, m_boundsColor);
 }
 
-void EntityRenderer::renderSolidBounds(RenderBatch& renderBatch)
+void EntityRenderer::renderSolidBounds(
+  BoundsRenderers& boundsRenderers, RenderBatch& renderBatch)
 {
-  m_solidBoundsRenderer.setApplyTinting(m_tint);
-  m_solidBoundsRenderer.setTintColor(m_tintColor);
-  renderBatch.add(&m_solidBoundsRenderer);
+  auto& renderer = boundsRenderers.solidBoundsRenderer;
+  renderer.setApplyTinting(m_tint);
+  renderer.setTintColor(m_tintColor);
+  renderBatch.add(&renderer);
 }
 
 void EntityRenderer::renderModels(RenderContext& renderContext, RenderBatch& renderBatch)
@@ -288,8 +293,10 @@ void EntityRenderer::renderClassnames(
     renderService.setForegroundColor(m_overlayTextColor);
     renderService.setBackgroundColor(m_overlayBackgroundColor);
 
-    for (const auto* entity : m_entities)
-    {
+    // only consider the entities in cells that are in view, leaving some room for the
+    // labels that extend beyond the bounds of their entities
+    const auto culler = ViewCuller{renderContext.camera(), 0.0f};
+    m_boundsCells.forEachVisibleEntity(culler, LabelMargin, [&](const auto* entity) {
       if (m_showHiddenEntities || m_editorContext.visible(entity))
       {
         if (
@@ -308,7 +315,7 @@ void EntityRenderer::renderClassnames(
           renderService.renderString(entityString(entity), EntityClassnameAnchor{entity});
         }
       }
-    }
+    });
   }
 }
 
@@ -380,7 +387,7 @@ std::vector<vm::vec3f> EntityRenderer::arrowHead(
 
 void EntityRenderer::invalidateBounds()
 {
-  m_boundsValid = false;
+  m_boundsCells.invalidate();
 }
 
 namespace
@@ -421,10 +428,13 @@ auto makeColoredSolidBoundsVertexBuilder(
 
 } // namespace
 
-void EntityRenderer::validateBounds()
+EntityRenderer::BoundsRenderers EntityRenderer::buildBoundsRenderers(
+  const std::vector<const mdl::EntityNode*>& entityNodes) const
 {
+  auto boundsRenderers = BoundsRenderers{};
+
   auto solidVertices = std::vector<GLVertexTypes::P3NC4::Vertex>{};
-  solidVertices.reserve(36 * m_entities.size());
+  solidVertices.reserve(36 * entityNodes.size());
 
   if (m_overrideBoundsColor)
   {
@@ -432,10 +442,10 @@ void EntityRenderer::validateBounds()
     auto pointEntityWireframeVertices = std::vector<Vertex>{};
     auto brushEntityWireframeVertices = std::vector<Vertex>{};
 
-    pointEntityWireframeVertices.reserve(24 * m_entities.size());
-    brushEntityWireframeVertices.reserve(24 * m_entities.size());
+    pointEntityWireframeVertices.reserve(24 * entityNodes.size());
+    brushEntityWireframeVertices.reserve(24 * entityNodes.size());
 
-    for (const auto* entityNode : m_entities)
+    for (const auto* entityNode : entityNodes)
     {
       if (m_editorContext.visible(entityNode))
       {
@@ -458,9 +468,9 @@ void EntityRenderer::validateBounds()
       }
     }
 
-    m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer{
+    boundsRenderers.pointEntityWireframeBoundsRenderer = DirectEdgeRenderer{
       VertexArray::move(std::move(pointEntityWireframeVertices)), PrimType::Lines};
-    m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer{
+    boundsRenderers.brushEntityWireframeBoundsRenderer = DirectEdgeRenderer{
       VertexArray::move(std::move(brushEntityWireframeVertices)), PrimType::Lines};
   }
   else
@@ -469,10 +479,10 @@ void EntityRenderer::validateBounds()
     auto pointEntityWireframeVertices = std::vector<Vertex>{};
     auto brushEntityWireframeVertices = std::vector<Vertex>{};
 
-    pointEntityWireframeVertices.reserve(24 * m_entities.size());
-    brushEntityWireframeVertices.reserve(24 * m_entities.size());
+    pointEntityWireframeVertices.reserve(24 * entityNodes.size());
+    brushEntityWireframeVertices.reserve(24 * entityNodes.size());
 
-    for (auto* entityNode : m_entities)
+    for (const auto* entityNode : entityNodes)
     {
       if (m_editorContext.visible(entityNode))
       {
@@ -497,15 +507,15 @@ void EntityRenderer::validateBounds()
       }
     }
 
-    m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer(
+    boundsRenderers.pointEntityWireframeBoundsRenderer = DirectEdgeRenderer(
       VertexArray::move(std::move(pointEntityWireframeVertices)), PrimType::Lines);
-    m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer(
+    boundsRenderers.brushEntityWireframeBoundsRenderer = DirectEdgeRenderer(
       VertexArray::move(std::move(brushEntityWireframeVertices)), PrimType::Lines);
   }
 
-  m_solidBoundsRenderer =
+  boundsRenderers.solidBoundsRenderer =
     TriangleRenderer{VertexArray::move(std::move(solidVertices)), PrimType::Quads};
-  m_boundsValid = true;
+  return boundsRenderers;
 }
 
 AttrString EntityRenderer::entityString(const mdl::EntityNode* entityNode) const
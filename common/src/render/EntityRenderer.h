@@ -21,6 +21,7 @@
 
 #include "Color.h"
 #include "render/EdgeRenderer.h"
+#include "render/EntityCellGrid.h"
 #include "render/EntityModelRenderer.h"
 #include "render/Renderable.h"
 #include "render/TriangleRenderer.h"
@@ -49,16 +50,23 @@ class AttrString;
 class EntityRenderer
 {
 private:
+  struct BoundsRenderers
+  {
+    DirectEdgeRenderer pointEntityWireframeBoundsRenderer;
+    DirectEdgeRenderer brushEntityWireframeBoundsRenderer;
+    TriangleRenderer solidBoundsRenderer;
+  };
+
   mdl::EntityModelManager& m_entityModelManager;
   const mdl::EditorContext& m_editorContext;
   kdl::vector_set<const mdl::EntityNode*> m_entities;
 
-  DirectEdgeRenderer m_pointEntityWireframeBoundsRenderer;
-  DirectEdgeRenderer m_brushEntityWireframeBoundsRenderer;
-
-  TriangleRenderer m_solidBoundsRenderer;
+  /**
+   * The bounds are rendered per cell so that cells outside of the view frustum can be
+   * skipped and so that changing an entity only rebuilds the bounds of its cell.
+   */
+  EntityCellGrid<BoundsRenderers> m_boundsCells;
   EntityModelRenderer m_modelRenderer;
-  bool m_boundsValid = false;
 
   bool m_showOverlays = true;
   Color m_overlayTextColor;
@@ -135,16 +143,19 @@ public: // rendering
 
 private:
   void renderBounds(RenderContext& renderContext, RenderBatch& renderBatch);
-  void renderPointEntityWireframeBounds(RenderBatch& renderBatch);
-  void renderBrushEntityWireframeBounds(RenderBatch& renderBatch);
-  void renderSolidBounds(RenderBatch& renderBatch);
+  void renderPointEntityWireframeBounds(
+    BoundsRenderers& boundsRenderers, RenderBatch& renderBatch);
+  void renderBrushEntityWireframeBounds(
+    BoundsRenderers& boundsRenderers, RenderBatch& renderBatch);
+  void renderSolidBounds(BoundsRenderers& boundsRenderers, RenderBatch& renderBatch);
   void renderModels(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderClassnames(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderAngles(RenderContext& renderContext, RenderBatch& renderBatch);
   std::vector<vm::vec3f> arrowHead(float length, float width) const;
 
   void invalidateBounds();
-  void validateBounds();
+  BoundsRenderers buildBoundsRenderers(
+    const std::vector<const mdl::EntityNode*>& entityNodes) const;
 
   AttrString entityString(const mdl::EntityNode* entityNode) const;
   const Color& boundsColor(const mdl::EntityNode* entityNode) const;
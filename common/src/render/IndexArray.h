@@ -123,7 +123,7 @@ private:
         toGL(primType),
         static_cast<GLsizei>(count),
         GL_UNSIGNED_INT,
-        reinterpret_cast<void*>(offset * 4u)));
+        reinterpret_cast<void*>(m_vbo->offset() + offset * 4u)));
     }
 
   private:
@@ -21,6 +21,7 @@
 
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Trace.h"
 #include "mdl/Brush.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
@@ -226,6 +227,8 @@ void MapRenderer::restoreSelectionColors()
 
 void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  traceZone("MapRenderer::render");
+
   setupGL(renderBatch);
   renderEntityDecals(renderContext, renderBatch);
   renderEntityLinks(renderContext, renderBatch);
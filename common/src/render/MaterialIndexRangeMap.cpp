@@ -140,6 +140,24 @@ void MaterialIndexRangeMap::render(VertexArray& vertexArray, MaterialRenderFunc&
   }
 }
 
+void MaterialIndexRangeMap::renderInstances(
+  VertexArray& vertexArray,
+  MaterialRenderFunc& func,
+  const size_t instanceCount,
+  const std::function<void(size_t)>& setupInstance)
+{
+  for (const auto& [material, indexArray] : *m_data)
+  {
+    func.before(material);
+    for (size_t i = 0; i < instanceCount; ++i)
+    {
+      setupInstance(i);
+      indexArray.render(vertexArray);
+    }
+    func.after(material);
+  }
+}
+
 void MaterialIndexRangeMap::forEachPrimitive(
   std::function<void(const Material*, PrimType, size_t, size_t)> func) const
 {
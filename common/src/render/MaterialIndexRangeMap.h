@@ -175,6 +175,23 @@ public:
    */
   void render(VertexArray& vertexArray, MaterialRenderFunc& func);
 
+  /**
+   * Renders the primitives stored in this index range map several times using the
+   * vertices in the given vertex array. The material callbacks are invoked only once per
+   * material, and all instances are rendered in between. Before an instance is rendered,
+   * the given setup function is called with the index of that instance.
+   *
+   * @param vertexArray the vertex array to render with
+   * @param func the material callbacks
+   * @param instanceCount the number of instances to render
+   * @param setupInstance called before each instance is rendered
+   */
+  void renderInstances(
+    VertexArray& vertexArray,
+    MaterialRenderFunc& func,
+    size_t instanceCount,
+    const std::function<void(size_t)>& setupInstance);
+
   /**
    * Invokes the given function for each primitive stored in this map.
    *
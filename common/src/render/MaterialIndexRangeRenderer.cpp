@@ -63,6 +63,18 @@ void MaterialIndexRangeRenderer::render(MaterialRenderFunc& func)
   }
 }
 
+void MaterialIndexRangeRenderer::renderInstances(
+  MaterialRenderFunc& func,
+  const size_t instanceCount,
+  const std::function<void(size_t)>& setupInstance)
+{
+  if (instanceCount > 0 && m_vertexArray.setup())
+  {
+    m_indexRange.renderInstances(m_vertexArray, func, instanceCount, setupInstance);
+    m_vertexArray.cleanup();
+  }
+}
+
 MultiMaterialIndexRangeRenderer::MultiMaterialIndexRangeRenderer(
   std::vector<std::unique_ptr<MaterialIndexRangeRenderer>> renderers)
   : m_renderers{std::move(renderers)}
@@ -99,4 +111,15 @@ void MultiMaterialIndexRangeRenderer::render(MaterialRenderFunc& func)
   }
 }
 
+void MultiMaterialIndexRangeRenderer::renderInstances(
+  MaterialRenderFunc& func,
+  const size_t instanceCount,
+  const std::function<void(size_t)>& setupInstance)
+{
+  for (auto& renderer : m_renderers)
+  {
+    renderer->renderInstances(func, instanceCount, setupInstance);
+  }
+}
+
 } // namespace tb::render
@@ -22,6 +22,7 @@
 #include "render/MaterialIndexRangeMap.h"
 #include "render/VertexArray.h"
 
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -44,6 +45,17 @@ public:
 
   virtual void prepare(VboManager& vboManager) = 0;
   virtual void render(MaterialRenderFunc& func) = 0;
+
+  /**
+   * Renders this renderer's primitives once for each of the given number of instances.
+   * Materials are bound once for all instances. The given function is called with the
+   * index of an instance before that instance is rendered, e.g. to set its
+   * transformation.
+   */
+  virtual void renderInstances(
+    MaterialRenderFunc& func,
+    size_t instanceCount,
+    const std::function<void(size_t)>& setupInstance) = 0;
 };
 
 class MaterialIndexRangeRenderer : public MaterialRenderer
@@ -63,6 +75,10 @@ public:
 
   void prepare(VboManager& vboManager) override;
   void render(MaterialRenderFunc& func) override;
+  void renderInstances(
+    MaterialRenderFunc& func,
+    size_t instanceCount,
+    const std::function<void(size_t)>& setupInstance) override;
 };
 
 class MultiMaterialIndexRangeRenderer : public MaterialRenderer
@@ -79,6 +95,10 @@ public:
 
   void prepare(VboManager& vboManager) override;
   void render(MaterialRenderFunc& func) override;
+  void renderInstances(
+    MaterialRenderFunc& func,
+    size_t instanceCount,
+    const std::function<void(size_t)>& setupInstance) override;
 };
 
 } // namespace tb::render
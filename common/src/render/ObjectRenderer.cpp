@@ -52,7 +52,7 @@ void ObjectRenderer::invalidateMaterials(
   const std::vector<const mdl::Material*>& materials)
 {
   m_brushRenderer.invalidateMaterials(materials);
-  m_patchRenderer.invalidate();
+  m_patchRenderer.invalidateMaterials(materials);
 }
 
 void ObjectRenderer::invalidateEntityModels(
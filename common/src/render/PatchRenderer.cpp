@@ -19,6 +19,7 @@
 
 #include "PatchRenderer.h"
 
+#include "Macros.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "mdl/EditorContext.h"
@@ -26,18 +27,14 @@
 #include "mdl/PatchNode.h"
 #include "mdl/Texture.h"
 #include "render/ActiveShader.h"
+#include "render/BrushRendererArrays.h"
 #include "render/Camera.h"
 #include "render/GLVertexType.h"
-#include "render/IndexRangeMapBuilder.h"
-#include "render/MaterialIndexArrayMapBuilder.h"
-#include "render/MaterialIndexArrayRenderer.h"
+#include "render/PrimType.h"
 #include "render/RenderBatch.h"
 #include "render/RenderContext.h"
 #include "render/RenderUtils.h"
 #include "render/Shaders.h"
-#include "render/VertexArray.h"
-
-#include "kdl/vector_utils.h"
 
 #include "vm/vec.h"
 
@@ -47,6 +44,7 @@ namespace tb::render
 PatchRenderer::PatchRenderer(const mdl::EditorContext& editorContext)
   : m_editorContext{editorContext}
 {
+  clear();
 }
 
 void PatchRenderer::setDefaultColor(const Color& faceColor)
@@ -96,40 +94,86 @@ void PatchRenderer::setOccludedEdgeColor(const Color& occludedEdgeColor)
 
 void PatchRenderer::invalidate()
 {
-  m_valid = false;
+  for (const auto* patchNode : m_allPatches)
+  {
+    removePatchFromVbo(*patchNode);
+  }
+  m_invalidPatches = m_allPatches;
+
+  assert(m_patchInfo.empty());
+  assert(m_faces->empty());
+}
+
+void PatchRenderer::invalidateMaterials(
+  const std::vector<const mdl::Material*>& materials)
+{
+  const auto materialSet =
+    std::unordered_set<const mdl::Material*>{materials.begin(), materials.end()};
+  for (const auto* patchNode : m_allPatches)
+  {
+    if (materialSet.contains(patchNode->patch().material()))
+    {
+      invalidatePatch(patchNode);
+    }
+  }
 }
 
 void PatchRenderer::clear()
 {
-  m_patchNodes.clear();
-  invalidate();
+  m_patchInfo.clear();
+  m_allPatches.clear();
+  m_invalidPatches.clear();
+
+  m_vertexArray = std::make_shared<BrushVertexArray>();
+  m_edgeIndices = std::make_shared<BrushIndexArray>();
+  m_faces = std::make_shared<MaterialToPatchIndicesMap>();
+
+  m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
 }
 
 void PatchRenderer::addPatch(const mdl::PatchNode* patchNode)
 {
-  if (m_patchNodes.insert(patchNode).second)
+  if (m_allPatches.insert(patchNode).second)
   {
-    invalidate();
+    assert(m_patchInfo.find(patchNode) == std::end(m_patchInfo));
+    assertResult(m_invalidPatches.insert(patchNode).second);
   }
 }
 
 void PatchRenderer::removePatch(const mdl::PatchNode* patchNode)
 {
-  if (auto it = m_patchNodes.find(patchNode); it != std::end(m_patchNodes))
+  if (m_allPatches.erase(patchNode) == 0u)
+  {
+    return;
+  }
+
+  if (m_invalidPatches.erase(patchNode) > 0u)
+  {
+    // invalid patches are not in the VBO
+    assert(m_patchInfo.find(patchNode) == std::end(m_patchInfo));
+    return;
+  }
+
+  removePatchFromVbo(*patchNode);
+}
+
+void PatchRenderer::invalidatePatch(const mdl::PatchNode* patchNode)
+{
+  if (
+    m_allPatches.contains(patchNode) && m_invalidPatches.insert(patchNode).second)
   {
-    m_patchNodes.erase(it);
-    invalidate();
+    removePatchFromVbo(*patchNode);
   }
 }
 
-void PatchRenderer::invalidatePatch(const mdl::PatchNode*)
+bool PatchRenderer::valid() const
 {
-  invalidate();
+  return m_invalidPatches.empty();
 }
 
 void PatchRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
-  if (!m_valid)
+  if (!valid())
   {
     validate();
   }
@@ -149,167 +193,176 @@ void PatchRenderer::render(RenderContext& renderContext, RenderBatch& renderBatc
   }
 }
 
-static MaterialIndexArrayRenderer buildMeshRenderer(
-  const std::vector<const mdl::PatchNode*>& patchNodes,
-  const mdl::EditorContext& editorContext)
+void PatchRenderer::validate()
 {
-  size_t vertexCount = 0u;
-  auto indexArrayMapSize = MaterialIndexArrayMap::Size{};
-
-  for (const auto* patchNode : patchNodes)
+  for (const auto* patchNode : m_invalidPatches)
   {
-    if (editorContext.visible(patchNode))
-    {
-      vertexCount += patchNode->grid().pointRowCount * patchNode->grid().pointColumnCount;
-
-      const auto* material = patchNode->patch().material();
-      const auto quadCount =
-        patchNode->grid().quadRowCount() * patchNode->grid().quadColumnCount();
-      indexArrayMapSize.inc(material, PrimType::Triangles, 6u * quadCount);
-    }
+    validatePatch(*patchNode);
   }
+  m_invalidPatches.clear();
+  assert(valid());
 
-  using Vertex = GLVertexTypes::P3NT2::Vertex;
-  auto vertices = std::vector<Vertex>{};
-  vertices.reserve(vertexCount);
+  m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
+}
 
-  auto indexArrayMapBuilder = MaterialIndexArrayMapBuilder{indexArrayMapSize};
-  using Index = MaterialIndexArrayMapBuilder::Index;
+void PatchRenderer::validatePatch(const mdl::PatchNode& patchNode)
+{
+  assert(m_patchInfo.find(&patchNode) == std::end(m_patchInfo));
 
-  for (const auto* patchNode : patchNodes)
+  if (!m_editorContext.visible(&patchNode))
   {
-    if (editorContext.visible(patchNode))
-    {
-      const auto vertexOffset = vertices.size();
-
-      const auto& grid = patchNode->grid();
-      auto gridVertices = kdl::vec_transform(grid.points, [](const auto& p) {
-        return Vertex{vm::vec3f{p.position}, vm::vec3f{p.normal}, vm::vec2f{p.uvCoords}};
-      });
-      vertices = kdl::vec_concat(std::move(vertices), std::move(gridVertices));
+    // NOTE: this skips inserting the patch into m_patchInfo
+    return;
+  }
 
-      const auto* material = patchNode->patch().material();
+  auto& info = m_patchInfo[&patchNode];
+  const auto& grid = patchNode.grid();
 
-      const auto pointsPerRow = grid.pointColumnCount;
-      for (size_t row = 0u; row < grid.quadRowCount(); ++row)
-      {
-        for (size_t col = 0u; col < grid.quadColumnCount(); ++col)
-        {
-          const auto i0 = vertexOffset + row * pointsPerRow + col;
-          const auto i1 = vertexOffset + row * pointsPerRow + col + 1u;
-          const auto i2 = vertexOffset + (row + 1u) * pointsPerRow + col + 1u;
-          const auto i3 = vertexOffset + (row + 1u) * pointsPerRow + col;
-
-          indexArrayMapBuilder.addTriangle(
-            material,
-            static_cast<Index>(i0),
-            static_cast<Index>(i1),
-            static_cast<Index>(i2));
-          indexArrayMapBuilder.addTriangle(
-            material,
-            static_cast<Index>(i2),
-            static_cast<Index>(i3),
-            static_cast<Index>(i0));
-        }
-      }
-    }
+  // insert the tessellated grid points into the VBO
+  auto [vertexKey, vertexDest] =
+    m_vertexArray->getPointerToInsertVerticesAt(grid.points.size());
+  for (const auto& p : grid.points)
+  {
+    *vertexDest++ = GLVertexTypes::P3NT2::Vertex{
+      vm::vec3f{p.position}, vm::vec3f{p.normal}, vm::vec2f{p.uvCoords}};
   }
+  info.vertexHolderKey = vertexKey;
 
-  auto vertexArray = VertexArray::move(std::move(vertices));
-  auto indexArray = IndexArray::move(std::move(indexArrayMapBuilder.indices()));
-  return MaterialIndexArrayRenderer{
-    std::move(vertexArray),
-    std::move(indexArray),
-    std::move(indexArrayMapBuilder.ranges())};
-}
-
-static DirectEdgeRenderer buildEdgeRenderer(
-  const std::vector<const mdl::PatchNode*>& patchNodes,
-  const mdl::EditorContext& editorContext)
-{
-  size_t vertexCount = 0u;
-  auto indexRangeMapSize = IndexRangeMap::Size{};
+  const auto vertexOffset = vertexKey->pos;
+  const auto pointIndex = [&](const size_t row, const size_t col) {
+    return static_cast<GLuint>(vertexOffset + row * grid.pointColumnCount + col);
+  };
 
-  for (const auto* patchNode : patchNodes)
+  // insert two triangles per quad into the index array of the patch's material
+  const auto quadCount = grid.quadRowCount() * grid.quadColumnCount();
+  if (quadCount > 0u)
   {
-    if (editorContext.visible(patchNode))
+    const auto* material = patchNode.patch().material();
+    auto& holderPtr = (*m_faces)[material];
+    if (holderPtr == nullptr)
     {
-      vertexCount +=
-        (patchNode->grid().pointRowCount + patchNode->grid().pointColumnCount - 2u) * 2u;
-      indexRangeMapSize.inc(PrimType::LineLoop, vertexCount);
+      // inserts into map!
+      holderPtr = std::make_shared<BrushIndexArray>();
     }
-  }
 
-  auto indexRangeMapBuilder =
-    IndexRangeMapBuilder<GLVertexTypes::P3>{vertexCount, indexRangeMapSize};
+    auto [faceKey, faceDest] = holderPtr->getPointerToInsertElementsAt(6u * quadCount);
+    info.material = material;
+    info.faceIndicesKey = faceKey;
 
-  for (const auto* patchNode : patchNodes)
-  {
-    if (editorContext.visible(patchNode))
+    for (size_t row = 0u; row < grid.quadRowCount(); ++row)
     {
-      const auto& grid = patchNode->grid();
+      for (size_t col = 0u; col < grid.quadColumnCount(); ++col)
+      {
+        const auto i0 = pointIndex(row, col);
+        const auto i1 = pointIndex(row, col + 1u);
+        const auto i2 = pointIndex(row + 1u, col + 1u);
+        const auto i3 = pointIndex(row + 1u, col);
+
+        *faceDest++ = i0;
+        *faceDest++ = i1;
+        *faceDest++ = i2;
+        *faceDest++ = i2;
+        *faceDest++ = i3;
+        *faceDest++ = i0;
+      }
+    }
+  }
 
-      auto edgeLoopVertices = std::vector<GLVertexTypes::P3::Vertex>{};
-      edgeLoopVertices.reserve((grid.pointRowCount + grid.pointColumnCount - 2u) * 2u);
+  // walk around the patch to collect the edge loop
+  // for each side, collect the first vertex up to but not including the last vertex
 
-      // walk around the patch to collect the edge vertices
-      // for each side, collect the first vertex up to but not including the last vertex
+  auto edgeLoopIndices = std::vector<GLuint>{};
+  edgeLoopIndices.reserve((grid.pointRowCount + grid.pointColumnCount - 2u) * 2u);
 
-      const auto t = 0u;
-      const auto b = grid.pointRowCount - 1u;
-      const auto l = 0u;
-      const auto r = grid.pointColumnCount - 1u;
+  const auto t = 0u;
+  const auto b = grid.pointRowCount - 1u;
+  const auto l = 0u;
+  const auto r = grid.pointColumnCount - 1u;
 
-      auto row = t;
-      auto col = l;
+  auto row = t;
+  auto col = l;
 
-      while (col < r)
-      {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row, col++).position});
-      }
-      assert(row == t && col == r);
+  while (col < r)
+  {
+    edgeLoopIndices.push_back(pointIndex(row, col++));
+  }
+  assert(row == t && col == r);
 
-      while (row < b)
-      {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row++, col).position});
-      }
-      assert(row == b && col == r);
+  while (row < b)
+  {
+    edgeLoopIndices.push_back(pointIndex(row++, col));
+  }
+  assert(row == b && col == r);
 
-      while (col > l)
-      {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row, col--).position});
-      }
-      assert(row == b && col == l);
+  while (col > l)
+  {
+    edgeLoopIndices.push_back(pointIndex(row, col--));
+  }
+  assert(row == b && col == l);
 
-      while (row > t)
-      {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row--, col).position});
-      }
-      assert(row == t && col == l);
+  while (row > t)
+  {
+    edgeLoopIndices.push_back(pointIndex(row--, col));
+  }
+  assert(row == t && col == l);
 
-      indexRangeMapBuilder.addLineLoop(edgeLoopVertices);
+  // insert the edge loop as individual lines
+  if (!edgeLoopIndices.empty())
+  {
+    auto [edgeKey, edgeDest] =
+      m_edgeIndices->getPointerToInsertElementsAt(2u * edgeLoopIndices.size());
+    info.edgeIndicesKey = edgeKey;
+
+    for (size_t i = 0u; i < edgeLoopIndices.size(); ++i)
+    {
+      *edgeDest++ = edgeLoopIndices[i];
+      *edgeDest++ = edgeLoopIndices[(i + 1u) % edgeLoopIndices.size()];
     }
   }
-
-  auto vertexArray = VertexArray::move(std::move(indexRangeMapBuilder.vertices()));
-  auto indexRangeMap = std::move(indexRangeMapBuilder.indices());
-  return DirectEdgeRenderer{std::move(vertexArray), std::move(indexRangeMap)};
 }
 
-void PatchRenderer::validate()
+void PatchRenderer::removePatchFromVbo(const mdl::PatchNode& patchNode)
 {
-  if (!m_valid)
+  auto it = m_patchInfo.find(&patchNode);
+  if (it == std::end(m_patchInfo))
   {
-    m_patchMeshRenderer = buildMeshRenderer(m_patchNodes.get_data(), m_editorContext);
-    m_edgeRenderer = buildEdgeRenderer(m_patchNodes.get_data(), m_editorContext);
+    // This means PatchRenderer::validatePatch skipped the patch, so it was never
+    // uploaded to the VBO's
+    return;
+  }
+
+  const auto& info = it->second;
 
-    m_valid = true;
+  m_vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
+  if (info.edgeIndicesKey != nullptr)
+  {
+    m_edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
   }
+
+  if (info.faceIndicesKey != nullptr)
+  {
+    auto faceIndexHolder = m_faces->at(info.material);
+    faceIndexHolder->zeroElementsWithKey(info.faceIndicesKey);
+
+    if (!faceIndexHolder->hasValidIndices())
+    {
+      // There are no indices left to render for this material, so delete the
+      // <Material, BrushIndexArray> entry from the map
+      m_faces->erase(info.material);
+    }
+  }
+
+  m_patchInfo.erase(it);
 }
 
 void PatchRenderer::prepareVerticesAndIndices(VboManager& vboManager)
 {
-  m_patchMeshRenderer.prepare(vboManager);
+  m_vertexArray->prepare(vboManager);
+
+  for (const auto& [material, indexHolderPtr] : *m_faces)
+  {
+    indexHolderPtr->prepare(vboManager);
+  }
 }
 
 namespace
@@ -364,6 +417,11 @@ struct RenderFunc : public MaterialRenderFunc
 
 void PatchRenderer::doRender(RenderContext& context)
 {
+  if (m_faces->empty() || !m_vertexArray->setupVertices())
+  {
+    return;
+  }
+
   auto& shaderManager = context.shaderManager();
   auto shader = ActiveShader{shaderManager, Shaders::FaceShader};
   auto& prefs = PreferenceManager::instance();
@@ -415,13 +473,25 @@ void PatchRenderer::doRender(RenderContext& context)
   }
   */
 
-  m_patchMeshRenderer.render(func);
+  for (const auto& [material, indexHolderPtr] : *m_faces)
+  {
+    if (indexHolderPtr->hasValidIndices())
+    {
+      func.before(material);
+      indexHolderPtr->setupIndices();
+      indexHolderPtr->render(PrimType::Triangles);
+      indexHolderPtr->cleanupIndices();
+      func.after(material);
+    }
+  }
 
   /*
   if (m_alpha < 1.0f) {
       glAssert(glDepthMask(GL_TRUE));
   }
   */
+
+  m_vertexArray->cleanupVertices();
 }
 
 } // namespace tb::render
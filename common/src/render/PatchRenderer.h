@@ -20,34 +20,61 @@
 #pragma once
 
 #include "Color.h"
+#include "render/AllocationTracker.h"
 #include "render/EdgeRenderer.h"
-#include "render/MaterialIndexArrayRenderer.h"
 #include "render/Renderable.h"
 
-#include "kdl/vector_set.h"
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace tb::mdl
 {
 class EditorContext;
+class Material;
 class PatchNode;
 } // namespace tb::mdl
 
 namespace tb::render
 {
+class BrushIndexArray;
+class BrushVertexArray;
 class RenderBatch;
 class RenderContext;
 class VboManager;
 
+/**
+ * Renders the tessellated meshes and the boundary edges of Bezier patches.
+ *
+ * Every patch owns a block of vertices and blocks of triangle and edge indices in shared
+ * buffers, so that changing a patch only rewrites (and uploads) the blocks of that patch.
+ */
 class PatchRenderer : public IndexedRenderable
 {
 private:
   const mdl::EditorContext& m_editorContext;
 
-  bool m_valid = true;
-  kdl::vector_set<const mdl::PatchNode*> m_patchNodes;
+  struct PatchInfo
+  {
+    AllocationTracker::Block* vertexHolderKey = nullptr;
+    AllocationTracker::Block* edgeIndicesKey = nullptr;
+    const mdl::Material* material = nullptr;
+    AllocationTracker::Block* faceIndicesKey = nullptr;
+  };
+  std::unordered_map<const mdl::PatchNode*, PatchInfo> m_patchInfo;
+
+  std::unordered_set<const mdl::PatchNode*> m_allPatches;
+  std::unordered_set<const mdl::PatchNode*> m_invalidPatches;
+
+  std::shared_ptr<BrushVertexArray> m_vertexArray;
+  std::shared_ptr<BrushIndexArray> m_edgeIndices;
 
-  MaterialIndexArrayRenderer m_patchMeshRenderer;
-  DirectEdgeRenderer m_edgeRenderer;
+  using MaterialToPatchIndicesMap =
+    std::unordered_map<const mdl::Material*, std::shared_ptr<BrushIndexArray>>;
+  std::shared_ptr<MaterialToPatchIndicesMap> m_faces;
+
+  IndexedEdgeRenderer m_edgeRenderer;
 
   Color m_defaultColor;
   bool m_grayscale = false;
@@ -93,6 +120,11 @@ public:
    * Equivalent to invalidatePatch() on all added patches.
    */
   void invalidate();
+  /**
+   * Equivalent to invalidatePatch() on all added patches that use one of the given
+   * materials.
+   */
+  void invalidateMaterials(const std::vector<const mdl::Material*>& materials);
   /**
    * Equivalent to removePatch() on all added patches.
    */
@@ -113,11 +145,19 @@ public:
    */
   void invalidatePatch(const mdl::PatchNode* patchNode);
 
+  bool valid() const;
+
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
 
-private:
+  /**
+   * Rebuilds the cached renderer data of all invalidated patches.
+   */
   void validate();
 
+private:
+  void validatePatch(const mdl::PatchNode& patchNode);
+  void removePatchFromVbo(const mdl::PatchNode& patchNode);
+
 private: // implement IndexedRenderable interface
   void prepareVerticesAndIndices(VboManager& vboManager) override;
   void doRender(RenderContext& renderContext) override;
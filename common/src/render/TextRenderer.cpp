@@ -84,10 +84,14 @@ void TextRenderer::renderString(
   const TextAnchor& position,
   const bool onTop)
 {
-
   const auto& camera = renderContext.camera();
   const auto distance = camera.perpendicularDistanceTo(position.position(camera));
-  if (distance <= 0.0f || !isVisible(renderContext, string, position, distance, onTop))
+  if (distance <= 0.0f)
+  {
+    return;
+  }
+
+  if (!isInViewDistance(renderContext, distance, onTop))
   {
     return;
   }
@@ -95,42 +99,27 @@ void TextRenderer::renderString(
   auto& fontManager = renderContext.fontManager();
   auto& font = fontManager.font(m_fontDescriptor);
 
-  auto vertices = font.quads(string, true);
-  const auto alphaFactor = computeAlphaFactor(renderContext, distance, onTop);
-  const auto size = font.measure(string);
-  const auto offset = position.offset(camera, size);
-
-  if (onTop)
-  {
-    addEntry(
-      m_entriesOnTop,
-      Entry{
-        std::move(vertices),
-        size,
-        offset,
-        Color{textColor, alphaFactor * textColor.a()},
-        Color{backgroundColor, alphaFactor * backgroundColor.a()},
-      });
-  }
-  else
+  auto layout = font.layout(string);
+  if (!isInViewport(renderContext, vm::round(layout->size), position))
   {
-    addEntry(
-      m_entries,
-      Entry{
-        std::move(vertices),
-        size,
-        offset,
-        Color{textColor, alphaFactor * textColor.a()},
-        Color{backgroundColor, alphaFactor * backgroundColor.a()}});
+    return;
   }
+
+  const auto alphaFactor = computeAlphaFactor(renderContext, distance, onTop);
+  const auto offset = position.offset(camera, layout->size);
+
+  addEntry(
+    onTop ? m_entriesOnTop : m_entries,
+    Entry{
+      std::move(layout),
+      offset,
+      Color{textColor, alphaFactor * textColor.a()},
+      Color{backgroundColor, alphaFactor * backgroundColor.a()},
+    });
 }
 
-bool TextRenderer::isVisible(
-  RenderContext& renderContext,
-  const AttrString& string,
-  const TextAnchor& position,
-  const float distance,
-  const bool onTop) const
+bool TextRenderer::isInViewDistance(
+  const RenderContext& renderContext, const float distance, const bool onTop) const
 {
   if (!onTop)
   {
@@ -143,11 +132,17 @@ bool TextRenderer::isVisible(
       return false;
     }
   }
+  return true;
+}
 
+bool TextRenderer::isInViewport(
+  const RenderContext& renderContext,
+  const vm::vec2f& size,
+  const TextAnchor& position) const
+{
   const auto& camera = renderContext.camera();
   const auto& viewport = camera.viewport();
 
-  const auto size = stringSize(renderContext, string);
   const auto offset = vm::vec2f{position.offset(camera, size)} - m_inset;
   const auto actualSize = size + 2.0f * m_inset;
 
@@ -176,18 +171,10 @@ float TextRenderer::computeAlphaFactor(
 void TextRenderer::addEntry(EntryCollection& collection, const Entry& entry)
 {
   collection.entries.push_back(entry);
-  collection.textVertexCount += entry.vertices.size();
+  collection.textVertexCount += entry.layout->quads.size() / 2;
   collection.rectVertexCount += roundedRect2DVertexCount(RectCornerSegments);
 }
 
-vm::vec2f TextRenderer::stringSize(
-  RenderContext& renderContext, const AttrString& string) const
-{
-  auto& fontManager = renderContext.fontManager();
-  auto& font = fontManager.font(m_fontDescriptor);
-  return vm::round(font.measure(string));
-}
-
 void TextRenderer::doPrepareVertices(VboManager& vboManager)
 {
   prepare(m_entries, false, vboManager);
@@ -221,8 +208,8 @@ void TextRenderer::addEntry(
   std::vector<TextVertex>& textVertices,
   std::vector<RectVertex>& rectVertices)
 {
-  const auto& stringVertices = entry.vertices;
-  const auto& stringSize = entry.size;
+  const auto& stringVertices = entry.layout->quads;
+  const auto& stringSize = entry.layout->size;
 
   const auto& offset = entry.offset;
 
@@ -201,6 +201,27 @@ vm::vec2f TextureFont::measure(const AttrString& string) const
   return measureString.size();
 }
 
+std::shared_ptr<const TextLayout> TextureFont::layout(const AttrString& string) const
+{
+  if (const auto it = m_layoutCache.find(string); it != m_layoutCache.end())
+  {
+    m_cachedLayouts.splice(m_cachedLayouts.begin(), m_cachedLayouts, it->second);
+    return it->second->second;
+  }
+
+  if (m_layoutCache.size() >= MaxCachedLayouts)
+  {
+    m_layoutCache.erase(m_cachedLayouts.back().first);
+    m_cachedLayouts.pop_back();
+  }
+
+  auto layout =
+    std::make_shared<const TextLayout>(TextLayout{quads(string, true), measure(string)});
+  m_cachedLayouts.emplace_front(string, layout);
+  m_layoutCache.emplace(string, m_cachedLayouts.begin());
+  return layout;
+}
+
 std::vector<vm::vec2f> TextureFont::quads(
   const std::string& string, const bool clockwise, const vm::vec2f& offset) const
 {
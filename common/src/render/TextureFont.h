@@ -20,22 +20,33 @@
 #pragma once
 
 #include "Macros.h"
+#include "render/AttrString.h"
 
 #include "vm/vec.h"
 
+#include <list>
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace tb::render
 {
-class AttrString;
 class FontGlyph;
 class FontTexture;
 
+struct TextLayout
+{
+  std::vector<vm::vec2f> quads;
+  vm::vec2f size;
+};
+
 class TextureFont
 {
 private:
+  static constexpr size_t MaxCachedLayouts = 4096;
+
   std::unique_ptr<FontTexture> m_texture;
   std::vector<FontGlyph> m_glyphs;
   int m_ascend;
@@ -45,6 +56,12 @@ private:
   unsigned char m_firstChar;
   unsigned char m_charCount;
 
+  using CachedLayout = std::pair<AttrString, std::shared_ptr<const TextLayout>>;
+
+  // most recently used layouts first
+  mutable std::list<CachedLayout> m_cachedLayouts;
+  mutable std::map<AttrString, std::list<CachedLayout>::iterator> m_layoutCache;
+
 public:
   TextureFont(
     std::unique_ptr<FontTexture> texture,
@@ -68,6 +85,13 @@ public:
     const vm::vec2f& offset = vm::vec2f{0, 0}) const;
   vm::vec2f measure(const AttrString& string) const;
 
+  /**
+   * Returns the clockwise quads and the size of the given string. The layouts of recently
+   * used strings are cached so that unchanged strings are not laid out again. When the
+   * cache is full, the least recently used layout is evicted.
+   */
+  std::shared_ptr<const TextLayout> layout(const AttrString& string) const;
+
   std::vector<vm::vec2f> quads(
     const std::string& string,
     bool clockwise,
@@ -24,32 +24,29 @@
 namespace tb::render
 {
 
-Vbo::Vbo(const GLenum type, const size_t capacity, const GLenum usage)
-  : m_type{type}
+Vbo::Vbo(
+  VboManager& vboManager,
+  const GLenum type,
+  const GLenum usage,
+  const GLuint bufferId,
+  const size_t offset,
+  const size_t capacity,
+  const VboArenaAllocator::Allocation allocation)
+  : m_vboManager{vboManager}
+  , m_type{type}
+  , m_usage{usage}
+  , m_bufferId{bufferId}
+  , m_offset{offset}
   , m_capacity{capacity}
+  , m_allocation{allocation}
 {
   assert(m_type == GL_ELEMENT_ARRAY_BUFFER || m_type == GL_ARRAY_BUFFER);
-
-  glAssert(glGenBuffers(1, &m_bufferId));
-  glAssert(glBindBuffer(m_type, m_bufferId));
-  glAssert(glBufferData(m_type, static_cast<GLsizeiptr>(m_capacity), nullptr, usage));
-}
-
-void Vbo::free()
-{
   assert(m_bufferId != 0);
-  glAssert(glDeleteBuffers(1, &m_bufferId));
-  m_bufferId = 0;
-}
-
-Vbo::~Vbo()
-{
-  assert(m_bufferId == 0);
 }
 
 size_t Vbo::offset() const
 {
-  return 0;
+  return m_offset;
 }
 
 size_t Vbo::capacity() const
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "render/GL.h"
+#include "render/VboArenaAllocator.h"
 #include "render/VboManager.h"
 
 #include <cassert>
@@ -30,37 +31,44 @@ namespace tb::render
 {
 
 /**
- * Wrapper around an OpenGL buffer
+ * Wrapper around a range of an OpenGL buffer. Depending on the allocation mode of the
+ * VboManager, the range spans the entire buffer or a part of a buffer that is shared with
+ * other VBOs.
  */
 class Vbo
 {
 private:
   friend class VboManager;
 
+  VboManager& m_vboManager;
+
   /**
    * e.g. GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
    */
   GLenum m_type;
-  size_t m_capacity;
+  GLenum m_usage;
   GLuint m_bufferId;
+  size_t m_offset;
+  size_t m_capacity;
 
-public:
   /**
-   * Immediately creates and binds to a buffer of the given type and capacity.
-   * The contents are initially unspecified.
+   * Only set if this VBO is a range of an arena.
    */
-  Vbo(GLenum type, size_t capacity, GLenum usage);
-  ~Vbo();
+  VboArenaAllocator::Allocation m_allocation;
 
-  /**
-   * Deletes the underlying OpenGL buffer with glDeleteBuffers.
-   * Must be called before the destructor.
-   * Calling any other methods after free() is disallowed.
-   */
-  void free();
+public:
+  Vbo(
+    VboManager& vboManager,
+    GLenum type,
+    GLenum usage,
+    GLuint bufferId,
+    size_t offset,
+    size_t capacity,
+    VboArenaAllocator::Allocation allocation = {});
 
   /**
-   * Deprecated, always returns 0.
+   * The offset of this VBO's range within the OpenGL buffer, in bytes. Must be added to
+   * any pointer that refers to the VBO's contents when rendering.
    */
   size_t offset() const;
   size_t capacity() const;
@@ -99,11 +107,12 @@ public:
     static_assert(std::is_standard_layout<T>::value);
 
     const auto* ptr = static_cast<const GLvoid*>(array);
-    const auto offset = static_cast<GLintptr>(address);
+    const auto offset = static_cast<GLintptr>(m_offset + address);
     const auto sizei = static_cast<GLsizeiptr>(size);
     glAssert(glBindBuffer(m_type, m_bufferId));
     glAssert(glBufferSubData(m_type, offset, sizei, ptr));
 
+    m_vboManager.m_uploadedBytes += size;
     return size;
   }
 };
@@ -0,0 +1,231 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "VboArenaAllocator.h"
+
+#include "Ensure.h"
+
+#include <algorithm>
+
+namespace tb::render
+{
+namespace
+{
+
+size_t alignSize(const size_t size)
+{
+  const auto alignment = VboArenaAllocator::Alignment;
+  return std::max(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+double fillRate(const VboArenaAllocator::Arena& arena)
+{
+  return double(arena.liveBytes) / double(arena.capacity());
+}
+
+} // namespace
+
+VboArenaAllocator::Arena::Arena(const size_t i_id, const size_t capacity)
+  : id{i_id}
+  , tracker{capacity}
+{
+}
+
+size_t VboArenaAllocator::Arena::capacity() const
+{
+  return tracker.capacity();
+}
+
+size_t VboArenaAllocator::Allocation::offset() const
+{
+  return block->pos;
+}
+
+size_t VboArenaAllocator::Allocation::size() const
+{
+  return block->size;
+}
+
+VboArenaAllocator::VboArenaAllocator(
+  const size_t minArenaCapacity, const size_t maxArenaCapacity)
+  : m_minArenaCapacity{alignSize(minArenaCapacity)}
+  , m_maxArenaCapacity{std::max(m_minArenaCapacity, alignSize(maxArenaCapacity))}
+{
+}
+
+VboArenaAllocator::Allocation VboArenaAllocator::allocate(const size_t size)
+{
+  const auto alignedSize = alignSize(size);
+
+  for (auto& arena : m_arenas)
+  {
+    if (auto allocation = allocateInArena(*arena, alignedSize); allocation.block)
+    {
+      m_liveBytes += alignedSize;
+      return allocation;
+    }
+  }
+
+  auto allocation = allocateInArena(createArena(alignedSize), alignedSize);
+  ensure(allocation.block != nullptr, "new arena has room for allocation");
+
+  m_liveBytes += alignedSize;
+  return allocation;
+}
+
+void VboArenaAllocator::free(const Allocation& allocation)
+{
+  auto& arena = *allocation.arena;
+  ensure(arena.blocks.erase(allocation.block) == 1, "allocation belongs to arena");
+
+  arena.liveBytes -= allocation.size();
+  m_liveBytes -= allocation.size();
+  arena.tracker.free(allocation.block);
+}
+
+void VboArenaAllocator::releaseEmptyArenas(
+  const std::function<void(const Arena&)>& onRelease)
+{
+  const auto largest = std::ranges::max_element(
+    m_arenas, [](const auto& lhs, const auto& rhs) {
+      return lhs->capacity() < rhs->capacity();
+    });
+  const auto* largestArena = largest != m_arenas.end() ? largest->get() : nullptr;
+
+  std::erase_if(m_arenas, [&](const auto& arena) {
+    if (arena.get() != largestArena && !arena->tracker.hasAllocations())
+    {
+      onRelease(*arena);
+      m_allocatedBytes -= arena->capacity();
+      return true;
+    }
+    return false;
+  });
+}
+
+std::vector<VboArenaAllocator::Move> VboArenaAllocator::compact(
+  const double maxFillRate)
+{
+  if (m_arenas.size() < 2)
+  {
+    return {};
+  }
+
+  auto* source = static_cast<Arena*>(nullptr);
+  for (auto& arena : m_arenas)
+  {
+    if (
+      arena->tracker.hasAllocations() && fillRate(*arena) < maxFillRate
+      && (!source || fillRate(*arena) < fillRate(*source)))
+    {
+      source = arena.get();
+    }
+  }
+
+  if (!source)
+  {
+    return {};
+  }
+
+  // move the largest allocations first to reduce the chance of failing due to
+  // fragmentation of the other arenas
+  auto blocks = std::vector<AllocationTracker::Block*>{
+    source->blocks.begin(), source->blocks.end()};
+  std::ranges::sort(
+    blocks, [](const auto* lhs, const auto* rhs) { return lhs->size > rhs->size; });
+
+  auto moves = std::vector<Move>{};
+  moves.reserve(blocks.size());
+
+  for (auto* block : blocks)
+  {
+    auto to = Allocation{};
+    for (auto& arena : m_arenas)
+    {
+      if (arena.get() != source)
+      {
+        if (to = allocateInArena(*arena, block->size); to.block)
+        {
+          break;
+        }
+      }
+    }
+
+    if (!to.block)
+    {
+      // roll back the moves planned so far
+      for (const auto& move : moves)
+      {
+        free(move.to);
+      }
+      return {};
+    }
+
+    m_liveBytes += to.size();
+    moves.push_back(Move{Allocation{source, block}, to});
+  }
+
+  return moves;
+}
+
+const std::vector<std::unique_ptr<VboArenaAllocator::Arena>>& VboArenaAllocator::
+  arenas() const
+{
+  return m_arenas;
+}
+
+size_t VboArenaAllocator::allocatedBytes() const
+{
+  return m_allocatedBytes;
+}
+
+size_t VboArenaAllocator::liveBytes() const
+{
+  return m_liveBytes;
+}
+
+VboArenaAllocator::Arena& VboArenaAllocator::createArena(const size_t size)
+{
+  auto largestCapacity = size_t(0);
+  for (const auto& arena : m_arenas)
+  {
+    largestCapacity = std::max(largestCapacity, arena->capacity());
+  }
+
+  const auto capacity = std::max(
+    {m_minArenaCapacity, std::min(2 * largestCapacity, m_maxArenaCapacity), size});
+
+  m_arenas.push_back(std::make_unique<Arena>(m_nextArenaId++, capacity));
+  m_allocatedBytes += capacity;
+  return *m_arenas.back();
+}
+
+VboArenaAllocator::Allocation VboArenaAllocator::allocateInArena(
+  Arena& arena, const size_t size)
+{
+  if (auto* block = arena.tracker.allocate(size))
+  {
+    arena.blocks.insert(block);
+    arena.liveBytes += block->size;
+    return Allocation{&arena, block};
+  }
+  return Allocation{};
+}
+
+} // namespace tb::render
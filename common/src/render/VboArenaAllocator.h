@@ -0,0 +1,139 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "render/AllocationTracker.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+namespace tb::render
+{
+
+/**
+ * Implements the bookkeeping for sub-allocating ranges of buffer memory from a few large
+ * arenas. The arenas are managed with an AllocationTracker each.
+ *
+ * If no arena has room for an allocation, a new arena is created. Its capacity is twice
+ * the capacity of the largest arena, but at least the requested size and at most the
+ * maximum arena capacity, unless the requested size exceeds that.
+ *
+ * This class does not create any OpenGL objects, so it can be used without a GPU. The
+ * VboManager creates a buffer object for each arena.
+ */
+class VboArenaAllocator
+{
+public:
+  static constexpr size_t Alignment = 16;
+
+  struct Arena
+  {
+    size_t id;
+    AllocationTracker tracker;
+    std::unordered_set<AllocationTracker::Block*> blocks;
+    size_t liveBytes = 0;
+
+    Arena(size_t id, size_t capacity);
+
+    size_t capacity() const;
+  };
+
+  struct Allocation
+  {
+    Arena* arena = nullptr;
+    AllocationTracker::Block* block = nullptr;
+
+    size_t offset() const;
+    size_t size() const;
+  };
+
+  /**
+   * Describes the relocation of a live allocation from one arena to another. Both
+   * allocations are live when the move is returned from compact().
+   */
+  struct Move
+  {
+    Allocation from;
+    Allocation to;
+  };
+
+private:
+  size_t m_minArenaCapacity;
+  size_t m_maxArenaCapacity;
+  size_t m_nextArenaId = 0;
+  std::vector<std::unique_ptr<Arena>> m_arenas;
+
+  size_t m_allocatedBytes = 0;
+  size_t m_liveBytes = 0;
+
+public:
+  explicit VboArenaAllocator(
+    size_t minArenaCapacity = 1024 * 1024, size_t maxArenaCapacity = 64 * 1024 * 1024);
+
+  /**
+   * Allocates a range of at least the given size. The offset of the returned allocation
+   * is a multiple of Alignment. Creates a new arena if no arena has room.
+   */
+  Allocation allocate(size_t size);
+
+  /**
+   * Frees the given allocation. Arenas are not released when they become empty; call
+   * releaseEmptyArenas() to do that.
+   */
+  void free(const Allocation& allocation);
+
+  /**
+   * Releases every arena that has no allocations except for the largest one. The given
+   * function is called for each arena before it is released.
+   */
+  void releaseEmptyArenas(const std::function<void(const Arena&)>& onRelease);
+
+  /**
+   * Attempts to move all live allocations out of the arena with the lowest fill rate if
+   * that rate is less than the given maximum. The allocations are moved into the other
+   * arenas; no new arena is created. Either all allocations of the arena are moved or
+   * none is.
+   *
+   * The caller must copy the contents of each move and then free its from allocation.
+   * Afterwards, the emptied arena can be released with releaseEmptyArenas().
+   */
+  std::vector<Move> compact(double maxFillRate = 0.25);
+
+  const std::vector<std::unique_ptr<Arena>>& arenas() const;
+
+  /**
+   * The sum of the capacities of all arenas.
+   */
+  size_t allocatedBytes() const;
+
+  /**
+   * The sum of the sizes of all live allocations.
+   */
+  size_t liveBytes() const;
+
+private:
+  Arena& createArena(size_t size);
+  static Allocation allocateInArena(Arena& arena, size_t size);
+};
+
+} // namespace tb::render
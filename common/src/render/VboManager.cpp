@@ -56,16 +56,67 @@ static GLenum usageToOpenGL(const VboUsage usage)
   }
 }
 
+static bool canCopyBuffers()
+{
+  return GLEW_VERSION_3_1 || GLEW_ARB_copy_buffer;
+}
+
+static GLuint createBuffer(const GLenum type, const size_t capacity, const GLenum usage)
+{
+  auto bufferId = GLuint(0);
+  glAssert(glGenBuffers(1, &bufferId));
+  glAssert(glBindBuffer(type, bufferId));
+  glAssert(glBufferData(type, static_cast<GLsizeiptr>(capacity), nullptr, usage));
+  return bufferId;
+}
+
+static void copyBuffer(
+  const GLuint sourceBufferId,
+  const size_t sourceOffset,
+  const GLuint targetBufferId,
+  const size_t targetOffset,
+  const size_t size)
+{
+  glAssert(glBindBuffer(GL_COPY_READ_BUFFER, sourceBufferId));
+  glAssert(glBindBuffer(GL_COPY_WRITE_BUFFER, targetBufferId));
+  glAssert(glCopyBufferSubData(
+    GL_COPY_READ_BUFFER,
+    GL_COPY_WRITE_BUFFER,
+    static_cast<GLintptr>(sourceOffset),
+    static_cast<GLintptr>(targetOffset),
+    static_cast<GLsizeiptr>(size)));
+  glAssert(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+  glAssert(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+}
+
 // VboManager
 
-VboManager::VboManager(ShaderManager& shaderManager)
+VboManager::VboManager(
+  ShaderManager& shaderManager, const VboAllocationMode allocationMode)
   : m_shaderManager{shaderManager}
+  , m_allocationMode{allocationMode}
 {
 }
 
 Vbo* VboManager::allocateVbo(VboType type, const size_t capacity, const VboUsage usage)
 {
-  auto result = std::make_unique<Vbo>(typeToOpenGL(type), capacity, usageToOpenGL(usage));
+  const auto glType = typeToOpenGL(type);
+  const auto glUsage = usageToOpenGL(usage);
+
+  auto result = std::unique_ptr<Vbo>{};
+  if (m_allocationMode == VboAllocationMode::Arena)
+  {
+    const auto allocation = arenaAllocator(glType, glUsage).allocate(capacity);
+    const auto bufferId = arenaBuffer(*allocation.arena, glType, glUsage);
+    result = std::make_unique<Vbo>(
+      *this, glType, glUsage, bufferId, allocation.offset(), capacity, allocation);
+    m_arenaVbos[allocation.block] = result.get();
+  }
+  else
+  {
+    const auto bufferId = createBuffer(glType, capacity, glUsage);
+    result = std::make_unique<Vbo>(*this, glType, glUsage, bufferId, 0, capacity);
+  }
 
   m_currentVboSize += capacity;
   m_currentVboCount++;
@@ -79,10 +130,76 @@ void VboManager::destroyVbo(Vbo* vbo)
   m_currentVboSize -= vbo->capacity();
   m_currentVboCount--;
 
-  vbo->free();
+  if (vbo->m_allocation.arena)
+  {
+    m_arenaVbos.erase(vbo->m_allocation.block);
+    arenaAllocator(vbo->m_type, vbo->m_usage).free(vbo->m_allocation);
+  }
+  else
+  {
+    glAssert(glDeleteBuffers(1, &vbo->m_bufferId));
+  }
+
   delete vbo;
 }
 
+bool VboManager::resizeVbo(Vbo& vbo, const size_t capacity)
+{
+  const auto preserve = canCopyBuffers();
+  const auto preservedBytes = preserve ? std::min(vbo.m_capacity, capacity) : 0;
+
+  m_currentVboSize = m_currentVboSize - vbo.m_capacity + capacity;
+
+  if (vbo.m_allocation.arena)
+  {
+    auto& allocator = arenaAllocator(vbo.m_type, vbo.m_usage);
+    const auto from = vbo.m_allocation;
+    const auto to = allocator.allocate(capacity);
+    moveVbo(vbo, to, preservedBytes);
+    allocator.free(from);
+  }
+  else
+  {
+    const auto bufferId = createBuffer(vbo.m_type, capacity, vbo.m_usage);
+    if (preservedBytes > 0)
+    {
+      copyBuffer(vbo.m_bufferId, 0, bufferId, 0, preservedBytes);
+    }
+    glAssert(glDeleteBuffers(1, &vbo.m_bufferId));
+    vbo.m_bufferId = bufferId;
+  }
+
+  vbo.m_capacity = capacity;
+  return preserve;
+}
+
+void VboManager::finishFrame()
+{
+  if (m_uploadedBytes == 0)
+  {
+    defragment();
+  }
+  m_uploadedBytes = 0;
+}
+
+void VboManager::defragment()
+{
+  for (auto& allocator : m_arenaAllocators)
+  {
+    if (canCopyBuffers())
+    {
+      for (const auto& move : allocator.compact())
+      {
+        auto* vbo = m_arenaVbos.at(move.from.block);
+        moveVbo(*vbo, move.to, vbo->m_capacity);
+        allocator.free(move.from);
+      }
+    }
+
+    releaseEmptyArenas(allocator);
+  }
+}
+
 size_t VboManager::peakVboCount() const
 {
   return m_peakVboCount;
@@ -98,9 +215,75 @@ size_t VboManager::currentVboSize() const
   return m_currentVboSize;
 }
 
+size_t VboManager::allocatedBytes() const
+{
+  if (m_allocationMode == VboAllocationMode::Arena)
+  {
+    auto result = size_t(0);
+    for (const auto& allocator : m_arenaAllocators)
+    {
+      result += allocator.allocatedBytes();
+    }
+    return result;
+  }
+  return m_currentVboSize;
+}
+
+size_t VboManager::uploadedBytes() const
+{
+  return m_uploadedBytes;
+}
+
 ShaderManager& VboManager::shaderManager()
 {
   return m_shaderManager;
 }
 
+VboArenaAllocator& VboManager::arenaAllocator(const GLenum type, const GLenum usage)
+{
+  const auto typeIndex = type == GL_ELEMENT_ARRAY_BUFFER ? 2u : 0u;
+  const auto usageIndex = usage == GL_DYNAMIC_DRAW ? 1u : 0u;
+  return m_arenaAllocators[typeIndex + usageIndex];
+}
+
+GLuint VboManager::arenaBuffer(
+  const VboArenaAllocator::Arena& arena, const GLenum type, const GLenum usage)
+{
+  auto it = m_arenaBuffers.find(&arena);
+  if (it == m_arenaBuffers.end())
+  {
+    const auto bufferId = createBuffer(type, arena.capacity(), usage);
+    it = m_arenaBuffers.emplace(&arena, bufferId).first;
+  }
+  return it->second;
+}
+
+void VboManager::moveVbo(
+  Vbo& vbo, const VboArenaAllocator::Allocation& to, const size_t preservedBytes)
+{
+  const auto bufferId = arenaBuffer(*to.arena, vbo.m_type, vbo.m_usage);
+  if (preservedBytes > 0)
+  {
+    copyBuffer(vbo.m_bufferId, vbo.m_offset, bufferId, to.offset(), preservedBytes);
+  }
+
+  m_arenaVbos.erase(vbo.m_allocation.block);
+  m_arenaVbos[to.block] = &vbo;
+
+  vbo.m_bufferId = bufferId;
+  vbo.m_offset = to.offset();
+  vbo.m_allocation = to;
+}
+
+void VboManager::releaseEmptyArenas(VboArenaAllocator& allocator)
+{
+  allocator.releaseEmptyArenas([&](const auto& arena) {
+    if (const auto it = m_arenaBuffers.find(&arena); it != m_arenaBuffers.end())
+    {
+      glAssert(glDeleteBuffers(1, &it->second));
+      m_arenaBuffers.erase(it);
+    }
+  });
+}
+
 } // namespace tb::render
@@ -19,7 +19,12 @@
 
 #pragma once
 
+#include "render/GL.h"
+#include "render/VboArenaAllocator.h"
+
+#include <array>
 #include <cstddef>
+#include <unordered_map>
 
 namespace tb::render
 {
@@ -38,16 +43,40 @@ enum class VboUsage
   DynamicDraw
 };
 
+enum class VboAllocationMode
+{
+  /**
+   * Every VBO is backed by its own OpenGL buffer object.
+   */
+  Dedicated,
+  /**
+   * VBOs are ranges of a few large OpenGL buffer objects, one set of buffer objects per
+   * combination of type and usage.
+   */
+  Arena,
+};
+
 class VboManager
 {
 private:
+  friend class Vbo;
+
   size_t m_peakVboCount = 0;
   size_t m_currentVboCount = 0;
   size_t m_currentVboSize = 0;
+  size_t m_uploadedBytes = 0;
   ShaderManager& m_shaderManager;
 
+  VboAllocationMode m_allocationMode;
+  std::array<VboArenaAllocator, 4> m_arenaAllocators;
+  std::unordered_map<const VboArenaAllocator::Arena*, GLuint> m_arenaBuffers;
+  std::unordered_map<const AllocationTracker::Block*, Vbo*> m_arenaVbos;
+
 public:
-  explicit VboManager(ShaderManager& shaderManager);
+  explicit VboManager(
+    ShaderManager& shaderManager,
+    VboAllocationMode allocationMode = VboAllocationMode::Dedicated);
+
   /**
    * Immediately creates and binds to an OpenGL buffer of the given type and capacity.
    * The contents are initially unspecified. See Vbo class.
@@ -55,11 +84,51 @@ public:
   Vbo* allocateVbo(VboType type, size_t capacity, VboUsage usage = VboUsage::StaticDraw);
   void destroyVbo(Vbo* vbo);
 
+  /**
+   * Changes the capacity of the given VBO. If the OpenGL implementation supports copying
+   * between buffer objects, the contents of the VBO are preserved up to the smaller of
+   * the old and the new capacity and true is returned. Otherwise, the contents are
+   * unspecified and false is returned.
+   */
+  bool resizeVbo(Vbo& vbo, size_t capacity);
+
+  /**
+   * Must be called after a frame was rendered. If nothing was uploaded during the frame,
+   * the arenas are defragmented.
+   */
+  void finishFrame();
+
+  /**
+   * Moves the VBOs out of sparsely used arenas and releases empty arenas.
+   */
+  void defragment();
+
   size_t peakVboCount() const;
   size_t currentVboCount() const;
+
+  /**
+   * The sum of the capacities of all live VBOs.
+   */
   size_t currentVboSize() const;
 
+  /**
+   * The number of bytes of OpenGL buffer memory reserved for VBOs. In arena mode, this
+   * includes the unused parts of the arenas.
+   */
+  size_t allocatedBytes() const;
+
+  /**
+   * The number of bytes written to VBOs since the last call to finishFrame().
+   */
+  size_t uploadedBytes() const;
+
   ShaderManager& shaderManager();
+
+private:
+  VboArenaAllocator& arenaAllocator(GLenum type, GLenum usage);
+  GLuint arenaBuffer(const VboArenaAllocator::Arena& arena, GLenum type, GLenum usage);
+  void moveVbo(Vbo& vbo, const VboArenaAllocator::Allocation& to, size_t preservedBytes);
+  void releaseEmptyArenas(VboArenaAllocator& allocator);
 };
 
 } // namespace tb::render
@@ -0,0 +1,72 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ViewCuller.h"
+
+#include "render/Camera.h"
+
+#include "vm/vec.h"
+
+namespace tb::render
+{
+
+ViewCuller::ViewCuller(const Camera& camera, const float minProjectedSize)
+  : m_camera{camera}
+  , m_minProjectedSize{minProjectedSize}
+{
+  m_camera.frustumPlanes(
+    m_frustumPlanes[0], m_frustumPlanes[1], m_frustumPlanes[2], m_frustumPlanes[3]);
+}
+
+bool ViewCuller::visible(const vm::bbox3d& bounds) const
+{
+  return visible(vm::bbox3f{bounds});
+}
+
+bool ViewCuller::visible(const vm::bbox3f& bounds) const
+{
+  // the planes' normals point out of the frustum, so the box is outside of a plane if
+  // the corner that is closest to the frustum is outside of it
+  for (const auto& plane : m_frustumPlanes)
+  {
+    const auto closestCorner = vm::vec3f{
+      plane.normal.x() < 0.0f ? bounds.max.x() : bounds.min.x(),
+      plane.normal.y() < 0.0f ? bounds.max.y() : bounds.min.y(),
+      plane.normal.z() < 0.0f ? bounds.max.z() : bounds.min.z()};
+    if (plane.point_distance(closestCorner) > 0.0f)
+    {
+      return false;
+    }
+  }
+
+  if (m_minProjectedSize > 0.0f)
+  {
+    const auto center = bounds.center();
+    const auto size = vm::get_abs_max_component(bounds.size(), 0);
+    const auto scalingFactor = m_camera.perspectiveScalingFactor(center);
+    if (scalingFactor > 0.0f && size / scalingFactor < m_minProjectedSize)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+} // namespace tb::render
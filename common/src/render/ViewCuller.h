@@ -0,0 +1,51 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "vm/bbox.h"
+#include "vm/plane.h"
+
+#include <array>
+
+namespace tb::render
+{
+class Camera;
+
+/**
+ * Determines whether bounding boxes are visible from a camera. A box is culled if it is
+ * outside of one of the side planes of the camera's view frustum, or if it is so small
+ * when projected onto the viewport that it would cover less than the given number of
+ * pixels along each axis.
+ */
+class ViewCuller
+{
+private:
+  const Camera& m_camera;
+  std::array<vm::plane3f, 4> m_frustumPlanes;
+  float m_minProjectedSize;
+
+public:
+  explicit ViewCuller(const Camera& camera, float minProjectedSize = 1.0f);
+
+  bool visible(const vm::bbox3d& bounds) const;
+  bool visible(const vm::bbox3f& bounds) const;
+};
+
+} // namespace tb::render
@@ -2138,6 +2138,14 @@ void ActionManager::createDebugMenu()
     [](auto& context) { context.frame()->debugShowPalette(); },
     [](const auto& context) { return context.hasDocument(); },
   }));
+  debugMenu.addItem(addAction(Action{
+    "Menu/Debug/Save Trace...",
+    QObject::tr("Save Trace..."),
+    ActionContext::Any,
+    QKeySequence{},
+    [](auto& context) { context.frame()->debugSaveTrace(); },
+    [](const auto& context) { return context.hasDocument(); },
+  }));
 #endif
 }
 
@@ -24,9 +24,20 @@
 #include "io/FileSystem.h"
 #include "io/PathInfo.h"
 #include "io/TraversalMode.h"
+#include "mdl/BezierPatch.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushNode.h"
+#include "mdl/EntityNode.h"
+#include "mdl/Game.h"
+#include "mdl/GroupNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
 #include "ui/MapDocument.h"
 
 #include "kdl/memory_utils.h"
+#include "kdl/overload.h"
 #include "kdl/path_utils.h"
 #include "kdl/result.h"
 #include "kdl/result_fold.h"
@@ -37,6 +48,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <stdexcept>
 
 namespace tb::ui
 {
@@ -111,6 +124,99 @@ Result<void> cleanBackups(
          | kdl::fold;
 }
 
+void snapshotChildren(const mdl::Node& node, mdl::Node& snapshot);
+
+mdl::Node* snapshotNode(const mdl::Node& node)
+{
+  auto* snapshot = node.accept(kdl::overload(
+    [](const mdl::WorldNode*) -> mdl::Node* {
+      throw std::runtime_error{"Cannot snapshot a nested world"};
+    },
+    [](const mdl::LayerNode* layerNode) -> mdl::Node* {
+      auto* layerSnapshot = new mdl::LayerNode{layerNode->layer()};
+      if (const auto& persistentId = layerNode->persistentId())
+      {
+        layerSnapshot->setPersistentId(*persistentId);
+      }
+      return layerSnapshot;
+    },
+    [](const mdl::GroupNode* groupNode) -> mdl::Node* {
+      auto* groupSnapshot = new mdl::GroupNode{groupNode->group()};
+      if (const auto& persistentId = groupNode->persistentId())
+      {
+        groupSnapshot->setPersistentId(*persistentId);
+      }
+      groupNode->cloneLinkId(*groupSnapshot);
+      return groupSnapshot;
+    },
+    [](const mdl::EntityNode* entityNode) -> mdl::Node* {
+      auto entity = entityNode->entity();
+      entity.unsetEntityDefinitionAndModel();
+
+      auto* entitySnapshot = new mdl::EntityNode{std::move(entity)};
+      entityNode->cloneLinkId(*entitySnapshot);
+      return entitySnapshot;
+    },
+    [](const mdl::BrushNode* brushNode) -> mdl::Node* {
+      auto brush = brushNode->brush();
+      for (auto& face : brush.faces())
+      {
+        face.setMaterial(nullptr);
+      }
+
+      auto* brushSnapshot = new mdl::BrushNode{std::move(brush)};
+      brushNode->cloneLinkId(*brushSnapshot);
+      return brushSnapshot;
+    },
+    [](const mdl::PatchNode* patchNode) -> mdl::Node* {
+      auto patch = patchNode->patch();
+      patch.setMaterial(nullptr);
+
+      auto* patchSnapshot = new mdl::PatchNode{std::move(patch)};
+      patchNode->cloneLinkId(*patchSnapshot);
+      return patchSnapshot;
+    }));
+
+  snapshot->setVisibilityState(node.visibilityState());
+  snapshot->setLockState(node.lockState());
+  snapshotChildren(node, *snapshot);
+  return snapshot;
+}
+
+void snapshotChildren(const mdl::Node& node, mdl::Node& snapshot)
+{
+  snapshot.addChildren(kdl::vec_transform(
+    node.children(), [](const auto* child) { return snapshotNode(*child); }));
+}
+
+/**
+ * Copies everything from the given world that is needed to write it to a map file. The
+ * snapshot does not reference any assets such as materials or entity definitions, so it
+ * can be written and destroyed on a worker thread while the document keeps changing.
+ */
+std::unique_ptr<mdl::WorldNode> snapshotWorld(const mdl::WorldNode& world)
+{
+  auto worldEntity = world.entity();
+  worldEntity.unsetEntityDefinitionAndModel();
+
+  auto worldSnapshot = std::make_unique<mdl::WorldNode>(
+    world.entityPropertyConfig(), std::move(worldEntity), world.mapFormat());
+
+  const auto& defaultLayer = *world.defaultLayer();
+  auto& defaultLayerSnapshot = *worldSnapshot->defaultLayer();
+  defaultLayerSnapshot.setLayer(defaultLayer.layer());
+  defaultLayerSnapshot.setVisibilityState(defaultLayer.visibilityState());
+  defaultLayerSnapshot.setLockState(defaultLayer.lockState());
+  snapshotChildren(defaultLayer, defaultLayerSnapshot);
+
+  for (const auto* customLayer : world.customLayers())
+  {
+    worldSnapshot->addChild(snapshotNode(*customLayer));
+  }
+
+  return worldSnapshot;
+}
+
 } // namespace
 
 io::PathMatcher makeBackupPathMatcher(std::filesystem::path mapBasename_)
@@ -141,8 +247,21 @@ Autosaver::Autosaver(
 {
 }
 
+Autosaver::~Autosaver()
+{
+  if (m_pendingBackup)
+  {
+    m_pendingBackup->result.wait();
+  }
+}
+
 void Autosaver::triggerAutosave(Logger& logger)
 {
+  if (!completePendingBackup(logger, false))
+  {
+    return;
+  }
+
   if (!kdl::mem_expired(m_document))
   {
     auto document = kdl::mem_lock(m_document);
@@ -155,8 +274,41 @@ void Autosaver::triggerAutosave(Logger& logger)
   }
 }
 
+void Autosaver::waitForPendingBackup(Logger& logger)
+{
+  completePendingBackup(logger, true);
+}
+
+bool Autosaver::completePendingBackup(Logger& logger, const bool wait)
+{
+  if (!m_pendingBackup)
+  {
+    return true;
+  }
+
+  if (
+    !wait
+    && m_pendingBackup->result.wait_for(std::chrono::seconds{0})
+         != std::future_status::ready)
+  {
+    return false;
+  }
+
+  m_pendingBackup->result.get() | kdl::transform([&]() {
+    logger.info() << "Created autosave backup at " << m_pendingBackup->path
+                  << " (blocked for " << m_pendingBackup->blockingTime.count() << "ms)";
+  }) | kdl::transform_error([&](auto e) {
+    logger.error() << "Could not create autosave backup: " << e.msg;
+  });
+
+  m_pendingBackup = std::nullopt;
+  return true;
+}
+
 void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document)
 {
+  const auto startTime = std::chrono::steady_clock::now();
+
   const auto& mapPath = document->path();
   assert(io::Disk::pathInfo(mapPath) == io::PathInfo::File);
 
@@ -175,12 +327,20 @@ void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document)
                           return fs.makeAbsolute(makeBackupName(mapBasename, backupNo));
                         });
              });
-  }) | kdl::transform([&](const auto& backupFilePath) {
+  }) | kdl::transform([&](auto backupFilePath) {
     m_lastSaveTime = Clock::now();
     m_lastModificationCount = document->modificationCount();
-    document->saveDocumentTo(backupFilePath);
 
-    logger.info() << "Created autosave backup at " << backupFilePath;
+    auto result = std::async(
+      std::launch::async,
+      [game = document->game(),
+       world = snapshotWorld(*document->world()),
+       backupFilePath]() { return game->writeMap(*world, backupFilePath); });
+
+    const auto blockingTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - startTime);
+    m_pendingBackup =
+      PendingBackup{std::move(backupFilePath), blockingTime, std::move(result)};
   }) | kdl::transform_error([&](auto e) {
     logger.error() << "Aborting autosave: " << e.msg;
   });
@@ -19,11 +19,14 @@
 
 #pragma once
 
+#include "Result.h"
 #include "io/PathMatcher.h"
 
 #include <chrono>
 #include <filesystem>
+#include <future>
 #include <memory>
+#include <optional>
 
 namespace tb
 {
@@ -37,11 +40,25 @@ class MapDocument;
 
 io::PathMatcher makeBackupPathMatcher(std::filesystem::path mapBasename);
 
+/**
+ * Periodically writes backups of a modified document.
+ *
+ * The backups are rotated and a snapshot of the document is taken on the calling thread,
+ * but the snapshot is written to the backup file on a worker thread. At most one backup
+ * is written at any time.
+ */
 class Autosaver
 {
 private:
   using Clock = std::chrono::system_clock;
 
+  struct PendingBackup
+  {
+    std::filesystem::path path;
+    std::chrono::milliseconds blockingTime;
+    std::future<Result<void>> result;
+  };
+
   std::weak_ptr<MapDocument> m_document;
 
   /**
@@ -65,15 +82,37 @@ private:
    */
   size_t m_lastModificationCount;
 
+  /**
+   * The backup that is currently being written, if any.
+   */
+  std::optional<PendingBackup> m_pendingBackup;
+
 public:
   explicit Autosaver(
     std::weak_ptr<MapDocument> document,
     std::chrono::milliseconds saveInterval = std::chrono::milliseconds(10 * 60 * 1000),
     size_t maxBackups = 50);
 
+  ~Autosaver();
+
+  /**
+   * Creates a backup if the document was modified and the save interval has elapsed. Does
+   * nothing while a previously started backup is still being written.
+   */
   void triggerAutosave(Logger& logger);
 
+  /**
+   * Blocks until the backup that is currently being written, if any, is complete.
+   */
+  void waitForPendingBackup(Logger& logger);
+
 private:
+  /**
+   * Logs the outcome of the pending backup if it is complete. Returns true if no backup
+   * is being written anymore.
+   */
+  bool completePendingBackup(Logger& logger, bool wait);
+
   void autosave(Logger& logger, std::shared_ptr<ui::MapDocument> document);
 };
 
@@ -37,6 +37,7 @@
 #include "kdl/map_utils.h"
 #include "kdl/memory_utils.h"
 #include "kdl/overload.h"
+#include "kdl/parallel.h"
 #include "kdl/set_temp.h"
 #include "kdl/vector_utils.h"
 
@@ -48,6 +49,7 @@
 
 #include <algorithm>
 #include <optional>
+#include <utility>
 
 namespace tb::ui
 {
@@ -801,35 +803,46 @@ void ClipTool::updateBrushes()
   const auto& brushNodes = document->selectedNodes().brushes();
   const auto& worldBounds = document->worldBounds();
 
-  const auto clip =
-    [&](auto* node, const auto& p1, const auto& p2, const auto& p3, auto& brushMap) {
-      auto brush = node->brush();
-      mdl::BrushFace::create(
-        p1,
-        p2,
-        p3,
-        mdl::BrushFaceAttributes(document->currentMaterialName()),
-        document->world()->mapFormat())
-        | kdl::and_then([&](mdl::BrushFace&& clipFace) {
-            setFaceAttributes(brush.faces(), clipFace);
-            return brush.clip(worldBounds, std::move(clipFace));
-          })
-        | kdl::transform([&]() {
-            brushMap[node->parent()].push_back(new mdl::BrushNode(std::move(brush)));
-          })
-        | kdl::transform_error(
-          [&](auto e) { document->error() << "Could not clip brush: " << e.msg; });
-    };
-
   if (canClip())
   {
     const auto points = m_strategy->getPoints();
     ensure(points.size() == 3, "invalid number of points");
 
-    for (auto* brushNode : brushNodes)
+    const auto attributes = mdl::BrushFaceAttributes(document->currentMaterialName());
+    const auto mapFormat = document->world()->mapFormat();
+
+    const auto clip =
+      [&](const auto* node, const auto& p1, const auto& p2, const auto& p3) {
+        auto brush = node->brush();
+        return mdl::BrushFace::create(p1, p2, p3, attributes, mapFormat)
+               | kdl::and_then([&](mdl::BrushFace&& clipFace) {
+                   setFaceAttributes(brush.faces(), clipFace);
+                   return brush.clip(worldBounds, std::move(clipFace));
+                 })
+               | kdl::transform([&]() { return std::move(brush); });
+      };
+
+    const auto addBrush = [&](auto* node, Result<mdl::Brush> result, auto& brushMap) {
+      std::move(result) | kdl::transform([&](mdl::Brush&& brush) {
+        brushMap[node->parent()].push_back(new mdl::BrushNode(std::move(brush)));
+      }) | kdl::transform_error([&](auto e) {
+        document->error() << "Could not clip brush: " << e.msg;
+      });
+    };
+
+    // The brushes are clipped in parallel, but added in the order of the selection
+    auto clipResults =
+      kdl::vec_parallel_transform(brushNodes, [&](const auto* brushNode) {
+        return std::pair{
+          clip(brushNode, points[0], points[1], points[2]),
+          clip(brushNode, points[0], points[2], points[1])};
+      });
+
+    for (size_t i = 0; i < brushNodes.size(); ++i)
     {
-      clip(brushNode, points[0], points[1], points[2], m_frontBrushes);
-      clip(brushNode, points[0], points[2], points[1], m_backBrushes);
+      auto& [frontResult, backResult] = clipResults[i];
+      addBrush(brushNodes[i], std::move(frontResult), m_frontBrushes);
+      addBrush(brushNodes[i], std::move(backResult), m_backBrushes);
     }
   }
   else
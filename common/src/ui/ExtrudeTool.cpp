@@ -35,6 +35,7 @@
 #include "kdl/map_utils.h"
 #include "kdl/memory_utils.h"
 #include "kdl/overload.h"
+#include "kdl/parallel.h"
 #include "kdl/reflection_impl.h"
 #include "kdl/result.h"
 #include "kdl/result_fold.h"
@@ -47,6 +48,7 @@
 #include "vm/vec_io.h" // IWYU pragma: keep
 
 #include <map>
+#include <optional>
 #include <vector>
 
 namespace tb::ui
@@ -400,17 +402,15 @@ bool splitBrushesOutward(
     }
   }
 
-  auto newDragFaces = std::vector<mdl::BrushFaceHandle>{};
-  auto newNodes = std::map<mdl::Node*, std::vector<mdl::Node*>>{};
+  const auto dragHandles = kdl::vec_transform(
+    dragState.initialDragHandles, [](const auto& dragHandle) { return &dragHandle; });
 
-  return kdl::vec_transform(
-           dragState.initialDragHandles,
-           [&](const auto& dragHandle) {
-             auto* brushNode = dragHandle.faceHandle.node();
-
-             const auto& oldBrush = dragHandle.brushAtDragStart;
-             const auto dragFaceIndex = dragHandle.faceHandle.faceIndex();
-             const auto newDragFaceNormal = dragHandle.faceNormal();
+  // The new brushes are computed in parallel, but added in the order of the drag handles
+  return kdl::vec_parallel_transform(
+           dragHandles,
+           [&](const auto* dragHandle) {
+             const auto& oldBrush = dragHandle->brushAtDragStart;
+             const auto dragFaceIndex = dragHandle->faceHandle.faceIndex();
 
              auto newBrush = oldBrush;
              return newBrush.moveBoundary(
@@ -420,21 +420,30 @@ bool splitBrushesOutward(
                         clipFace.invert();
                         return newBrush.clip(worldBounds, std::move(clipFace));
                       })
-                    | kdl::transform([&]() {
-                        auto* newBrushNode = new mdl::BrushNode(std::move(newBrush));
-                        newNodes[brushNode->parent()].push_back(newBrushNode);
-
-                        // Look up the new face index of the new drag handle
-                        if (
-                          const auto newDragFaceIndex =
-                            newBrushNode->brush().findFace(newDragFaceNormal))
-                        {
-                          newDragFaces.push_back(
-                            mdl::BrushFaceHandle(newBrushNode, *newDragFaceIndex));
-                        }
-                      });
+                    | kdl::transform([&]() { return std::move(newBrush); });
            })
-         | kdl::fold | kdl::transform([&]() {
+         | kdl::fold | kdl::transform([&](auto newBrushes) {
+             auto newDragFaces = std::vector<mdl::BrushFaceHandle>{};
+             auto newNodes = std::map<mdl::Node*, std::vector<mdl::Node*>>{};
+
+             for (size_t i = 0; i < newBrushes.size(); ++i)
+             {
+               const auto& dragHandle = dragState.initialDragHandles[i];
+               auto* brushNode = dragHandle.faceHandle.node();
+
+               auto* newBrushNode = new mdl::BrushNode(std::move(newBrushes[i]));
+               newNodes[brushNode->parent()].push_back(newBrushNode);
+
+               // Look up the new face index of the new drag handle
+               if (
+                 const auto newDragFaceIndex =
+                   newBrushNode->brush().findFace(dragHandle.faceNormal()))
+               {
+                 newDragFaces.push_back(
+                   mdl::BrushFaceHandle(newBrushNode, *newDragFaceIndex));
+               }
+             }
+
              // Apply the changes calculated above
              document.rollbackTransaction();
 
@@ -444,13 +453,23 @@ bool splitBrushesOutward(
              dragState.currentDragFaces = std::move(newDragFaces);
              dragState.totalDelta = delta;
            })
-         | kdl::transform_error([&](auto e) {
-             document.error() << "Could not extrude brush: " << e;
-             kdl::map_clear_and_delete(newNodes);
-           })
+         | kdl::transform_error(
+           [&](auto e) { document.error() << "Could not extrude brush: " << e; })
          | kdl::is_success();
 }
 
+/**
+ * The result of splitting a brush inward: the part of the brush that is closer to the
+ * drag handle, the part that is split off if there is one, and the normal of the face at
+ * which the brush was split.
+ */
+struct InwardSplit
+{
+  mdl::Brush frontBrush;
+  std::optional<mdl::Brush> backBrush;
+  vm::vec3d clipFaceNormal;
+};
+
 /**
  * Splits brushes "inwards" effectively clipping the selected brushes into two halves.
  *
@@ -479,77 +498,99 @@ bool splitBrushesInward(
     }
   }
 
-  auto newDragFaces = std::vector<mdl::BrushFaceHandle>{};
-  // This map is to handle the case when the brushes being
-  // extruded have different parents (e.g. different brush entities),
-  // so each newly created brush should be made a sibling of the brush it was cloned
-  // from.
-  auto newNodes = std::map<mdl::Node*, std::vector<mdl::Node*>>{};
-  auto nodesToUpdate = std::vector<std::pair<mdl::Node*, mdl::NodeContents>>{};
-
-  for (const auto& dragHandle : dragState.initialDragHandles)
-  {
-    auto* brushNode = dragHandle.faceHandle.node();
-
-    // "Front" means the part closer to the drag handles at the drag start
-    auto frontBrush = dragHandle.brushAtDragStart;
-    auto backBrush = dragHandle.brushAtDragStart;
-
-    auto clipFace = frontBrush.face(dragHandle.faceHandle.faceIndex());
-
-    if (clipFace.transform(vm::translation_matrix(delta), lockAlignment).is_error())
-    {
-      document.error() << "Could not extrude inwards: Error transforming face";
-      kdl::map_clear_and_delete(newNodes);
-      return false;
-    }
-
-    auto clipFaceInverted = clipFace;
-    clipFaceInverted.invert();
-
-    // Front brush should always be valid
-    if (frontBrush.clip(worldBounds, clipFaceInverted).is_error())
-    {
-      document.error() << "Could not extrude inwards: Front brush is empty";
-      kdl::map_clear_and_delete(newNodes);
-      return false;
-    }
-
-    nodesToUpdate.emplace_back(brushNode, std::move(frontBrush));
-
-    // Back brush
-    if (backBrush.clip(worldBounds, clipFace).is_success())
-    {
-      auto* newBrushNode = new mdl::BrushNode(std::move(backBrush));
-      newNodes[brushNode->parent()].push_back(newBrushNode);
-
-      // Look up the new face index of the new drag handle
-      if (const auto newDragFaceIndex = newBrushNode->brush().findFace(clipFace.normal()))
-      {
-        newDragFaces.emplace_back(newBrushNode, *newDragFaceIndex);
-      }
-    }
-  }
-
-  // Apply changes calculated above
-
-  dragState.currentDragFaces.clear();
-  document.rollbackTransaction();
-
-  // FIXME: deal with linked group update failure (needed for #3647)
-  const bool success = document.swapNodeContents("Resize Brushes", nodesToUpdate);
-  unused(success);
+  const auto dragHandles = kdl::vec_transform(
+    dragState.initialDragHandles, [](const auto& dragHandle) { return &dragHandle; });
+
+  // The brushes are split in parallel, but the results are applied in the order of the
+  // drag handles
+  return kdl::vec_parallel_transform(
+           dragHandles,
+           [&](const auto* dragHandle) -> Result<InwardSplit> {
+             // "Front" means the part closer to the drag handles at the drag start
+             auto frontBrush = dragHandle->brushAtDragStart;
+             auto backBrush = dragHandle->brushAtDragStart;
+
+             auto clipFace = frontBrush.face(dragHandle->faceHandle.faceIndex());
+
+             if (clipFace.transform(vm::translation_matrix(delta), lockAlignment)
+                   .is_error())
+             {
+               return Error{"Error transforming face"};
+             }
+
+             auto clipFaceInverted = clipFace;
+             clipFaceInverted.invert();
+
+             // Front brush should always be valid
+             if (frontBrush.clip(worldBounds, clipFaceInverted).is_error())
+             {
+               return Error{"Front brush is empty"};
+             }
+
+             auto split =
+               InwardSplit{std::move(frontBrush), std::nullopt, clipFace.normal()};
+
+             // Back brush
+             if (backBrush.clip(worldBounds, clipFace).is_success())
+             {
+               split.backBrush = std::move(backBrush);
+             }
+
+             return split;
+           })
+         | kdl::fold | kdl::transform([&](auto splits) {
+             auto newDragFaces = std::vector<mdl::BrushFaceHandle>{};
+             // This map is to handle the case when the brushes being
+             // extruded have different parents (e.g. different brush entities),
+             // so each newly created brush should be made a sibling of the brush it was
+             // cloned from.
+             auto newNodes = std::map<mdl::Node*, std::vector<mdl::Node*>>{};
+             auto nodesToUpdate = std::vector<std::pair<mdl::Node*, mdl::NodeContents>>{};
+
+             for (size_t i = 0; i < splits.size(); ++i)
+             {
+               auto& split = splits[i];
+               auto* brushNode = dragState.initialDragHandles[i].faceHandle.node();
+
+               nodesToUpdate.emplace_back(brushNode, std::move(split.frontBrush));
+
+               if (split.backBrush)
+               {
+                 auto* newBrushNode = new mdl::BrushNode(std::move(*split.backBrush));
+                 newNodes[brushNode->parent()].push_back(newBrushNode);
+
+                 // Look up the new face index of the new drag handle
+                 if (
+                   const auto newDragFaceIndex =
+                     newBrushNode->brush().findFace(split.clipFaceNormal))
+                 {
+                   newDragFaces.emplace_back(newBrushNode, *newDragFaceIndex);
+                 }
+               }
+             }
+
+             // Apply changes calculated above
+
+             dragState.currentDragFaces.clear();
+             document.rollbackTransaction();
 
-  // Add the newly split off brushes and select them (keeping the original brushes
-  // selected).
-  // FIXME: deal with linked group update failure (needed for #3647)
-  const auto addedNodes = document.addNodes(newNodes);
-  document.selectNodes(addedNodes);
+             // FIXME: deal with linked group update failure (needed for #3647)
+             const bool success =
+               document.swapNodeContents("Resize Brushes", nodesToUpdate);
+             unused(success);
 
-  dragState.currentDragFaces = std::move(newDragFaces);
-  dragState.totalDelta = delta;
+             // Add the newly split off brushes and select them (keeping the original
+             // brushes selected).
+             // FIXME: deal with linked group update failure (needed for #3647)
+             const auto addedNodes = document.addNodes(newNodes);
+             document.selectNodes(addedNodes);
 
-  return true;
+             dragState.currentDragFaces = std::move(newDragFaces);
+             dragState.totalDelta = delta;
+           })
+         | kdl::transform_error(
+           [&](auto e) { document.error() << "Could not extrude inwards: " << e.msg; })
+         | kdl::is_success();
 }
 
 std::vector<vm::polygon3d> getPolygons(const std::vector<ExtrudeDragHandle>& dragHandles)
@@ -43,7 +43,8 @@ std::string GLContextManager::GLVersion = "unknown";
 
 GLContextManager::GLContextManager()
   : m_shaderManager{std::make_unique<render::ShaderManager>()}
-  , m_vboManager{std::make_unique<render::VboManager>(*m_shaderManager)}
+  , m_vboManager{std::make_unique<render::VboManager>(
+      *m_shaderManager, render::VboAllocationMode::Arena)}
   , m_fontManager{std::make_unique<render::FontManager>()}
 {
 }
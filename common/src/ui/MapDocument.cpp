@@ -22,6 +22,7 @@
 #include "Exceptions.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Trace.h"
 #include "Uuid.h"
 #include "io/DiskIO.h"
 #include "io/ExportOptions.h"
@@ -70,6 +71,7 @@
 #include "mdl/ModelUtils.h"
 #include "mdl/Node.h"
 #include "mdl/NodeContents.h"
+#include "mdl/NodeIdSet.h"
 #include "mdl/NodeQueries.h"
 #include "mdl/NonIntegerVerticesValidator.h"
 #include "mdl/PatchNode.h"
@@ -88,6 +90,7 @@
 #include "ui/Actions.h"
 #include "ui/AddRemoveNodesCommand.h"
 #include "ui/BrushVertexCommands.h"
+#include "ui/CachingLogger.h"
 #include "ui/CurrentGroupCommand.h"
 #include "ui/Grid.h"
 #include "ui/MapTextEncoding.h"
@@ -126,12 +129,18 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstdlib>
+#include <future>
 #include <map>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
+#include <variant>
 #include <vector>
 
 namespace tb::ui
@@ -208,6 +217,33 @@ std::vector<mdl::GroupNode*> collectGroupsOrContainers(
   return kdl::vec_sort_and_remove_duplicates(std::move(result));
 }
 
+using NodeContentType =
+  std::variant<mdl::Layer, mdl::Group, mdl::Entity, mdl::Brush, mdl::BezierPatch>;
+
+template <typename N>
+NodeContentType copyNodeContents(N* node)
+{
+  return node->accept(kdl::overload(
+    [](const mdl::WorldNode* worldNode) -> NodeContentType {
+      return worldNode->entity();
+    },
+    [](const mdl::LayerNode* layerNode) -> NodeContentType {
+      return layerNode->layer();
+    },
+    [](const mdl::GroupNode* groupNode) -> NodeContentType {
+      return groupNode->group();
+    },
+    [](const mdl::EntityNode* entityNode) -> NodeContentType {
+      return entityNode->entity();
+    },
+    [](const mdl::BrushNode* brushNode) -> NodeContentType {
+      return brushNode->brush();
+    },
+    [](const mdl::PatchNode* patchNode) -> NodeContentType {
+      return patchNode->patch();
+    }));
+}
+
 /**
  * Applies the given lambda to a copy of the contents of each of the given nodes and
  * returns a vector of pairs of the original node and the modified contents.
@@ -227,35 +263,13 @@ template <typename N, typename L>
 std::optional<std::vector<std::pair<mdl::Node*, mdl::NodeContents>>> applyToNodeContents(
   const std::vector<N*>& nodes, L lambda)
 {
-  using NodeContentType =
-    std::variant<mdl::Layer, mdl::Group, mdl::Entity, mdl::Brush, mdl::BezierPatch>;
-
   auto newNodes = std::vector<std::pair<mdl::Node*, mdl::NodeContents>>{};
   newNodes.reserve(nodes.size());
 
   bool success = true;
   std::transform(
     std::begin(nodes), std::end(nodes), std::back_inserter(newNodes), [&](auto* node) {
-      NodeContentType nodeContents = node->accept(kdl::overload(
-        [](const mdl::WorldNode* worldNode) -> NodeContentType {
-          return worldNode->entity();
-        },
-        [](const mdl::LayerNode* layerNode) -> NodeContentType {
-          return layerNode->layer();
-        },
-        [](const mdl::GroupNode* groupNode) -> NodeContentType {
-          return groupNode->group();
-        },
-        [](const mdl::EntityNode* entityNode) -> NodeContentType {
-          return entityNode->entity();
-        },
-        [](const mdl::BrushNode* brushNode) -> NodeContentType {
-          return brushNode->brush();
-        },
-        [](const mdl::PatchNode* patchNode) -> NodeContentType {
-          return patchNode->patch();
-        }));
-
+      auto nodeContents = copyNodeContents(node);
       success = success && std::visit(lambda, nodeContents);
       return std::make_pair(node, mdl::NodeContents(std::move(nodeContents)));
     });
@@ -263,6 +277,79 @@ std::optional<std::vector<std::pair<mdl::Node*, mdl::NodeContents>>> applyToNode
   return success ? std::make_optional(newNodes) : std::nullopt;
 }
 
+/**
+ * Applies the given lambda to a copy of the contents of each of the given nodes in
+ * parallel and returns a vector of tuples of the original node, the modified contents and
+ * the result of the lambda, in the order of the given nodes.
+ *
+ * The lambda L needs an overload for every type of node contents. It should modify the
+ * given node contents in place and return a value of type R. The lambda is called from
+ * multiple threads, so it must not modify any shared state.
+ */
+template <typename R, typename N, typename L>
+std::vector<std::tuple<mdl::Node*, mdl::NodeContents, R>> applyToNodeContentsInParallel(
+  const std::vector<N*>& nodes, const L& lambda)
+{
+  return kdl::vec_parallel_transform(nodes, [&](N* node) {
+    auto nodeContents = copyNodeContents(node);
+    auto result = std::visit(lambda, nodeContents);
+    return std::tuple<mdl::Node*, mdl::NodeContents, R>{
+      node, mdl::NodeContents{std::move(nodeContents)}, std::move(result)};
+  });
+}
+
+/**
+ * The result of moving vertices, edges or faces of a brush: the new positions of the
+ * moved handles, an error if moving them failed, or an empty optional if they cannot be
+ * moved.
+ */
+template <typename P>
+using MoveHandlesResult = std::optional<Result<std::vector<P>>>;
+
+/**
+ * Collects the node contents computed by moving the handles of brushes with
+ * applyToNodeContentsInParallel. The results are processed in the order of the nodes.
+ *
+ * If every handle was moved, returns the new node contents and appends the new handle
+ * positions to the given vector. Otherwise, logs the first error if there is one, and
+ * returns an empty optional.
+ */
+template <typename P>
+std::optional<std::vector<std::pair<mdl::Node*, mdl::NodeContents>>> collectMovedHandles(
+  std::vector<std::tuple<mdl::Node*, mdl::NodeContents, MoveHandlesResult<P>>> results,
+  std::vector<P>& newHandlePositions,
+  Logger& logger,
+  const std::string_view errorMessage)
+{
+  auto newNodes = std::vector<std::pair<mdl::Node*, mdl::NodeContents>>{};
+  newNodes.reserve(results.size());
+
+  for (auto& [node, nodeContents, moveResult] : results)
+  {
+    if (!moveResult)
+    {
+      return std::nullopt;
+    }
+
+    const auto success =
+      std::move(*moveResult) | kdl::transform([&](auto newPositions) {
+        newHandlePositions =
+          kdl::vec_concat(std::move(newHandlePositions), std::move(newPositions));
+      })
+      | kdl::if_error([&](auto e) { logger.error() << errorMessage << e.msg; })
+      | kdl::is_success();
+
+    if (!success)
+    {
+      return std::nullopt;
+    }
+
+    newNodes.emplace_back(node, std::move(nodeContents));
+  }
+
+  return newNodes;
+}
+
 /**
  * Applies the given lambda to a copy of the contents of each of the given nodes and
  * swaps the node contents if the given lambda succeeds for all node contents.
@@ -613,6 +700,8 @@ Result<void> MapDocument::loadDocument(
   std::shared_ptr<mdl::Game> game,
   const std::filesystem::path& path)
 {
+  traceZone("MapDocument::loadDocument");
+
   info("Loading document from " + path.string());
 
   clearRepeatableCommands();
@@ -641,6 +730,8 @@ void MapDocument::saveDocumentAs(const std::filesystem::path& path)
 
 void MapDocument::saveDocumentTo(const std::filesystem::path& path)
 {
+  traceZone("MapDocument::saveDocumentTo");
+
   ensure(m_game.get() != nullptr, "game is null");
   ensure(m_world, "world is null");
   m_game->writeMap(*m_world, path) | kdl::transform_error([&](const auto& e) {
@@ -735,56 +826,49 @@ namespace
 
 auto extractNodesToPaste(const std::vector<mdl::Node*>& nodes, mdl::Node* parent)
 {
-  auto nodesToDetach = std::vector<mdl::Node*>{};
   auto nodesToDelete = std::vector<mdl::Node*>{};
   auto nodesToAdd = std::map<mdl::Node*, std::vector<mdl::Node*>>{};
 
+  // Detaches all children of the given container at once. Removing the children one by
+  // one would take quadratic time since every removal erases from the container's
+  // children. The detached nodes are either added to the map or deleted below.
+  const auto detachChildren = [](mdl::Node* container) {
+    for (auto& child : container->replaceChildren({}))
+    {
+      child.release();
+    }
+  };
+
   for (auto* node : nodes)
   {
     node->accept(kdl::overload(
       [&](auto&& thisLambda, mdl::WorldNode* world) {
         world->visitChildren(thisLambda);
+        detachChildren(world);
         nodesToDelete.push_back(world);
       },
       [&](auto&& thisLambda, mdl::LayerNode* layer) {
         layer->visitChildren(thisLambda);
-        nodesToDetach.push_back(layer);
+        detachChildren(layer);
         nodesToDelete.push_back(layer);
       },
-      [&](mdl::GroupNode* group) {
-        nodesToDetach.push_back(group);
-        nodesToAdd[parent].push_back(group);
-      },
+      [&](mdl::GroupNode* group) { nodesToAdd[parent].push_back(group); },
       [&](auto&& thisLambda, mdl::EntityNode* entityNode) {
         if (mdl::isWorldspawn(entityNode->entity().classname()))
         {
           entityNode->visitChildren(thisLambda);
-          nodesToDetach.push_back(entityNode);
+          detachChildren(entityNode);
           nodesToDelete.push_back(entityNode);
         }
         else
         {
-          nodesToDetach.push_back(entityNode);
           nodesToAdd[parent].push_back(entityNode);
         }
       },
-      [&](mdl::BrushNode* brush) {
-        nodesToDetach.push_back(brush);
-        nodesToAdd[parent].push_back(brush);
-      },
-      [&](mdl::PatchNode* patch) {
-        nodesToDetach.push_back(patch);
-        nodesToAdd[parent].push_back(patch);
-      }));
+      [&](mdl::BrushNode* brush) { nodesToAdd[parent].push_back(brush); },
+      [&](mdl::PatchNode* patch) { nodesToAdd[parent].push_back(patch); }));
   }
 
-  for (auto* node : nodesToDetach)
-  {
-    if (auto* nodeParent = node->parent())
-    {
-      nodeParent->removeChild(node);
-    }
-  }
   kdl::vec_clear_and_delete(nodesToDelete);
 
   return nodesToAdd;
@@ -2555,6 +2639,7 @@ void MapDocument::moveSelectionToLayer(mdl::LayerNode* layer)
 
   auto nodesToMove = std::vector<mdl::Node*>{};
   auto nodesToSelect = std::vector<mdl::Node*>{};
+  auto movedEntityIds = mdl::NodeIdSet{};
 
   const auto addBrushOrPatchNode = [&](auto* node) {
     assert(node->selected());
@@ -2569,7 +2654,7 @@ void MapDocument::moveSelectionToLayer(mdl::LayerNode* layer)
       }
       else
       {
-        if (!kdl::vec_contains(nodesToMove, entity))
+        if (movedEntityIds.insert(entity->nodeId()))
         {
           nodesToMove.push_back(entity);
           nodesToSelect = kdl::vec_concat(std::move(nodesToSelect), entity->children());
@@ -2599,6 +2684,7 @@ void MapDocument::moveSelectionToLayer(mdl::LayerNode* layer)
         {
           nodesToMove.push_back(entity);
           nodesToSelect.push_back(entity);
+          movedEntityIds.insert(entity->nodeId());
         }
       },
       [&](mdl::BrushNode* brush) { addBrushOrPatchNode(brush); },
@@ -3156,16 +3242,26 @@ bool MapDocument::csgSubtract()
   auto toRemove =
     std::vector<mdl::Node*>{std::begin(subtrahendNodes), std::end(subtrahendNodes)};
 
+  // The minuends are subtracted from in parallel, but the results are processed in the
+  // order of the minuends so that the resulting nodes are always added in the same order.
+  const auto mapFormat = m_world->mapFormat();
+  const auto& defaultMaterialName = currentMaterialName();
+  auto subtractionResults =
+    kdl::vec_parallel_transform(minuendNodes, [&](auto* minuendNode) {
+      return std::pair{
+        minuendNode,
+        minuendNode->brush().subtract(
+          mapFormat, m_worldBounds, defaultMaterialName, subtrahends)};
+    });
+
   return kdl::vec_transform(
-           minuendNodes,
-           [&](auto* minuendNode) {
-             const auto& minuend = minuendNode->brush();
-             auto currentSubtractionResults = minuend.subtract(
-               m_world->mapFormat(), m_worldBounds, currentMaterialName(), subtrahends);
+           std::move(subtractionResults),
+           [&](auto minuendAndResults) {
+             auto* minuendNode = minuendAndResults.first;
 
              return kdl::vec_filter(
-                      std::move(currentSubtractionResults),
-                      [](const auto r) { return r | kdl::is_success(); })
+                      std::move(minuendAndResults.second),
+                      [](const auto& r) { return r | kdl::is_success(); })
                     | kdl::fold | kdl::transform([&](auto currentBrushes) {
                         if (!currentBrushes.empty())
                         {
@@ -3615,16 +3711,19 @@ bool MapDocument::extrudeBrushes(
   const std::vector<vm::polygon3d>& faces, const vm::vec3d& delta)
 {
   const auto nodes = m_selectedNodes.nodes();
-  return applyAndSwap(
-    *this,
-    "Resize Brushes",
+  if (nodes.empty())
+  {
+    return true;
+  }
+
+  const auto alignmentLock = pref(Preferences::AlignmentLock);
+  auto resizeResults = applyToNodeContentsInParallel<Result<bool>>(
     nodes,
-    collectContainingGroups(nodes),
     kdl::overload(
-      [](mdl::Layer&) { return true; },
-      [](mdl::Group&) { return true; },
-      [](mdl::Entity&) { return true; },
-      [&](mdl::Brush& brush) {
+      [](mdl::Layer&) -> Result<bool> { return true; },
+      [](mdl::Group&) -> Result<bool> { return true; },
+      [](mdl::Entity&) -> Result<bool> { return true; },
+      [&](mdl::Brush& brush) -> Result<bool> {
         const auto faceIndex = brush.findFace(faces);
         if (!faceIndex)
         {
@@ -3632,16 +3731,31 @@ bool MapDocument::extrudeBrushes(
           return true;
         }
 
-        return brush.moveBoundary(
-                 m_worldBounds, *faceIndex, delta, pref(Preferences::AlignmentLock))
-               | kdl::transform([&]() { return m_worldBounds.contains(brush.bounds()); })
-               | kdl::transform_error([&](auto e) {
-                   error() << "Could not resize brush: " << e.msg;
-                   return false;
-                 })
-               | kdl::value();
+        return brush.moveBoundary(m_worldBounds, *faceIndex, delta, alignmentLock)
+               | kdl::transform([&]() { return m_worldBounds.contains(brush.bounds()); });
       },
-      [](mdl::BezierPatch&) { return true; }));
+      [](mdl::BezierPatch&) -> Result<bool> { return true; }));
+
+  auto newNodes = std::vector<std::pair<mdl::Node*, mdl::NodeContents>>{};
+  newNodes.reserve(resizeResults.size());
+
+  for (auto& [node, nodeContents, resizeResult] : resizeResults)
+  {
+    const auto success = std::move(resizeResult) | kdl::transform_error([&](auto e) {
+                           error() << "Could not resize brush: " << e.msg;
+                           return false;
+                         })
+                         | kdl::value();
+    if (!success)
+    {
+      return false;
+    }
+
+    newNodes.emplace_back(node, std::move(nodeContents));
+  }
+
+  return swapNodeContents(
+    "Resize Brushes", std::move(newNodes), collectContainingGroups(nodes));
 }
 
 bool MapDocument::setFaceAttributes(const mdl::BrushFaceAttributes& attributes)
@@ -3787,39 +3901,41 @@ bool MapDocument::snapVertices(const double snapTo)
 MapDocument::MoveVerticesResult MapDocument::moveVertices(
   std::vector<vm::vec3d> vertexPositions, const vm::vec3d& delta)
 {
-  auto newVertexPositions = std::vector<vm::vec3d>{};
-  auto newNodes = applyToNodeContents(
+  using MoveResult = MoveHandlesResult<vm::vec3d>;
+
+  const auto uvLock = pref(Preferences::UVLock);
+  auto moveResults = applyToNodeContentsInParallel<MoveResult>(
     m_selectedNodes.nodes(),
     kdl::overload(
-      [](mdl::Layer&) { return true; },
-      [](mdl::Group&) { return true; },
-      [](mdl::Entity&) { return true; },
-      [&](mdl::Brush& brush) {
+      [](mdl::Layer&) -> MoveResult { return std::vector<vm::vec3d>{}; },
+      [](mdl::Group&) -> MoveResult { return std::vector<vm::vec3d>{}; },
+      [](mdl::Entity&) -> MoveResult { return std::vector<vm::vec3d>{}; },
+      [&](mdl::Brush& brush) -> MoveResult {
         const auto verticesToMove = kdl::vec_filter(
           vertexPositions, [&](const auto& vertex) { return brush.hasVertex(vertex); });
         if (verticesToMove.empty())
         {
-          return true;
+          return std::vector<vm::vec3d>{};
         }
 
         if (!brush.canMoveVertices(m_worldBounds, verticesToMove, delta))
         {
-          return false;
+          return std::nullopt;
         }
 
-        return brush.moveVertices(
-                 m_worldBounds, verticesToMove, delta, pref(Preferences::UVLock))
+        return brush.moveVertices(m_worldBounds, verticesToMove, delta, uvLock)
                | kdl::transform([&]() {
-                   auto newPositions =
-                     brush.findClosestVertexPositions(verticesToMove + delta);
-                   newVertexPositions = kdl::vec_concat(
-                     std::move(newVertexPositions), std::move(newPositions));
-                 })
-               | kdl::if_error(
-                 [&](auto e) { error() << "Could not move brush vertices: " << e.msg; })
-               | kdl::is_success();
+                   return brush.findClosestVertexPositions(verticesToMove + delta);
+                 });
       },
-      [](mdl::BezierPatch&) { return true; }));
+      [](mdl::BezierPatch&) -> MoveResult { return std::vector<vm::vec3d>{}; }));
+
+  auto newVertexPositions = std::vector<vm::vec3d>{};
+  auto newNodes = collectMovedHandles(
+    std::move(moveResults),
+    newVertexPositions,
+    *this,
+    "Could not move brush vertices: ");
 
   if (newNodes)
   {
@@ -3866,40 +3982,40 @@ MapDocument::MoveVerticesResult MapDocument::moveVertices(
 bool MapDocument::moveEdges(
   std::vector<vm::segment3d> edgePositions, const vm::vec3d& delta)
 {
-  auto newEdgePositions = std::vector<vm::segment3d>{};
-  auto newNodes = applyToNodeContents(
+  using MoveResult = MoveHandlesResult<vm::segment3d>;
+
+  const auto uvLock = pref(Preferences::UVLock);
+  auto moveResults = applyToNodeContentsInParallel<MoveResult>(
     m_selectedNodes.nodes(),
     kdl::overload(
-      [](mdl::Layer&) { return true; },
-      [](mdl::Group&) { return true; },
-      [](mdl::Entity&) { return true; },
-      [&](mdl::Brush& brush) {
+      [](mdl::Layer&) -> MoveResult { return std::vector<vm::segment3d>{}; },
+      [](mdl::Group&) -> MoveResult { return std::vector<vm::segment3d>{}; },
+      [](mdl::Entity&) -> MoveResult { return std::vector<vm::segment3d>{}; },
+      [&](mdl::Brush& brush) -> MoveResult {
         const auto edgesToMove = kdl::vec_filter(
           edgePositions, [&](const auto& edge) { return brush.hasEdge(edge); });
         if (edgesToMove.empty())
         {
-          return true;
+          return std::vector<vm::segment3d>{};
         }
 
         if (!brush.canMoveEdges(m_worldBounds, edgesToMove, delta))
         {
-          return false;
+          return std::nullopt;
         }
 
-        return brush.moveEdges(
-                 m_worldBounds, edgesToMove, delta, pref(Preferences::UVLock))
+        return brush.moveEdges(m_worldBounds, edgesToMove, delta, uvLock)
                | kdl::transform([&]() {
-                   auto newPositions = brush.findClosestEdgePositions(kdl::vec_transform(
+                   return brush.findClosestEdgePositions(kdl::vec_transform(
                      edgesToMove,
                      [&](const auto& edge) { return edge.translate(delta); }));
-                   newEdgePositions = kdl::vec_concat(
-                     std::move(newEdgePositions), std::move(newPositions));
-                 })
-               | kdl::if_error(
-                 [&](auto e) { error() << "Could not move brush edges: " << e.msg; })
-               | kdl::is_success();
+                 });
       },
-      [](mdl::BezierPatch&) { return true; }));
+      [](mdl::BezierPatch&) -> MoveResult { return std::vector<vm::segment3d>{}; }));
+
+  auto newEdgePositions = std::vector<vm::segment3d>{};
+  auto newNodes = collectMovedHandles(
+    std::move(moveResults), newEdgePositions, *this, "Could not move brush edges: ");
 
   if (newNodes)
   {
@@ -3934,40 +4050,40 @@ bool MapDocument::moveEdges(
 bool MapDocument::moveFaces(
   std::vector<vm::polygon3d> facePositions, const vm::vec3d& delta)
 {
-  auto newFacePositions = std::vector<vm::polygon3d>{};
-  auto newNodes = applyToNodeContents(
+  using MoveResult = MoveHandlesResult<vm::polygon3d>;
+
+  const auto uvLock = pref(Preferences::UVLock);
+  auto moveResults = applyToNodeContentsInParallel<MoveResult>(
     m_selectedNodes.nodes(),
     kdl::overload(
-      [](mdl::Layer&) { return true; },
-      [](mdl::Group&) { return true; },
-      [](mdl::Entity&) { return true; },
-      [&](mdl::Brush& brush) {
+      [](mdl::Layer&) -> MoveResult { return std::vector<vm::polygon3d>{}; },
+      [](mdl::Group&) -> MoveResult { return std::vector<vm::polygon3d>{}; },
+      [](mdl::Entity&) -> MoveResult { return std::vector<vm::polygon3d>{}; },
+      [&](mdl::Brush& brush) -> MoveResult {
         const auto facesToMove = kdl::vec_filter(
           facePositions, [&](const auto& face) { return brush.hasFace(face); });
         if (facesToMove.empty())
         {
-          return true;
+          return std::vector<vm::polygon3d>{};
         }
 
         if (!brush.canMoveFaces(m_worldBounds, facesToMove, delta))
         {
-          return false;
+          return std::nullopt;
         }
 
-        return brush.moveFaces(
-                 m_worldBounds, facesToMove, delta, pref(Preferences::UVLock))
+        return brush.moveFaces(m_worldBounds, facesToMove, delta, uvLock)
                | kdl::transform([&]() {
-                   auto newPositions = brush.findClosestFacePositions(kdl::vec_transform(
+                   return brush.findClosestFacePositions(kdl::vec_transform(
                      facesToMove,
                      [&](const auto& face) { return face.translate(delta); }));
-                   newFacePositions = kdl::vec_concat(
-                     std::move(newFacePositions), std::move(newPositions));
-                 })
-               | kdl::if_error(
-                 [&](auto e) { error() << "Could not move brush faces: " << e.msg; })
-               | kdl::is_success();
+                 });
       },
-      [](mdl::BezierPatch&) { return true; }));
+      [](mdl::BezierPatch&) -> MoveResult { return std::vector<vm::polygon3d>{}; }));
+
+  auto newFacePositions = std::vector<vm::polygon3d>{};
+  auto newNodes = collectMovedHandles(
+    std::move(moveResults), newFacePositions, *this, "Could not move brush faces: ");
 
   if (newNodes)
   {
@@ -4261,19 +4377,49 @@ void MapDocument::cancelTransaction()
   m_repeatStack->commitTransaction();
 }
 
+void MapDocument::openNotificationBatch()
+{
+  m_nodesDidChangeBatch.open();
+  m_nodeVisibilityDidChangeBatch.open();
+  m_nodeLockingDidChangeBatch.open();
+  m_brushFacesDidChangeBatch.open();
+}
+
+void MapDocument::closeNotificationBatch()
+{
+  m_brushFacesDidChangeBatch.close();
+  m_nodeLockingDidChangeBatch.close();
+  m_nodeVisibilityDidChangeBatch.close();
+  m_nodesDidChangeBatch.close();
+}
+
+const NotifierBatchStats& MapDocument::nodesDidChangeBatchStats() const
+{
+  return m_nodesDidChangeBatch.stats();
+}
+
+const NotifierBatchStats& MapDocument::brushFacesDidChangeBatchStats() const
+{
+  return m_brushFacesDidChangeBatch.stats();
+}
+
 std::unique_ptr<CommandResult> MapDocument::execute(std::unique_ptr<Command>&& command)
 {
+  traceZone("MapDocument::execute");
   return doExecute(std::move(command));
 }
 
 std::unique_ptr<CommandResult> MapDocument::executeAndStore(
   std::unique_ptr<UndoableCommand>&& command)
 {
+  traceZone("MapDocument::executeAndStore");
   return doExecuteAndStore(std::move(command));
 }
 
 void MapDocument::processResourcesSync(const mdl::ProcessContext& processContext)
 {
+  m_materialManager->requestUsedTextures();
+
   auto allProcessedResourceIds = std::vector<mdl::ResourceId>{};
   while (m_resourceManager->needsProcessing())
   {
@@ -4298,6 +4444,8 @@ void MapDocument::processResourcesSync(const mdl::ProcessContext& processContext
 
 void MapDocument::processResourcesAsync(const mdl::ProcessContext& processContext)
 {
+  m_materialManager->requestUsedTextures();
+
   const auto processedResourceIds = m_resourceManager->process(
     [](auto task) { return std::async(std::move(task)); },
     processContext,
@@ -4496,13 +4644,54 @@ void MapDocument::setEnabledMaterialCollections(
   transaction.finish(success);
 }
 
+namespace
+{
+
+auto millisecondsSince(const std::chrono::steady_clock::time_point startTime)
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+           std::chrono::steady_clock::now() - startTime)
+    .count();
+}
+
+} // namespace
+
 void MapDocument::loadAssets()
 {
-  loadEntityDefinitions();
+  traceZone("MapDocument::loadAssets");
+
+  const auto startTime = std::chrono::steady_clock::now();
+
+  // Entity definitions are read from the disk and not from the game file system, so they
+  // can be parsed on a worker thread while the material collections are loaded. Messages
+  // logged by the worker are cached and replayed once it has finished.
+  const auto entityDefinitionSpec = entityDefinitionFile();
+  const auto entityDefinitionPath =
+    m_game->findEntityDefinitionFile(entityDefinitionSpec, externalSearchPaths());
+
+  auto entityDefinitionLogger = CachingLogger{};
+  auto entityDefinitions =
+    std::async(std::launch::async, [&, game = m_game, startTime]() {
+      auto status = io::SimpleParserStatus{entityDefinitionLogger};
+      auto result = game->loadEntityDefinitions(status, entityDefinitionPath);
+      entityDefinitionLogger.debug()
+        << "Parsed entity definitions in " << millisecondsSince(startTime) << "ms";
+      return result;
+    });
+
+  loadMaterials();
+  debug() << "Loaded material collections in " << millisecondsSince(startTime) << "ms";
+
+  auto loadedEntityDefinitions = entityDefinitions.get();
+  entityDefinitionLogger.setParentLogger(&logger());
+  setLoadedEntityDefinitions(
+    entityDefinitionSpec, entityDefinitionPath, std::move(loadedEntityDefinitions));
+
+  const auto bindStartTime = std::chrono::steady_clock::now();
   setEntityDefinitions();
   loadEntityModels();
-  loadMaterials();
   setMaterials();
+  debug() << "Bound assets to map in " << millisecondsSince(bindStartTime) << "ms";
 }
 
 void MapDocument::unloadAssets()
@@ -4518,23 +4707,30 @@ void MapDocument::loadEntityDefinitions()
   const auto path = m_game->findEntityDefinitionFile(spec, externalSearchPaths());
   auto status = io::SimpleParserStatus{logger()};
 
-  m_entityDefinitionManager->loadDefinitions(path, *m_game, status)
-    | kdl::transform([&]() {
-        info("Loaded entity definition file " + path.filename().string());
-        createEntityDefinitionActions();
-      })
-    | kdl::transform_error([&](auto e) {
-        if (spec.builtin())
-        {
-          error() << "Could not load builtin entity definition file '" << spec.path()
-                  << "': " << e.msg;
-        }
-        else
-        {
-          error() << "Could not load external entity definition file '" << spec.path()
-                  << "': " << e.msg;
-        }
-      });
+  setLoadedEntityDefinitions(spec, path, m_game->loadEntityDefinitions(status, path));
+}
+
+void MapDocument::setLoadedEntityDefinitions(
+  const mdl::EntityDefinitionFileSpec& spec,
+  const std::filesystem::path& path,
+  Result<std::vector<std::unique_ptr<mdl::EntityDefinition>>> definitions)
+{
+  std::move(definitions) | kdl::transform([&](auto loadedDefinitions) {
+    m_entityDefinitionManager->setDefinitions(std::move(loadedDefinitions));
+    info("Loaded entity definition file " + path.filename().string());
+    createEntityDefinitionActions();
+  }) | kdl::transform_error([&](auto e) {
+    if (spec.builtin())
+    {
+      error() << "Could not load builtin entity definition file '" << spec.path()
+              << "': " << e.msg;
+    }
+    else
+    {
+      error() << "Could not load external entity definition file '" << spec.path()
+              << "': " << e.msg;
+    }
+  });
 }
 
 void MapDocument::unloadEntityDefinitions()
@@ -4589,54 +4785,112 @@ void MapDocument::unloadMaterials()
   m_materialManager->clear();
 }
 
-static auto makeSetMaterialsVisitor(mdl::MaterialManager& manager)
+namespace
+{
+
+constexpr auto MaterialBindingChunkSize = size_t(1024);
+
+struct MaterialBindingNodes
+{
+  std::vector<mdl::BrushNode*> brushNodes;
+  std::vector<mdl::PatchNode*> patchNodes;
+};
+
+auto makeCollectMaterialBindingNodesVisitor(MaterialBindingNodes& result)
 {
   return kdl::overload(
     [](auto&& thisLambda, mdl::WorldNode* world) { world->visitChildren(thisLambda); },
     [](auto&& thisLambda, mdl::LayerNode* layer) { layer->visitChildren(thisLambda); },
     [](auto&& thisLambda, mdl::GroupNode* group) { group->visitChildren(thisLambda); },
     [](auto&& thisLambda, mdl::EntityNode* entity) { entity->visitChildren(thisLambda); },
-    [&](mdl::BrushNode* brushNode) {
-      const mdl::Brush& brush = brushNode->brush();
-      for (size_t i = 0u; i < brush.faceCount(); ++i)
+    [&](mdl::BrushNode* brushNode) { result.brushNodes.push_back(brushNode); },
+    [&](mdl::PatchNode* patchNode) { result.patchNodes.push_back(patchNode); });
+}
+
+/**
+ * Binds the materials returned by the given function to the given brushes and patches.
+ *
+ * The brushes are split into chunks which are bound in parallel. Within a chunk, every
+ * material name is only resolved once, and every brush is invalidated at most once. The
+ * given function must therefore be safe to call from multiple threads.
+ */
+template <typename ResolveMaterial>
+void bindMaterials(
+  const MaterialBindingNodes& nodes, const ResolveMaterial& resolveMaterial)
+{
+  const auto& brushNodes = nodes.brushNodes;
+  const auto bindChunk = [&](const size_t chunkIndex) {
+    auto materialsByName = std::unordered_map<std::string_view, mdl::Material*>{};
+    auto faceMaterials = std::vector<mdl::Material*>{};
+
+    const auto first = chunkIndex * MaterialBindingChunkSize;
+    const auto last = std::min(first + MaterialBindingChunkSize, brushNodes.size());
+    for (auto i = first; i < last; ++i)
+    {
+      auto* brushNode = brushNodes[i];
+
+      faceMaterials.clear();
+      for (const auto& face : brushNode->brush().faces())
       {
-        const mdl::BrushFace& face = brush.face(i);
-        mdl::Material* material = manager.material(face.attributes().materialName());
-        brushNode->setFaceMaterial(i, material);
+        const auto& materialName = face.attributes().materialName();
+        auto [it, inserted] = materialsByName.try_emplace(materialName, nullptr);
+        if (inserted)
+        {
+          it->second = resolveMaterial(materialName);
+        }
+        faceMaterials.push_back(it->second);
       }
-    },
-    [&](mdl::PatchNode* patchNode) {
-      auto* material = manager.material(patchNode->patch().materialName());
-      patchNode->setMaterial(material);
-    });
+
+      brushNode->setFaceMaterials(faceMaterials);
+    }
+  };
+
+  const auto chunkCount =
+    (brushNodes.size() + MaterialBindingChunkSize - 1) / MaterialBindingChunkSize;
+  if (chunkCount > 1)
+  {
+    kdl::parallel_for(chunkCount, bindChunk);
+  }
+  else if (chunkCount == 1)
+  {
+    bindChunk(0);
+  }
+
+  for (auto* patchNode : nodes.patchNodes)
+  {
+    patchNode->setMaterial(resolveMaterial(patchNode->patch().materialName()));
+  }
 }
 
-static auto makeUnsetMaterialsVisitor()
+auto makeResolveMaterial(mdl::MaterialManager& manager)
 {
-  return kdl::overload(
-    [](auto&& thisLambda, mdl::WorldNode* world) { world->visitChildren(thisLambda); },
-    [](auto&& thisLambda, mdl::LayerNode* layer) { layer->visitChildren(thisLambda); },
-    [](auto&& thisLambda, mdl::GroupNode* group) { group->visitChildren(thisLambda); },
-    [](auto&& thisLambda, mdl::EntityNode* entity) { entity->visitChildren(thisLambda); },
-    [](mdl::BrushNode* brushNode) {
-      const mdl::Brush& brush = brushNode->brush();
-      for (size_t i = 0u; i < brush.faceCount(); ++i)
-      {
-        brushNode->setFaceMaterial(i, nullptr);
-      }
-    },
-    [](mdl::PatchNode* patchNode) { patchNode->setMaterial(nullptr); });
+  // looking up a material does not modify the manager, so this is safe to call from
+  // multiple threads
+  return [&](const std::string& materialName) { return manager.material(materialName); };
 }
 
+mdl::Material* resolveNoMaterial(const std::string&)
+{
+  return nullptr;
+}
+
+} // namespace
+
 void MapDocument::setMaterials()
 {
-  m_world->accept(makeSetMaterialsVisitor(*m_materialManager));
+  traceZone("MapDocument::setMaterials");
+
+  auto nodes = MaterialBindingNodes{};
+  m_world->accept(makeCollectMaterialBindingNodesVisitor(nodes));
+  bindMaterials(nodes, makeResolveMaterial(*m_materialManager));
   materialUsageCountsDidChangeNotifier();
 }
 
 void MapDocument::setMaterials(const std::vector<mdl::Node*>& nodes)
 {
-  mdl::Node::visitAll(nodes, makeSetMaterialsVisitor(*m_materialManager));
+  auto bindingNodes = MaterialBindingNodes{};
+  mdl::Node::visitAll(nodes, makeCollectMaterialBindingNodesVisitor(bindingNodes));
+  bindMaterials(bindingNodes, makeResolveMaterial(*m_materialManager));
   materialUsageCountsDidChangeNotifier();
 }
 
@@ -4654,13 +4908,17 @@ void MapDocument::setMaterials(const std::vector<mdl::BrushFaceHandle>& faceHand
 
 void MapDocument::unsetMaterials()
 {
-  m_world->accept(makeUnsetMaterialsVisitor());
+  auto nodes = MaterialBindingNodes{};
+  m_world->accept(makeCollectMaterialBindingNodesVisitor(nodes));
+  bindMaterials(nodes, resolveNoMaterial);
   materialUsageCountsDidChangeNotifier();
 }
 
 void MapDocument::unsetMaterials(const std::vector<mdl::Node*>& nodes)
 {
-  mdl::Node::visitAll(nodes, makeUnsetMaterialsVisitor());
+  auto bindingNodes = MaterialBindingNodes{};
+  mdl::Node::visitAll(nodes, makeCollectMaterialBindingNodesVisitor(bindingNodes));
+  bindMaterials(bindingNodes, resolveNoMaterial);
   materialUsageCountsDidChangeNotifier();
 }
 
@@ -5085,6 +5343,15 @@ void MapDocument::clearModificationCount()
 
 void MapDocument::connectObservers()
 {
+  // these must be connected first so that pending notifications are delivered before
+  // any other observer learns about the upcoming change
+  m_notifierConnection +=
+    nodesWillBeRemovedNotifier.connect(this, &MapDocument::nodesWillBeRemoved);
+  m_notifierConnection +=
+    nodesWillChangeNotifier.connectUnbatched(this, &MapDocument::nodesWillChange);
+  m_notifierConnection +=
+    selectionWillChangeNotifier.connect(this, &MapDocument::selectionWillChange);
+
   m_notifierConnection += materialCollectionsWillChangeNotifier.connect(
     this, &MapDocument::materialCollectionsWillChange);
   m_notifierConnection += materialCollectionsDidChangeNotifier.connect(
@@ -5122,10 +5389,11 @@ void MapDocument::connectObservers()
     nodesWereAddedNotifier.connect(this, &MapDocument::initializeNodeTags);
   m_notifierConnection +=
     nodesWillBeRemovedNotifier.connect(this, &MapDocument::clearNodeTags);
+  // tags are updated immediately so that they are current once the batch is delivered
   m_notifierConnection +=
-    nodesDidChangeNotifier.connect(this, &MapDocument::updateNodeTags);
+    nodesDidChangeNotifier.connectUnbatched(this, &MapDocument::updateNodeTags);
   m_notifierConnection +=
-    brushFacesDidChangeNotifier.connect(this, &MapDocument::updateFaceTags);
+    brushFacesDidChangeNotifier.connectUnbatched(this, &MapDocument::updateFaceTags);
   m_notifierConnection +=
     modsDidChangeNotifier.connect(this, &MapDocument::updateAllFaceTags);
 }
@@ -5205,4 +5473,26 @@ void MapDocument::transactionUndone(const std::string& name)
   debug() << "Transaction '" << name << "' undone";
 }
 
+void MapDocument::nodesWillBeRemoved(const std::vector<mdl::Node*>&)
+{
+  // removed nodes may be deleted before the notification batch is closed
+  m_nodesDidChangeBatch.flush();
+  m_nodeVisibilityDidChangeBatch.flush();
+  m_nodeLockingDidChangeBatch.flush();
+  m_brushFacesDidChangeBatch.flush();
+}
+
+void MapDocument::nodesWillChange(const std::vector<mdl::Node*>&)
+{
+  // changing a brush can invalidate the indices of pending brush face handles
+  m_brushFacesDidChangeBatch.flush();
+}
+
+void MapDocument::selectionWillChange()
+{
+  // observers of the selection expect the changed nodes to be announced while they are
+  // still selected
+  m_nodesDidChangeBatch.flush();
+}
+
 } // namespace tb::ui
@@ -213,6 +213,14 @@ public: // notification
   Notifier<> portalFileWasUnloadedNotifier;
 
 private:
+  NotifierBatch<mdl::Node*> m_nodesDidChangeBatch{
+    nodesDidChangeNotifier, nodesWillChangeNotifier};
+  NotifierBatch<mdl::Node*> m_nodeVisibilityDidChangeBatch{
+    nodeVisibilityDidChangeNotifier};
+  NotifierBatch<mdl::Node*> m_nodeLockingDidChangeBatch{nodeLockingDidChangeNotifier};
+  NotifierBatch<mdl::BrushFaceHandle> m_brushFacesDidChangeBatch{
+    brushFacesDidChangeNotifier};
+
   NotifierConnection m_notifierConnection;
 
 protected:
@@ -656,6 +664,26 @@ public: // transactions
   bool commitTransaction();
   void cancelTransaction();
 
+  /**
+   * Coalesces the node and brush face change notifications until the batch is closed
+   * again. While the batch is open, observers are notified once per notifier with all
+   * changed nodes or faces instead of once per change. Batches can be nested.
+   *
+   * Pending notifications are delivered early before nodes are removed, and pending
+   * brush face notifications are delivered early before nodes change, because either
+   * can invalidate the nodes or faces passed to the observers. Pending node change
+   * notifications are also delivered before the selection changes.
+   *
+   * A node that changes again while its change notification is pending is not announced
+   * again by nodesWillChangeNotifier, so that observers receive exactly one will and one
+   * did notification for it.
+   */
+  void openNotificationBatch();
+  void closeNotificationBatch();
+
+  const NotifierBatchStats& nodesDidChangeBatchStats() const;
+  const NotifierBatchStats& brushFacesDidChangeBatchStats() const;
+
   virtual bool isCurrentDocumentStateObservable() const = 0;
 
 private:
@@ -724,6 +752,10 @@ private:
   void unloadAssets();
 
   void loadEntityDefinitions();
+  void setLoadedEntityDefinitions(
+    const mdl::EntityDefinitionFileSpec& spec,
+    const std::filesystem::path& path,
+    Result<std::vector<std::unique_ptr<mdl::EntityDefinition>>> definitions);
   void unloadEntityDefinitions();
 
   void loadEntityModels();
@@ -821,6 +853,9 @@ private: // observers
   void commandUndone(UndoableCommand& command);
   void transactionDone(const std::string& name);
   void transactionUndone(const std::string& name);
+  void nodesWillBeRemoved(const std::vector<mdl::Node*>& nodes);
+  void nodesWillChange(const std::vector<mdl::Node*>& nodes);
+  void selectionWillChange();
 };
 
 } // namespace tb::ui
@@ -42,7 +42,9 @@
 #include "Exceptions.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Trace.h"
 #include "TrenchBroomApp.h"
+#include "io/DiskIO.h"
 #include "io/ExportOptions.h"
 #include "io/PathQt.h"
 #include "mdl/BrushFace.h"
@@ -186,7 +188,9 @@ MapFrame::~MapFrame()
 
   // let's trigger a final autosave before releasing the document
   auto logger = NullLogger{};
+  m_autosaver->waitForPendingBackup(logger);
   m_autosaver->triggerAutosave(logger);
+  m_autosaver->waitForPendingBackup(logger);
 
   m_document->setViewEffectsService(nullptr);
   m_document.reset();
@@ -2252,6 +2256,21 @@ void MapFrame::debugShowPalette()
   showModelessDialog(window);
 }
 
+void MapFrame::debugSaveTrace()
+{
+  const auto fileName = QFileDialog::getSaveFileName(
+    this, tr("Save Trace"), "trace.json", "Chrome trace files (*.json)");
+  if (!fileName.isEmpty())
+  {
+    const auto path = io::pathFromQString(fileName);
+    io::Disk::withOutputStream(path, [](auto& stream) { writeChromeTrace(stream); })
+      | kdl::transform([&]() { logger().info() << "Saved trace to " << path; })
+      | kdl::transform_error([&](const auto& e) {
+          logger().error() << "Could not save trace: " << e.msg;
+        });
+  }
+}
+
 void MapFrame::focusChange(QWidget* /* oldFocus */, QWidget* newFocus)
 {
   if (auto* newMapView = dynamic_cast<MapViewBase*>(newFocus))
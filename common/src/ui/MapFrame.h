@@ -398,6 +398,7 @@ public:
   void debugThrowExceptionDuringCommand();
   void debugSetWindowSize();
   void debugShowPalette();
+  void debugSaveTrace();
 
   void focusChange(QWidget* oldFocus, QWidget* newFocus);
 
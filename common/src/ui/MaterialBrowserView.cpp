@@ -196,8 +196,13 @@ void MaterialBrowserView::addMaterialToLayout(
   const auto titleHeight = fontManager().font(font).measure(materialName).y();
 
   const auto scaleFactor = pref(Preferences::MaterialBrowserIconSize);
+  // the thumbnail has the aspect ratio of the texture, and the layout shrinks both to the
+  // same cell size
   const auto* texture = material.texture();
-  const auto textureSize = texture ? texture->sizef() : vm::vec2f{64, 64};
+  const auto* thumbnail = material.thumbnail();
+  const auto textureSize = texture     ? texture->sizef()
+                           : thumbnail ? thumbnail->sizef()
+                                       : vm::vec2f{64, 64};
   const auto scaledTextureSize = vm::round(scaleFactor * textureSize);
 
   layout.addItem(
@@ -402,13 +407,26 @@ void MaterialBrowserView::renderMaterials(
               Vertex{{bounds.right(), height - (bounds.top() - y)}, {1, 0}},
             });
 
-            material.activate(
-              pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
-
-            vertexArray.prepare(vboManager());
-            vertexArray.render(render::PrimType::Quads);
-
-            material.deactivate();
+            const auto minFilter = pref(Preferences::TextureMinFilter);
+            const auto magFilter = pref(Preferences::TextureMagFilter);
+
+            // prefer the full texture if it happens to be loaded because the material is
+            // in use
+            if (const auto* thumbnail = material.thumbnail();
+                thumbnail && !material.texture())
+            {
+              thumbnail->activate(minFilter, magFilter);
+              vertexArray.prepare(vboManager());
+              vertexArray.render(render::PrimType::Quads);
+              thumbnail->deactivate();
+            }
+            else
+            {
+              material.activate(minFilter, magFilter);
+              vertexArray.prepare(vboManager());
+              vertexArray.render(render::PrimType::Quads);
+              material.deactivate();
+            }
           }
         }
       }
@@ -442,6 +460,8 @@ QString MaterialBrowserView::tooltip(const Cell& cell)
   }
   else
   {
+    // the size of the thumbnail isn't the size of the texture
+    material.requestTexture();
     ss << "Loading...";
   }
   return tooltip;
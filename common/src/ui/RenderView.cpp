@@ -104,12 +104,13 @@ RenderView::RenderView(GLContextManager& contextManager, QWidget* parent)
     m_lastFPSCounterUpdate = currentTime;
 
     m_currentFPS = fmt::format(
-      R"(Avg FPS: {} Max time between frames: {}ms. {} currentVBOS({} peak) totalling {} KiB)",
+      R"(Avg FPS: {} Max time between frames: {}ms. {} currentVBOS({} peak) totalling {} KiB ({} KiB allocated))",
       avgFps,
       maxFrameTime,
       m_glContext->vboManager().currentVboCount(),
       m_glContext->vboManager().peakVboCount(),
-      m_glContext->vboManager().currentVboSize() / 1024u);
+      m_glContext->vboManager().currentVboSize() / 1024u,
+      m_glContext->vboManager().allocatedBytes() / 1024u);
   });
 
   fpsCounter->start(1000);
@@ -205,6 +206,7 @@ void RenderView::paintGL()
   }
 
   render();
+  vboManager().finishFrame();
 
   // Update stats
   m_framesRendered++;
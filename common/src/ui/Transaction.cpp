@@ -75,14 +75,10 @@ void Transaction::finish(const bool commit)
 bool Transaction::commit()
 {
   assert(m_state == State::Running);
-  if (m_document.commitTransaction())
-  {
-    m_state = State::Committed;
-    return true;
-  }
-
-  m_state = State::Cancelled;
-  return false;
+  const auto committed = m_document.commitTransaction();
+  m_state = committed ? State::Committed : State::Cancelled;
+  m_document.closeNotificationBatch();
+  return committed;
 }
 
 void Transaction::rollback()
@@ -96,10 +92,12 @@ void Transaction::cancel()
   assert(m_state == State::Running);
   m_document.cancelTransaction();
   m_state = State::Cancelled;
+  m_document.closeNotificationBatch();
 }
 
 void Transaction::begin()
 {
+  m_document.openNotificationBatch();
   m_document.startTransaction(m_name, TransactionScope::Oneshot);
 }
 
@@ -34,6 +34,7 @@
 #include <cassert>
 #include <map>
 #include <ranges>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace tb::ui
@@ -82,7 +83,7 @@ void UpdateLinkedGroupsHelper::undoLinkedGroupUpdates(MapDocumentCommandFacade&
 void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other)
 {
   // Both helpers have already applied their changes at this point, so in both helpers,
-  // m_linkedGroups contains pairs p where
+  // childrenToReplace contains pairs p where
   // - p.first is the group node to update
   // - p.second is a vector containing the group node's original children
   //
@@ -93,20 +94,51 @@ void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other)
   // p_o is not an update for a linked group node that was updated by this helper, then
   // we will add p_o to our updates and remove it from the other helper's updates to
   // prevent the replaced node to be deleted with the other helper.
+  //
+  // Likewise, contentsToSwap contains the original contents of the swapped nodes. If a
+  // node swapped by the other helper was also swapped by this helper, then we keep the
+  // original contents stored in this helper. If it is a descendant of a node whose
+  // children were replaced by this helper, then it will be discarded when this helper
+  // restores the original children, so its contents need not be restored.
+
+  auto& myLinkedGroupUpdates = std::get<mdl::LinkedGroupUpdates>(m_state);
+  auto& theirLinkedGroupUpdates = std::get<mdl::LinkedGroupUpdates>(other.m_state);
+
+  auto& myChildrenToReplace = myLinkedGroupUpdates.childrenToReplace;
+  auto& mySwappedNodes = myLinkedGroupUpdates.contentsToSwap;
+
+  const auto isReplacedByMe = [&](const auto* node) {
+    return std::ranges::any_of(myChildrenToReplace, [&](const auto& p) {
+      return p.first->isAncestorOf(node);
+    });
+  };
+
+  auto mySwappedNodeSet = std::unordered_set<const mdl::Node*>{};
+  for (const auto& [node, contents] : mySwappedNodes)
+  {
+    mySwappedNodeSet.insert(node);
+  }
 
-  auto& myLinkedGroupUpdates = std::get<LinkedGroupUpdates>(m_state);
-  auto& theirLinkedGroupUpdates = std::get<LinkedGroupUpdates>(other.m_state);
+  for (auto& [theirNode, theirOldContents] : theirLinkedGroupUpdates.contentsToSwap)
+  {
+    if (!mySwappedNodeSet.contains(theirNode) && !isReplacedByMe(theirNode))
+    {
+      mySwappedNodes.emplace_back(theirNode, std::move(theirOldContents));
+    }
+  }
+  theirLinkedGroupUpdates.contentsToSwap.clear();
 
-  for (auto& [theirGroupNodeToUpdate_, theirOldChildren] : theirLinkedGroupUpdates)
+  for (auto& [theirGroupNodeToUpdate_, theirOldChildren] :
+       theirLinkedGroupUpdates.childrenToReplace)
   {
     const auto myIt = std::ranges::find_if(
-      myLinkedGroupUpdates,
+      myChildrenToReplace,
       [theirGroupNodeToUpdate = theirGroupNodeToUpdate_](const auto& p) {
         return p.first == theirGroupNodeToUpdate;
       });
-    if (myIt == std::end(myLinkedGroupUpdates))
+    if (myIt == std::end(myChildrenToReplace))
     {
-      myLinkedGroupUpdates.emplace_back(
+      myChildrenToReplace.emplace_back(
         theirGroupNodeToUpdate_, std::move(theirOldChildren));
     }
   }
@@ -124,13 +156,14 @@ Result<void> UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(
                      std::forward<decltype(linkedGroupUpdates)>(linkedGroupUpdates);
                  });
       },
-      [](const LinkedGroupUpdates&) -> Result<void> { return kdl::void_success; }),
+      [](const mdl::LinkedGroupUpdates&) -> Result<void> {
+        return kdl::void_success;
+      }),
     m_state);
 }
 
-Result<UpdateLinkedGroupsHelper::LinkedGroupUpdates> UpdateLinkedGroupsHelper::
-  computeLinkedGroupUpdates(
-    const ChangedLinkedGroups& changedLinkedGroups, MapDocumentCommandFacade& document)
+Result<mdl::LinkedGroupUpdates> UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(
+  const ChangedLinkedGroups& changedLinkedGroups, MapDocumentCommandFacade& document)
 {
   if (!checkLinkedGroupsToUpdate(changedLinkedGroups))
   {
@@ -143,11 +176,38 @@ Result<UpdateLinkedGroupsHelper::LinkedGroupUpdates> UpdateLinkedGroupsHelper::
              mdl::collectGroupsWithLinkId({document.world()}, groupNode->linkId()),
              groupNode);
 
-           return mdl::updateLinkedGroups(*groupNode, groupNodesToUpdate, worldBounds);
+           return mdl::computeLinkedGroupUpdates(
+             *groupNode, groupNodesToUpdate, worldBounds);
          })
-         | kdl::fold
-         | kdl::and_then([&](auto nestedUpdateLists) -> Result<LinkedGroupUpdates> {
-             return kdl::vec_flatten(std::move(nestedUpdateLists));
+         | kdl::fold | kdl::transform([](auto updateLists) {
+             auto result = mdl::LinkedGroupUpdates{};
+
+             // A node can be swapped by more than one update if it belongs to nested
+             // linked groups. Since the groups are ordered so that descendants are
+             // updated before their ancestors, the last update wins. Swapping a node
+             // only once keeps the change undoable.
+             auto swappedNodeIndices = std::unordered_map<const mdl::Node*, size_t>{};
+             for (auto& updates : updateLists)
+             {
+               result.childrenToReplace = kdl::vec_concat(
+                 std::move(result.childrenToReplace),
+                 std::move(updates.childrenToReplace));
+
+               for (auto& [node, contents] : updates.contentsToSwap)
+               {
+                 const auto [it, inserted] =
+                   swappedNodeIndices.emplace(node, result.contentsToSwap.size());
+                 if (inserted)
+                 {
+                   result.contentsToSwap.emplace_back(node, std::move(contents));
+                 }
+                 else
+                 {
+                   result.contentsToSwap[it->second].second = std::move(contents);
+                 }
+               }
+             }
+             return result;
            });
 }
 
@@ -156,11 +216,25 @@ void UpdateLinkedGroupsHelper::doApplyOrUndoLinkedGroupUpdates(
 {
   std::visit(
     kdl::overload(
-      [](const ChangedLinkedGroups&) {},
-      [&](LinkedGroupUpdates&& linkedGroupUpdates) {
-        m_state = document.performReplaceChildren(std::move(linkedGroupUpdates));
+      [](ChangedLinkedGroups&) {},
+      [&](mdl::LinkedGroupUpdates& linkedGroupUpdates) {
+        // Swapped nodes may be removed by replacing the children of their ancestors, so
+        // the contents must be swapped while these nodes are still in the tree
+        if (!m_applied)
+        {
+          document.performSwapNodeContents(linkedGroupUpdates.contentsToSwap);
+          linkedGroupUpdates.childrenToReplace = document.performReplaceChildren(
+            std::move(linkedGroupUpdates.childrenToReplace));
+        }
+        else
+        {
+          linkedGroupUpdates.childrenToReplace = document.performReplaceChildren(
+            std::move(linkedGroupUpdates.childrenToReplace));
+          document.performSwapNodeContents(linkedGroupUpdates.contentsToSwap);
+        }
+        m_applied = !m_applied;
       }),
-    std::move(m_state));
+    m_state);
 }
 
 } // namespace tb::ui
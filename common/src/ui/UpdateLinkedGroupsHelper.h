@@ -20,16 +20,14 @@
 #pragma once
 
 #include "Result.h"
+#include "mdl/LinkedGroupUtils.h"
 
-#include <memory>
-#include <utility>
 #include <variant>
 #include <vector>
 
 namespace tb::mdl
 {
 class GroupNode;
-class Node;
 } // namespace tb::mdl
 
 namespace tb::ui
@@ -49,18 +47,18 @@ bool checkLinkedGroupsToUpdate(const std::vector<mdl::GroupNode*>& changedLinked
  *
  * The class is initialized with a vector of group nodes whose changes should be
  * propagated to the members of their respective link sets. When applyLinkedGroupUpdates
- * is first called, a replacement node is created for each linked group that needs to be
- * updated, and these linked groups are replaced with their replacements. Calling
- * applyLinkedGroupUpdates replaces the replacement nodes with their original
- * corresponding groups again, effectively undoing the change.
+ * is first called, the changes to the linked groups are computed. Only the contents of
+ * the nodes that actually differ from their transformed source nodes are swapped, and
+ * only those linked groups whose structure no longer matches their source group have
+ * their children replaced. Calling undoLinkedGroupUpdates swaps the original contents
+ * and children back in, effectively undoing the change.
  */
 class UpdateLinkedGroupsHelper
 {
 private:
   using ChangedLinkedGroups = std::vector<mdl::GroupNode*>;
-  using LinkedGroupUpdates =
-    std::vector<std::pair<mdl::Node*, std::vector<std::unique_ptr<mdl::Node>>>>;
-  std::variant<ChangedLinkedGroups, LinkedGroupUpdates> m_state;
+  std::variant<ChangedLinkedGroups, mdl::LinkedGroupUpdates> m_state;
+  bool m_applied = false;
 
 public:
   explicit UpdateLinkedGroupsHelper(ChangedLinkedGroups changedLinkedGroups);
@@ -72,7 +70,7 @@ public:
 
 private:
   Result<void> computeLinkedGroupUpdates(MapDocumentCommandFacade& document);
-  static Result<LinkedGroupUpdates> computeLinkedGroupUpdates(
+  static Result<mdl::LinkedGroupUpdates> computeLinkedGroupUpdates(
     const ChangedLinkedGroups& changedLinkedGroups, MapDocumentCommandFacade& document);
 
   void doApplyOrUndoLinkedGroupUpdates(MapDocumentCommandFacade& document);
@@ -17,7 +17,9 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "Logger.h"
 #include "io/DiskIO.h"
+#include "io/EntityDefinitionClassInfo.h"
 #include "io/FgdParser.h"
 #include "io/Reader.h"
 #include "io/TestParserStatus.h"
@@ -26,6 +28,8 @@
 #include "mdl/EntityDefinitionTestUtils.h"
 #include "mdl/PropertyDefinition.h"
 
+#include "kdl/vector_utils.h"
+
 #include <algorithm>
 #include <filesystem>
 #include <string>
@@ -1015,6 +1019,36 @@ TEST_CASE("FgdParserTest.parseRecursiveInclude")
   }));
 }
 
+TEST_CASE("FgdParserTest.parseIncludeTree")
+{
+  const auto basePath =
+    std::filesystem::current_path() / "fixture/test/io/Fgd/parseIncludeTree";
+  const auto path = basePath / "host.fgd";
+  auto file = Disk::openFile(path) | kdl::value();
+  auto reader = file->reader().buffer();
+
+  auto parser = FgdParser{reader.stringView(), Color{1.0f, 1.0f, 1.0f, 1.0f}, path};
+
+  auto status = TestParserStatus{};
+  const auto classInfos = parser.parseClassInfos(status);
+
+  // included files are merged in the order of their include directives, and a file
+  // that is included twice contributes its classes twice
+  CHECK(
+    kdl::vec_transform(classInfos, [](const auto& classInfo) { return classInfo.name; })
+    == std::vector<std::string>{
+      "worldspawn", "Common", "info_a", "Common", "info_b", "info_player_start"});
+  CHECK(
+    parser.includedPaths()
+    == std::vector<std::filesystem::path>{
+      basePath / "a/a.fgd",
+      basePath / "common.fgd",
+      basePath / "b/b.fgd",
+      basePath / "common.fgd",
+    });
+  CHECK(status.countStatus(LogLevel::Error) == 1u);
+}
+
 TEST_CASE("FgdParserTest.parseStringContinuations")
 {
   const auto file = R"(
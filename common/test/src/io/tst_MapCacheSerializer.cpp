@@ -0,0 +1,410 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/MapCacheSerializer.h"
+#include "io/NodeWriter.h"
+#include "io/Reader.h"
+#include "io/ReaderException.h"
+#include "io/TestParserStatus.h"
+#include "io/WorldReader.h"
+#include "mdl/BezierPatch.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/GroupNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/overload.h"
+
+#include "vm/bbox.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::io
+{
+namespace
+{
+
+const auto WorldBounds = vm::bbox3d{8192.0};
+
+std::string writeCache(const mdl::WorldNode& worldNode)
+{
+  auto stream = std::stringstream{};
+  auto writer = NodeWriter{
+    worldNode, std::make_unique<MapCacheSerializer>(stream, worldNode.mapFormat())};
+  writer.writeMap();
+  return stream.str();
+}
+
+std::unique_ptr<mdl::WorldNode> readCache(
+  const std::string& cache, const std::vector<mdl::MapFormat>& mapFormats)
+{
+  auto reader = Reader::from(cache.data(), cache.data() + cache.size());
+  auto status = TestParserStatus{};
+  auto worldNode = WorldReader::readCache(reader, mapFormats, WorldBounds, {}, status);
+  CHECK((worldNode == nullptr || reader.eof()));
+  return worldNode;
+}
+
+void checkFacesEqual(const mdl::BrushFace& actual, const mdl::BrushFace& expected)
+{
+  CHECK(actual == expected);
+  CHECK(actual.uAxis() == expected.uAxis());
+  CHECK(actual.vAxis() == expected.vAxis());
+  CHECK(actual.lineNumber() == expected.lineNumber());
+  CHECK(actual.lineCount() == expected.lineCount());
+}
+
+void checkNodesEqual(const mdl::Node& actual, const mdl::Node& expected)
+{
+  CAPTURE(expected.name());
+
+  CHECK(actual.lineNumber() == expected.lineNumber());
+  CHECK(actual.lineCount() == expected.lineCount());
+
+  expected.accept(kdl::overload(
+    [&](const mdl::WorldNode* expectedWorld) {
+      const auto* actualWorld = dynamic_cast<const mdl::WorldNode*>(&actual);
+      REQUIRE(actualWorld != nullptr);
+      CHECK(actualWorld->mapFormat() == expectedWorld->mapFormat());
+      CHECK(actualWorld->entity() == expectedWorld->entity());
+    },
+    [&](const mdl::LayerNode* expectedLayer) {
+      const auto* actualLayer = dynamic_cast<const mdl::LayerNode*>(&actual);
+      REQUIRE(actualLayer != nullptr);
+      CHECK(actualLayer->layer() == expectedLayer->layer());
+      CHECK(actualLayer->persistentId() == expectedLayer->persistentId());
+      CHECK(actualLayer->lockState() == expectedLayer->lockState());
+      CHECK(actualLayer->visibilityState() == expectedLayer->visibilityState());
+    },
+    [&](const mdl::GroupNode* expectedGroup) {
+      const auto* actualGroup = dynamic_cast<const mdl::GroupNode*>(&actual);
+      REQUIRE(actualGroup != nullptr);
+      CHECK(actualGroup->group() == expectedGroup->group());
+      CHECK(actualGroup->persistentId() == expectedGroup->persistentId());
+      CHECK(actualGroup->linkId() == expectedGroup->linkId());
+    },
+    [&](const mdl::EntityNode* expectedEntity) {
+      const auto* actualEntity = dynamic_cast<const mdl::EntityNode*>(&actual);
+      REQUIRE(actualEntity != nullptr);
+      CHECK(actualEntity->entity() == expectedEntity->entity());
+    },
+    [&](const mdl::BrushNode* expectedBrush) {
+      const auto* actualBrush = dynamic_cast<const mdl::BrushNode*>(&actual);
+      REQUIRE(actualBrush != nullptr);
+
+      const auto& actualFaces = actualBrush->brush().faces();
+      const auto& expectedFaces = expectedBrush->brush().faces();
+      REQUIRE(actualFaces.size() == expectedFaces.size());
+      for (size_t i = 0; i < expectedFaces.size(); ++i)
+      {
+        checkFacesEqual(actualFaces[i], expectedFaces[i]);
+      }
+      CHECK(
+        actualBrush->brush().vertexPositions()
+        == expectedBrush->brush().vertexPositions());
+    },
+    [&](const mdl::PatchNode* expectedPatch) {
+      const auto* actualPatch = dynamic_cast<const mdl::PatchNode*>(&actual);
+      REQUIRE(actualPatch != nullptr);
+      CHECK(actualPatch->patch() == expectedPatch->patch());
+    }));
+
+  REQUIRE(actual.childCount() == expected.childCount());
+  for (size_t i = 0; i < expected.childCount(); ++i)
+  {
+    checkNodesEqual(*actual.children()[i], *expected.children()[i]);
+  }
+}
+
+} // namespace
+
+TEST_CASE("MapCacheSerializer")
+{
+  using T = std::tuple<mdl::MapFormat, std::string>;
+
+  // clang-format off
+  const auto [mapFormat, data] = GENERATE(values<T>({
+  {mdl::MapFormat::Standard, R"(
+// entity 0
+{
+"classname" "worldspawn"
+"_tb_layer_color" "0.5 0.25 1"
+"message" "with \"quotes\" and a \\ backslash"
+// brush 0
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) none 0 0 0 1 1
+}
+}
+// entity 1
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "My Layer"
+"_tb_id" "1"
+"_tb_layer_sort_index" "0"
+"_tb_layer_locked" "1"
+}
+// entity 2
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "Group 1"
+"_tb_id" "2"
+"_tb_linked_group_id" "abcd"
+"_tb_transformation" "1 0 0 32 0 1 0 0 0 0 1 0 0 0 0 1"
+"_tb_layer" "1"
+// brush 0
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56.5 -32 12.25 0.5 1.5
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+}
+// entity 3
+{
+"classname" "func_door"
+"_tb_group" "2"
+"_tb_protected_properties" "origin;with\;semicolon"
+// brush 0
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+}
+// entity 4
+{
+"classname" "info_player_start"
+"origin" "1 2 3"
+}
+)"},
+  {mdl::MapFormat::Valve, R"(
+// entity 0
+{
+"classname" "worldspawn"
+"mapversion" "220"
+// brush 0
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) METAL4_5 [ 1 0 0 64 ] [ 0 -1 0 0 ] 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) METAL4_5 [ 0.6 0.8 0 64 ] [ 0 0 -1 0 ] 15 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 -1 0 0 ] 0 1 1
+}
+}
+)"},
+  {mdl::MapFormat::Quake2, R"(
+// entity 0
+{
+"classname" "worldspawn"
+// brush 0
+{
+( -712 1280 -448 ) ( -904 1280 -448 ) ( -904 992 -448 ) attribsExplicit 56 -32 0 1 1 8 9 700
+( -904 992 -416 ) ( -904 1280 -416 ) ( -712 1280 -416 ) attribsOmitted 32 32 0 1 1
+( -832 968 -416 ) ( -832 1256 -416 ) ( -832 1256 -448 ) attribsExplicitlyZero 16 96 0 1 1 0 0 0
+( -920 1088 -448 ) ( -920 1088 -416 ) ( -680 1088 -416 ) rtz/c_mf_v3c 56 96 0 1 1 0 0 0
+( -968 1152 -448 ) ( -920 1152 -448 ) ( -944 1152 -416 ) rtz/c_mf_v3c 56 96 0 1 1 0 0 0
+( -896 1056 -416 ) ( -896 1056 -448 ) ( -896 1344 -448 ) rtz/c_mf_v3c 16 96 0 1 1 0 0 0
+}
+}
+)"},
+  {mdl::MapFormat::Daikatana, R"(
+// entity 0
+{
+"classname" "worldspawn"
+// brush 0
+{
+( -712 1280 -448 ) ( -904 1280 -448 ) ( -904 992 -448 ) rtz/c_mf_v3cw 56 -32 0 1 1 0 0 0 5 6 7
+( -904 992 -416 ) ( -904 1280 -416 ) ( -712 1280 -416 ) rtz/b_rc_v16w 32 32 0 1 1 1 2 3 8 9 10
+( -832 968 -416 ) ( -832 1256 -416 ) ( -832 1256 -448 ) rtz/c_mf_v3cww 16 96 0 1 1
+( -920 1088 -448 ) ( -920 1088 -416 ) ( -680 1088 -416 ) rtz/c_mf_v3c 56 96 0 1 1 0 0 0
+( -968 1152 -448 ) ( -920 1152 -448 ) ( -944 1152 -416 ) rtz/c_mf_v3c 56 96 0 1 1 0 0 0
+( -896 1056 -416 ) ( -896 1056 -448 ) ( -896 1344 -448 ) rtz/c_mf_v3c 16 96 0 1 1 0 0 0
+}
+}
+)"},
+  {mdl::MapFormat::Quake3, R"(
+// entity 0
+{
+"classname" "worldspawn"
+// brush 0
+{
+patchDef2
+{
+common/caulk
+( 5 3 0 0 0 )
+(
+( (-64 -64 4 0   0 ) (-64 0 4 0   -0.25 ) (-64 64 4 0   -0.5 ) )
+( (  0 -64 4 0.2 0 ) (  0 0 4 0.2 -0.25 ) (  0 64 4 0.2 -0.5 ) )
+( ( 64 -64 4 0.4 0 ) ( 64 0 4 0.4 -0.25 ) ( 64 64 4 0.4 -0.5 ) )
+( (128 -64 4 0.6 0 ) (128 0 4 0.6 -0.25 ) (128 64 4 0.6 -0.5 ) )
+( (192 -64 4 0.8 0 ) (192 0 4 0.8 -0.25 ) (192 64 4 0.8 -0.5 ) )
+)
+}
+}
+// brush 1
+{
+( 64 64 64 ) ( 64 -64 64 ) ( -64 64 64 ) common/caulk 0 0 0 1 1 134217728 0 0
+( 64 64 64 ) ( -64 64 64 ) ( 64 64 -64 ) common/caulk 0 0 0 1 1 134217728 0 0
+( 64 64 64 ) ( 64 64 -64 ) ( 64 -64 64 ) common/caulk 0 0 0 1 1 134217728 0 0
+( -64 -64 -64 ) ( 64 -64 -64 ) ( -64 64 -64 ) common/caulk 0 0 0 1 1 134217728 0 0
+( -64 -64 -64 ) ( -64 -64 64 ) ( 64 -64 -64 ) common/caulk 0 0 0 1 1 134217728 0 0
+( -64 -64 -64 ) ( -64 64 -64 ) ( -64 -64 64 ) common/caulk 0 0 0 1 1 134217728 0 0
+}
+}
+)"},
+  }));
+  // clang-format on
+
+  CAPTURE(mapFormat);
+
+  auto status = TestParserStatus{};
+  auto worldReader = WorldReader{data, mapFormat, {}};
+  const auto expectedWorld = worldReader.read(WorldBounds, status);
+  REQUIRE(expectedWorld != nullptr);
+
+  const auto cache = writeCache(*expectedWorld);
+
+  SECTION("Reading the cache yields the same nodes as parsing the map file")
+  {
+    const auto actualWorld = readCache(cache, {mapFormat});
+    REQUIRE(actualWorld != nullptr);
+    checkNodesEqual(*actualWorld, *expectedWorld);
+  }
+
+  SECTION("Reading the cache fails if it was written for another map format")
+  {
+    const auto otherFormat = mapFormat == mdl::MapFormat::Standard
+                               ? mdl::MapFormat::Valve
+                               : mdl::MapFormat::Standard;
+    CHECK(readCache(cache, {otherFormat}) == nullptr);
+  }
+
+  SECTION("Reading a truncated cache throws")
+  {
+    const auto truncatedCache = cache.substr(0, cache.size() - 1);
+    CHECK_THROWS_AS(readCache(truncatedCache, {mapFormat}), ReaderException);
+  }
+
+  SECTION("Reading a cache with a corrupt element count throws")
+  {
+    // the property count of the first entity precedes the first property key, and the
+    // corrupt count overflows when it is multiplied with the minimum property size
+    const auto key = std::string{"classname"};
+    auto keyPrefix = std::string(sizeof(uint64_t), '\0');
+    const auto keySize = uint64_t(key.size());
+    std::memcpy(keyPrefix.data(), &keySize, sizeof(keySize));
+
+    const auto keyOffset = cache.find(keyPrefix + key);
+    REQUIRE(keyOffset != std::string::npos);
+    REQUIRE(keyOffset >= sizeof(uint64_t));
+
+    auto corruptCache = cache;
+    const auto corruptCount = (uint64_t(1) << 60) + 1;
+    std::memcpy(
+      corruptCache.data() + keyOffset - sizeof(uint64_t),
+      &corruptCount,
+      sizeof(corruptCount));
+
+    CHECK_THROWS_AS(readCache(corruptCache, {mapFormat}), ReaderException);
+  }
+}
+
+TEST_CASE("MapCacheSerializer.corruptPatch")
+{
+  const auto data = R"(
+{
+"classname" "worldspawn"
+{
+patchDef2
+{
+common/caulk
+( 5 3 0 0 0 )
+(
+( (-64 -64 4 0   0 ) (-64 0 4 0   -0.25 ) (-64 64 4 0   -0.5 ) )
+( (  0 -64 4 0.2 0 ) (  0 0 4 0.2 -0.25 ) (  0 64 4 0.2 -0.5 ) )
+( ( 64 -64 4 0.4 0 ) ( 64 0 4 0.4 -0.25 ) ( 64 64 4 0.4 -0.5 ) )
+( (128 -64 4 0.6 0 ) (128 0 4 0.6 -0.25 ) (128 64 4 0.6 -0.5 ) )
+( (192 -64 4 0.8 0 ) (192 0 4 0.8 -0.25 ) (192 64 4 0.8 -0.5 ) )
+)
+}
+}
+}
+)";
+
+  auto status = TestParserStatus{};
+  auto worldReader = WorldReader{data, mdl::MapFormat::Quake3, {}};
+  const auto world = worldReader.read(WorldBounds, status);
+  REQUIRE(world != nullptr);
+
+  const auto cache = writeCache(*world);
+  REQUIRE(readCache(cache, {mdl::MapFormat::Quake3}) != nullptr);
+
+  // the row count, the column count and the control point count follow each other
+  const auto dimensions = std::array<uint64_t, 3>{5, 3, 15};
+  const auto dimensionsOffset =
+    cache.find(std::string{reinterpret_cast<const char*>(dimensions.data()), 24});
+  REQUIRE(dimensionsOffset != std::string::npos);
+
+  const auto corruptDimensions = [&](const uint64_t rowCount, const uint64_t colCount) {
+    auto corruptCache = cache;
+    const auto corrupt = std::array<uint64_t, 2>{rowCount, colCount};
+    std::memcpy(corruptCache.data() + dimensionsOffset, corrupt.data(), 16);
+    return corruptCache;
+  };
+
+  SECTION("Reading a patch whose dimensions overflow throws")
+  {
+    // (2^63 + 5) * (2^63 + 3) wraps around to the control point count of 15
+    const auto corruptCache = corruptDimensions((1ull << 63) + 5, (1ull << 63) + 3);
+    CHECK_THROWS_AS(readCache(corruptCache, {mdl::MapFormat::Quake3}), ReaderException);
+  }
+
+  SECTION("Reading a patch with invalid dimensions throws")
+  {
+    const auto corruptCache = corruptDimensions(1, 15);
+    CHECK_THROWS_AS(readCache(corruptCache, {mdl::MapFormat::Quake3}), ReaderException);
+  }
+}
+
+} // namespace tb::io
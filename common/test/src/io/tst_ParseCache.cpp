@@ -0,0 +1,449 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Color.h"
+#include "io/EntityDefinitionClassInfo.h"
+#include "io/FgdParser.h"
+#include "io/ParseCache.h"
+#include "io/Quake3ShaderParser.h"
+#include "io/TestEnvironment.h"
+#include "io/TestParserStatus.h"
+#include "io/WorldReader.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
+#include "mdl/LayerNode.h"
+#include "mdl/PropertyDefinition.h"
+#include "mdl/Quake3Shader.h"
+#include "mdl/Texture.h"
+#include "mdl/TextureBuffer.h"
+#include "mdl/WorldNode.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::io
+{
+namespace
+{
+
+const auto HostFgd = R"FGD(
+@baseclass = Targetname [ targetname(target_source) : "Name" ]
+@baseclass = Appearflags [
+  spawnflags(Flags) =
+  [
+    256 : "Not on Easy" : 0
+    512 : "Not on Normal" : 1
+  ]
+]
+
+@include "include.fgd"
+
+@PointClass base(Targetname, Appearflags) size(-16 -16 -24, 16 16 32) color(0 255 0)
+  model({ "path": ":progs/player.mdl", "skin": skin, "frame": frame == 1 ? 2 : 3 })
+  = info_player_start : "Player 1 start"
+[
+  skin(integer) : "Skin" : 1
+  health(float) : "Health" : "12.5"
+  worldtype(choices) : "Ambience" : 0 =
+  [
+    0 : "Medieval"
+    1 : "Metal (runic)"
+  ]
+  secret(boolean) : "Secret" : 1
+]
+)FGD";
+
+const auto IncludeFgd = R"(
+@SolidClass = worldspawn : "World entity"
+[
+  message(string) : "Text on entering the world"
+  target(target_destination) : "Target"
+]
+)";
+
+const auto Shaders = R"(
+textures/liquids/lavahell2
+{
+  qer_editorimage textures/eerie/lavahell.tga
+  surfaceparm nolightmap
+  cull none
+  {
+    map $lightmap
+    blendFunc GL_DST_COLOR GL_ZERO
+  }
+}
+
+textures/test/test2
+{
+  qer_editorimage textures/test/test2.tga
+}
+)";
+
+const auto Map = R"(
+{
+"classname" "worldspawn"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) none 0 0 0 1 1
+}
+}
+)";
+
+struct ParseResult
+{
+  std::vector<EntityDefinitionClassInfo> classInfos;
+  std::vector<std::filesystem::path> paths;
+};
+
+ParseResult parseFgd(const std::filesystem::path& path, const std::string& contents)
+{
+  auto parser = FgdParser{contents, Color{1.0f, 1.0f, 1.0f, 1.0f}, path};
+  auto status = TestParserStatus{};
+  auto classInfos = parser.parseClassInfos(status);
+
+  auto paths = std::vector<std::filesystem::path>{path};
+  paths.insert(paths.end(), parser.includedPaths().begin(), parser.includedPaths().end());
+  return {std::move(classInfos), std::move(paths)};
+}
+
+void checkClassInfosEqual(
+  const std::vector<EntityDefinitionClassInfo>& actual,
+  const std::vector<EntityDefinitionClassInfo>& expected)
+{
+  REQUIRE(actual.size() == expected.size());
+  for (size_t i = 0; i < actual.size(); ++i)
+  {
+    const auto& lhs = actual[i];
+    const auto& rhs = expected[i];
+    CAPTURE(rhs.name);
+
+    CHECK(lhs.type == rhs.type);
+    CHECK(lhs.location == rhs.location);
+    CHECK(lhs.name == rhs.name);
+    CHECK(lhs.description == rhs.description);
+    CHECK(lhs.color == rhs.color);
+    CHECK(lhs.size == rhs.size);
+    CHECK(lhs.modelDefinition == rhs.modelDefinition);
+    CHECK(lhs.decalDefinition == rhs.decalDefinition);
+    CHECK(lhs.superClasses == rhs.superClasses);
+
+    REQUIRE(lhs.propertyDefinitions.size() == rhs.propertyDefinitions.size());
+    for (size_t j = 0; j < lhs.propertyDefinitions.size(); ++j)
+    {
+      CAPTURE(rhs.propertyDefinitions[j]->key());
+      CHECK(lhs.propertyDefinitions[j]->equals(rhs.propertyDefinitions[j].get()));
+      CHECK(
+        typeid(*lhs.propertyDefinitions[j]) == typeid(*rhs.propertyDefinitions[j]));
+    }
+  }
+}
+
+/**
+ * Overwrites the 64 bit value that follows the given marker in the only file in the
+ * given directory.
+ */
+void overwriteValueAfter(
+  const std::filesystem::path& directory, const uint64_t marker, const uint64_t value)
+{
+  auto paths = std::vector<std::filesystem::path>{};
+  for (const auto& entry : std::filesystem::recursive_directory_iterator{directory})
+  {
+    if (entry.is_regular_file())
+    {
+      paths.push_back(entry.path());
+    }
+  }
+  REQUIRE(paths.size() == 1u);
+
+  auto contents = std::string{};
+  {
+    auto stream = std::ifstream{paths.front(), std::ios::binary};
+    contents.assign(std::istreambuf_iterator<char>{stream}, {});
+  }
+
+  const auto markerBytes =
+    std::string{reinterpret_cast<const char*>(&marker), sizeof(marker)};
+  const auto markerPos = contents.find(markerBytes);
+  REQUIRE(markerPos != std::string::npos);
+
+  contents.replace(
+    markerPos + sizeof(marker),
+    sizeof(value),
+    reinterpret_cast<const char*>(&value),
+    sizeof(value));
+
+  auto stream = std::ofstream{paths.front(), std::ios::binary | std::ios::trunc};
+  stream << contents;
+}
+
+} // namespace
+
+TEST_CASE("ParseCache")
+{
+  auto env = TestEnvironment{[](auto& e) {
+    e.createFile("defs/host.fgd", HostFgd);
+    e.createFile("defs/include.fgd", IncludeFgd);
+  }};
+
+  auto cache = ParseCache{env.dir() / "cache"};
+
+  SECTION("readShaders")
+  {
+    auto parser = Quake3ShaderParser{Shaders};
+    auto status = TestParserStatus{};
+    const auto shaders = parser.parse(status);
+    REQUIRE(shaders.size() == 2u);
+
+    const auto fingerprint = makeFileFingerprint("scripts/test.shader", Shaders);
+
+    SECTION("Returns nothing if the cache is empty")
+    {
+      CHECK(cache.readShaders(fingerprint) == std::nullopt);
+    }
+
+    SECTION("Returns the cached shaders if the fingerprint matches")
+    {
+      cache.writeShaders(fingerprint, shaders);
+      CHECK(cache.readShaders(fingerprint) == shaders);
+    }
+
+    SECTION("Returns nothing if the file contents changed")
+    {
+      cache.writeShaders(fingerprint, shaders);
+
+      const auto changedContents = std::string{Shaders} + "\ntextures/test/test3 {}";
+      CHECK(
+        cache.readShaders(makeFileFingerprint("scripts/test.shader", changedContents))
+        == std::nullopt);
+    }
+
+    SECTION("Returns nothing after the cache was cleared")
+    {
+      cache.writeShaders(fingerprint, shaders);
+      cache.clear();
+      CHECK(cache.readShaders(fingerprint) == std::nullopt);
+    }
+
+    SECTION("Returns nothing if the shader count is corrupt")
+    {
+      cache.writeShaders(fingerprint, shaders);
+
+      // the shader count follows the content hash of the only fingerprint
+      overwriteValueAfter(
+        cache.directory(), fingerprint.contentHash, std::numeric_limits<uint64_t>::max());
+      CHECK(cache.readShaders(fingerprint) == std::nullopt);
+    }
+  }
+
+  SECTION("readThumbnail")
+  {
+    auto buffer = mdl::TextureBuffer{2 * 3 * 4};
+    for (size_t i = 0; i < buffer.size(); ++i)
+    {
+      buffer.data()[i] = static_cast<unsigned char>(i);
+    }
+
+    const auto thumbnail = mdl::Texture{
+      2,
+      3,
+      Color{0.1f, 0.2f, 0.3f, 1.0f},
+      GL_RGBA,
+      mdl::TextureMask::On,
+      mdl::NoEmbeddedDefaults{},
+      std::move(buffer)};
+
+    const auto fingerprint = makeFileFingerprint("textures/test.png", "image data");
+
+    SECTION("Returns nothing if the cache is empty")
+    {
+      CHECK(!cache.readThumbnail(fingerprint));
+    }
+
+    SECTION("Returns the cached thumbnail if the fingerprint matches")
+    {
+      cache.writeThumbnail(fingerprint, thumbnail);
+
+      const auto cachedThumbnail = cache.readThumbnail(fingerprint);
+      REQUIRE(cachedThumbnail.has_value());
+      CHECK(cachedThumbnail->width() == 2u);
+      CHECK(cachedThumbnail->height() == 3u);
+      CHECK(cachedThumbnail->averageColor() == thumbnail.averageColor());
+      CHECK(cachedThumbnail->format() == GLenum(GL_RGBA));
+      CHECK(cachedThumbnail->mask() == mdl::TextureMask::On);
+
+      const auto& expectedBuffer = thumbnail.buffersIfLoaded().front();
+      const auto& actualBuffer = cachedThumbnail->buffersIfLoaded().front();
+      REQUIRE(actualBuffer.size() == expectedBuffer.size());
+      CHECK(std::equal(
+        actualBuffer.data(),
+        actualBuffer.data() + actualBuffer.size(),
+        expectedBuffer.data()));
+    }
+
+    SECTION("Returns nothing if the file contents changed")
+    {
+      cache.writeThumbnail(fingerprint, thumbnail);
+      CHECK(!cache.readThumbnail(makeFileFingerprint("textures/test.png", "other data")));
+    }
+
+    SECTION("Returns nothing if the thumbnail dimensions overflow")
+    {
+      cache.writeThumbnail(fingerprint, thumbnail);
+
+      // the width follows the content hash of the only fingerprint; with this width, the
+      // buffer size wraps around to the actual size of 2 * 3 * 4 bytes
+      overwriteValueAfter(cache.directory(), fingerprint.contentHash, (1ull << 62) + 2);
+      CHECK(!cache.readThumbnail(fingerprint));
+    }
+
+    SECTION("Returns nothing if the thumbnail size exceeds the entry")
+    {
+      cache.writeThumbnail(fingerprint, thumbnail);
+
+      // the buffer size follows the last two components of the average color
+      const auto color = std::array<float, 2>{0.3f, 1.0f};
+      auto colorMarker = uint64_t(0);
+      std::memcpy(&colorMarker, color.data(), sizeof(colorMarker));
+
+      const auto width = uint64_t(1) << 40;
+      overwriteValueAfter(cache.directory(), fingerprint.contentHash, width);
+      overwriteValueAfter(cache.directory(), colorMarker, width * 3 * 4);
+      CHECK(!cache.readThumbnail(fingerprint));
+    }
+  }
+
+  SECTION("readMap")
+  {
+    const auto worldBounds = vm::bbox3d{8192.0};
+
+    auto status = TestParserStatus{};
+    auto worldReader = WorldReader{Map, mdl::MapFormat::Standard, {}};
+    const auto worldNode = worldReader.read(worldBounds, status);
+    REQUIRE(worldNode != nullptr);
+
+    const auto fingerprint = makeFileFingerprint("maps/test.map", Map);
+    const auto readMap = [&](const auto& f, const std::vector<mdl::MapFormat>& formats) {
+      return cache.readMap(f, formats, worldBounds, {}, status);
+    };
+
+    SECTION("Returns nothing if the cache is empty")
+    {
+      CHECK(readMap(fingerprint, {mdl::MapFormat::Standard}) == nullptr);
+    }
+
+    SECTION("Returns the cached world if the fingerprint matches")
+    {
+      cache.writeMap(fingerprint, *worldNode).wait();
+
+      const auto cachedWorldNode = readMap(fingerprint, {mdl::MapFormat::Standard});
+      REQUIRE(cachedWorldNode != nullptr);
+      CHECK(cachedWorldNode->mapFormat() == mdl::MapFormat::Standard);
+      CHECK(cachedWorldNode->entity() == worldNode->entity());
+
+      const auto& children = cachedWorldNode->defaultLayer()->children();
+      REQUIRE(children.size() == 1u);
+
+      const auto* brushNode = dynamic_cast<const mdl::BrushNode*>(children.front());
+      REQUIRE(brushNode != nullptr);
+      CHECK(
+        brushNode->brush()
+        == static_cast<const mdl::BrushNode*>(
+             worldNode->defaultLayer()->children().front())
+             ->brush());
+    }
+
+    SECTION("Returns nothing if the file contents changed")
+    {
+      cache.writeMap(fingerprint, *worldNode).wait();
+
+      const auto changedContents = std::string{Map} + "\n{}";
+      CHECK(
+        readMap(
+          makeFileFingerprint("maps/test.map", changedContents),
+          {mdl::MapFormat::Standard})
+        == nullptr);
+    }
+
+    SECTION("Returns nothing if the map was cached for another format")
+    {
+      cache.writeMap(fingerprint, *worldNode).wait();
+      CHECK(readMap(fingerprint, {mdl::MapFormat::Valve}) == nullptr);
+    }
+  }
+
+  SECTION("readClassInfos")
+  {
+    const auto hostPath = env.dir() / "defs/host.fgd";
+    const auto includePath = env.dir() / "defs/include.fgd";
+
+    const auto [classInfos, paths] = parseFgd(hostPath, HostFgd);
+    REQUIRE(classInfos.size() == 4u);
+    REQUIRE(paths == std::vector<std::filesystem::path>{hostPath, includePath});
+
+    SECTION("Returns nothing if the cache is empty")
+    {
+      CHECK(cache.readClassInfos(hostPath) == std::nullopt);
+    }
+
+    SECTION("Returns the cached class infos if no file changed")
+    {
+      cache.writeClassInfos(paths, classInfos);
+
+      const auto cachedClassInfos = cache.readClassInfos(hostPath);
+      REQUIRE(cachedClassInfos != std::nullopt);
+      checkClassInfosEqual(*cachedClassInfos, classInfos);
+    }
+
+    SECTION("Returns nothing if an included file changed")
+    {
+      cache.writeClassInfos(paths, classInfos);
+
+      // make sure that the modification time changes, too
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+      env.createFile("defs/include.fgd", std::string{IncludeFgd} + "\n// changed");
+
+      CHECK(cache.readClassInfos(hostPath) == std::nullopt);
+    }
+
+    SECTION("Returns nothing if an included file was removed")
+    {
+      cache.writeClassInfos(paths, classInfos);
+      std::filesystem::remove(includePath);
+
+      CHECK(cache.readClassInfos(hostPath) == std::nullopt);
+    }
+  }
+}
+
+} // namespace tb::io
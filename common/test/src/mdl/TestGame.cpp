@@ -63,6 +63,11 @@ const io::FileSystem& TestGame::gameFileSystem() const
   return *m_fs;
 }
 
+const io::ParseCache* TestGame::parseCache() const
+{
+  return nullptr;
+}
+
 std::filesystem::path TestGame::gamePath() const
 {
   return ".";
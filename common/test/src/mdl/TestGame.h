@@ -55,6 +55,7 @@ public:
 
   const GameConfig& config() const override;
   const io::FileSystem& gameFileSystem() const override;
+  const io::ParseCache* parseCache() const override;
 
   std::filesystem::path gamePath() const override;
   void setGamePath(const std::filesystem::path& gamePath, Logger& logger) override;
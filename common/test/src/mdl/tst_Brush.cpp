@@ -26,17 +26,22 @@
 #include "mdl/Texture.h"
 
 #include "kdl/range_to_vector.h"
+#include "kdl/range_utils.h"
 #include "kdl/result.h"
 #include "kdl/result_fold.h"
 #include "kdl/vector_utils.h"
 
 #include "vm/approx.h"
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
+#include "vm/mat_io.h" // IWYU pragma: keep
 #include "vm/polygon.h"
 #include "vm/segment.h"
 #include "vm/vec.h"
 #include "vm/vec_ext.h"
 
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "Catch2.h"
@@ -192,6 +197,17 @@ class UVLockTest
   MapFormat param = F;
 };
 
+BrushGeometry makeGeometry(const Brush& brush)
+{
+  const auto vertexPositions = brush.vertexPositions();
+  const auto faceVertexIndices = kdl::vec_transform(brush.faces(), [&](const auto& face) {
+    return kdl::vec_transform(face.vertexPositions(), [&](const auto& position) {
+      return kdl::index_of(vertexPositions, position).value();
+    });
+  });
+  return BrushGeometry{vertexPositions, faceVertexIndices};
+}
+
 } // namespace
 
 TEST_CASE("BrushTest.constructBrushWithFaces")
@@ -242,6 +258,115 @@ TEST_CASE("BrushTest.constructBrushWithRedundantFaces")
           .is_error());
 }
 
+TEST_CASE("BrushTest.constructBrushWithGeometry")
+{
+  const auto worldBounds = vm::bbox3d{4096.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  const auto bounds = vm::bbox3d{vm::vec3d{-16, -8, 0}, vm::vec3d{16, 8, 32}};
+  const auto brush = builder.createCuboid(bounds, "material") | kdl::value();
+
+  SECTION("Matching geometry is adopted")
+  {
+    const auto result = Brush::create(worldBounds, brush.faces(), makeGeometry(brush));
+    REQUIRE(result.is_success());
+
+    const auto& created = result.value();
+    CHECK(created == brush);
+    CHECK(created.bounds() == brush.bounds());
+    CHECK_THAT(
+      created.vertexPositions(), Catch::UnorderedEquals(brush.vertexPositions()));
+    for (const auto& face : created.faces())
+    {
+      CHECK(face.geometry() != nullptr);
+      CHECK(face.boundary() == face.geometry()->plane());
+    }
+  }
+
+  SECTION("Mismatched geometry is recomputed")
+  {
+    const auto other = builder.createCube(64.0, "material") | kdl::value();
+    const auto result = Brush::create(worldBounds, brush.faces(), makeGeometry(other));
+    REQUIRE(result.is_success());
+
+    const auto& created = result.value();
+    CHECK(created.bounds() == brush.bounds());
+    CHECK_THAT(
+      created.vertexPositions(), Catch::UnorderedEquals(brush.vertexPositions()));
+  }
+
+  SECTION("Empty geometry is recomputed")
+  {
+    const auto result = Brush::create(worldBounds, brush.faces(), BrushGeometry{});
+    REQUIRE(result.is_success());
+    CHECK(result.value().bounds() == brush.bounds());
+  }
+
+  SECTION("Geometry outside of world bounds is rejected")
+  {
+    const auto smallWorldBounds = vm::bbox3d{16.0};
+    CHECK(Brush::create(smallWorldBounds, brush.faces(), makeGeometry(brush)).is_error());
+  }
+}
+
+TEST_CASE("BrushTest.transform")
+{
+  const auto worldBounds = vm::bbox3d{4096.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  const auto bounds = vm::bbox3d{vm::vec3d{-16, -8, 0}, vm::vec3d{16, 8, 32}};
+  const auto brush = builder.createCuboid(bounds, "material") | kdl::value();
+
+  using T = std::tuple<vm::mat4x4d>;
+
+  // clang-format off
+  const auto
+  [transformation] = GENERATE(values<T>({
+  {vm::translation_matrix(vm::vec3d{16, -32, 8})},
+  {vm::rotation_matrix(vm::vec3d{0, 0, 1}, vm::to_radians(90.0))},
+  {vm::rotation_matrix(vm::normalize(vm::vec3d{1, 1, 0}), vm::to_radians(30.0))},
+  {vm::scaling_matrix(vm::vec3d{2, 0.5, 1})},
+  {vm::shear_matrix(0.5, 0.0, 0.0, 0.25, 0.0, 0.0)},
+  // scales the slanted faces of the rotated cuboid non-uniformly
+  {vm::scaling_matrix(vm::vec3d{2, 0.5, 1})
+   * vm::rotation_matrix(vm::normalize(vm::vec3d{1, 1, 0}), vm::to_radians(30.0))},
+  {vm::mirror_matrix<double>(vm::axis::x)},
+  }));
+  // clang-format on
+
+  CAPTURE(transformation);
+
+  auto transformed = brush;
+  REQUIRE(transformed.transform(worldBounds, transformation, false).is_success());
+
+  CHECK(transformed.faceCount() == brush.faceCount());
+  CHECK(transformed.vertexCount() == brush.vertexCount());
+  for (const auto& position : brush.vertexPositions())
+  {
+    CHECK(transformed.hasVertex(vm::correct(transformation * position), 0.001));
+  }
+
+  for (const auto& face : transformed.faces())
+  {
+    REQUIRE(face.geometry() != nullptr);
+    CHECK(face.boundary() == face.geometry()->plane());
+    for (const auto& position : face.vertexPositions())
+    {
+      CHECK(face.boundary().point_status(position) == vm::plane_status::inside);
+    }
+  }
+
+  // the transformed brush must match a brush that is computed from its faces
+  const auto rebuilt = Brush::create(worldBounds, transformed.faces()) | kdl::value();
+  REQUIRE(rebuilt.faceCount() == transformed.faceCount());
+  for (size_t i = 0; i < rebuilt.faceCount(); ++i)
+  {
+    CHECK(transformed.face(i) == rebuilt.face(i));
+    CHECK(vm::isEqual(
+      transformed.face(i).polygon(), rebuilt.face(i).polygon(), vm::Cd::almost_zero()));
+  }
+}
+
 TEST_CASE("BrushTest.clip")
 {
   const auto worldBounds = vm::bbox3d{4096.0};
@@ -2232,6 +2357,41 @@ TEST_CASE("BrushTest.subtractDisjoint")
     subtraction.vertexPositions(), Catch::UnorderedEquals(brush1.vertexPositions()));
 }
 
+TEST_CASE("BrushTest.subtractPartiallyDisjoint")
+{
+  const auto worldBounds = vm::bbox3d{4096.0};
+
+  const auto minuendBounds = vm::bbox3d{{-32, -32, -8}, {32, 32, 8}};
+  const auto splitBounds = vm::bbox3d{{-4, -64, -16}, {4, 64, 16}};
+  const auto carveBounds = vm::bbox3d{{16, 16, -16}, {24, 24, 16}};
+  const auto disjointBounds = vm::bbox3d{{124, 124, -4}, {132, 132, +4}};
+  CHECK_FALSE(minuendBounds.intersects(disjointBounds));
+
+  auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+  const auto minuend = builder.createCuboid(minuendBounds, "material") | kdl::value();
+  const auto split = builder.createCuboid(splitBounds, "split") | kdl::value();
+  const auto carve = builder.createCuboid(carveBounds, "carve") | kdl::value();
+  const auto disjoint = builder.createCuboid(disjointBounds, "disjoint") | kdl::value();
+
+  const auto expectedFragments =
+    minuend.subtract(MapFormat::Standard, worldBounds, "material", {&split, &carve})
+    | kdl::fold | kdl::value();
+  REQUIRE(expectedFragments.size() > 2u);
+
+  const auto fragments =
+    minuend.subtract(
+      MapFormat::Standard, worldBounds, "material", {&split, &disjoint, &carve})
+    | kdl::fold | kdl::value();
+  REQUIRE(fragments.size() == expectedFragments.size());
+
+  for (size_t i = 0; i < fragments.size(); ++i)
+  {
+    CHECK_THAT(
+      fragments[i].vertexPositions(),
+      Catch::UnorderedEquals(expectedFragments[i].vertexPositions()));
+  }
+}
+
 TEST_CASE("BrushTest.subtractEnclosed")
 {
   const auto worldBounds = vm::bbox3d{4096.0};
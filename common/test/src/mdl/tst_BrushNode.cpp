@@ -29,14 +29,19 @@
 #include "mdl/Hit.h"
 #include "mdl/HitAdapter.h"
 #include "mdl/MapFormat.h"
+#include "mdl/Material.h"
 #include "mdl/PatchNode.h"
 #include "mdl/PickResult.h"
+#include "mdl/Texture.h"
+#include "mdl/TextureResource.h"
 
 #include "kdl/result.h"
 
 #include "vm/approx.h"
+#include "vm/ray_io.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -300,6 +305,66 @@ TEST_CASE("BrushNodeTest.pick")
   CHECK(hits2.empty());
 }
 
+TEST_CASE("BrushNodeTest.pickMatchesFaceIntersection")
+{
+  const auto worldBounds = vm::bbox3d{4096.0};
+  const auto editorContext = EditorContext{};
+
+  auto builder = BrushBuilder{MapFormat::Quake3, worldBounds};
+  const auto bounds = vm::bbox3d{{-32, -32, -32}, {32, 32, 32}};
+
+  auto brush = GENERATE_COPY(
+    builder.createCube(64.0, "material") | kdl::value(),
+    builder.createCylinder(bounds, 7, RadiusMode::ToEdge, vm::axis::z, "material")
+      | kdl::value(),
+    builder.createIcoSphere(bounds, 1, "material") | kdl::value());
+
+  auto brushNode = BrushNode{brush};
+
+  // cast rays from the corners and edge midpoints of a larger box towards points on a
+  // grid, so that some rays hit edges and vertices exactly and some miss the brush
+  for (const auto& origin : {
+         vm::vec3d{-64, -64, -64},
+         vm::vec3d{64, -64, 48},
+         vm::vec3d{0, -64, 0},
+         vm::vec3d{-64, 0, 32},
+         vm::vec3d{0, 0, 0},
+       })
+  {
+    for (double x = -48.0; x <= 48.0; x += 8.0)
+    {
+      for (double y = -48.0; y <= 48.0; y += 8.0)
+      {
+        const auto ray = vm::ray3d{origin, vm::normalize(vm::vec3d{x, y, 32} - origin)};
+        CAPTURE(ray);
+
+        auto expectedDistance = std::optional<double>{};
+        auto expectedFaceIndex = size_t(0);
+        for (size_t i = 0u; i < brush.faceCount() && !expectedDistance; ++i)
+        {
+          expectedDistance = brush.face(i).intersectWithRay(ray);
+          expectedFaceIndex = i;
+        }
+
+        auto pickResult = PickResult{};
+        brushNode.pick(editorContext, ray, pickResult);
+
+        if (expectedDistance)
+        {
+          REQUIRE(pickResult.size() == 1u);
+          const auto& hit = pickResult.all().front();
+          CHECK(hit.distance() == *expectedDistance);
+          CHECK(hitToFaceHandle(hit)->faceIndex() == expectedFaceIndex);
+        }
+        else
+        {
+          CHECK(pickResult.empty());
+        }
+      }
+    }
+  }
+}
+
 TEST_CASE("BrushNodeTest.clone")
 {
   const vm::bbox3d worldBounds(4096.0);
@@ -350,4 +415,29 @@ TEST_CASE("BrushNodeTest.clone")
   }
 }
 
+TEST_CASE("BrushNodeTest.setFaceMaterials")
+{
+  const auto worldBounds = vm::bbox3d{4096.0};
+
+  auto material1 = Material{"material1", createTextureResource(Texture{64, 64})};
+  auto material2 = Material{"material2", createTextureResource(Texture{64, 64})};
+
+  auto brushNode = BrushNode{
+    BrushBuilder{MapFormat::Quake3, worldBounds}.createCube(64.0, "material1")
+    | kdl::value()};
+  REQUIRE(brushNode.brush().faceCount() == 6u);
+
+  brushNode.setFaceMaterials(
+    {&material1, &material1, &material1, &material2, &material2, nullptr});
+  CHECK(brushNode.brush().face(0).material() == &material1);
+  CHECK(brushNode.brush().face(3).material() == &material2);
+  CHECK(brushNode.brush().face(5).material() == nullptr);
+  CHECK(material1.usageCount() == 3u);
+  CHECK(material2.usageCount() == 2u);
+
+  brushNode.setFaceMaterials({nullptr, nullptr, nullptr, nullptr, nullptr, nullptr});
+  CHECK(material1.usageCount() == 0u);
+  CHECK(material2.usageCount() == 0u);
+}
+
 } // namespace tb::mdl
@@ -17,19 +17,25 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "Color.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "mdl/BezierPatch.h"
+#include "mdl/Brush.h"
 #include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
 #include "mdl/EditorContext.h"
 #include "mdl/Entity.h"
+#include "mdl/EntityDefinition.h"
 #include "mdl/EntityNode.h"
 #include "mdl/GroupNode.h"
+#include "mdl/Layer.h"
 #include "mdl/LayerNode.h"
 #include "mdl/LockState.h"
 #include "mdl/MapFormat.h"
 #include "mdl/PatchNode.h"
+#include "mdl/Tag.h"
 #include "mdl/VisibilityState.h"
 #include "mdl/WorldNode.h"
 
@@ -1203,4 +1209,197 @@ TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.testGroupedNodes")
   }
 }
 
+TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.cachedNodeStates")
+{
+  SECTION("Changing the hidden tags")
+  {
+    const auto tag = Tag{"tag", {}};
+    auto* brushNode = createTopLevelBrush();
+    auto* patchNode = createTopLevelPatch();
+
+    brushNode->addTag(tag);
+    patchNode->addTag(tag);
+
+    REQUIRE(context.visible(brushNode));
+    REQUIRE(context.visible(patchNode));
+
+    context.setHiddenTags(tag.type());
+    CHECK_FALSE(context.visible(brushNode));
+    CHECK_FALSE(context.visible(patchNode));
+    CHECK_FALSE(context.selectable(brushNode));
+    CHECK_FALSE(context.selectable(patchNode));
+
+    context.setHiddenTags(0);
+    CHECK(context.visible(brushNode));
+    CHECK(context.visible(patchNode));
+  }
+
+  SECTION("Changing the tags of a node")
+  {
+    const auto tag = Tag{"tag", {}};
+    auto* brushNode = createTopLevelBrush();
+    auto* patchNode = createTopLevelPatch();
+
+    context.setHiddenTags(tag.type());
+    REQUIRE(context.visible(brushNode));
+    REQUIRE(context.visible(patchNode));
+
+    brushNode->addTag(tag);
+    patchNode->addTag(tag);
+    CHECK_FALSE(context.visible(brushNode));
+    CHECK_FALSE(context.visible(patchNode));
+
+    brushNode->removeTag(tag);
+    patchNode->removeTag(tag);
+    CHECK(context.visible(brushNode));
+    CHECK(context.visible(patchNode));
+  }
+
+  SECTION("Changing the tags of brush faces")
+  {
+    const auto tag = Tag{"tag", {}};
+    auto* brushNode = createTopLevelBrush();
+
+    context.setHiddenTags(tag.type());
+    REQUIRE(context.visible(brushNode));
+
+    auto brush = brushNode->brush();
+    for (auto& face : brush.faces())
+    {
+      face.addTag(tag);
+    }
+    brushNode->setBrush(std::move(brush));
+    CHECK_FALSE(context.visible(brushNode));
+  }
+
+  SECTION("Changing the layer visibility and lock state")
+  {
+    auto* layerNode = worldNode.defaultLayer();
+    auto* brushNode = createTopLevelBrush();
+    auto* entityNode = createTopLevelPointEntity();
+
+    REQUIRE(context.visible(brushNode));
+    REQUIRE(context.visible(entityNode));
+    REQUIRE(context.selectable(brushNode));
+    REQUIRE(context.selectable(entityNode));
+
+    layerNode->setVisibilityState(VisibilityState::Hidden);
+    CHECK_FALSE(context.visible(brushNode));
+    CHECK_FALSE(context.visible(entityNode));
+
+    layerNode->setVisibilityState(VisibilityState::Inherited);
+    layerNode->setLockState(LockState::Locked);
+    CHECK(context.visible(brushNode));
+    CHECK(context.visible(entityNode));
+    CHECK_FALSE(context.selectable(brushNode));
+    CHECK_FALSE(context.selectable(entityNode));
+
+    layerNode->setLockState(LockState::Inherited);
+    CHECK(context.selectable(brushNode));
+    CHECK(context.selectable(entityNode));
+  }
+
+  SECTION("Changing the visibility and lock state of a node")
+  {
+    auto* brushNode = createTopLevelBrush();
+
+    REQUIRE(context.visible(brushNode));
+    REQUIRE(context.selectable(brushNode));
+
+    brushNode->setVisibilityState(VisibilityState::Hidden);
+    CHECK_FALSE(context.visible(brushNode));
+
+    brushNode->setVisibilityState(VisibilityState::Inherited);
+    brushNode->setLockedByOtherSelection(true);
+    CHECK(context.visible(brushNode));
+    CHECK_FALSE(context.selectable(brushNode));
+
+    brushNode->setLockedByOtherSelection(false);
+    CHECK(context.selectable(brushNode));
+  }
+
+  SECTION("Opening and closing groups")
+  {
+    auto [outerGroupNode, innerGroupNode, brushNode] = createdNestedGroupedBrush();
+
+    REQUIRE(context.selectable(outerGroupNode));
+    REQUIRE_FALSE(context.selectable(innerGroupNode));
+    REQUIRE_FALSE(context.selectable(brushNode));
+
+    context.pushGroup(outerGroupNode);
+    CHECK_FALSE(context.selectable(outerGroupNode));
+    CHECK(context.selectable(innerGroupNode));
+    CHECK_FALSE(context.selectable(brushNode));
+
+    context.pushGroup(innerGroupNode);
+    CHECK_FALSE(context.selectable(innerGroupNode));
+    CHECK(context.selectable(brushNode));
+
+    context.popGroup();
+    context.popGroup();
+    CHECK(context.selectable(outerGroupNode));
+    CHECK_FALSE(context.selectable(innerGroupNode));
+    CHECK_FALSE(context.selectable(brushNode));
+  }
+
+  SECTION("Changing the parent of a node")
+  {
+    auto* hiddenLayerNode = new LayerNode{Layer{"hidden"}};
+    hiddenLayerNode->setVisibilityState(VisibilityState::Hidden);
+    worldNode.addChild(hiddenLayerNode);
+
+    auto* brushNode = createTopLevelBrush();
+    REQUIRE(context.visible(brushNode));
+
+    worldNode.defaultLayer()->removeChild(brushNode);
+    hiddenLayerNode->addChild(brushNode);
+    CHECK_FALSE(context.visible(brushNode));
+  }
+
+  SECTION("Hiding entity definitions")
+  {
+    auto definition =
+      PointEntityDefinition{"some_name", Color{}, vm::bbox3d{32.0}, "", {}, {}, {}};
+
+    auto* entityNode = createTopLevelPointEntity();
+    auto [brushEntityNode, brushNode] = createTopLevelBrushEntity();
+
+    context.setEntityDefinitionHidden(&definition, true);
+    REQUIRE(context.visible(entityNode));
+    REQUIRE(context.visible(brushNode));
+
+    entityNode->setDefinition(&definition);
+    brushEntityNode->setDefinition(&definition);
+    CHECK_FALSE(context.visible(entityNode));
+    CHECK_FALSE(context.visible(brushNode));
+    CHECK_FALSE(context.visible(brushEntityNode));
+
+    context.setEntityDefinitionHidden(&definition, false);
+    CHECK(context.visible(entityNode));
+    CHECK(context.visible(brushNode));
+    CHECK(context.visible(brushEntityNode));
+
+    context.setEntityDefinitionHidden(&definition, true);
+    CHECK_FALSE(context.visible(entityNode));
+
+    entityNode->setDefinition(nullptr);
+    brushEntityNode->setDefinition(nullptr);
+    CHECK(context.visible(entityNode));
+    CHECK(context.visible(brushNode));
+  }
+
+  SECTION("Resetting the context")
+  {
+    const auto tag = Tag{"tag", {}};
+    auto* brushNode = createTopLevelBrush();
+    brushNode->addTag(tag);
+
+    context.setHiddenTags(tag.type());
+    REQUIRE_FALSE(context.visible(brushNode));
+
+    context.reset();
+    CHECK(context.visible(brushNode));
+  }
+}
+
 } // namespace tb::mdl
@@ -34,6 +34,7 @@
 #include "vm/intersection.h"
 
 #include <filesystem>
+#include <tuple>
 
 #include "Catch2.h"
 
@@ -145,4 +146,52 @@ TEST_CASE("EntityModelTest.buildRenderer.defaultSkinIndex")
   CHECK(renderer1 != nullptr);
   CHECK(renderer2 != nullptr);
 }
+
+TEST_CASE("EntityModelTest.addMesh.loader")
+{
+  auto modelData = EntityModelData{PitchType::Normal, Orientation::Oriented};
+  auto& frame = modelData.addFrame("test", vm::bbox3f{-8, 8});
+
+  auto& surface = modelData.addSurface("surface", 1);
+  auto materials = std::vector<Material>{};
+  materials.push_back(makeDummyMaterial("skin"));
+  surface.setSkins(std::move(materials));
+
+  auto loaderCalls = 0;
+  surface.addMesh(frame, [&]() {
+    ++loaderCalls;
+
+    auto size = render::IndexRangeMap::Size{};
+    size.inc(render::PrimType::Triangles, 1);
+
+    auto builder = render::IndexRangeMapBuilder<EntityModelVertex::Type>{3, size};
+    builder.addTriangle(
+      EntityModelVertex{{-8, -8, 0}, {0, 0}},
+      EntityModelVertex{{8, -8, 0}, {1, 0}},
+      EntityModelVertex{{0, 8, 0}, {0, 1}});
+    return std::tuple{std::move(builder.vertices()), std::move(builder.indices())};
+  });
+
+  CHECK(loaderCalls == 0);
+
+  SECTION("The mesh is loaded when the frame is hit tested")
+  {
+    const auto ray = vm::ray3f{vm::vec3f{0, 0, 16}, vm::vec3f{0, 0, -1}};
+    CHECK(frame.intersect(ray) == vm::optional_approx(std::optional{16.0f}));
+    CHECK(loaderCalls == 1);
+
+    const auto missRay = vm::ray3f{vm::vec3f{0, 16, 16}, vm::vec3f{0, 0, -1}};
+    CHECK(frame.intersect(missRay) == std::nullopt);
+    CHECK(loaderCalls == 1);
+
+    CHECK(modelData.buildRenderer(0, 0) != nullptr);
+    CHECK(loaderCalls == 1);
+  }
+
+  SECTION("The mesh is loaded when the frame is rendered")
+  {
+    CHECK(modelData.buildRenderer(0, 0) != nullptr);
+    CHECK(loaderCalls == 1);
+  }
+}
 } // namespace tb::mdl
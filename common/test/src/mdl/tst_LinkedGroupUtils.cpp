@@ -160,6 +160,78 @@ TEST_CASE("GroupNode.updateLinkedGroups")
   }
 }
 
+TEST_CASE("GroupNode.computeLinkedGroupUpdates")
+{
+  const auto worldBounds = vm::bbox3d{8192.0};
+
+  auto groupNode = GroupNode{Group{"name"}};
+  auto* entityNode = new EntityNode{Entity{}};
+  groupNode.addChild(entityNode);
+
+  auto groupNodeClone = std::unique_ptr<GroupNode>{
+    static_cast<GroupNode*>(groupNode.cloneRecursively(worldBounds))};
+  auto* entityNodeClone = static_cast<EntityNode*>(groupNodeClone->children().front());
+
+  transformNode(
+    *groupNodeClone, vm::translation_matrix(vm::vec3d{0, 2, 0}), worldBounds);
+  REQUIRE(entityNodeClone->entity().origin() == vm::vec3d{0, 2, 0});
+
+  SECTION("Unchanged nodes are not updated")
+  {
+    computeLinkedGroupUpdates(groupNode, {groupNodeClone.get()}, worldBounds)
+      | kdl::transform([&](const LinkedGroupUpdates& u) {
+          CHECK(u.childrenToReplace.empty());
+          CHECK(u.contentsToSwap.empty());
+        })
+      | kdl::transform_error([](const auto&) { FAIL(); });
+  }
+
+  SECTION("Changed nodes have their contents swapped")
+  {
+    transformNode(*entityNode, vm::translation_matrix(vm::vec3d{0, 0, 3}), worldBounds);
+    REQUIRE(entityNode->entity().origin() == vm::vec3d{0, 0, 3});
+
+    computeLinkedGroupUpdates(groupNode, {groupNodeClone.get()}, worldBounds)
+      | kdl::transform([&](const LinkedGroupUpdates& u) {
+          CHECK(u.childrenToReplace.empty());
+          REQUIRE(u.contentsToSwap.size() == 1u);
+
+          const auto& [nodeToSwap, contents] = u.contentsToSwap.front();
+          CHECK(nodeToSwap == entityNodeClone);
+          CHECK(std::get<Entity>(contents.get()).origin() == vm::vec3d{0, 2, 3});
+        })
+      | kdl::transform_error([](const auto&) { FAIL(); });
+  }
+
+  SECTION("Groups with a different structure have their children replaced")
+  {
+    groupNode.addChild(new EntityNode{Entity{}});
+
+    computeLinkedGroupUpdates(groupNode, {groupNodeClone.get()}, worldBounds)
+      | kdl::transform([&](const LinkedGroupUpdates& u) {
+          CHECK(u.contentsToSwap.empty());
+          REQUIRE(u.childrenToReplace.size() == 1u);
+
+          const auto& [groupNodeToUpdate, newChildren] = u.childrenToReplace.front();
+          CHECK(groupNodeToUpdate == groupNodeClone.get());
+          CHECK(newChildren.size() == 2u);
+        })
+      | kdl::transform_error([](const auto&) { FAIL(); });
+  }
+
+  SECTION("Changed nodes must remain within world bounds")
+  {
+    transformNode(
+      *groupNodeClone, vm::translation_matrix(vm::vec3d{8192 - 8, 0, 0}), worldBounds);
+    transformNode(*entityNode, vm::translation_matrix(vm::vec3d{1, 0, 0}), worldBounds);
+
+    computeLinkedGroupUpdates(groupNode, {groupNodeClone.get()}, worldBounds)
+      | kdl::transform([](auto) { FAIL(); }) | kdl::transform_error([](auto e) {
+          CHECK(e == Error{"Updating a linked node would exceed world bounds"});
+        });
+  }
+}
+
 TEST_CASE("GroupNode.updateNestedLinkedGroups")
 {
   const auto worldBounds = vm::bbox3d{8192.0};
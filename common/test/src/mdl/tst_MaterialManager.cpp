@@ -0,0 +1,103 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Logger.h"
+#include "mdl/AssetReference.h"
+#include "mdl/Material.h"
+#include "mdl/MaterialCollection.h"
+#include "mdl/MaterialManager.h"
+#include "mdl/Texture.h"
+#include "mdl/TextureResource.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::mdl
+{
+namespace
+{
+
+Material makeMaterial(std::string name)
+{
+  auto textureResource = std::make_shared<TextureResource>(
+    []() -> Result<Texture> { return Texture{1, 1}; });
+  textureResource->deferLoading();
+  return Material{std::move(name), std::move(textureResource)};
+}
+
+std::vector<MaterialCollection> makeCollections(std::vector<Material> materials)
+{
+  auto result = std::vector<MaterialCollection>{};
+  result.emplace_back(std::move(materials));
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("MaterialManager.requestUsedTextures")
+{
+  auto logger = NullLogger{};
+  auto materialManager = MaterialManager{logger};
+
+  auto materials = std::vector<Material>{};
+  materials.push_back(makeMaterial("used"));
+  materials.push_back(makeMaterial("unused"));
+  materialManager.setMaterialCollections(makeCollections(std::move(materials)));
+
+  auto* usedMaterial = materialManager.material("used");
+  const auto* unusedMaterial = materialManager.material("unused");
+  REQUIRE(usedMaterial != nullptr);
+  REQUIRE(unusedMaterial != nullptr);
+
+  materialManager.requestUsedTextures();
+  CHECK(usedMaterial->textureResource().isDeferred());
+  CHECK(unusedMaterial->textureResource().isDeferred());
+
+  SECTION("Requests the textures of materials that came into use")
+  {
+    const auto reference1 = AssetReference{usedMaterial};
+    const auto reference2 = AssetReference{usedMaterial};
+
+    materialManager.requestUsedTextures();
+    CHECK(!usedMaterial->textureResource().isDeferred());
+    CHECK(unusedMaterial->textureResource().isDeferred());
+  }
+
+  SECTION("Requests the textures of materials that were in use before they were added")
+  {
+    auto inUseMaterials = std::vector<Material>{};
+    inUseMaterials.push_back(makeMaterial("in_use"));
+    const auto reference = AssetReference{&inUseMaterials.front()};
+
+    materialManager.clear();
+    materialManager.setMaterialCollections(makeCollections(std::move(inUseMaterials)));
+
+    const auto* inUseMaterial = materialManager.material("in_use");
+    REQUIRE(inUseMaterial != nullptr);
+    CHECK(inUseMaterial->textureResource().isDeferred());
+
+    materialManager.requestUsedTextures();
+    CHECK(!inUseMaterial->textureResource().isDeferred());
+  }
+}
+
+} // namespace tb::mdl
@@ -255,6 +255,55 @@ TEST_CASE("ModelUtils.collectTouchingNodes")
       std::vector<Node*>{&groupNode, &entityNode, &brushNode, &patchNode}));
 }
 
+TEST_CASE("ModelUtils.collectTouchingNodes.world")
+{
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  auto builder = BrushBuilder{mapFormat, worldBounds};
+
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+  auto* layerNode = worldNode.defaultLayer();
+
+  auto* brushNode = new BrushNode{builder.createCube(64.0, "material") | kdl::value()};
+  auto* farBrushNode = new BrushNode{
+    builder.createCuboid(vm::bbox3d{{512, 512, 512}, {576, 576, 576}}, "material")
+    | kdl::value()};
+  auto* queryBrushNode =
+    new BrushNode{builder.createCube(24.0, "material") | kdl::value()};
+
+  // the group's bounds touch the query brush, but none of its children do
+  auto* groupNode = new GroupNode{Group{"group"}};
+  groupNode->addChild(new BrushNode{
+    builder.createCuboid(vm::bbox3d{{-64, -64, -64}, {-32, -32, -32}}, "material")
+    | kdl::value()});
+  groupNode->addChild(new BrushNode{
+    builder.createCuboid(vm::bbox3d{{32, 32, 32}, {64, 64, 64}}, "material")
+    | kdl::value()});
+
+  layerNode->addChild(brushNode);
+  layerNode->addChild(farBrushNode);
+  layerNode->addChild(queryBrushNode);
+  layerNode->addChild(groupNode);
+
+  REQUIRE(queryBrushNode->intersects(groupNode));
+  REQUIRE_FALSE(queryBrushNode->intersects(groupNode->children().front()));
+  REQUIRE_FALSE(queryBrushNode->intersects(groupNode->children().back()));
+
+  CHECK_THAT(
+    collectTouchingNodes({&worldNode}, {queryBrushNode}),
+    Catch::Matchers::Equals(std::vector<Node*>{brushNode, groupNode}));
+
+  CHECK_THAT(
+    collectTouchingNodes({layerNode}, {queryBrushNode, brushNode}),
+    Catch::Matchers::Equals(std::vector<Node*>{groupNode}));
+
+  groupNode->open();
+  CHECK_THAT(
+    collectTouchingNodes({&worldNode}, {queryBrushNode}),
+    Catch::Matchers::Equals(std::vector<Node*>{brushNode}));
+}
+
 TEST_CASE("ModelUtils.collectContainedNodes")
 {
   constexpr auto worldBounds = vm::bbox3d{8192.0};
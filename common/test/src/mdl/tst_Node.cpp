@@ -39,6 +39,10 @@
 #include "kdl/result.h"
 #include "kdl/vector_utils.h"
 
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <thread>
 #include <variant>
 #include <vector>
 
@@ -276,6 +280,120 @@ TEST_CASE("NodeTest.destroyChild")
   CHECK(childDestroyed);
 }
 
+TEST_CASE("NodeTest.nodeId")
+{
+  auto node1 = std::make_unique<TestNode>();
+  auto node2 = std::make_unique<TestNode>();
+  CHECK(node1->nodeId() != node2->nodeId());
+
+  SECTION("Ids of destroyed nodes are reused")
+  {
+    const auto id = node1->nodeId();
+    node1.reset();
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+      // the id of the destroyed node or a lower free id is reused
+      auto node = std::make_unique<TestNode>();
+      CHECK(node->nodeId() <= id);
+      CHECK(node->nodeId() != node2->nodeId());
+    }
+  }
+
+  SECTION("Nodes created on different threads have distinct ids")
+  {
+    auto nodes = std::vector<std::vector<std::unique_ptr<TestNode>>>(4);
+    auto threads = std::vector<std::thread>{};
+    for (auto& threadNodes : nodes)
+    {
+      threads.emplace_back([&]() {
+        for (size_t i = 0; i < 1000; ++i)
+        {
+          threadNodes.push_back(std::make_unique<TestNode>());
+        }
+      });
+    }
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    auto ids = std::set<IdType>{node1->nodeId(), node2->nodeId()};
+    for (const auto& threadNodes : nodes)
+    {
+      for (const auto& node : threadNodes)
+      {
+        ids.insert(node->nodeId());
+      }
+    }
+    CHECK(ids.size() == 4002u);
+  }
+}
+
+TEST_CASE("NodeTest.stateRevision")
+{
+  auto rootNode = TestNode{};
+  auto* childNode = new TestNode{};
+  auto* grandChildNode = new TestNode{};
+  auto* siblingNode = new TestNode{};
+
+  childNode->addChild(grandChildNode);
+  rootNode.addChildren({childNode, siblingNode});
+
+  const auto revisions = [&]() {
+    return std::vector<uint64_t>{
+      rootNode.stateRevision(),
+      childNode->stateRevision(),
+      grandChildNode->stateRevision(),
+      siblingNode->stateRevision(),
+    };
+  };
+
+  const auto changed = [&](const auto& oldRevisions) {
+    const auto newRevisions = revisions();
+    auto result = std::vector<bool>{};
+    for (size_t i = 0; i < newRevisions.size(); ++i)
+    {
+      result.push_back(newRevisions[i] != oldRevisions[i]);
+    }
+    return result;
+  };
+
+  const auto initialRevisions = revisions();
+  CHECK(
+    std::set<uint64_t>{initialRevisions.begin(), initialRevisions.end()}.size()
+    == initialRevisions.size());
+
+  SECTION("Changing the visibility state changes the revisions of the subtree")
+  {
+    childNode->setVisibilityState(VisibilityState::Hidden);
+    CHECK(changed(initialRevisions) == std::vector<bool>{false, true, true, false});
+
+    const auto currentRevisions = revisions();
+    childNode->setVisibilityState(VisibilityState::Hidden);
+    CHECK(revisions() == currentRevisions);
+  }
+
+  SECTION("Changing the lock state changes the revisions of the subtree")
+  {
+    childNode->setLockState(LockState::Locked);
+    CHECK(changed(initialRevisions) == std::vector<bool>{false, true, true, false});
+  }
+
+  SECTION("Locking by another selection changes the revisions of the subtree")
+  {
+    childNode->setLockedByOtherSelection(true);
+    CHECK(changed(initialRevisions) == std::vector<bool>{false, true, true, false});
+  }
+
+  SECTION("Changing the parent changes the revisions of the subtree")
+  {
+    rootNode.removeChild(childNode);
+    siblingNode->addChild(childNode);
+    CHECK(changed(initialRevisions) == std::vector<bool>{false, true, true, false});
+  }
+}
+
 TEST_CASE("NodeTest.addRemoveChild")
 {
   auto rootNode = MockNode{};
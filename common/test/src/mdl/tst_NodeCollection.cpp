@@ -504,4 +504,125 @@ TEST_CASE("NodeCollection.clear")
   CHECK(nodeCollection.patches() == std::vector<PatchNode*>{});
 }
 
+TEST_CASE("NodeCollection.contains")
+{
+  const auto mapFormat = MapFormat::Quake3;
+  const auto worldBounds = vm::bbox3d{8192.0};
+
+  auto layerNode = LayerNode{Layer{"layer"}};
+  auto groupNode = GroupNode{Group{"group"}};
+  auto entityNode = EntityNode{Entity{}};
+  auto brushNode = BrushNode{
+    BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "material") | kdl::value()};
+
+  // clang-format off
+  auto patchNode = PatchNode{BezierPatch{3, 3, {
+    {0, 0, 0}, {1, 0, 1}, {2, 0, 0},
+    {0, 1, 1}, {1, 1, 2}, {2, 1, 1},
+    {0, 2, 0}, {1, 2, 1}, {2, 2, 0} }, "material"}};
+  // clang-format on
+
+  auto nodeCollection = NodeCollection{};
+  nodeCollection.addNodes({&groupNode, &brushNode});
+
+  CHECK_FALSE(nodeCollection.contains(&layerNode));
+  CHECK(nodeCollection.contains(&groupNode));
+  CHECK_FALSE(nodeCollection.contains(&entityNode));
+  CHECK(nodeCollection.contains(&brushNode));
+  CHECK_FALSE(nodeCollection.contains(&patchNode));
+
+  nodeCollection.removeNode(&brushNode);
+  CHECK_FALSE(nodeCollection.contains(&brushNode));
+
+  nodeCollection.clear();
+  CHECK_FALSE(nodeCollection.contains(&groupNode));
+}
+
+TEST_CASE("NodeCollection.addNodes ignores contained nodes")
+{
+  const auto mapFormat = MapFormat::Quake3;
+  const auto worldBounds = vm::bbox3d{8192.0};
+
+  auto layerNode = LayerNode{Layer{"layer"}};
+  auto groupNode = GroupNode{Group{"group"}};
+  auto entityNode = EntityNode{Entity{}};
+  auto brushNode = BrushNode{
+    BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "material") | kdl::value()};
+
+  // clang-format off
+  auto patchNode = PatchNode{BezierPatch{3, 3, {
+    {0, 0, 0}, {1, 0, 1}, {2, 0, 0},
+    {0, 1, 1}, {1, 1, 2}, {2, 1, 1},
+    {0, 2, 0}, {1, 2, 1}, {2, 2, 0} }, "material"}};
+  // clang-format on
+
+  auto nodeCollection = NodeCollection{};
+  nodeCollection.addNodes({&entityNode, &brushNode, &entityNode});
+  nodeCollection.addNode(&brushNode);
+
+  CHECK(nodeCollection.nodes() == std::vector<Node*>{&entityNode, &brushNode});
+  CHECK(nodeCollection.entities() == std::vector<EntityNode*>{&entityNode});
+  CHECK(nodeCollection.brushes() == std::vector<BrushNode*>{&brushNode});
+}
+
+TEST_CASE("NodeCollection.removeNodes")
+{
+  const auto mapFormat = MapFormat::Quake3;
+  const auto worldBounds = vm::bbox3d{8192.0};
+
+  auto layerNode = LayerNode{Layer{"layer"}};
+  auto groupNode = GroupNode{Group{"group"}};
+  auto entityNode = EntityNode{Entity{}};
+  auto brushNode = BrushNode{
+    BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "material") | kdl::value()};
+
+  // clang-format off
+  auto patchNode = PatchNode{BezierPatch{3, 3, {
+    {0, 0, 0}, {1, 0, 1}, {2, 0, 0},
+    {0, 1, 1}, {1, 1, 2}, {2, 1, 1},
+    {0, 2, 0}, {1, 2, 1}, {2, 2, 0} }, "material"}};
+  // clang-format on
+
+  auto nodeCollection = NodeCollection{};
+  nodeCollection.addNodes({&layerNode, &groupNode, &entityNode, &brushNode, &patchNode});
+
+  SECTION("some nodes")
+  {
+    nodeCollection.removeNodes({&patchNode, &groupNode, &patchNode});
+    CHECK(
+      nodeCollection.nodes() == std::vector<Node*>{&layerNode, &entityNode, &brushNode});
+    CHECK(nodeCollection.layers() == std::vector<LayerNode*>{&layerNode});
+    CHECK(nodeCollection.groups() == std::vector<GroupNode*>{});
+    CHECK(nodeCollection.entities() == std::vector<EntityNode*>{&entityNode});
+    CHECK(nodeCollection.brushes() == std::vector<BrushNode*>{&brushNode});
+    CHECK(nodeCollection.patches() == std::vector<PatchNode*>{});
+    CHECK_FALSE(nodeCollection.contains(&groupNode));
+    CHECK_FALSE(nodeCollection.contains(&patchNode));
+  }
+
+  SECTION("all nodes")
+  {
+    nodeCollection.removeNodes(
+      {&brushNode, &patchNode, &layerNode, &groupNode, &entityNode});
+    CHECK(nodeCollection.empty());
+    CHECK_FALSE(nodeCollection.contains(&brushNode));
+  }
+
+  SECTION("nodes that are not contained")
+  {
+    auto otherBrushNode = BrushNode{
+      BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "material") | kdl::value()};
+
+    nodeCollection.removeNodes({&otherBrushNode});
+    CHECK(nodeCollection.nodeCount() == 5u);
+  }
+
+  SECTION("collection")
+  {
+    nodeCollection.removeNodes(NodeCollection{{&entityNode, &brushNode}});
+    CHECK(
+      nodeCollection.nodes() == std::vector<Node*>{&layerNode, &groupNode, &patchNode});
+  }
+}
+
 } // namespace tb::mdl
@@ -0,0 +1,98 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/NodeIdSet.h"
+
+#include "Catch2.h"
+
+namespace tb::mdl
+{
+
+TEST_CASE("NodeIdSet")
+{
+  auto set = NodeIdSet{};
+  CHECK(set.empty());
+  CHECK(set.count() == 0u);
+  CHECK_FALSE(set.contains(0u));
+
+  SECTION("insert")
+  {
+    CHECK(set.insert(3u));
+    CHECK(set.insert(200u));
+    CHECK_FALSE(set.insert(3u));
+
+    CHECK(set.count() == 2u);
+    CHECK(set.contains(3u));
+    CHECK(set.contains(200u));
+    CHECK_FALSE(set.contains(4u));
+    CHECK_FALSE(set.contains(1000u));
+  }
+
+  SECTION("erase")
+  {
+    set.insert(3u);
+    set.insert(200u);
+
+    CHECK(set.erase(200u));
+    CHECK_FALSE(set.erase(200u));
+    CHECK_FALSE(set.erase(1000u));
+
+    CHECK(set.count() == 1u);
+    CHECK(set.contains(3u));
+    CHECK_FALSE(set.contains(200u));
+
+    auto expected = NodeIdSet{};
+    expected.insert(3u);
+    CHECK(set == expected);
+  }
+
+  SECTION("clear")
+  {
+    set.insert(3u);
+    set.insert(200u);
+    set.clear();
+
+    CHECK(set.empty());
+    CHECK_FALSE(set.contains(3u));
+    CHECK(set == NodeIdSet{});
+  }
+
+  SECTION("difference")
+  {
+    set.insert(1u);
+    set.insert(2u);
+    set.insert(130u);
+
+    auto other = NodeIdSet{};
+    other.insert(2u);
+    other.insert(3u);
+    other.insert(300u);
+
+    set -= other;
+    CHECK(set.count() == 2u);
+    CHECK(set.contains(1u));
+    CHECK(set.contains(130u));
+    CHECK_FALSE(set.contains(2u));
+
+    other -= other;
+    CHECK(other == NodeIdSet{});
+  }
+}
+
+} // namespace tb::mdl
@@ -22,12 +22,18 @@
 #include "mdl/Polyhedron_IO.h" // IWYU pragma: keep
 #include "mdl/Polyhedron_Instantiation.h"
 
+#include "kdl/vector_utils.h"
+
+#include "vm/approx.h"
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
 #include "vm/vec.h"
 #include "vm/vec_io.h"
 
 #include <algorithm>
 #include <iterator>
 #include <set>
+#include <tuple>
 
 #include "Catch2.h"
 
@@ -351,6 +357,129 @@ TEST_CASE("PolyhedronTest.constructCube")
      {p2, p6, p8, p4}}));
 }
 
+TEST_CASE("PolyhedronTest.constructFromTopology")
+{
+  const auto p1 = vm::vec3d{-8, -8, -8};
+  const auto p2 = vm::vec3d{-8, -8, +8};
+  const auto p3 = vm::vec3d{-8, +8, -8};
+  const auto p4 = vm::vec3d{-8, +8, +8};
+  const auto p5 = vm::vec3d{+8, -8, -8};
+  const auto p6 = vm::vec3d{+8, -8, +8};
+  const auto p7 = vm::vec3d{+8, +8, -8};
+  const auto p8 = vm::vec3d{+8, +8, +8};
+
+  const auto positions = std::vector<vm::vec3d>{p1, p2, p3, p4, p5, p6, p7, p8};
+
+  SECTION("Cube")
+  {
+    const auto p = Polyhedron3d{
+      positions,
+      {
+        {0, 4, 5, 1},
+        {2, 0, 1, 3},
+        {6, 2, 3, 7},
+        {4, 6, 7, 5},
+        {2, 6, 4, 0},
+        {1, 5, 7, 3},
+      }};
+
+    CHECK(p == Polyhedron3d{p1, p2, p3, p4, p5, p6, p7, p8});
+    CHECK(p.bounds() == vm::bbox3d{8.0});
+
+    for (const auto* face : p.faces())
+    {
+      CHECK(vm::dot(face->plane().normal, face->center()) > 0.0);
+    }
+  }
+
+  SECTION("Open surface")
+  {
+    const auto p = Polyhedron3d{
+      positions,
+      {
+        {0, 4, 5, 1},
+        {2, 0, 1, 3},
+        {6, 2, 3, 7},
+        {4, 6, 7, 5},
+        {2, 6, 4, 0},
+      }};
+
+    CHECK(p.empty());
+  }
+
+  SECTION("Inconsistent orientation")
+  {
+    const auto p = Polyhedron3d{
+      positions,
+      {
+        {0, 4, 5, 1},
+        {2, 0, 1, 3},
+        {6, 2, 3, 7},
+        {4, 6, 7, 5},
+        {2, 6, 4, 0},
+        {3, 7, 5, 1},
+      }};
+
+    CHECK(p.empty());
+  }
+
+  SECTION("Invalid indices")
+  {
+    CHECK(Polyhedron3d{positions, {{0, 4, 8}}}.empty());
+    CHECK(Polyhedron3d{positions, {{0, 4, 4}}}.empty());
+    CHECK(Polyhedron3d{positions, {{0, 4}}}.empty());
+  }
+}
+
+TEST_CASE("PolyhedronTest.constructFromPrevious")
+{
+  const auto p1 = vm::vec3d{-8, -8, -8};
+  const auto p2 = vm::vec3d{-8, -8, +8};
+  const auto p3 = vm::vec3d{-8, +8, -8};
+  const auto p4 = vm::vec3d{-8, +8, +8};
+  const auto p5 = vm::vec3d{+8, -8, -8};
+  const auto p6 = vm::vec3d{+8, -8, +8};
+  const auto p7 = vm::vec3d{+8, +8, -8};
+  const auto p8 = vm::vec3d{+8, +8, +8};
+
+  const auto previous = Polyhedron3d{p1, p2, p3, p4, p5, p6, p7, p8};
+
+  auto positions = previous.vertexPositions();
+  const auto moveVertex = [&](const auto& from, const auto& to) {
+    std::replace(positions.begin(), positions.end(), from, to);
+  };
+
+  SECTION("Move top face up")
+  {
+    const auto delta = vm::vec3d{0, 0, 4};
+    moveVertex(p2, p2 + delta);
+    moveVertex(p4, p4 + delta);
+    moveVertex(p6, p6 + delta);
+    moveVertex(p8, p8 + delta);
+  }
+
+  SECTION("Move vertex outward")
+  {
+    moveVertex(p8, vm::vec3d{+12, +12, +12});
+  }
+
+  SECTION("Move vertex inward")
+  {
+    moveVertex(p8, vm::vec3d{+4, +4, +8});
+  }
+
+  SECTION("Move vertex onto other vertex")
+  {
+    moveVertex(p8, p7);
+  }
+
+  const auto p = Polyhedron3d{previous, positions};
+  const auto expected = Polyhedron3d{positions};
+
+  CHECK(p == expected);
+  CHECK(p.bounds() == expected.bounds());
+}
+
 TEST_CASE("PolyhedronTest.copy")
 {
   const auto p1 = vm::vec3d{0, 0, 8};
@@ -392,6 +521,61 @@ TEST_CASE("PolyhedronTest.swap")
   CHECK(rhs.bounds() == original.bounds());
 }
 
+TEST_CASE("PolyhedronTest.transform")
+{
+  const auto p1 = vm::vec3d{0, 0, 8};
+  const auto p2 = vm::vec3d{8, 0, 0};
+  const auto p3 = vm::vec3d{-8, 0, 0};
+  const auto p4 = vm::vec3d{0, 8, 0};
+
+  using T = std::tuple<vm::mat4x4d>;
+
+  // clang-format off
+  const auto
+  [transformation] = GENERATE(values<T>({
+  {vm::translation_matrix(vm::vec3d{16, 8, 0}) * vm::rotation_matrix(0.0, 0.0, 1.0)},
+  {vm::scaling_matrix(vm::vec3d{2, 0.5, 1})},
+  {vm::shear_matrix(0.5, 0.0, 0.0, 0.25, 0.0, 0.0)},
+  }));
+  // clang-format on
+
+  CAPTURE(transformation);
+
+  auto p = Polyhedron3d{p1, p2, p3, p4};
+  p.transform(transformation);
+
+  const auto expected = Polyhedron3d{
+    transformation * p1, transformation * p2, transformation * p3, transformation * p4};
+
+  CHECK(hasFaces(
+    p,
+    kdl::vec_transform(expected.faces(), [](const auto* face) {
+      return face->vertexPositions();
+    }),
+    0.0001));
+  CHECK(p.bounds().min == vm::approx{expected.bounds().min});
+  CHECK(p.bounds().max == vm::approx{expected.bounds().max});
+
+  for (const auto* face : p.faces())
+  {
+    for (const auto* halfEdge : face->boundary())
+    {
+      CHECK(
+        face->plane().point_status(halfEdge->origin()->position())
+        == vm::plane_status::inside);
+    }
+  }
+
+  // the face planes must match the planes that are computed from the transformed points
+  for (const auto* expectedFace : expected.faces())
+  {
+    const auto* face = p.findFaceByPositions(expectedFace->vertexPositions(), 0.0001);
+    REQUIRE(face != nullptr);
+    CHECK(face->plane().normal == vm::approx{expectedFace->plane().normal});
+    CHECK(face->plane().distance == vm::approx{expectedFace->plane().distance});
+  }
+}
+
 TEST_CASE("PolyhedronTest.clipCubeWithHorizontalPlane")
 {
   const auto p1 = vm::vec3d{-64, -64, -64};
@@ -220,6 +220,58 @@ TEST_CASE("Resource")
       }
     }
 
+    SECTION("ResourceDeferred state")
+    {
+      resource.deferLoading();
+      REQUIRE(std::holds_alternative<ResourceDeferred<MockResource>>(resource.state()));
+
+      CHECK(resource.get() == nullptr);
+      CHECK(resource.isDeferred());
+      CHECK(!resource.isDropped());
+
+      SECTION("process")
+      {
+        CHECK(!resource.process(taskRunner, processContext));
+        CHECK(std::holds_alternative<ResourceDeferred<MockResource>>(resource.state()));
+        CHECK(mockTaskRunner.tasks.empty());
+      }
+
+      SECTION("requestLoading")
+      {
+        resource.requestLoading();
+        CHECK(std::holds_alternative<ResourceUnloaded<MockResource>>(resource.state()));
+        CHECK(!resource.isDeferred());
+
+        CHECK(resource.process(taskRunner, processContext));
+        CHECK(std::holds_alternative<ResourceLoading<MockResource>>(resource.state()));
+        CHECK(mockTaskRunner.tasks.size() == 1);
+      }
+
+      SECTION("drop")
+      {
+        resource.drop();
+        CHECK(std::holds_alternative<ResourceDropped>(resource.state()));
+        CHECK(resource.isDropped());
+        CHECK(mockTaskRunner.tasks.empty());
+      }
+
+      SECTION("loadSync")
+      {
+        resource.loadSync();
+        CHECK(resource.get() != nullptr);
+        CHECK(std::holds_alternative<ResourceLoaded<MockResource>>(resource.state()));
+        CHECK(mockTaskRunner.tasks.empty());
+      }
+
+      SECTION("dropSync")
+      {
+        resource.dropSync(glContextAvailable);
+        CHECK(std::holds_alternative<ResourceDropped>(resource.state()));
+        CHECK(resource.isDropped());
+        CHECK(mockDropCall == std::nullopt);
+      }
+    }
+
     SECTION("ResourceLoading state")
     {
       setResourceState<ResourceLoading<MockResource>>(
@@ -705,6 +757,16 @@ TEST_CASE("Resource")
       CHECK(resource.needsProcessing());
     }
 
+    SECTION("ResourceDeferred state")
+    {
+      auto resource = ResourceT{[&]() { return Result<MockResource>{MockResource{}}; }};
+      resource.deferLoading();
+      CHECK(!resource.needsProcessing());
+
+      resource.requestLoading();
+      CHECK(resource.needsProcessing());
+    }
+
     SECTION("ResourceLoading state")
     {
       auto resource = ResourceT{[&]() { return Result<MockResource>{MockResource{}}; }};
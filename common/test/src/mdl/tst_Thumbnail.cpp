@@ -0,0 +1,144 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Color.h"
+#include "mdl/Texture.h"
+#include "mdl/TextureBuffer.h"
+#include "mdl/Thumbnail.h"
+
+#include "kdl/result.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::mdl
+{
+namespace
+{
+
+Texture makeTexture(
+  const size_t width,
+  const size_t height,
+  const GLenum format,
+  const std::vector<unsigned char>& pixel)
+{
+  auto buffer = TextureBuffer{width * height * pixel.size()};
+  for (size_t i = 0; i < width * height; ++i)
+  {
+    std::copy(pixel.begin(), pixel.end(), buffer.data() + i * pixel.size());
+  }
+
+  return Texture{
+    width,
+    height,
+    Color{1.0f, 0.0f, 0.0f, 1.0f},
+    format,
+    TextureMask::Off,
+    NoEmbeddedDefaults{},
+    std::move(buffer)};
+}
+
+std::vector<unsigned char> pixelAt(const Texture& texture, const size_t x, const size_t y)
+{
+  const auto bytesPerPixel = bytesPerPixelForFormat(texture.format());
+  const auto* data = texture.buffersIfLoaded().front().data()
+                     + (y * texture.width() + x) * bytesPerPixel;
+  return {data, data + bytesPerPixel};
+}
+
+} // namespace
+
+TEST_CASE("createThumbnail")
+{
+  SECTION("Returns textures that fit as they are")
+  {
+    const auto thumbnail = createThumbnail(makeTexture(64, 128, GL_RGB, {1, 2, 3}), 128);
+    REQUIRE(thumbnail.is_success());
+    CHECK(thumbnail.value().width() == 64u);
+    CHECK(thumbnail.value().height() == 128u);
+    CHECK(pixelAt(thumbnail.value(), 10, 100) == std::vector<unsigned char>{1, 2, 3});
+  }
+
+  SECTION("Downscales textures preserving the aspect ratio")
+  {
+    using T = std::tuple<size_t, size_t, size_t, size_t>;
+    const auto [width, height, expectedWidth, expectedHeight] = GENERATE(values<T>({
+      {256, 256, 128, 128},
+      {512, 128, 128, 32},
+      {64, 1024, 8, 128},
+      {2048, 1, 128, 1},
+    }));
+
+    CAPTURE(width, height);
+
+    const auto thumbnail =
+      createThumbnail(makeTexture(width, height, GL_BGRA, {10, 20, 30, 255}), 128);
+    REQUIRE(thumbnail.is_success());
+
+    const auto& texture = thumbnail.value();
+    CHECK(texture.width() == expectedWidth);
+    CHECK(texture.height() == expectedHeight);
+    CHECK(texture.format() == GLenum(GL_BGRA));
+    CHECK(texture.averageColor() == Color{1.0f, 0.0f, 0.0f, 1.0f});
+    CHECK(texture.buffersIfLoaded().size() == 1u);
+    CHECK(
+      pixelAt(texture, expectedWidth - 1, expectedHeight - 1)
+      == std::vector<unsigned char>{10, 20, 30, 255});
+  }
+
+  SECTION("Averages pixels weighted by alpha")
+  {
+    auto texture = makeTexture(4, 2, GL_RGBA, {0, 0, 0, 0});
+    auto* data = const_cast<unsigned char*>(texture.buffersIfLoaded().front().data());
+
+    // the left half is opaque red, the right half is transparent green
+    for (const auto x : {0, 1})
+    {
+      for (const auto y : {0, 1})
+      {
+        auto* pixel = data + (y * 4 + x) * 4;
+        pixel[0] = 255;
+        pixel[3] = 255;
+
+        pixel = data + (y * 4 + x + 2) * 4;
+        pixel[1] = 255;
+      }
+    }
+
+    const auto thumbnail = createThumbnail(std::move(texture), 2);
+    REQUIRE(thumbnail.is_success());
+    REQUIRE(thumbnail.value().width() == 2u);
+    REQUIRE(thumbnail.value().height() == 1u);
+
+    CHECK(pixelAt(thumbnail.value(), 0, 0) == std::vector<unsigned char>{255, 0, 0, 255});
+    CHECK(pixelAt(thumbnail.value(), 1, 0) == std::vector<unsigned char>{0, 0, 0, 0});
+  }
+
+  SECTION("Fails if the texture is not loaded")
+  {
+    auto texture = makeTexture(256, 256, GL_RGB, {1, 2, 3});
+    texture.upload(false);
+
+    CHECK(createThumbnail(std::move(texture), 128).is_error());
+  }
+}
+
+} // namespace tb::mdl
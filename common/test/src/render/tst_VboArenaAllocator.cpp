@@ -0,0 +1,183 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/VboArenaAllocator.h"
+
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::render
+{
+
+TEST_CASE("VboArenaAllocator")
+{
+  auto allocator = VboArenaAllocator{1024, 4096};
+
+  SECTION("Initially has no arenas")
+  {
+    CHECK(allocator.arenas().empty());
+    CHECK(allocator.allocatedBytes() == 0u);
+    CHECK(allocator.liveBytes() == 0u);
+  }
+
+  SECTION("Aligns allocations")
+  {
+    const auto a1 = allocator.allocate(10);
+    const auto a2 = allocator.allocate(17);
+
+    CHECK(a1.offset() % VboArenaAllocator::Alignment == 0u);
+    CHECK(a1.size() == 16u);
+    CHECK(a2.offset() % VboArenaAllocator::Alignment == 0u);
+    CHECK(a2.size() == 32u);
+    CHECK(allocator.liveBytes() == 48u);
+  }
+
+  SECTION("Sub-allocates from a single arena")
+  {
+    auto allocations = std::vector<VboArenaAllocator::Allocation>{};
+    for (size_t i = 0; i < 8; ++i)
+    {
+      allocations.push_back(allocator.allocate(128));
+    }
+
+    CHECK(allocator.arenas().size() == 1u);
+    CHECK(allocator.allocatedBytes() == 1024u);
+    CHECK(allocator.liveBytes() == 1024u);
+
+    for (const auto& allocation : allocations)
+    {
+      CHECK(allocation.arena == allocations.front().arena);
+    }
+  }
+
+  SECTION("Grows geometrically")
+  {
+    allocator.allocate(1024);
+    CHECK(allocator.allocatedBytes() == 1024u);
+
+    allocator.allocate(1024);
+    CHECK(allocator.arenas().size() == 2u);
+    CHECK(allocator.allocatedBytes() == 1024u + 2048u);
+
+    allocator.allocate(2048);
+    allocator.allocate(16);
+    CHECK(allocator.arenas().size() == 3u);
+    CHECK(allocator.allocatedBytes() == 1024u + 2048u + 4096u);
+
+    SECTION("Up to the maximum arena capacity")
+    {
+      allocator.allocate(4096);
+      allocator.allocate(16);
+      CHECK(allocator.arenas().back()->capacity() == 4096u);
+    }
+
+    SECTION("Unless the allocation is larger")
+    {
+      allocator.allocate(8192);
+      CHECK(allocator.arenas().back()->capacity() == 8192u);
+    }
+  }
+
+  SECTION("Frees allocations")
+  {
+    const auto a1 = allocator.allocate(512);
+    const auto a2 = allocator.allocate(512);
+    allocator.free(a1);
+
+    CHECK(allocator.liveBytes() == 512u);
+    CHECK(allocator.allocatedBytes() == 1024u);
+
+    const auto a3 = allocator.allocate(512);
+    CHECK(a3.arena == a2.arena);
+    CHECK(a3.offset() == a1.offset());
+    CHECK(allocator.arenas().size() == 1u);
+  }
+
+  SECTION("Releases empty arenas except for the largest one")
+  {
+    const auto a1 = allocator.allocate(1024);
+    const auto a2 = allocator.allocate(2048);
+    allocator.free(a1);
+    allocator.free(a2);
+
+    auto released = std::vector<size_t>{};
+    allocator.releaseEmptyArenas(
+      [&](const auto& arena) { released.push_back(arena.capacity()); });
+
+    CHECK(released == std::vector<size_t>{1024});
+    CHECK(allocator.arenas().size() == 1u);
+    CHECK(allocator.allocatedBytes() == 2048u);
+  }
+
+  SECTION("Compacts sparse arenas")
+  {
+    const auto a1 = allocator.allocate(1024);
+    const auto a2 = allocator.allocate(1024);
+    const auto a3 = allocator.allocate(256);
+    const auto a4 = allocator.allocate(1024);
+    REQUIRE(allocator.arenas().size() == 3u);
+    REQUIRE(a2.arena == a3.arena);
+
+    allocator.free(a1);
+    allocator.free(a4);
+
+    SECTION("Moves all allocations out of the sparsest arena")
+    {
+      // the second arena is 1280 / 2048 full, the third one is empty
+      allocator.free(a2);
+      const auto a3Size = a3.size();
+
+      const auto moves = allocator.compact(0.25);
+      REQUIRE(moves.size() == 1u);
+      CHECK(moves[0].from.block == a3.block);
+      CHECK(moves[0].to.arena != a3.arena);
+      CHECK(moves[0].to.size() == a3Size);
+      CHECK(allocator.liveBytes() == 2 * a3Size);
+
+      allocator.free(moves[0].from);
+
+      auto released = std::vector<size_t>{};
+      allocator.releaseEmptyArenas(
+        [&](const auto& arena) { released.push_back(arena.capacity()); });
+
+      CHECK(released == std::vector<size_t>{2048});
+      CHECK(allocator.liveBytes() == a3Size);
+    }
+
+    SECTION("Does not compact arenas that are used enough")
+    {
+      CHECK(allocator.compact(0.25).empty());
+    }
+
+    SECTION("Moves nothing if not all allocations fit into other arenas")
+    {
+      // the first arena has room for a2, but no arena has room for a3
+      const auto a5 = allocator.allocate(4096);
+      REQUIRE(a5.arena == a4.arena);
+
+      const auto liveBytes = allocator.liveBytes();
+      CHECK(allocator.compact(0.75).empty());
+      CHECK(allocator.liveBytes() == liveBytes);
+      CHECK_FALSE(a1.arena->tracker.hasAllocations());
+    }
+  }
+}
+
+} // namespace tb::render
@@ -19,6 +19,9 @@
 
 #include "Notifier.h"
 
+#include "kdl/string_utils.h"
+
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -424,4 +427,165 @@ TEST_CASE("NotifyBeforeAndAfter")
   }
 }
 
+TEST_CASE("NotifierBatch")
+{
+  auto n = Notifier<const std::vector<int>&>{};
+  auto batch = NotifierBatch<int>{n};
+
+  auto calls = std::vector<std::vector<int>>{};
+  auto connection = n.connect([&](const auto& v) { calls.push_back(v); });
+
+  SECTION("Delivers notifications immediately when not open")
+  {
+    n(std::vector<int>{1, 2});
+    n(std::vector<int>{2, 3});
+
+    CHECK(calls == std::vector<std::vector<int>>{{1, 2}, {2, 3}});
+    CHECK(batch.stats().collectedNotifications == 0);
+  }
+
+  SECTION("Coalesces notifications while open")
+  {
+    batch.open();
+    CHECK(batch.isOpen());
+
+    n(std::vector<int>{1, 2});
+    n(std::vector<int>{3, 2, 1});
+    n(std::vector<int>{4});
+    CHECK(calls.empty());
+
+    batch.close();
+    CHECK_FALSE(batch.isOpen());
+    CHECK(calls == std::vector<std::vector<int>>{{1, 2, 3, 4}});
+    CHECK(batch.stats().collectedNotifications == 3);
+    CHECK(batch.stats().deliveredNotifications == 1);
+    CHECK(batch.stats().deliveredElements == 4);
+
+    n(std::vector<int>{5});
+    CHECK(calls == std::vector<std::vector<int>>{{1, 2, 3, 4}, {5}});
+  }
+
+  SECTION("Only delivers when the outermost batch is closed")
+  {
+    batch.open();
+    n(std::vector<int>{1});
+
+    batch.open();
+    n(std::vector<int>{2});
+    batch.close();
+    CHECK(calls.empty());
+
+    batch.close();
+    CHECK(calls == std::vector<std::vector<int>>{{1, 2}});
+  }
+
+  SECTION("Flush delivers the collected notifications")
+  {
+    batch.open();
+    n(std::vector<int>{1});
+    batch.flush();
+    CHECK(calls == std::vector<std::vector<int>>{{1}});
+
+    n(std::vector<int>{2});
+    batch.close();
+    CHECK(calls == std::vector<std::vector<int>>{{1}, {2}});
+    CHECK(batch.stats().deliveredNotifications == 2);
+  }
+
+  SECTION("Does not deliver anything if nothing was collected")
+  {
+    batch.open();
+    batch.close();
+    CHECK(calls.empty());
+    CHECK(batch.stats().deliveredNotifications == 0);
+  }
+
+  SECTION("Notifies unbatched observers immediately")
+  {
+    auto unbatchedCalls = std::vector<std::vector<int>>{};
+    auto unbatchedConnection =
+      n.connectUnbatched([&](const auto& v) { unbatchedCalls.push_back(v); });
+
+    batch.open();
+    n(std::vector<int>{1, 2});
+    n(std::vector<int>{2});
+    CHECK(calls.empty());
+    CHECK(unbatchedCalls == std::vector<std::vector<int>>{{1, 2}, {2}});
+
+    batch.close();
+    CHECK(calls == std::vector<std::vector<int>>{{1, 2}});
+    CHECK(unbatchedCalls == std::vector<std::vector<int>>{{1, 2}, {2}});
+  }
+}
+
+TEST_CASE("NotifierBatch with will notifier")
+{
+  auto will = Notifier<const std::vector<int>&>{};
+  auto did = Notifier<const std::vector<int>&>{};
+  auto batch = NotifierBatch<int>{did, will};
+
+  auto calls = std::vector<std::string>{};
+  auto willConnection = will.connect([&](const auto& v) {
+    calls.push_back("will " + kdl::str_join(v, ","));
+  });
+  auto didConnection = did.connect([&](const auto& v) {
+    calls.push_back("did " + kdl::str_join(v, ","));
+  });
+
+  auto unbatchedWillCalls = std::vector<std::vector<int>>{};
+  auto unbatchedWillConnection =
+    will.connectUnbatched([&](const auto& v) { unbatchedWillCalls.push_back(v); });
+
+  SECTION("Announces every change when not open")
+  {
+    will(std::vector<int>{1});
+    did(std::vector<int>{1});
+    will(std::vector<int>{1});
+    did(std::vector<int>{1});
+
+    CHECK(calls == std::vector<std::string>{"will 1", "did 1", "will 1", "did 1"});
+  }
+
+  SECTION("Does not announce elements that are already pending")
+  {
+    batch.open();
+    will(std::vector<int>{1, 2});
+    did(std::vector<int>{1, 2});
+    will(std::vector<int>{2, 3});
+    did(std::vector<int>{2, 3});
+    will(std::vector<int>{1});
+    did(std::vector<int>{1});
+    batch.close();
+
+    CHECK(calls == std::vector<std::string>{"will 1,2", "will 3", "did 1,2,3"});
+    CHECK(unbatchedWillCalls == std::vector<std::vector<int>>{{1, 2}, {2, 3}, {1}});
+  }
+
+  SECTION("Announces elements again after the batch was flushed")
+  {
+    batch.open();
+    will(std::vector<int>{1});
+    did(std::vector<int>{1});
+    batch.flush();
+    will(std::vector<int>{1});
+    did(std::vector<int>{1});
+    batch.close();
+
+    CHECK(calls == std::vector<std::string>{"will 1", "did 1", "will 1", "did 1"});
+  }
+
+  SECTION("Announces every change after the batch was closed")
+  {
+    batch.open();
+    will(std::vector<int>{1});
+    did(std::vector<int>{1});
+    batch.close();
+
+    will(std::vector<int>{1});
+    did(std::vector<int>{1});
+
+    CHECK(calls == std::vector<std::string>{"will 1", "did 1", "will 1", "did 1"});
+  }
+}
+
 } // namespace tb
@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Trace.h"
+#include "el/EvaluationContext.h"
+#include "el/Expression.h"
+#include "el/Value.h"
+#include "io/ELParser.h"
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "Catch2.h"
+
+namespace tb
+{
+
+TEST_CASE("Trace")
+{
+  clearTraceEvents();
+
+  {
+    const auto outer = TraceZone{"outer"};
+    {
+      const auto inner = TraceZone{"inner \"quoted\""};
+    }
+  }
+
+  auto thread = std::thread{[]() { const auto zone = TraceZone{"worker"}; }};
+  thread.join();
+
+  SECTION("collectTraceEvents")
+  {
+    const auto events = collectTraceEvents();
+    REQUIRE(events.size() == 3u);
+
+    const auto& outer = events[0];
+    const auto& inner = events[1];
+    const auto& worker = events[2];
+
+    CHECK(outer.name == std::string{"outer"});
+    CHECK(outer.depth == 0u);
+
+    CHECK(inner.name == std::string{"inner \"quoted\""});
+    CHECK(inner.depth == 1u);
+    CHECK(inner.threadId == outer.threadId);
+    CHECK(inner.start >= outer.start);
+    CHECK(inner.start + inner.duration <= outer.start + outer.duration);
+
+    CHECK(worker.name == std::string{"worker"});
+    CHECK(worker.depth == 0u);
+    CHECK(worker.threadId != outer.threadId);
+
+    CHECK(droppedTraceEventCount() == 0u);
+  }
+
+  SECTION("writeChromeTrace writes well-formed JSON")
+  {
+    auto str = std::stringstream{};
+    writeChromeTrace(str);
+
+    const auto trace =
+      io::ELParser::parseStrict(str.str()).evaluate(el::EvaluationContext{});
+    REQUIRE(trace.type() == el::ValueType::Map);
+
+    const auto& traceEvents = trace.mapValue().at("traceEvents");
+    REQUIRE(traceEvents.type() == el::ValueType::Array);
+    REQUIRE(traceEvents.arrayValue().size() == 3u);
+
+    const auto& inner = traceEvents.arrayValue()[1].mapValue();
+    CHECK(inner.at("name").stringValue() == "inner \"quoted\"");
+    CHECK(inner.at("ph").stringValue() == "X");
+    CHECK(inner.at("ts").type() == el::ValueType::Number);
+    CHECK(inner.at("dur").type() == el::ValueType::Number);
+    CHECK(inner.at("tid").type() == el::ValueType::Number);
+  }
+
+  SECTION("clearTraceEvents")
+  {
+    clearTraceEvents();
+    CHECK(collectTraceEvents().empty());
+  }
+}
+
+} // namespace tb
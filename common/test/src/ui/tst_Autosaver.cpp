@@ -96,6 +96,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverNoSaveUntilSaveInter
   document->addNodes({{document->currentLayer(), {createBrushNode("some_material")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForPendingBackup(logger);
 
   CHECK_FALSE(env.fileExists("autosave/test.1.map"));
   CHECK_FALSE(env.directoryExists("autosave"));
@@ -113,6 +114,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverNoSaveOfUnchangedMap
 
   auto autosaver = Autosaver{document, 0s};
   autosaver.triggerAutosave(logger);
+  autosaver.waitForPendingBackup(logger);
 
   CHECK_FALSE(env.fileExists("autosave/test.1.map"));
   CHECK_FALSE(env.directoryExists("autosave"));
@@ -136,6 +138,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAfterSaveInterv
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForPendingBackup(logger);
 
   CHECK(env.fileExists("autosave/test.1.map"));
   CHECK(env.directoryExists("autosave"));
@@ -159,6 +162,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAgainAfterSaveI
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForPendingBackup(logger);
 
   CHECK(env.fileExists("autosave/test.1.map"));
   CHECK(env.directoryExists("autosave"));
@@ -168,15 +172,55 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAgainAfterSaveI
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForPendingBackup(logger);
   CHECK_FALSE(env.fileExists("autosave/test.2.map"));
 
   // modify the map
   document->addNodes({{document->currentLayer(), {createBrushNode("some_material")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForPendingBackup(logger);
   CHECK(env.fileExists("autosave/test.2.map"));
 }
 
+TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverWritesSnapshot")
+{
+  using namespace std::chrono_literals;
+
+  auto env = io::TestEnvironment{};
+  auto logger = NullLogger{};
+
+  document->saveDocumentAs(env.dir() / "test.map");
+  assert(env.fileExists("test.map"));
+
+  auto autosaver = Autosaver{document, 0s};
+
+  auto* layerNode = new mdl::LayerNode{mdl::Layer{"custom"}};
+  document->addNodes({{document->world(), {layerNode}}});
+
+  auto* brushNode = createBrushNode("some_material");
+  auto* entityNode = new mdl::EntityNode{mdl::Entity{{{"classname", "light"}}}};
+  document->addNodes({{layerNode, {brushNode, entityNode}}});
+
+  document->selectNodes({brushNode});
+  document->groupSelection("group");
+  document->deselectAll();
+
+  document->lock({layerNode});
+
+  autosaver.triggerAutosave(logger);
+
+  // changes made while the backup is being written must not affect it
+  document->addNodes({{document->currentLayer(), {new mdl::EntityNode{{}}}}});
+  autosaver.waitForPendingBackup(logger);
+
+  document->undoCommand();
+  document->saveDocumentTo(env.dir() / "expected.map");
+
+  REQUIRE(env.fileExists("autosave/test.1.map"));
+  CHECK(env.loadFile("autosave/test.1.map") == env.loadFile("expected.map"));
+}
+
 TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 {
   using namespace std::chrono_literals;
@@ -219,6 +263,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 
     std::this_thread::sleep_for(100ms);
     autosaver.triggerAutosave(logger);
+    autosaver.waitForPendingBackup(logger);
 
     const auto allPaths = kdl::vec_push_back(initialPaths, "autosave/test.3.map");
 
@@ -243,6 +288,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 
     std::this_thread::sleep_for(100ms);
     autosaver.triggerAutosave(logger);
+    autosaver.waitForPendingBackup(logger);
 
     CHECK(env.directoryContents("autosave") == allPaths);
     CHECK(
@@ -304,6 +350,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 
     std::this_thread::sleep_for(100ms);
     autosaver.triggerAutosave(logger);
+    autosaver.waitForPendingBackup(logger);
 
     const auto allPaths = std::vector<std::filesystem::path>{
       "autosave/test.1.map",
@@ -351,6 +398,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesWhenCrashFilesP
   document->addNodes({{document->currentLayer(), {createBrushNode("some_material")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForPendingBackup(logger);
 
   CHECK(env.fileExists("autosave/test.2.map"));
 }
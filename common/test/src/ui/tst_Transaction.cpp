@@ -18,17 +18,36 @@
  */
 
 #include "MapDocumentTest.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushNode.h"
 #include "mdl/Entity.h"
 #include "mdl/EntityNode.h"
 #include "ui/Transaction.h"
+#include "ui/VertexTool.h"
 
 #include "vm/mat_ext.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "Catch2.h"
 
 namespace tb::ui
 {
 
+namespace
+{
+
+auto countNotifications(
+  const std::vector<std::vector<mdl::Node*>>& calls, const mdl::Node* node)
+{
+  return std::count_if(calls.begin(), calls.end(), [&](const auto& nodes) {
+    return std::find(nodes.begin(), nodes.end(), node) != nodes.end();
+  });
+}
+
+} // namespace
+
 TEST_CASE_METHOD(MapDocumentTest, "Transaction")
 {
   document->selectAllNodes();
@@ -86,4 +105,93 @@ TEST_CASE_METHOD(MapDocumentTest, "Transaction")
   }
 }
 
+TEST_CASE_METHOD(MapDocumentTest, "Transaction.coalescesNotifications")
+{
+  auto* entityNode = new mdl::EntityNode{mdl::Entity{}};
+  document->addNodes({{document->parentForNodes(), {entityNode}}});
+  document->selectNodes({entityNode});
+
+  auto nodesDidChangeCalls = std::vector<std::vector<mdl::Node*>>{};
+  auto connection = document->nodesDidChangeNotifier.connect(
+    [&](const auto& nodes) { nodesDidChangeCalls.push_back(nodes); });
+
+  const auto statsBefore = document->nodesDidChangeBatchStats();
+
+  {
+    auto transaction = Transaction{document};
+    document->transformObjects("translate", vm::translation_matrix(vm::vec3d{1, 0, 0}));
+    document->transformObjects("translate", vm::translation_matrix(vm::vec3d{0, 1, 0}));
+    document->setProperty("key", "value");
+
+    CHECK(nodesDidChangeCalls.empty());
+    transaction.commit();
+  }
+
+  REQUIRE(nodesDidChangeCalls.size() == 1u);
+  CHECK(std::count(
+          nodesDidChangeCalls.front().begin(),
+          nodesDidChangeCalls.front().end(),
+          entityNode)
+        == 1);
+
+  const auto& statsAfter = document->nodesDidChangeBatchStats();
+  CHECK(statsAfter.collectedNotifications > statsBefore.collectedNotifications + 1);
+  CHECK(statsAfter.deliveredNotifications == statsBefore.deliveredNotifications + 1);
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "Transaction.pairsNodeChangeNotifications")
+{
+  auto* brushNode = createBrushNode();
+  document->addNodes({{document->parentForNodes(), {brushNode}}});
+  document->selectNodes({brushNode});
+
+  auto tool = VertexTool{document};
+  REQUIRE(tool.activate());
+  REQUIRE(tool.handleManager().totalHandleCount() == 8u);
+
+  auto nodesWillChangeCalls = std::vector<std::vector<mdl::Node*>>{};
+  auto nodesDidChangeCalls = std::vector<std::vector<mdl::Node*>>{};
+  auto connection = NotifierConnection{};
+  connection += document->nodesWillChangeNotifier.connect(
+    [&](const auto& nodes) { nodesWillChangeCalls.push_back(nodes); });
+  connection += document->nodesDidChangeNotifier.connect(
+    [&](const auto& nodes) { nodesDidChangeCalls.push_back(nodes); });
+
+  SECTION("Changing a node twice")
+  {
+    {
+      auto transaction = Transaction{document};
+      document->translateObjects(vm::vec3d{16, 0, 0});
+      document->translateObjects(vm::vec3d{0, 16, 0});
+      transaction.commit();
+    }
+
+    CHECK(countNotifications(nodesWillChangeCalls, brushNode) == 1);
+    CHECK(countNotifications(nodesDidChangeCalls, brushNode) == 1);
+
+    const auto vertexPositions = brushNode->brush().vertexPositions();
+    CHECK(tool.handleManager().totalHandleCount() == vertexPositions.size());
+    CHECK(std::all_of(
+      vertexPositions.begin(), vertexPositions.end(), [&](const auto& position) {
+        return tool.handleManager().contains(position);
+      }));
+  }
+
+  SECTION("Changing a node and deselecting it")
+  {
+    {
+      auto transaction = Transaction{document};
+      document->translateObjects(vm::vec3d{16, 0, 0});
+      document->deselectAll();
+      transaction.commit();
+    }
+
+    CHECK(countNotifications(nodesWillChangeCalls, brushNode) == 1);
+    CHECK(countNotifications(nodesDidChangeCalls, brushNode) == 1);
+    CHECK(tool.handleManager().totalHandleCount() == 0u);
+  }
+
+  tool.deactivate();
+}
+
 } // namespace tb::ui
@@ -86,6 +86,10 @@ TEST_CASE_METHOD(UpdateLinkedGroupsHelperTest, "ownership")
   auto* linkedNode =
     static_cast<mdl::GroupNode*>(groupNode->cloneRecursively(document->worldBounds()));
 
+  // change the structure of the linked group so that the children of groupNode are
+  // replaced instead of having their contents swapped
+  linkedNode->addChild(new mdl::EntityNode{mdl::Entity{}});
+
   document->addNodes({{document->parentForNodes(), {groupNode, linkedNode}}});
 
   SECTION("Helper takes ownership of replaced child nodes")
@@ -186,15 +190,15 @@ TEST_CASE_METHOD(UpdateLinkedGroupsHelperTest, "applyLinkedGroupUpdates")
     +-groupNode
       +-brushNode (translated 0 16 0)
     +-linkedGroupNode (translated 32 0 0)
-      +-newLinkedBrushNode (translated 32 16 0)
+      +-linkedBrushNode (translated 32 16 0)
   */
 
-  // changes were propagated
+  // changes were propagated by swapping the contents of the linked brush node
   REQUIRE(linkedGroupNode->childCount() == 1u);
-  CHECK(linkedBrushNode->parent() == nullptr);
-  auto* newLinkedBrushNode = linkedGroupNode->children().front();
+  CHECK_THAT(
+    linkedGroupNode->children(), Catch::Equals(std::vector<mdl::Node*>{linkedBrushNode}));
   CHECK(
-    newLinkedBrushNode->physicalBounds()
+    linkedBrushNode->physicalBounds()
     == originalBrushBounds.translate(vm::vec3d(32.0, 16.0, 0.0)));
 
   // undo change propagation
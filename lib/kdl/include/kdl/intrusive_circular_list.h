@@ -685,7 +685,7 @@ public:
         delete cur;
         cur = next;
       } while (cur != m_head);
-      m_size = 0u;
+      release();
     }
   }
 
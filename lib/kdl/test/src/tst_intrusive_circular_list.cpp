@@ -1547,4 +1547,16 @@ TEST_CASE("intrusive_circular_list_test.clear_with_items")
   CHECK(e2_deleted);
   assertList({}, l);
 }
+
+TEST_CASE("intrusive_circular_list_test.push_back_after_clear")
+{
+  list l;
+
+  l.push_back(new element());
+  l.clear();
+
+  element* e1 = new element();
+  l.push_back(e1);
+  assertList({e1}, l);
+}
 } // namespace kdl